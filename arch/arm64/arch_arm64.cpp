@@ -270,16 +270,16 @@ class Arm64Architecture : public Architecture
 
 	virtual bool Disassemble(const uint8_t* data, uint64_t addr, size_t maxLen, Instruction& result)
 	{
-		(void)addr;
-		(void)maxLen;
-		memset(&result, 0, sizeof(result));
-
 		if (m_onlyDisassembleOnAlignedAddresses && (addr % 4 != 0))
 			return false;
 
-		if (aarch64_decompose(*(uint32_t*)data, &result, addr) != 0)
-			return false;
-		return true;
+		// Info, text and IL for an instruction are requested separately, share one decode between them
+		return DecodeCached<Instruction, 4>(data, addr, maxLen, result, [&](Instruction& instr) -> size_t {
+			memset(&instr, 0, sizeof(instr));
+			if (aarch64_decompose(*(uint32_t*)data, &instr, addr) != 0)
+				return 0;
+			return 4;
+		});
 	}
 
 
@@ -416,7 +416,7 @@ class Arm64Architecture : public Architecture
 
 
 	uint32_t tokenize_shift(
-	    const InstructionOperand* __restrict operand, vector<InstructionTextToken>& result)
+	    const InstructionOperand* __restrict operand, InstructionTextTokenSink& result)
 	{
 		if (operand->shiftType != ShiftType_NONE)
 		{
@@ -424,14 +424,14 @@ class Arm64Architecture : public Architecture
 			if (shiftStr == NULL)
 				return FAILED_TO_DISASSEMBLE_OPERAND;
 
-			result.emplace_back(TextToken, ", ");
-			result.emplace_back(TextToken, shiftStr);
+			result.AddToken(TextToken, ", ");
+			result.AddToken(TextToken, shiftStr);
 			if (operand->shiftValueUsed != 0)
 			{
 				char buf[64] = {0};
 				snprintf(buf, sizeof(buf), "%#x", (uint32_t)operand->shiftValue);
-				result.emplace_back(OperationToken, " #");
-				result.emplace_back(IntegerToken, buf, operand->shiftValue);
+				result.AddToken(OperationToken, " #");
+				result.AddToken(IntegerToken, buf, operand->shiftValue);
 			}
 		}
 		return DISASM_SUCCESS;
@@ -439,7 +439,7 @@ class Arm64Architecture : public Architecture
 
 
 	uint32_t tokenize_shifted_immediate(
-	    const InstructionOperand* __restrict operand, vector<InstructionTextToken>& result)
+	    const InstructionOperand* __restrict operand, InstructionTextTokenSink& result)
 	{
 		char buf[64] = {0};
 		const char* sign = "";
@@ -464,23 +464,23 @@ class Arm64Architecture : public Architecture
 			} f;
 			f.intValue = (uint32_t)operand->immediate;
 			snprintf(buf, sizeof(buf), "%.08f", f.floatValue);
-			result.emplace_back(OperationToken, "#");
-			result.emplace_back(FloatingPointToken, buf);
+			result.AddToken(OperationToken, "#");
+			result.AddToken(FloatingPointToken, buf);
 			break;
 		}
 		case IMM32:
 			snprintf(buf, sizeof(buf), "%s%#x", sign, (uint32_t)imm);
-			result.emplace_back(OperationToken, "#");
-			result.emplace_back(IntegerToken, buf, operand->immediate);
+			result.AddToken(OperationToken, "#");
+			result.AddToken(IntegerToken, buf, operand->immediate);
 			break;
 		case IMM64:
 			snprintf(buf, sizeof(buf), "%s%#" PRIx64, sign, imm);
-			result.emplace_back(OperationToken, "#");
-			result.emplace_back(IntegerToken, buf, operand->immediate);
+			result.AddToken(OperationToken, "#");
+			result.AddToken(IntegerToken, buf, operand->immediate);
 			break;
 		case LABEL:
 			snprintf(buf, sizeof(buf), "%#" PRIx64, operand->immediate);
-			result.emplace_back(PossibleAddressToken, buf, operand->immediate);
+			result.AddToken(PossibleAddressToken, buf, operand->immediate);
 			break;
 		default:
 			return FAILED_TO_DISASSEMBLE_OPERAND;
@@ -492,19 +492,19 @@ class Arm64Architecture : public Architecture
 
 
 	uint32_t tokenize_shifted_register(const InstructionOperand* restrict operand,
-	    uint32_t registerNumber, vector<InstructionTextToken>& result)
+	    uint32_t registerNumber, InstructionTextTokenSink& result)
 	{
 		const char* reg = get_register_name(operand->reg[registerNumber]);
 		if (EMPTY(reg))
 			return FAILED_TO_DISASSEMBLE_REGISTER;
 
-		result.emplace_back(RegisterToken, reg);
+		result.AddToken(RegisterToken, reg);
 		tokenize_shift(operand, result);
 		return DISASM_SUCCESS;
 	}
 
 	uint32_t tokenize_register(const InstructionOperand* restrict operand, uint32_t registerNumber,
-	    vector<InstructionTextToken>& result)
+	    InstructionTextTokenSink& result)
 	{
 		char buf[64] = {0};
 
@@ -512,7 +512,7 @@ class Arm64Architecture : public Architecture
 		if (operand->operandClass == SYS_REG)
 		{
 			snprintf(buf, sizeof(buf), "%s", get_system_register_name((SystemReg)operand->sysreg));
-			result.emplace_back(RegisterToken, buf);
+			result.AddToken(RegisterToken, buf);
 			return DISASM_SUCCESS;
 		}
 
@@ -533,25 +533,25 @@ class Arm64Architecture : public Architecture
 		if (operand->pred_qual && operand->reg[registerNumber] >= REG_P0 &&
 		    operand->reg[registerNumber] <= REG_P31)
 		{
-			result.emplace_back(RegisterToken, reg);
-			result.emplace_back(TextToken, "/");
-			result.emplace_back(TextToken, string(1, operand->pred_qual));
+			result.AddToken(RegisterToken, reg);
+			result.AddToken(TextToken, "/");
+			result.AddToken(TextToken, string(1, operand->pred_qual));
 			return DISASM_SUCCESS;
 		}
 
 		/* case other regs */
-		result.emplace_back(RegisterToken, reg);
+		result.AddToken(RegisterToken, reg);
 		const char* arrspec = get_register_arrspec(operand->reg[registerNumber], operand);
 		if (arrspec)
-			result.emplace_back(TextToken, arrspec);
+			result.AddToken(TextToken, arrspec);
 
 		/* only use index if this is isolated REG (not, for example, MULTIREG */
 		if (operand->operandClass == REG && operand->laneUsed)
 		{
 			snprintf(buf, sizeof(buf), "%u", operand->lane);
-			result.emplace_back(BraceToken, "[");
-			result.emplace_back(IntegerToken, buf);
-			result.emplace_back(BraceToken, "]");
+			result.AddToken(BraceToken, "[");
+			result.AddToken(IntegerToken, buf);
+			result.AddToken(BraceToken, "]");
 		}
 
 		return DISASM_SUCCESS;
@@ -559,7 +559,7 @@ class Arm64Architecture : public Architecture
 
 
 	uint32_t tokenize_memory_operand(
-	    const InstructionOperand* restrict operand, vector<InstructionTextToken>& result)
+	    const InstructionOperand* restrict operand, InstructionTextTokenSink& result)
 	{
 		char immBuff[32] = {0};
 		char paramBuff[32] = {0};
@@ -578,10 +578,10 @@ class Arm64Architecture : public Architecture
 		}
 		const char* startToken = "[";
 		const char* endToken = "";
-		result.emplace_back(BraceToken, startToken);
-		result.emplace_back(BeginMemoryOperandToken, "");
-		result.emplace_back(RegisterToken, reg0);
-		result.emplace_back(TextToken, get_register_arrspec(operand->reg[0], operand));
+		result.AddToken(BraceToken, startToken);
+		result.AddToken(BeginMemoryOperandToken, "");
+		result.AddToken(RegisterToken, reg0);
+		result.AddToken(TextToken, get_register_arrspec(operand->reg[0], operand));
 
 		switch (operand->operandClass)
 		{
@@ -590,52 +590,52 @@ class Arm64Architecture : public Architecture
 		case MEM_PRE_IDX:
 			endToken = "!";
 			snprintf(immBuff, sizeof(immBuff), "%s%#" PRIx64, sign, (uint64_t)imm);
-			result.emplace_back(TextToken, ", ");
-			result.emplace_back(OperationToken, "#");
-			result.emplace_back(IntegerToken, immBuff, operand->immediate);
+			result.AddToken(TextToken, ", ");
+			result.AddToken(OperationToken, "#");
+			result.AddToken(IntegerToken, immBuff, operand->immediate);
 			break;
 		case MEM_POST_IDX:  // [<reg>], <reg|imm>
 			endToken = NULL;
 			if (operand->reg[1] == REG_NONE)
 			{
 				snprintf(paramBuff, sizeof(paramBuff), "%s%#" PRIx64, sign, (uint64_t)imm);
-				result.emplace_back(EndMemoryOperandToken, "");
-				result.emplace_back(BraceToken, "]");
-				result.emplace_back(TextToken, ", ");
-				result.emplace_back(OperationToken, "#");
-				result.emplace_back(IntegerToken, paramBuff, operand->immediate);
+				result.AddToken(EndMemoryOperandToken, "");
+				result.AddToken(BraceToken, "]");
+				result.AddToken(TextToken, ", ");
+				result.AddToken(OperationToken, "#");
+				result.AddToken(IntegerToken, paramBuff, operand->immediate);
 			}
 			else
 			{
 				reg1 = get_register_name(operand->reg[1]);
 				if (EMPTY(reg1))
 					return FAILED_TO_DISASSEMBLE_REGISTER;
-				result.emplace_back(EndMemoryOperandToken, "");
-				result.emplace_back(BraceToken, "]");
-				result.emplace_back(TextToken, ", ");
-				result.emplace_back(RegisterToken, reg1);
-				result.emplace_back(TextToken, get_register_arrspec(operand->reg[1], operand));
+				result.AddToken(EndMemoryOperandToken, "");
+				result.AddToken(BraceToken, "]");
+				result.AddToken(TextToken, ", ");
+				result.AddToken(RegisterToken, reg1);
+				result.AddToken(TextToken, get_register_arrspec(operand->reg[1], operand));
 			}
 			break;
 		case MEM_OFFSET:  // [<reg> optional(imm)]
 			if (operand->immediate != 0)
 			{
 				snprintf(immBuff, sizeof(immBuff), "%s%#" PRIx64, sign, (uint64_t)imm);
-				result.emplace_back(TextToken, ", ");
-				result.emplace_back(OperationToken, "#");
-				result.emplace_back(IntegerToken, immBuff, operand->immediate);
+				result.AddToken(TextToken, ", ");
+				result.AddToken(OperationToken, "#");
+				result.AddToken(IntegerToken, immBuff, operand->immediate);
 
 				if (operand->mul_vl)
-					result.emplace_back(TextToken, ", mul vl");
+					result.AddToken(TextToken, ", mul vl");
 			}
 			break;
 		case MEM_EXTENDED:  // [<reg>, <reg> optional(shift optional(imm))]
-			result.emplace_back(TextToken, ", ");
+			result.AddToken(TextToken, ", ");
 			reg1 = get_register_name(operand->reg[1]);
 			if (EMPTY(reg1))
 				return FAILED_TO_DISASSEMBLE_REGISTER;
-			result.emplace_back(RegisterToken, reg1);
-			result.emplace_back(TextToken, get_register_arrspec(operand->reg[1], operand));
+			result.AddToken(RegisterToken, reg1);
+			result.AddToken(TextToken, get_register_arrspec(operand->reg[1], operand));
 			tokenize_shift(operand, result);
 			break;
 		default:
@@ -643,60 +643,60 @@ class Arm64Architecture : public Architecture
 		}
 		if (endToken != NULL)
 		{
-			result.emplace_back(EndMemoryOperandToken, "");
-			result.emplace_back(BraceToken, "]");
-			result.emplace_back(TextToken, endToken);
+			result.AddToken(EndMemoryOperandToken, "");
+			result.AddToken(BraceToken, "]");
+			result.AddToken(TextToken, endToken);
 		}
 		return DISASM_SUCCESS;
 	}
 
 
 	uint32_t tokenize_multireg_operand(
-	    const InstructionOperand* restrict operand, vector<InstructionTextToken>& result)
+	    const InstructionOperand* restrict operand, InstructionTextTokenSink& result)
 	{
 		char index[32] = {0};
 		uint32_t elementCount = 0;
 
-		result.emplace_back(TextToken, "{");
+		result.AddToken(TextToken, "{");
 		for (; elementCount < 4 && operand->reg[elementCount] != REG_NONE; elementCount++)
 		{
 			if (elementCount != 0)
-				result.emplace_back(TextToken, ", ");
+				result.AddToken(TextToken, ", ");
 
 			if (tokenize_register(operand, elementCount, result) != 0)
 				return FAILED_TO_DISASSEMBLE_OPERAND;
 		}
-		result.emplace_back(TextToken, "}");
+		result.AddToken(TextToken, "}");
 
 		if (operand->laneUsed)
 		{
-			result.emplace_back(BraceToken, "[");
+			result.AddToken(BraceToken, "[");
 			snprintf(index, sizeof(index), "%d", operand->lane);
-			result.emplace_back(IntegerToken, index, operand->lane);
-			result.emplace_back(BraceToken, "]");
+			result.AddToken(IntegerToken, index, operand->lane);
+			result.AddToken(BraceToken, "]");
 		}
 		return DISASM_SUCCESS;
 	}
 
 
 	uint32_t tokenize_condition(
-	    const InstructionOperand* restrict operand, vector<InstructionTextToken>& result)
+	    const InstructionOperand* restrict operand, InstructionTextTokenSink& result)
 	{
 		const char* condStr = get_condition((Condition)operand->cond);
 		if (condStr == NULL)
 			return FAILED_TO_DISASSEMBLE_OPERAND;
 
-		result.emplace_back(TextToken, condStr);
+		result.AddToken(TextToken, condStr);
 		return DISASM_SUCCESS;
 	}
 
 
 	uint32_t tokenize_implementation_specific(
-	    const InstructionOperand* restrict operand, vector<InstructionTextToken>& result)
+	    const InstructionOperand* restrict operand, InstructionTextTokenSink& result)
 	{
 		char buf[32] = {0};
 		get_implementation_specific(operand, buf, sizeof(buf));
-		result.emplace_back(RegisterToken, buf);
+		result.AddToken(RegisterToken, buf);
 		return DISASM_SUCCESS;
 	}
 
@@ -783,8 +783,57 @@ class Arm64Architecture : public Architecture
 	}
 
 
-	virtual bool GetInstructionText(const uint8_t* data, uint64_t addr, size_t& len,
-	    vector<InstructionTextToken>& result) override
+	virtual size_t GetInstructionInfoBatch(
+	    const uint8_t* data, uint64_t addr, size_t len, InstructionInfo* results, size_t maxCount) override
+	{
+		if (m_onlyDisassembleOnAlignedAddresses && (addr % 4 != 0))
+			return 0;
+
+		// Classify the run first. ADRP, B and BL always decode and their info follows from the word alone, so
+		// only the remaining words need the full decoder.
+		uint8_t classes[64];
+		size_t count = 0;
+		size_t offset = 0;
+		while (count < maxCount && len - offset >= 4)
+		{
+			size_t chunk = min(min(maxCount - count, (len - offset) / 4), sizeof(classes));
+			aarch64_classify(data + offset, chunk, classes);
+			for (size_t i = 0; i < chunk; i++, offset += 4)
+			{
+				uint32_t insword = *(uint32_t*)(data + offset);
+				InstructionInfo& result = results[count];
+				if (classes[i] == ARM64_CLASS_ADRP)
+				{
+					result.length = 4;
+				}
+				else if ((insword & 0x7C000000) == 0x14000000)
+				{
+					// B and BL, imm26 is a signed word offset
+					uint64_t target = addr + offset + (int64_t)((int32_t)(insword << 6) >> 4);
+					result.length = 4;
+					result.AddBranch((insword & 0x80000000) ? CallDestination : UnconditionalBranch, target);
+				}
+				else
+				{
+					Instruction instr;
+					if (!Disassemble(data + offset, addr + offset, len - offset, instr))
+						return count;
+					SetInstructionInfoForInstruction(addr + offset, instr, result);
+				}
+				count++;
+			}
+		}
+		return count;
+	}
+
+
+	virtual bool GetInstructionText(const uint8_t* data, uint64_t addr, size_t& len, vector<InstructionTextToken>& result) override
+	{
+		return GetInstructionTextFromTokens(data, addr, len, result);
+	}
+
+	virtual bool GetInstructionTextTokens(const uint8_t* data, uint64_t addr, size_t& len,
+	    InstructionTextTokenSink& result) override
 	{
 		len = 4;
 		Instruction instr;
@@ -806,8 +855,8 @@ class Arm64Architecture : public Architecture
 		else
 			buf[1] = '\0';
 
-		result.emplace_back(InstructionToken, operation);
-		result.emplace_back(TextToken, buf);
+		result.AddToken(InstructionToken, operation);
+		result.AddToken(TextToken, buf);
 		for (size_t i = 0; i < MAX_OPERANDS; i++)
 		{
 			if (instr.operands[i].operandClass == NONE)
@@ -816,7 +865,7 @@ class Arm64Architecture : public Architecture
 			struct InstructionOperand *operand = &(instr.operands[i]);
 
 			if (i != 0)
-				result.emplace_back(OperandSeparatorToken, ", ");
+				result.AddToken(OperandSeparatorToken, ", ");
 
 			switch (instr.operands[i].operandClass)
 			{
@@ -847,65 +896,65 @@ class Arm64Architecture : public Architecture
 				tokenizeSuccess = tokenize_implementation_specific(&instr.operands[i], result) == 0;
 				break;
 			case NAME:
-				result.emplace_back(TextToken, instr.operands[i].name);
+				result.AddToken(TextToken, instr.operands[i].name);
 				tokenizeSuccess = true;
 				break;
 			case STR_IMM: /* eg: "mul #0xe" */
-				result.emplace_back(TextToken, instr.operands[i].name);
-				result.emplace_back(OperationToken, " #");
+				result.AddToken(TextToken, instr.operands[i].name);
+				result.AddToken(OperationToken, " #");
 				snprintf(buf, sizeof(buf), "0x%" PRIx64, instr.operands[i].immediate);
-				result.emplace_back(IntegerToken, buf);
+				result.AddToken(IntegerToken, buf);
 				tokenizeSuccess = true;
 				break;
 			case ACCUM_ARRAY: /* eg: "za[w12, #0x6]" */
-				result.emplace_back(TextToken, "ZA");
-				result.emplace_back(BraceToken, "[");
+				result.AddToken(TextToken, "ZA");
+				result.AddToken(BraceToken, "[");
 				snprintf(buf, sizeof(buf), "%s", get_register_name(operand->reg[0]));
-				result.emplace_back(RegisterToken, buf);
-				result.emplace_back(OperandSeparatorToken, ", ");
-				result.emplace_back(OperationToken, " #");
+				result.AddToken(RegisterToken, buf);
+				result.AddToken(OperandSeparatorToken, ", ");
+				result.AddToken(OperationToken, " #");
 				snprintf(buf, sizeof(buf), "0x%" PRIx64, operand->immediate);
-				result.emplace_back(IntegerToken, buf);
-				result.emplace_back(BraceToken, "]");
+				result.AddToken(IntegerToken, buf);
+				result.AddToken(BraceToken, "]");
 				tokenizeSuccess = true;
 				break;
 			case SME_TILE: /* eg: "z0v.b[w12, #0xb]" */
 				snprintf(buf, sizeof(buf), "Z%d", operand->tile);
-				result.emplace_back(TextToken, buf);
+				result.AddToken(TextToken, buf);
 				if (operand->slice == SLICE_HORIZONTAL)
-					result.emplace_back(TextToken, "h");
+					result.AddToken(TextToken, "h");
 				else if (operand->slice == SLICE_VERTICAL)
-					result.emplace_back(TextToken, "v");
-				result.emplace_back(TextToken, get_arrspec_str_truncated(operand->arrSpec));
+					result.AddToken(TextToken, "v");
+				result.AddToken(TextToken, get_arrspec_str_truncated(operand->arrSpec));
 				if (operand->reg[0] != REG_NONE)
 				{
-					result.emplace_back(BraceToken, "[");
+					result.AddToken(BraceToken, "[");
 					snprintf(buf, sizeof(buf), "%s", get_register_name(operand->reg[0]));
-					result.emplace_back(RegisterToken, buf);
+					result.AddToken(RegisterToken, buf);
 					if (operand->arrSpec != ARRSPEC_FULL)
 					{
-						result.emplace_back(OperandSeparatorToken, ", ");
-						result.emplace_back(OperationToken, " #");
+						result.AddToken(OperandSeparatorToken, ", ");
+						result.AddToken(OperationToken, " #");
 						snprintf(buf, sizeof(buf), "0x%" PRIx64, instr.operands[i].immediate);
-						result.emplace_back(IntegerToken, buf);
+						result.AddToken(IntegerToken, buf);
 					}
-					result.emplace_back(BraceToken, "]");
+					result.AddToken(BraceToken, "]");
 				}
 				tokenizeSuccess = true;
 				break;
 			case INDEXED_ELEMENT: /* eg: "p12.d[w15, #0xf]" */
-				result.emplace_back(RegisterToken, get_register_name(operand->reg[0]));
-				result.emplace_back(TextToken, get_arrspec_str_truncated(operand->arrSpec));
-				result.emplace_back(BraceToken, "[");
-				result.emplace_back(RegisterToken, get_register_name(operand->reg[1]));
+				result.AddToken(RegisterToken, get_register_name(operand->reg[0]));
+				result.AddToken(TextToken, get_arrspec_str_truncated(operand->arrSpec));
+				result.AddToken(BraceToken, "[");
+				result.AddToken(RegisterToken, get_register_name(operand->reg[1]));
 				if (operand->immediate)
 				{
-					result.emplace_back(OperandSeparatorToken, ", ");
-					result.emplace_back(OperationToken, "#");
+					result.AddToken(OperandSeparatorToken, ", ");
+					result.AddToken(OperationToken, "#");
 					snprintf(buf, sizeof(buf), "0x%" PRIx64, operand->immediate);
-					result.emplace_back(IntegerToken, buf);
+					result.AddToken(IntegerToken, buf);
 				}
-				result.emplace_back(BraceToken, "]");
+				result.AddToken(BraceToken, "]");
 				tokenizeSuccess = true;
 				break;
 			default:
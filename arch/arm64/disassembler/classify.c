@@ -0,0 +1,190 @@
+/* Coarse classification of instruction words.
+
+   Prescans over code (looking for calls, returns, ADRP targets, or just for data that can't be code)
+   only need to know which of a handful of classes a word falls in, not its operands. Every class is
+   a mask/value compare on the raw word, so a buffer can be classified a vector of words at a time:
+   each rule is an AND and a compare-equal per vector, and the rules are disjoint so the per-rule
+   results can simply be OR'd together.
+
+   The classes are deliberately shallow. ARM64_CLASS_INVALID only covers the unallocated top-level
+   encoding groups, a word classified as anything else may still fail to decode. Pointer
+   authenticating variants (BLRAA, BRAA, RETAA, ...) are classified as their base form.
+
+   `test classify <corpus>` checks the vector paths against the scalar one and against the decoder. */
+
+#include "decode.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CLASSIFY_SSE2
+	#include <emmintrin.h>
+#endif
+
+#if defined(CLASSIFY_SSE2) && defined(__GNUC__)
+	#define CLASSIFY_AVX2
+	#include <immintrin.h>
+#endif
+
+struct ClassifyRule
+{
+	uint32_t mask;
+	uint32_t value;
+	uint32_t cls;
+};
+
+/* no word matches more than one rule */
+static const struct ClassifyRule classify_rules[] = {
+    {0xFC000000, 0x14000000, ARM64_CLASS_BRANCH},     /* B */
+    {0xFF000010, 0x54000000, ARM64_CLASS_BRANCH},     /* B.cond */
+    {0x7C000000, 0x34000000, ARM64_CLASS_BRANCH},     /* CBZ, CBNZ, TBZ, TBNZ */
+    {0xFEFF0000, 0xD61F0000, ARM64_CLASS_BRANCH},     /* BR, BRAA, BRAB, ... */
+    {0xFC000000, 0x94000000, ARM64_CLASS_CALL},       /* BL */
+    {0xFEFF0000, 0xD63F0000, ARM64_CLASS_CALL},       /* BLR, BLRAA, BLRAB, ... */
+    {0xFFFF0000, 0xD65F0000, ARM64_CLASS_RETURN},     /* RET, RETAA, RETAB */
+    {0x9F000000, 0x90000000, ARM64_CLASS_ADRP},       /* ADRP */
+    {0x0A000000, 0x08000000, ARM64_CLASS_LOAD_STORE}, /* op0 == x1x0 */
+    {0x1A000000, 0x02000000, ARM64_CLASS_INVALID},    /* op0 == 00x1 */
+    {0x9E000000, 0x00000000, ARM64_CLASS_INVALID},    /* op0 == 0000, UDF and reserved */
+};
+
+#define CLASSIFY_RULE_COUNT (sizeof(classify_rules) / sizeof(classify_rules[0]))
+
+static inline uint32_t load_word(const uint8_t* data)
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+	       ((uint32_t)data[3] << 24);
+}
+
+enum Arm64WordClass aarch64_classify_word(uint32_t insword)
+{
+	for (size_t i = 0; i < CLASSIFY_RULE_COUNT; i++)
+		if ((insword & classify_rules[i].mask) == classify_rules[i].value)
+			return (enum Arm64WordClass)classify_rules[i].cls;
+	return ARM64_CLASS_OTHER;
+}
+
+static void classify_scalar(const uint8_t* data, size_t count, uint8_t* classes)
+{
+	for (size_t i = 0; i < count; i++)
+		classes[i] = (uint8_t)aarch64_classify_word(load_word(data + i * 4));
+}
+
+#ifdef CLASSIFY_SSE2
+static inline __m128i classify_sse2_4(__m128i words)
+{
+	__m128i result = _mm_setzero_si128();
+	for (size_t i = 0; i < CLASSIFY_RULE_COUNT; i++)
+	{
+		__m128i masked = _mm_and_si128(words, _mm_set1_epi32((int)classify_rules[i].mask));
+		__m128i hit = _mm_cmpeq_epi32(masked, _mm_set1_epi32((int)classify_rules[i].value));
+		result = _mm_or_si128(result, _mm_and_si128(hit, _mm_set1_epi32((int)classify_rules[i].cls)));
+	}
+	return result;
+}
+
+/* 16 words per iteration, narrowed to 16 class bytes */
+static size_t classify_sse2(const uint8_t* data, size_t count, uint8_t* classes)
+{
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m128i* src = (const __m128i*)(data + i * 4);
+		__m128i a = classify_sse2_4(_mm_loadu_si128(src + 0));
+		__m128i b = classify_sse2_4(_mm_loadu_si128(src + 1));
+		__m128i c = classify_sse2_4(_mm_loadu_si128(src + 2));
+		__m128i d = classify_sse2_4(_mm_loadu_si128(src + 3));
+		__m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+		_mm_storeu_si128((__m128i*)(classes + i), packed);
+	}
+	return i;
+}
+#endif
+
+#ifdef CLASSIFY_AVX2
+__attribute__((target("avx2"))) static inline __m256i classify_avx2_8(__m256i words)
+{
+	__m256i result = _mm256_setzero_si256();
+	for (size_t i = 0; i < CLASSIFY_RULE_COUNT; i++)
+	{
+		__m256i masked = _mm256_and_si256(words, _mm256_set1_epi32((int)classify_rules[i].mask));
+		__m256i hit = _mm256_cmpeq_epi32(masked, _mm256_set1_epi32((int)classify_rules[i].value));
+		result =
+		    _mm256_or_si256(result, _mm256_and_si256(hit, _mm256_set1_epi32((int)classify_rules[i].cls)));
+	}
+	return result;
+}
+
+/* 32 words per iteration. The packs work within 128-bit lanes, which leaves the dwords of the result
+   interleaved as 0,2,4,6,1,3,5,7 and the final permute puts them back in order. */
+__attribute__((target("avx2"))) static size_t classify_avx2(
+    const uint8_t* data, size_t count, uint8_t* classes)
+{
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32)
+	{
+		const __m256i* src = (const __m256i*)(data + i * 4);
+		__m256i a = classify_avx2_8(_mm256_loadu_si256(src + 0));
+		__m256i b = classify_avx2_8(_mm256_loadu_si256(src + 1));
+		__m256i c = classify_avx2_8(_mm256_loadu_si256(src + 2));
+		__m256i d = classify_avx2_8(_mm256_loadu_si256(src + 3));
+		__m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+		_mm256_storeu_si256((__m256i*)(classes + i), _mm256_permutevar8x32_epi32(packed, order));
+	}
+	return i;
+}
+
+/* called from any analysis thread, every thread computes the same answer so a relaxed atomic is enough */
+static int have_avx2(void)
+{
+	static int cached = -1;
+	int result = __atomic_load_n(&cached, __ATOMIC_RELAXED);
+	if (result < 0)
+	{
+		__builtin_cpu_init();
+		result = __builtin_cpu_supports("avx2") ? 1 : 0;
+		__atomic_store_n(&cached, result, __ATOMIC_RELAXED);
+	}
+	return result;
+}
+#endif
+
+void aarch64_classify_with(
+    const uint8_t* data, size_t count, uint8_t* classes, enum Arm64ClassifyImpl impl)
+{
+	size_t done = 0;
+	switch (impl)
+	{
+#ifdef CLASSIFY_AVX2
+	case ARM64_CLASSIFY_AVX2:
+		if (have_avx2())
+			done = classify_avx2(data, count, classes);
+		break;
+#endif
+#ifdef CLASSIFY_SSE2
+	case ARM64_CLASSIFY_SSE2:
+		done = classify_sse2(data, count, classes);
+		break;
+#endif
+	default:
+		break;
+	}
+	classify_scalar(data + done * 4, count - done, classes + done);
+}
+
+enum Arm64ClassifyImpl aarch64_classify_best_impl(void)
+{
+#ifdef CLASSIFY_AVX2
+	if (have_avx2())
+		return ARM64_CLASSIFY_AVX2;
+#endif
+#ifdef CLASSIFY_SSE2
+	return ARM64_CLASSIFY_SSE2;
+#else
+	return ARM64_CLASSIFY_SCALAR;
+#endif
+}
+
+void aarch64_classify(const uint8_t* data, size_t count, uint8_t* classes)
+{
+	aarch64_classify_with(data, count, classes, aarch64_classify_best_impl());
+}
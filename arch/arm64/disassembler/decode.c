@@ -5,6 +5,16 @@ int decode_spec(context* ctx, Instruction* dec);        // from decode0.cpp
 int decode_scratchpad(context* ctx, Instruction* dec);  // from decode_scratchpad.c
 
 int aarch64_decompose(uint32_t instructionValue, Instruction* instr, uint64_t address)
+{
+	/* common encodings are filled in directly, everything else goes through the spec */
+	int rc = aarch64_decompose_fast(instructionValue, instr, address);
+	if (rc != DECODE_STATUS_UNMATCHED)
+		return rc;
+
+	return aarch64_decompose_spec(instructionValue, instr, address);
+}
+
+int aarch64_decompose_spec(uint32_t instructionValue, Instruction* instr, uint64_t address)
 {
 	context ctx = {0};
 	ctx.halted = 1;  // enable disassembly of exception instructions like DCPS1
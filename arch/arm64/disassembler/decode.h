@@ -567,14 +567,48 @@ struct Instruction
 typedef struct Instruction Instruction;
 #endif
 
+/* coarse word classes, see aarch64_classify() */
+enum Arm64WordClass
+{
+	ARM64_CLASS_OTHER = 0,
+	ARM64_CLASS_INVALID,    /* UDF or an unallocated top-level encoding group */
+	ARM64_CLASS_BRANCH,     /* B, B.cond, CBZ, CBNZ, TBZ, TBNZ, BR */
+	ARM64_CLASS_CALL,       /* BL, BLR */
+	ARM64_CLASS_RETURN,     /* RET */
+	ARM64_CLASS_ADRP,       /* ADRP */
+	ARM64_CLASS_LOAD_STORE, /* anything in the loads and stores group */
+};
+
+enum Arm64ClassifyImpl
+{
+	ARM64_CLASSIFY_SCALAR = 0,
+	ARM64_CLASSIFY_SSE2,
+	ARM64_CLASSIFY_AVX2,
+};
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
 	int aarch64_decompose(uint32_t instructionValue, Instruction* instr, uint64_t address);
+
+	/* the two halves of aarch64_decompose(), exposed for testing: the table driven path for common
+	   encodings (returns DECODE_STATUS_UNMATCHED for anything else) and the full spec decoder */
+	int aarch64_decompose_fast(uint32_t instructionValue, Instruction* instr, uint64_t address);
+	int aarch64_decompose_spec(uint32_t instructionValue, Instruction* instr, uint64_t address);
 	size_t get_register_size(enum Register);
 
+	/* classify `count` little endian instruction words at `data`, writing one enum Arm64WordClass
+	   byte per word to `classes`, using the widest vector implementation the host supports */
+	void aarch64_classify(const uint8_t* data, size_t count, uint8_t* classes);
+	enum Arm64WordClass aarch64_classify_word(uint32_t insword);
+
+	/* the same with an explicit implementation, unsupported ones fall back to scalar */
+	void aarch64_classify_with(
+	    const uint8_t* data, size_t count, uint8_t* classes, enum Arm64ClassifyImpl impl);
+	enum Arm64ClassifyImpl aarch64_classify_best_impl(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,731 @@
+/* Direct decoding of the most frequent encodings.
+
+   Ordinary compiled code is dominated by a small set of encodings: branches, add/sub, moves, logical
+   ops and loads/stores. For those, running the spec decoder (decode_spec() followed by
+   decode_scratchpad()) means zeroing a ~3KB context, walking the decode tree and extracting every
+   pcode variable just to produce a handful of operands.
+
+   aarch64_decompose_fast() dispatches on the top ten opcode bits through a precomputed table and
+   fills the Instruction directly for those encodings. Every field it writes matches what the spec
+   path produces for the same word, including the choice of alias (MOV, CMP, MUL, CSET, ...).
+   Anything it does not fully recognize, including every undefined or unallocated case, is left to
+   the spec path by returning DECODE_STATUS_UNMATCHED before the Instruction is touched.
+
+   `test bench <corpus>` checks the two paths against each other. */
+
+#include "decode.h"
+#include "pcode.h"
+
+/* instruction classes handled here, selected by bits [31:22] */
+enum FastClass
+{
+	FAST_NONE = 0,
+	FAST_BRANCH_IMM,    /* B, BL */
+	FAST_BRANCH_COND,   /* B.cond */
+	FAST_COMPBRANCH,    /* CBZ, CBNZ */
+	FAST_TESTBRANCH,    /* TBZ, TBNZ */
+	FAST_BRANCH_REG,    /* BR, BLR, RET */
+	FAST_HINT,          /* NOP */
+	FAST_PCRELADDR,     /* ADR, ADRP */
+	FAST_ADDSUB_IMM,    /* ADD, ADDS, SUB, SUBS (immediate) and MOV, CMN, CMP */
+	FAST_LOG_SHIFT,     /* AND, ORR, EOR, ANDS (shifted register) and MOV, TST */
+	FAST_ADDSUB_SHIFT,  /* ADD, ADDS, SUB, SUBS (shifted register) and CMN, CMP, NEG, NEGS */
+	FAST_MOVEWIDE,      /* MOVZ, MOVK and MOV */
+	FAST_CONDSEL,       /* CSEL, CSINC, CSINV, CSNEG and CINC, CSET, CINV, CSETM, CNEG */
+	FAST_DP_2SRC,       /* UDIV, SDIV */
+	FAST_DP_3SRC,       /* MADD, MSUB and MUL, MNEG */
+	FAST_LDST_POS,      /* LDR/STR (unsigned offset), general and SIMD&FP */
+	FAST_LDST_IMM,      /* LDUR/STUR and LDR/STR (pre- and post-index), general and SIMD&FP */
+	FAST_LDST_PAIR,     /* LDP/STP (offset, pre- and post-index), general and SIMD&FP */
+	FAST_LOADLIT,       /* LDR (literal), general and SIMD&FP */
+};
+
+/* Indexed by insword >> 22. Each row covers one value of bits [31:27]. Membership only routes a word
+   to a handler, the handler itself checks the remaining bits and may still decline. */
+static const uint8_t fast_class_table[1024] = {
+    /* 00000 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 00001 */ 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 10, 10, 10, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 00010 */ 7, 7, 7, 7, 8, 8, 0, 0, 0, 0, 11, 11, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    /* 00011 */ 18, 18, 18, 18, 0, 0, 0, 0, 0, 0, 12, 13, 14, 0, 0, 0, 18, 18, 18, 18, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 00100 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 00101 */ 0, 0, 17, 17, 17, 17, 17, 17, 9, 9, 9, 9, 10, 10, 10, 10, 0, 0, 17, 17, 17, 17, 17, 17, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 00110 */ 7, 7, 7, 7, 8, 8, 0, 0, 0, 0, 11, 11, 0, 0, 0, 0, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4,
+    /* 00111 */ 16, 16, 16, 16, 15, 15, 15, 15, 0, 0, 0, 0, 0, 0, 0, 0, 16, 16, 16, 16, 15, 15, 15, 15, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 01000 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 01001 */ 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 10, 10, 10, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 01010 */ 7, 7, 7, 7, 8, 8, 0, 0, 0, 0, 11, 11, 0, 0, 0, 0, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 01011 */ 18, 18, 18, 18, 0, 0, 0, 0, 0, 0, 12, 0, 0, 0, 0, 0, 18, 18, 18, 18, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 01100 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 01101 */ 0, 0, 17, 17, 17, 17, 17, 17, 9, 9, 9, 9, 10, 10, 10, 10, 0, 0, 17, 17, 17, 17, 17, 17, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 01110 */ 7, 7, 7, 7, 8, 8, 0, 0, 0, 0, 11, 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 01111 */ 16, 16, 16, 16, 15, 15, 15, 15, 0, 0, 0, 0, 0, 0, 0, 0, 16, 16, 16, 16, 15, 15, 15, 15, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 10000 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 10001 */ 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 10, 10, 10, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 10010 */ 7, 7, 7, 7, 8, 8, 0, 0, 0, 0, 11, 11, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    /* 10011 */ 18, 18, 18, 18, 0, 0, 0, 0, 0, 0, 12, 13, 14, 0, 0, 0, 18, 18, 18, 18, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 10100 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 10101 */ 0, 0, 17, 17, 17, 17, 17, 17, 9, 9, 9, 9, 10, 10, 10, 10, 0, 0, 17, 17, 17, 17, 17, 17, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 10110 */ 7, 7, 7, 7, 8, 8, 0, 0, 0, 0, 11, 11, 0, 0, 0, 0, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4,
+    /* 10111 */ 16, 16, 16, 16, 15, 15, 15, 15, 0, 0, 0, 0, 0, 0, 0, 0, 16, 16, 16, 16, 15, 15, 15, 15, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 11000 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 11001 */ 0, 0, 0, 0, 0, 0, 0, 0, 9, 9, 9, 9, 10, 10, 10, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 11010 */ 7, 7, 7, 7, 8, 8, 0, 0, 0, 0, 11, 11, 0, 0, 0, 0, 0, 0, 0, 0, 6, 0, 0, 0, 5, 5, 0, 0, 0, 0, 0, 0,
+    /* 11011 */ 18, 18, 18, 18, 0, 0, 0, 0, 0, 0, 12, 0, 0, 0, 0, 0, 18, 18, 18, 18, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 11100 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 11101 */ 0, 0, 17, 17, 17, 17, 17, 17, 9, 9, 9, 9, 10, 10, 10, 10, 0, 0, 17, 17, 17, 17, 17, 17, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 11110 */ 7, 7, 7, 7, 8, 8, 0, 0, 0, 0, 11, 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 11111 */ 16, 16, 16, 16, 15, 15, 15, 15, 0, 0, 0, 0, 0, 0, 0, 0, 16, 16, 16, 16, 15, 15, 15, 15, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+/* register lookups, matching regMap[][][] in decode_scratchpad.c */
+static inline Register gpr(bool is64, uint32_t num, bool sp)
+{
+	if (num == 31)
+		return is64 ? (sp ? REG_SP : REG_XZR) : (sp ? REG_WSP : REG_WZR);
+	return (Register)((is64 ? REG_X0 : REG_W0) + num);
+}
+
+/* SIMD&FP register of 1 << scale bytes */
+static inline Register fpr(uint32_t scale, uint32_t num)
+{
+	static const Register base[5] = {REG_B0, REG_H0, REG_S0, REG_D0, REG_Q0};
+	return (Register)(base[scale] + num);
+}
+
+/* operand writers, matching the ADD_OPERAND_* macros in decode_scratchpad.c */
+static inline void add_reg(InstructionOperand* op, Register reg)
+{
+	op->operandClass = REG;
+	op->reg[0] = reg;
+}
+
+static inline void add_imm(InstructionOperand* op, enum OperandClass cls, uint64_t imm)
+{
+	op->operandClass = cls;
+	op->immediate = imm;
+}
+
+static inline void add_label(InstructionOperand* op, uint64_t address)
+{
+	op->operandClass = LABEL;
+	op->immediate = address;
+}
+
+static inline void add_mem(InstructionOperand* op, enum OperandClass cls, uint32_t n, uint64_t offset)
+{
+	op->operandClass = cls;
+	op->reg[0] = gpr(true, n, true);
+	op->immediate = offset;
+	op->signedImm = 1;
+}
+
+static inline void add_cond(InstructionOperand* op, uint32_t cond)
+{
+	op->operandClass = CONDITION;
+	op->cond = (Condition)cond;
+}
+
+/* OPTIONAL_SHIFT_AMOUNT: LSL #0 is not shown */
+static inline void add_optional_shift(InstructionOperand* op, uint32_t shift, uint32_t amount)
+{
+	ShiftType type = (ShiftType)(ShiftType_LSL + shift);
+	if (type == ShiftType_LSL && amount == 0)
+		return;
+	op->shiftType = type;
+	op->shiftValue = amount;
+	op->shiftValueUsed = 1;
+}
+
+static inline void add_shift(InstructionOperand* op, ShiftType type, uint32_t amount)
+{
+	op->shiftType = type;
+	op->shiftValue = amount;
+	op->shiftValueUsed = 1;
+}
+
+/* start an accepted instruction, the equivalent of OK() plus the head of decode_scratchpad() */
+static inline InstructionOperand* begin(Instruction* instr, uint32_t insword, enum ENCODING enc)
+{
+	instr->insword = insword;
+	instr->encoding = enc;
+	instr->operation = enc_to_oper(enc);
+	memset(instr->operands, 0, sizeof(instr->operands));
+	return instr->operands;
+}
+
+#define BITS(HI, LO) ((insword >> (LO)) & ((1u << ((HI) - (LO) + 1)) - 1))
+#define RD BITS(4, 0)
+#define RT BITS(4, 0)
+#define RN BITS(9, 5)
+#define RT2 BITS(14, 10)
+#define RA BITS(14, 10)
+#define RM BITS(20, 16)
+
+/* sign extend the low WIDTH bits of X to 64 bits */
+#define SEXT(X, WIDTH) ((uint64_t)((int64_t)((uint64_t)(X) << (64 - (WIDTH))) >> (64 - (WIDTH))))
+
+static int fast_branch_imm(uint32_t insword, Instruction* instr, uint64_t address)
+{
+	InstructionOperand* op =
+	    begin(instr, insword, BITS(31, 31) ? ENC_BL_ONLY_BRANCH_IMM : ENC_B_ONLY_BRANCH_IMM);
+	add_label(&op[0], address + SEXT(BITS(25, 0) << 2, 28));
+	return DECODE_STATUS_OK;
+}
+
+static int fast_branch_cond(uint32_t insword, Instruction* instr, uint64_t address)
+{
+	static const Operation lookup[16] = {ARM64_B_EQ, ARM64_B_NE, ARM64_B_CS, ARM64_B_CC, ARM64_B_MI,
+	    ARM64_B_PL, ARM64_B_VS, ARM64_B_VC, ARM64_B_HI, ARM64_B_LS, ARM64_B_GE, ARM64_B_LT, ARM64_B_GT,
+	    ARM64_B_LE, ARM64_B_AL, ARM64_B_NV};
+
+	if (BITS(24, 24) || BITS(4, 4))
+		return DECODE_STATUS_UNMATCHED;
+
+	InstructionOperand* op = begin(instr, insword, ENC_B_ONLY_CONDBRANCH);
+	instr->operation = lookup[BITS(3, 0)];
+	add_label(&op[0], address + SEXT(BITS(23, 5) << 2, 21));
+	return DECODE_STATUS_OK;
+}
+
+static int fast_compbranch(uint32_t insword, Instruction* instr, uint64_t address)
+{
+	static const enum ENCODING encs[2][2] = {
+	    {ENC_CBZ_32_COMPBRANCH, ENC_CBNZ_32_COMPBRANCH}, {ENC_CBZ_64_COMPBRANCH, ENC_CBNZ_64_COMPBRANCH}};
+	bool sf = BITS(31, 31);
+
+	InstructionOperand* op = begin(instr, insword, encs[sf][BITS(24, 24)]);
+	add_reg(&op[0], gpr(sf, RT, false));
+	add_label(&op[1], address + SEXT(BITS(23, 5) << 2, 21));
+	return DECODE_STATUS_OK;
+}
+
+static int fast_testbranch(uint32_t insword, Instruction* instr, uint64_t address)
+{
+	bool b5 = BITS(31, 31);
+
+	InstructionOperand* op =
+	    begin(instr, insword, BITS(24, 24) ? ENC_TBNZ_ONLY_TESTBRANCH : ENC_TBZ_ONLY_TESTBRANCH);
+	add_reg(&op[0], gpr(b5, RT, false));
+	add_imm(&op[1], IMM32, (b5 << 5) | BITS(23, 19));
+	add_label(&op[2], address + SEXT(BITS(18, 5) << 2, 16));
+	return DECODE_STATUS_OK;
+}
+
+static int fast_branch_reg(uint32_t insword, Instruction* instr)
+{
+	/* no PAC variants (A, M, Z) and RM must be zero */
+	switch (insword & 0xFFFFFC1F)
+	{
+	case 0xD61F0000:
+		add_reg(&begin(instr, insword, ENC_BR_64_BRANCH_REG)[0], gpr(true, RN, false));
+		return DECODE_STATUS_OK;
+	case 0xD63F0000:
+		add_reg(&begin(instr, insword, ENC_BLR_64_BRANCH_REG)[0], gpr(true, RN, false));
+		return DECODE_STATUS_OK;
+	case 0xD65F0000:
+	{
+		InstructionOperand* op = begin(instr, insword, ENC_RET_64R_BRANCH_REG);
+		/* the default x30 is not shown */
+		if (RN != 30)
+			add_reg(&op[0], gpr(true, RN, false));
+		return DECODE_STATUS_OK;
+	}
+	default:
+		return DECODE_STATUS_UNMATCHED;
+	}
+}
+
+static int fast_hint(uint32_t insword, Instruction* instr)
+{
+	if (insword != 0xD503201F)
+		return DECODE_STATUS_UNMATCHED;
+	begin(instr, insword, ENC_NOP_HI_HINTS);
+	return DECODE_STATUS_OK;
+}
+
+static int fast_pcreladdr(uint32_t insword, Instruction* instr, uint64_t address)
+{
+	InstructionOperand* op;
+	uint64_t eaddr;
+
+	if (BITS(31, 31))
+	{
+		op = begin(instr, insword, ENC_ADRP_ONLY_PCRELADDR);
+		eaddr = (address & 0xFFFFFFFFFFFFF000) + SEXT(((uint64_t)BITS(23, 5) << 14) | (BITS(30, 29) << 12), 33);
+	}
+	else
+	{
+		op = begin(instr, insword, ENC_ADR_ONLY_PCRELADDR);
+		eaddr = address + SEXT((BITS(23, 5) << 2) | BITS(30, 29), 21);
+	}
+	add_reg(&op[0], gpr(true, RD, false));
+	add_label(&op[1], eaddr);
+	return DECODE_STATUS_OK;
+}
+
+static int fast_addsub_imm(uint32_t insword, Instruction* instr)
+{
+	bool sf = BITS(31, 31);
+	uint32_t op_s = BITS(30, 29);
+	uint32_t sh = BITS(22, 22);
+	uint32_t imm12 = BITS(21, 10);
+	enum OperandClass imm_class = sf ? IMM64 : IMM32;
+	InstructionOperand* op;
+	int i = 0;
+
+	switch (op_s)
+	{
+	case 0: /* ADD */
+		if (!sh && !imm12 && (RD == 31 || RN == 31))
+		{
+			op = begin(instr, insword, sf ? ENC_MOV_ADD_64_ADDSUB_IMM : ENC_MOV_ADD_32_ADDSUB_IMM);
+			add_reg(&op[0], gpr(sf, RD, true));
+			add_reg(&op[1], gpr(sf, RN, true));
+			instr->setflags = FLAGEFFECT_NONE;
+			return DECODE_STATUS_OK;
+		}
+		op = begin(instr, insword, sf ? ENC_ADD_64_ADDSUB_IMM : ENC_ADD_32_ADDSUB_IMM);
+		add_reg(&op[i++], gpr(sf, RD, true));
+		break;
+	case 1: /* ADDS */
+		if (RD == 31)
+		{
+			op = begin(instr, insword, sf ? ENC_CMN_ADDS_64S_ADDSUB_IMM : ENC_CMN_ADDS_32S_ADDSUB_IMM);
+		}
+		else
+		{
+			op = begin(instr, insword, sf ? ENC_ADDS_64S_ADDSUB_IMM : ENC_ADDS_32S_ADDSUB_IMM);
+			add_reg(&op[i++], gpr(sf, RD, false));
+		}
+		break;
+	case 2: /* SUB */
+		op = begin(instr, insword, sf ? ENC_SUB_64_ADDSUB_IMM : ENC_SUB_32_ADDSUB_IMM);
+		add_reg(&op[i++], gpr(sf, RD, true));
+		break;
+	default: /* SUBS */
+		if (RD == 31)
+		{
+			op = begin(instr, insword, sf ? ENC_CMP_SUBS_64S_ADDSUB_IMM : ENC_CMP_SUBS_32S_ADDSUB_IMM);
+		}
+		else
+		{
+			op = begin(instr, insword, sf ? ENC_SUBS_64S_ADDSUB_IMM : ENC_SUBS_32S_ADDSUB_IMM);
+			add_reg(&op[i++], gpr(sf, RD, false));
+		}
+		break;
+	}
+
+	add_reg(&op[i++], gpr(sf, RN, true));
+	add_imm(&op[i], imm_class, imm12);
+	if (sh)
+		add_shift(&op[i], ShiftType_LSL, 12);
+	instr->setflags = (op_s & 1) ? FLAGEFFECT_SETS : FLAGEFFECT_NONE;
+	return DECODE_STATUS_OK;
+}
+
+static int fast_log_shift(uint32_t insword, Instruction* instr)
+{
+	static const enum ENCODING encs[2][4] = {
+	    {ENC_AND_32_LOG_SHIFT, ENC_ORR_32_LOG_SHIFT, ENC_EOR_32_LOG_SHIFT, ENC_ANDS_32_LOG_SHIFT},
+	    {ENC_AND_64_LOG_SHIFT, ENC_ORR_64_LOG_SHIFT, ENC_EOR_64_LOG_SHIFT, ENC_ANDS_64_LOG_SHIFT}};
+	bool sf = BITS(31, 31);
+	uint32_t opc = BITS(30, 29);
+	uint32_t shift = BITS(23, 22);
+	uint32_t imm6 = BITS(15, 10);
+	InstructionOperand* op;
+	int i = 0;
+
+	/* inverted forms (BIC, ORN, EON, BICS) and the undefined 32-bit shift amounts */
+	if (BITS(21, 21) || (!sf && (imm6 & 0x20)))
+		return DECODE_STATUS_UNMATCHED;
+
+	if (opc == 1 && !shift && !imm6 && RN == 31)
+	{
+		op = begin(instr, insword, sf ? ENC_MOV_ORR_64_LOG_SHIFT : ENC_MOV_ORR_32_LOG_SHIFT);
+		add_reg(&op[0], gpr(sf, RD, false));
+		add_reg(&op[1], gpr(sf, RM, false));
+		instr->setflags = FLAGEFFECT_NONE;
+		return DECODE_STATUS_OK;
+	}
+
+	if (opc == 3 && RD == 31)
+	{
+		op = begin(instr, insword, sf ? ENC_TST_ANDS_64_LOG_SHIFT : ENC_TST_ANDS_32_LOG_SHIFT);
+	}
+	else
+	{
+		op = begin(instr, insword, encs[sf][opc]);
+		add_reg(&op[i++], gpr(sf, RD, false));
+	}
+	add_reg(&op[i++], gpr(sf, RN, false));
+	add_reg(&op[i], gpr(sf, RM, false));
+	add_optional_shift(&op[i], shift, imm6);
+	instr->setflags = opc == 3 ? FLAGEFFECT_SETS : FLAGEFFECT_NONE;
+	return DECODE_STATUS_OK;
+}
+
+static int fast_addsub_shift(uint32_t insword, Instruction* instr)
+{
+	static const enum ENCODING encs[2][4] = {
+	    {ENC_ADD_32_ADDSUB_SHIFT, ENC_ADDS_32_ADDSUB_SHIFT, ENC_SUB_32_ADDSUB_SHIFT, ENC_SUBS_32_ADDSUB_SHIFT},
+	    {ENC_ADD_64_ADDSUB_SHIFT, ENC_ADDS_64_ADDSUB_SHIFT, ENC_SUB_64_ADDSUB_SHIFT, ENC_SUBS_64_ADDSUB_SHIFT}};
+	bool sf = BITS(31, 31);
+	uint32_t op_s = BITS(30, 29);
+	uint32_t shift = BITS(23, 22);
+	uint32_t imm6 = BITS(15, 10);
+	InstructionOperand* op;
+	int i = 0;
+
+	/* extended register forms, ROR and the undefined 32-bit shift amounts */
+	if (BITS(21, 21) || shift == 3 || (!sf && (imm6 & 0x20)))
+		return DECODE_STATUS_UNMATCHED;
+
+	if ((op_s == 1 || op_s == 3) && RD == 31)
+	{
+		/* CMN, CMP */
+		op = begin(instr, insword,
+		    op_s == 1 ? (sf ? ENC_CMN_ADDS_64_ADDSUB_SHIFT : ENC_CMN_ADDS_32_ADDSUB_SHIFT) :
+		                (sf ? ENC_CMP_SUBS_64_ADDSUB_SHIFT : ENC_CMP_SUBS_32_ADDSUB_SHIFT));
+		add_reg(&op[i++], gpr(sf, RN, false));
+	}
+	else if (op_s >= 2 && RN == 31)
+	{
+		/* NEG, NEGS */
+		op = begin(instr, insword,
+		    op_s == 2 ? (sf ? ENC_NEG_SUB_64_ADDSUB_SHIFT : ENC_NEG_SUB_32_ADDSUB_SHIFT) :
+		                (sf ? ENC_NEGS_SUBS_64_ADDSUB_SHIFT : ENC_NEGS_SUBS_32_ADDSUB_SHIFT));
+		add_reg(&op[i++], gpr(sf, RD, false));
+	}
+	else
+	{
+		op = begin(instr, insword, encs[sf][op_s]);
+		add_reg(&op[i++], gpr(sf, RD, false));
+		add_reg(&op[i++], gpr(sf, RN, false));
+	}
+	add_reg(&op[i], gpr(sf, RM, false));
+	add_optional_shift(&op[i], shift, imm6);
+	instr->setflags = (op_s & 1) ? FLAGEFFECT_SETS : FLAGEFFECT_NONE;
+	return DECODE_STATUS_OK;
+}
+
+static int fast_movewide(uint32_t insword, Instruction* instr)
+{
+	bool sf = BITS(31, 31);
+	uint32_t opc = BITS(30, 29);
+	uint32_t hw = BITS(22, 21);
+	uint64_t imm16 = BITS(20, 5);
+	InstructionOperand* op;
+
+	/* MOVN and its MOV alias are left to the spec, as are the unallocated forms */
+	if (opc < 2 || (!sf && (hw & 2)))
+		return DECODE_STATUS_UNMATCHED;
+
+	if (opc == 2 && !(imm16 == 0 && hw != 0))
+	{
+		op = begin(instr, insword, sf ? ENC_MOV_MOVZ_64_MOVEWIDE : ENC_MOV_MOVZ_32_MOVEWIDE);
+		add_reg(&op[0], gpr(sf, RD, false));
+		if (sf)
+			add_imm(&op[1], IMM64, imm16 << (hw * 16));
+		else
+			add_imm(&op[1], IMM32, (uint64_t)(int64_t)(int32_t)(uint32_t)(imm16 << (hw * 16)));
+		return DECODE_STATUS_OK;
+	}
+
+	if (opc == 2)
+		op = begin(instr, insword, sf ? ENC_MOVZ_64_MOVEWIDE : ENC_MOVZ_32_MOVEWIDE);
+	else
+		op = begin(instr, insword, sf ? ENC_MOVK_64_MOVEWIDE : ENC_MOVK_32_MOVEWIDE);
+	add_reg(&op[0], gpr(sf, RD, false));
+	add_imm(&op[1], sf ? IMM64 : IMM32, imm16);
+	if (hw)
+		add_shift(&op[1], ShiftType_LSL, 16 * hw);
+	return DECODE_STATUS_OK;
+}
+
+static int fast_condsel(uint32_t insword, Instruction* instr)
+{
+	static const enum ENCODING encs[2][4] = {
+	    {ENC_CSEL_32_CONDSEL, ENC_CSINC_32_CONDSEL, ENC_CSINV_32_CONDSEL, ENC_CSNEG_32_CONDSEL},
+	    {ENC_CSEL_64_CONDSEL, ENC_CSINC_64_CONDSEL, ENC_CSINV_64_CONDSEL, ENC_CSNEG_64_CONDSEL}};
+	static const enum ENCODING cset[2][4] = {
+	    {ENC_UNKNOWN, ENC_CSET_CSINC_32_CONDSEL, ENC_CSETM_CSINV_32_CONDSEL, ENC_UNKNOWN},
+	    {ENC_UNKNOWN, ENC_CSET_CSINC_64_CONDSEL, ENC_CSETM_CSINV_64_CONDSEL, ENC_UNKNOWN}};
+	static const enum ENCODING cinc[2][4] = {
+	    {ENC_UNKNOWN, ENC_CINC_CSINC_32_CONDSEL, ENC_CINV_CSINV_32_CONDSEL, ENC_CNEG_CSNEG_32_CONDSEL},
+	    {ENC_UNKNOWN, ENC_CINC_CSINC_64_CONDSEL, ENC_CINV_CSINV_64_CONDSEL, ENC_CNEG_CSNEG_64_CONDSEL}};
+	bool sf = BITS(31, 31);
+	uint32_t kind = (BITS(30, 30) << 1) | BITS(10, 10);
+	uint32_t cond = BITS(15, 12);
+	InstructionOperand* op;
+
+	if (BITS(21, 21) || BITS(11, 11))
+		return DECODE_STATUS_UNMATCHED;
+
+	if (kind != 0 && (cond & 14) != 14)
+	{
+		/* CNEG only needs RN == RM, CINC and CINV also exclude the zero register */
+		if (RN == RM && (kind == 3 || RN != 31))
+		{
+			op = begin(instr, insword, cinc[sf][kind]);
+			add_reg(&op[0], gpr(sf, RD, false));
+			add_reg(&op[1], gpr(sf, RN, false));
+			add_cond(&op[2], cond ^ 1);
+			return DECODE_STATUS_OK;
+		}
+		if (kind != 3 && RN == 31 && RM == 31)
+		{
+			op = begin(instr, insword, cset[sf][kind]);
+			add_reg(&op[0], gpr(sf, RD, false));
+			add_cond(&op[1], cond ^ 1);
+			return DECODE_STATUS_OK;
+		}
+	}
+
+	op = begin(instr, insword, encs[sf][kind]);
+	add_reg(&op[0], gpr(sf, RD, false));
+	add_reg(&op[1], gpr(sf, RN, false));
+	add_reg(&op[2], gpr(sf, RM, false));
+	add_cond(&op[3], cond);
+	return DECODE_STATUS_OK;
+}
+
+static int fast_dp_2src(uint32_t insword, Instruction* instr)
+{
+	bool sf = BITS(31, 31);
+	InstructionOperand* op;
+
+	if (BITS(21, 21))
+		return DECODE_STATUS_UNMATCHED;
+
+	switch (BITS(15, 10))
+	{
+	case 2:
+		op = begin(instr, insword, sf ? ENC_UDIV_64_DP_2SRC : ENC_UDIV_32_DP_2SRC);
+		break;
+	case 3:
+		op = begin(instr, insword, sf ? ENC_SDIV_64_DP_2SRC : ENC_SDIV_32_DP_2SRC);
+		break;
+	default:
+		return DECODE_STATUS_UNMATCHED;
+	}
+	add_reg(&op[0], gpr(sf, RD, false));
+	add_reg(&op[1], gpr(sf, RN, false));
+	add_reg(&op[2], gpr(sf, RM, false));
+	return DECODE_STATUS_OK;
+}
+
+static int fast_dp_3src(uint32_t insword, Instruction* instr)
+{
+	static const enum ENCODING encs[2][2][2] = {
+	    {{ENC_MADD_32A_DP_3SRC, ENC_MSUB_32A_DP_3SRC}, {ENC_MUL_MADD_32A_DP_3SRC, ENC_MNEG_MSUB_32A_DP_3SRC}},
+	    {{ENC_MADD_64A_DP_3SRC, ENC_MSUB_64A_DP_3SRC}, {ENC_MUL_MADD_64A_DP_3SRC, ENC_MNEG_MSUB_64A_DP_3SRC}}};
+	bool sf = BITS(31, 31);
+	bool alias = RA == 31;
+
+	/* only op31 == 000, the widening and high multiplies are left to the spec */
+	if (BITS(23, 21))
+		return DECODE_STATUS_UNMATCHED;
+
+	InstructionOperand* op = begin(instr, insword, encs[sf][alias][BITS(15, 15)]);
+	add_reg(&op[0], gpr(sf, RD, false));
+	add_reg(&op[1], gpr(sf, RN, false));
+	add_reg(&op[2], gpr(sf, RM, false));
+	if (!alias)
+		add_reg(&op[3], gpr(sf, RA, false));
+	return DECODE_STATUS_OK;
+}
+
+/* load/store register encodings, indexed by [V][size][opc] */
+#define LDST_ENCODINGS(SUFFIX) \
+	{ \
+		{ \
+			{ENC_STRB_32_##SUFFIX, ENC_LDRB_32_##SUFFIX, ENC_LDRSB_64_##SUFFIX, ENC_LDRSB_32_##SUFFIX}, \
+			{ENC_STRH_32_##SUFFIX, ENC_LDRH_32_##SUFFIX, ENC_LDRSH_64_##SUFFIX, ENC_LDRSH_32_##SUFFIX}, \
+			{ENC_STR_32_##SUFFIX, ENC_LDR_32_##SUFFIX, ENC_LDRSW_64_##SUFFIX, ENC_UNKNOWN}, \
+			{ENC_STR_64_##SUFFIX, ENC_LDR_64_##SUFFIX, ENC_UNKNOWN, ENC_UNKNOWN}, \
+		}, \
+		{ \
+			{ENC_STR_B_##SUFFIX, ENC_LDR_B_##SUFFIX, ENC_STR_Q_##SUFFIX, ENC_LDR_Q_##SUFFIX}, \
+			{ENC_STR_H_##SUFFIX, ENC_LDR_H_##SUFFIX, ENC_UNKNOWN, ENC_UNKNOWN}, \
+			{ENC_STR_S_##SUFFIX, ENC_LDR_S_##SUFFIX, ENC_UNKNOWN, ENC_UNKNOWN}, \
+			{ENC_STR_D_##SUFFIX, ENC_LDR_D_##SUFFIX, ENC_UNKNOWN, ENC_UNKNOWN}, \
+		} \
+	}
+
+static const enum ENCODING ldst_pos_encodings[2][4][4] = LDST_ENCODINGS(LDST_POS);
+static const enum ENCODING ldst_pre_encodings[2][4][4] = LDST_ENCODINGS(LDST_IMMPRE);
+static const enum ENCODING ldst_post_encodings[2][4][4] = LDST_ENCODINGS(LDST_IMMPOST);
+
+static const enum ENCODING ldst_unscaled_encodings[2][4][4] = {
+    {
+        {ENC_STURB_32_LDST_UNSCALED, ENC_LDURB_32_LDST_UNSCALED, ENC_LDURSB_64_LDST_UNSCALED,
+            ENC_LDURSB_32_LDST_UNSCALED},
+        {ENC_STURH_32_LDST_UNSCALED, ENC_LDURH_32_LDST_UNSCALED, ENC_LDURSH_64_LDST_UNSCALED,
+            ENC_LDURSH_32_LDST_UNSCALED},
+        {ENC_STUR_32_LDST_UNSCALED, ENC_LDUR_32_LDST_UNSCALED, ENC_LDURSW_64_LDST_UNSCALED, ENC_UNKNOWN},
+        {ENC_STUR_64_LDST_UNSCALED, ENC_LDUR_64_LDST_UNSCALED, ENC_UNKNOWN, ENC_UNKNOWN},
+    },
+    {
+        {ENC_STUR_B_LDST_UNSCALED, ENC_LDUR_B_LDST_UNSCALED, ENC_STUR_Q_LDST_UNSCALED, ENC_LDUR_Q_LDST_UNSCALED},
+        {ENC_STUR_H_LDST_UNSCALED, ENC_LDUR_H_LDST_UNSCALED, ENC_UNKNOWN, ENC_UNKNOWN},
+        {ENC_STUR_S_LDST_UNSCALED, ENC_LDUR_S_LDST_UNSCALED, ENC_UNKNOWN, ENC_UNKNOWN},
+        {ENC_STUR_D_LDST_UNSCALED, ENC_LDUR_D_LDST_UNSCALED, ENC_UNKNOWN, ENC_UNKNOWN},
+    }};
+
+/* transfer register of a single register load/store */
+static inline Register ldst_reg(bool v, uint32_t size, uint32_t opc, uint32_t num)
+{
+	if (v)
+		return fpr(opc & 2 ? 4 : size, num);
+	return gpr(size == 3 || opc == 2, num, false);
+}
+
+static int fast_ldst_pos(uint32_t insword, Instruction* instr)
+{
+	bool v = BITS(26, 26);
+	uint32_t size = BITS(31, 30);
+	uint32_t opc = BITS(23, 22);
+	enum ENCODING enc = ldst_pos_encodings[v][size][opc];
+	uint32_t scale = (v && (opc & 2)) ? 4 : size;
+
+	if (enc == ENC_UNKNOWN)
+		return DECODE_STATUS_UNMATCHED;
+
+	InstructionOperand* op = begin(instr, insword, enc);
+	add_reg(&op[0], ldst_reg(v, size, opc, RT));
+	add_mem(&op[1], MEM_OFFSET, RN, (uint64_t)BITS(21, 10) << scale);
+	return DECODE_STATUS_OK;
+}
+
+static int fast_ldst_imm(uint32_t insword, Instruction* instr)
+{
+	bool v = BITS(26, 26);
+	uint32_t size = BITS(31, 30);
+	uint32_t opc = BITS(23, 22);
+	enum ENCODING enc;
+	enum OperandClass cls;
+
+	switch (BITS(11, 10))
+	{
+	case 0:
+		enc = ldst_unscaled_encodings[v][size][opc];
+		cls = MEM_OFFSET;
+		break;
+	case 1:
+		enc = ldst_post_encodings[v][size][opc];
+		cls = MEM_POST_IDX;
+		break;
+	case 3:
+		enc = ldst_pre_encodings[v][size][opc];
+		cls = MEM_PRE_IDX;
+		break;
+	default:
+		/* unprivileged */
+		return DECODE_STATUS_UNMATCHED;
+	}
+
+	/* bit 21 selects the register offset and atomic forms */
+	if (BITS(21, 21) || enc == ENC_UNKNOWN)
+		return DECODE_STATUS_UNMATCHED;
+
+	InstructionOperand* op = begin(instr, insword, enc);
+	add_reg(&op[0], ldst_reg(v, size, opc, RT));
+	add_mem(&op[1], cls, RN, SEXT(BITS(20, 12), 9));
+	return DECODE_STATUS_OK;
+}
+
+/* load/store pair encodings, indexed by [V][opc][bits 24:23][L] */
+#define LDST_PAIR_ENCODINGS(T) \
+	{ \
+		{ENC_UNKNOWN, ENC_UNKNOWN}, \
+		{ENC_STP_##T##_LDSTPAIR_POST, ENC_LDP_##T##_LDSTPAIR_POST}, \
+		{ENC_STP_##T##_LDSTPAIR_OFF, ENC_LDP_##T##_LDSTPAIR_OFF}, \
+		{ENC_STP_##T##_LDSTPAIR_PRE, ENC_LDP_##T##_LDSTPAIR_PRE}, \
+	}
+#define LDST_PAIR_NONE {{ENC_UNKNOWN}}
+
+static const enum ENCODING ldst_pair_encodings[2][4][4][2] = {
+    {LDST_PAIR_ENCODINGS(32), LDST_PAIR_NONE, LDST_PAIR_ENCODINGS(64), LDST_PAIR_NONE},
+    {LDST_PAIR_ENCODINGS(S), LDST_PAIR_ENCODINGS(D), LDST_PAIR_ENCODINGS(Q), LDST_PAIR_NONE}};
+
+static int fast_ldst_pair(uint32_t insword, Instruction* instr)
+{
+	static const enum OperandClass classes[4] = {NONE, MEM_POST_IDX, MEM_OFFSET, MEM_PRE_IDX};
+	bool v = BITS(26, 26);
+	uint32_t opc = BITS(31, 30);
+	uint32_t index = BITS(24, 23);
+	enum ENCODING enc = ldst_pair_encodings[v][opc][index][BITS(22, 22)];
+	uint32_t scale = v ? 2 + opc : 2 + (opc >> 1);
+
+	if (enc == ENC_UNKNOWN)
+		return DECODE_STATUS_UNMATCHED;
+
+	InstructionOperand* op = begin(instr, insword, enc);
+	add_reg(&op[0], v ? fpr(scale, RT) : gpr(opc == 2, RT, false));
+	add_reg(&op[1], v ? fpr(scale, RT2) : gpr(opc == 2, RT2, false));
+	add_mem(&op[2], classes[index], RN, SEXT(BITS(21, 15), 7) << scale);
+	return DECODE_STATUS_OK;
+}
+
+static int fast_loadlit(uint32_t insword, Instruction* instr, uint64_t address)
+{
+	static const enum ENCODING encs[2][4] = {
+	    {ENC_LDR_32_LOADLIT, ENC_LDR_64_LOADLIT, ENC_LDRSW_64_LOADLIT, ENC_UNKNOWN},
+	    {ENC_LDR_S_LOADLIT, ENC_LDR_D_LOADLIT, ENC_LDR_Q_LOADLIT, ENC_UNKNOWN}};
+	bool v = BITS(26, 26);
+	uint32_t opc = BITS(31, 30);
+	enum ENCODING enc = encs[v][opc];
+
+	if (enc == ENC_UNKNOWN)
+		return DECODE_STATUS_UNMATCHED;
+
+	InstructionOperand* op = begin(instr, insword, enc);
+	add_reg(&op[0], v ? fpr(2 + opc, RT) : gpr(opc != 0, RT, false));
+	add_label(&op[1], address + SEXT(BITS(23, 5) << 2, 21));
+	return DECODE_STATUS_OK;
+}
+
+int aarch64_decompose_fast(uint32_t insword, Instruction* instr, uint64_t address)
+{
+	switch (fast_class_table[insword >> 22])
+	{
+	case FAST_BRANCH_IMM:
+		return fast_branch_imm(insword, instr, address);
+	case FAST_BRANCH_COND:
+		return fast_branch_cond(insword, instr, address);
+	case FAST_COMPBRANCH:
+		return fast_compbranch(insword, instr, address);
+	case FAST_TESTBRANCH:
+		return fast_testbranch(insword, instr, address);
+	case FAST_BRANCH_REG:
+		return fast_branch_reg(insword, instr);
+	case FAST_HINT:
+		return fast_hint(insword, instr);
+	case FAST_PCRELADDR:
+		return fast_pcreladdr(insword, instr, address);
+	case FAST_ADDSUB_IMM:
+		return fast_addsub_imm(insword, instr);
+	case FAST_LOG_SHIFT:
+		return fast_log_shift(insword, instr);
+	case FAST_ADDSUB_SHIFT:
+		return fast_addsub_shift(insword, instr);
+	case FAST_MOVEWIDE:
+		return fast_movewide(insword, instr);
+	case FAST_CONDSEL:
+		return fast_condsel(insword, instr);
+	case FAST_DP_2SRC:
+		return fast_dp_2src(insword, instr);
+	case FAST_DP_3SRC:
+		return fast_dp_3src(insword, instr);
+	case FAST_LDST_POS:
+		return fast_ldst_pos(insword, instr);
+	case FAST_LDST_IMM:
+		return fast_ldst_imm(insword, instr);
+	case FAST_LDST_PAIR:
+		return fast_ldst_pair(insword, instr);
+	case FAST_LOADLIT:
+		return fast_loadlit(insword, instr, address);
+	default:
+		return DECODE_STATUS_UNMATCHED;
+	}
+}
@@ -268,6 +268,227 @@ double subtract_timespecs(struct timespec t1, struct timespec t0)
 	return delta;
 }
 
+/* Time aarch64_decompose() against the spec-only decoder over a corpus of instruction words, eg: the
+   raw .text of a real binary (objcopy -O binary --only-section=.text a.out text.bin), and check that
+   both produce identical decompositions and text for every word. */
+int bench(const char* path, int passes)
+{
+	FILE* fp = fopen(path, "rb");
+	if (!fp)
+	{
+		printf("ERROR: unable to open %s\n", path);
+		return -1;
+	}
+	fseek(fp, 0, SEEK_END);
+	size_t count = ftell(fp) / sizeof(uint32_t);
+	fseek(fp, 0, SEEK_SET);
+	uint32_t* corpus = malloc(count * sizeof(uint32_t));
+	if (!corpus || fread(corpus, sizeof(uint32_t), count, fp) != count)
+	{
+		printf("ERROR: unable to read %s\n", path);
+		fclose(fp);
+		free(corpus);
+		return -1;
+	}
+	fclose(fp);
+
+	/* verify */
+	size_t fast = 0, mismatches = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		Instruction a, b;
+		char text_a[1024] = {'\0'}, text_b[1024] = {'\0'};
+		uint64_t address = i * 4;
+
+		memset(&a, 0, sizeof(a));
+		memset(&b, 0, sizeof(b));
+		int rc_a = aarch64_decompose(corpus[i], &a, address);
+		int rc_b = aarch64_decompose_spec(corpus[i], &b, address);
+		if (rc_a == 0)
+			aarch64_disassemble(&a, text_a, sizeof(text_a));
+		if (rc_b == 0)
+			aarch64_disassemble(&b, text_b, sizeof(text_b));
+
+		Instruction c;
+		memset(&c, 0, sizeof(c));
+		if (aarch64_decompose_fast(corpus[i], &c, address) == 0)
+			fast++;
+
+		if (rc_a != rc_b || memcmp(&a, &b, sizeof(a)) || strcmp(text_a, text_b))
+		{
+			if (mismatches++ < 16)
+				printf("MISMATCH %08X: \"%s\" (%d) vs. spec \"%s\" (%d)\n", corpus[i], text_a, rc_a, text_b, rc_b);
+		}
+	}
+	printf("%zu instructions, %zu (%.1f%%) on the fast path, %zu mismatches\n", count, fast,
+	    count ? 100.0 * fast / count : 0.0, mismatches);
+
+	/* time */
+	struct timespec t0, t1;
+	Instruction instr;
+	double delta_fast, delta_spec;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (int pass = 0; pass < passes; pass++)
+		for (size_t i = 0; i < count; i++)
+			aarch64_decompose(corpus[i], &instr, i * 4);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	delta_fast = subtract_timespecs(t1, t0);
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (int pass = 0; pass < passes; pass++)
+		for (size_t i = 0; i < count; i++)
+			aarch64_decompose_spec(corpus[i], &instr, i * 4);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	delta_spec = subtract_timespecs(t1, t0);
+
+	double total = (double)count * passes;
+	printf("aarch64_decompose(): %.0f instructions/s\n", total / delta_fast);
+	printf("    spec path only: %.0f instructions/s\n", total / delta_spec);
+	printf("           speedup: %.2fx\n", delta_spec / delta_fast);
+
+	free(corpus);
+	return mismatches ? -1 : 0;
+}
+
+/* The class the decoder implies for a word, or -1 if the decoded operation says nothing about it */
+static int expected_class(int rc, const Instruction* instr)
+{
+	if (rc != DECODE_STATUS_OK)
+		return -1;
+	switch (instr->operation)
+	{
+	case ARM64_B:
+	case ARM64_CBZ:
+	case ARM64_CBNZ:
+	case ARM64_TBZ:
+	case ARM64_TBNZ:
+	case ARM64_BR:
+	case ARM64_BRAA:
+	case ARM64_BRAAZ:
+	case ARM64_BRAB:
+	case ARM64_BRABZ:
+		return ARM64_CLASS_BRANCH;
+	case ARM64_BL:
+	case ARM64_BLR:
+	case ARM64_BLRAA:
+	case ARM64_BLRAAZ:
+	case ARM64_BLRAB:
+	case ARM64_BLRABZ:
+		return ARM64_CLASS_CALL;
+	case ARM64_RET:
+	case ARM64_RETAA:
+	case ARM64_RETAB:
+		return ARM64_CLASS_RETURN;
+	case ARM64_ADRP:
+		return ARM64_CLASS_ADRP;
+	case ARM64_UDF:
+		return ARM64_CLASS_INVALID;
+	default:
+		if (instr->operation >= ARM64_B_AL && instr->operation <= ARM64_B_VS)
+			return ARM64_CLASS_BRANCH;
+		return -1;
+	}
+}
+
+/* Check the vector classifiers against the scalar one and the decoder over a corpus of instruction
+   words, then time each implementation. */
+int classify(const char* path, int passes)
+{
+	FILE* fp = fopen(path, "rb");
+	if (!fp)
+	{
+		printf("ERROR: unable to open %s\n", path);
+		return -1;
+	}
+	fseek(fp, 0, SEEK_END);
+	size_t count = ftell(fp) / sizeof(uint32_t);
+	fseek(fp, 0, SEEK_SET);
+	uint8_t* corpus = malloc(count * sizeof(uint32_t));
+	uint8_t* classes[3] = {malloc(count + 1), malloc(count + 1), malloc(count + 1)};
+	if (!corpus || !classes[0] || !classes[1] || !classes[2] ||
+	    fread(corpus, sizeof(uint32_t), count, fp) != count)
+	{
+		printf("ERROR: unable to read %s\n", path);
+		fclose(fp);
+		free(corpus);
+		for (int i = 0; i < 3; i++)
+			free(classes[i]);
+		return -1;
+	}
+	fclose(fp);
+
+	static const char* names[3] = {"scalar", "sse2", "avx2"};
+	enum Arm64ClassifyImpl best = aarch64_classify_best_impl();
+	size_t mismatches = 0, histogram[ARM64_CLASS_LOAD_STORE + 1] = {0};
+
+	/* vector paths against scalar, over every tail length so the remainder loops are covered too */
+	for (int impl = ARM64_CLASSIFY_SCALAR; impl <= (int)best; impl++)
+	{
+		size_t tail = count < 64 ? count : 64;
+		for (size_t n = count - tail; n <= count; n++)
+		{
+			classes[impl][n] = 0xFF;
+			aarch64_classify_with(corpus, n, classes[impl], (enum Arm64ClassifyImpl)impl);
+			if (classes[impl][n] != 0xFF)
+			{
+				printf("ERROR: %s wrote past %zu words\n", names[impl], n);
+				mismatches++;
+			}
+		}
+		if (impl != ARM64_CLASSIFY_SCALAR && memcmp(classes[impl], classes[0], count))
+		{
+			printf("ERROR: %s disagrees with scalar\n", names[impl]);
+			mismatches++;
+		}
+	}
+
+	/* scalar against the decoder */
+	for (size_t i = 0; i < count; i++)
+	{
+		uint32_t insword;
+		Instruction instr;
+		memcpy(&insword, corpus + i * 4, sizeof(insword));
+		memset(&instr, 0, sizeof(instr));
+		int rc = aarch64_decompose(insword, &instr, i * 4);
+		int expected = expected_class(rc, &instr);
+		int cls = classes[0][i];
+		histogram[cls]++;
+
+		if ((expected != -1 && cls != expected) ||
+		    (expected == -1 && rc == DECODE_STATUS_OK && cls != ARM64_CLASS_OTHER &&
+		        cls != ARM64_CLASS_LOAD_STORE))
+		{
+			if (mismatches++ < 16)
+				printf("MISMATCH %08X: class %d, decoder %d (rc %d)\n", insword, cls, expected, rc);
+		}
+	}
+	printf("%zu words: %zu other, %zu invalid, %zu branch, %zu call, %zu return, %zu adrp, %zu load/store, "
+	       "%zu mismatches\n",
+	    count, histogram[ARM64_CLASS_OTHER], histogram[ARM64_CLASS_INVALID], histogram[ARM64_CLASS_BRANCH],
+	    histogram[ARM64_CLASS_CALL], histogram[ARM64_CLASS_RETURN], histogram[ARM64_CLASS_ADRP],
+	    histogram[ARM64_CLASS_LOAD_STORE], mismatches);
+
+	/* time */
+	struct timespec t0, t1;
+	double delta[3];
+	for (int impl = ARM64_CLASSIFY_SCALAR; impl <= (int)best; impl++)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		for (int pass = 0; pass < passes; pass++)
+			aarch64_classify_with(corpus, count, classes[impl], (enum Arm64ClassifyImpl)impl);
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		delta[impl] = subtract_timespecs(t1, t0);
+		printf("%6s: %.0f words/s (%.2fx scalar)\n", names[impl], (double)count * passes / delta[impl],
+		    delta[0] / delta[impl]);
+	}
+
+	free(corpus);
+	for (int i = 0; i < 3; i++)
+		free(classes[i]);
+	return mismatches ? -1 : 0;
+}
+
 /* main */
 int main(int ac, char** av)
 {
@@ -284,9 +505,31 @@ int main(int ac, char** av)
 	{
 		printf("example usage:\n");
 		printf("\t%s d503201f\n", av[0]);
+		printf("\t%s bench text.bin [passes]\n", av[0]);
+		printf("\t%s classify text.bin [passes]\n", av[0]);
 		return -1;
 	}
 
+	if (!strcmp(av[1], "bench"))
+	{
+		if (ac <= 2)
+		{
+			printf("ERROR: bench needs a file of little endian instruction words\n");
+			return -1;
+		}
+		return bench(av[2], ac > 3 ? atoi(av[3]) : 10);
+	}
+
+	if (!strcmp(av[1], "classify"))
+	{
+		if (ac <= 2)
+		{
+			printf("ERROR: classify needs a file of little endian instruction words\n");
+			return -1;
+		}
+		return classify(av[2], ac > 3 ? atoi(av[3]) : 1000);
+	}
+
 	if (!strcmp(av[1], "decode-speed"))
 	{
 		verbose = false;
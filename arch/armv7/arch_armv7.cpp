@@ -821,7 +821,7 @@ protected:
 		}
 	}
 
-	uint32_t tokenize_shift(const InstructionOperand& op, vector<InstructionTextToken>& result)
+	uint32_t tokenize_shift(const InstructionOperand& op, InstructionTextTokenSink& result)
 	{
 		char operand[64] = {0};
 		if (op.shift != SHIFT_NONE)
@@ -830,16 +830,16 @@ protected:
 			if (shiftStr == NULL)
 				return FAILED_TO_DISASSEMBLE_OPERAND;
 
-			result.emplace_back(TextToken, ", ");
-			result.emplace_back(KeywordToken, shiftStr);
+			result.AddToken(TextToken, ", ");
+			result.AddToken(KeywordToken, shiftStr);
 			snprintf(operand, sizeof(operand), "%#x", (uint32_t)op.imm);
-			result.emplace_back(OperationToken, " #");
-			result.emplace_back(IntegerToken, operand, op.imm);
+			result.AddToken(OperationToken, " #");
+			result.AddToken(IntegerToken, operand, op.imm);
 		}
 		return DISASM_SUCCESS;
 	}
 
-	void tokenize_shifted_immediate(const InstructionOperand& op,  vector<InstructionTextToken>& result)
+	void tokenize_shifted_immediate(const InstructionOperand& op,  InstructionTextTokenSink& result)
 	{
 		char operand[64] = {0};
 		const char* sign = "";
@@ -848,27 +848,27 @@ protected:
 			case FIMM16:
 			case FIMM32:
 				snprintf(operand, sizeof(operand), "%f", op.immf);
-				result.emplace_back(OperationToken, "#");
-				result.emplace_back(FloatingPointToken, operand);
+				result.AddToken(OperationToken, "#");
+				result.AddToken(FloatingPointToken, operand);
 				break;
 			case FIMM64:
 				snprintf(operand, sizeof(operand), "%e", op.immd);
-				result.emplace_back(OperationToken, "#");
-				result.emplace_back(FloatingPointToken, operand);
+				result.AddToken(OperationToken, "#");
+				result.AddToken(FloatingPointToken, operand);
 				break;
 			case IMM:
 				snprintf(operand, sizeof(operand), "%s%#x", sign, (uint32_t)op.imm);
-				result.emplace_back(OperationToken, "#");
-				result.emplace_back(IntegerToken, operand, op.imm);
+				result.AddToken(OperationToken, "#");
+				result.AddToken(IntegerToken, operand, op.imm);
 				break;
 			case IMM64:
 				snprintf(operand, sizeof(operand), "%s%#" PRIx64, sign, op.imm64);
-				result.emplace_back(OperationToken, "#");
-				result.emplace_back(IntegerToken, operand, op.imm64);
+				result.AddToken(OperationToken, "#");
+				result.AddToken(IntegerToken, operand, op.imm64);
 				break;
 			case LABEL:
 				snprintf(operand, sizeof(operand), "%#x", op.imm);
-				result.emplace_back(PossibleAddressToken, operand, op.imm);
+				result.AddToken(PossibleAddressToken, operand, op.imm);
 				break;
 			default:
 				return;
@@ -879,7 +879,7 @@ protected:
 
 	uint32_t tokenize_shifted_register(
 		const InstructionOperand& op,
-		vector<InstructionTextToken>& result)
+		InstructionTextTokenSink& result)
 	{
 		const char* reg = NULL;
 		reg = GetRegisterName((enum Register)op.reg).c_str();
@@ -887,7 +887,7 @@ protected:
 			return FAILED_TO_DISASSEMBLE_REGISTER;
 
 
-		result.emplace_back(RegisterToken, reg);
+		result.AddToken(RegisterToken, reg);
 		tokenize_shift(op, result);
 		return DISASM_SUCCESS;
 	}
@@ -1102,24 +1102,29 @@ public:
 		return true;
 	}
 
-	static inline void GetImmToken(const InstructionOperand& op, vector<InstructionTextToken>& result)
+	static inline void GetImmToken(const InstructionOperand& op, InstructionTextTokenSink& result)
 	{
 		char operand[32];
 		snprintf(operand, sizeof(operand), "%#x", (uint32_t)op.imm);
-		result.emplace_back(OperationToken, " #");
-		result.emplace_back(IntegerToken, operand, op.imm);
+		result.AddToken(OperationToken, " #");
+		result.AddToken(IntegerToken, operand, op.imm);
 	}
 
-	static inline void GetSignedImmToken(const InstructionOperand& op, vector<InstructionTextToken>& result)
+	static inline void GetSignedImmToken(const InstructionOperand& op, InstructionTextTokenSink& result)
 	{
 		char operand[32];
 		const char* neg[2] = {"-", ""};
 		snprintf(operand, sizeof(operand), "%s%#x", neg[op.flags.add == 1], (uint32_t)op.imm);
-		result.emplace_back(OperationToken, " #");
-		result.emplace_back(IntegerToken, operand, op.imm);
+		result.AddToken(OperationToken, " #");
+		result.AddToken(IntegerToken, operand, op.imm);
 	}
 
 	virtual bool GetInstructionText(const uint8_t* data, uint64_t addr, size_t& len, vector<InstructionTextToken>& result) override
+	{
+		return GetInstructionTextFromTokens(data, addr, len, result);
+	}
+
+	virtual bool GetInstructionTextTokens(const uint8_t* data, uint64_t addr, size_t& len, InstructionTextTokenSink& result) override
 	{
 		Instruction instr;
 		char padding[9];
@@ -1146,8 +1151,8 @@ public:
 		else
 			padding[1] = '\0';
 
-		result.emplace_back(InstructionToken, operation);
-		result.emplace_back(TextToken, padding);
+		result.AddToken(InstructionToken, operation);
+		result.AddToken(TextToken, padding);
 
 		try
 		{
@@ -1157,7 +1162,7 @@ public:
 				return true;
 
 			if (i != 0)
-				result.emplace_back(OperandSeparatorToken, ", ");
+				result.AddToken(OperandSeparatorToken, ", ");
 
 			switch (instr.operands[i].cls)
 			{
@@ -1170,34 +1175,34 @@ public:
 				tokenize_shifted_immediate(instr.operands[i], result);
 				break;
 			case REG:
-				result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].reg));
-				result.emplace_back(OperationToken, wb[instr.operands[i].flags.wb]);
+				result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].reg));
+				result.AddToken(OperationToken, wb[instr.operands[i].flags.wb]);
 				if (instr.operands[i].shift == SHIFT_NONE)
 				{
 					if (instr.operands[i].flags.hasElements == 1)
 					{
-						result.emplace_back(BraceToken, "[");
+						result.AddToken(BraceToken, "[");
 						snprintf(tmpOperand, sizeof(tmpOperand), "%d", instr.operands[i].imm);
-						result.emplace_back(IntegerToken, tmpOperand, instr.operands[i].imm);
-						result.emplace_back(BraceToken, "]");
+						result.AddToken(IntegerToken, tmpOperand, instr.operands[i].imm);
+						result.AddToken(BraceToken, "]");
 					}
 				}
 				else if (instr.operands[i].flags.offsetRegUsed == 1)
 				{
 					//Register shifted by register
-					result.emplace_back(TextToken, ", ");
-					result.emplace_back(KeywordToken, get_shift(instr.operands[i].shift));
-					result.emplace_back(TextToken, " ");
-					result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].offset));
+					result.AddToken(TextToken, ", ");
+					result.AddToken(KeywordToken, get_shift(instr.operands[i].shift));
+					result.AddToken(TextToken, " ");
+					result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].offset));
 				}
 				else
 				{
 					//Register shifted by constant
-					result.emplace_back(TextToken, ", ");
-					result.emplace_back(KeywordToken, get_shift(instr.operands[i].shift));
+					result.AddToken(TextToken, ", ");
+					result.AddToken(KeywordToken, get_shift(instr.operands[i].shift));
 					if (instr.operands[i].shift != SHIFT_RRX)
 					{
-						result.emplace_back(TextToken, " ");
+						result.AddToken(TextToken, " ");
 						GetImmToken(instr.operands[i], result);
 					}
 				}
@@ -1206,7 +1211,7 @@ public:
 			case REG_LIST_SINGLE:
 			case REG_LIST_DOUBLE:
 				{
-					result.emplace_back(BraceToken, "{");
+					result.AddToken(BraceToken, "{");
 					first = true;
 					uint32_t base = 0;
 					if (instr.operands[i].cls == REG_LIST_SINGLE)
@@ -1219,121 +1224,121 @@ public:
 						if (((instr.operands[i].reg >> j) & 1) == 1)
 						{
 							if (!first)
-								result.emplace_back(TextToken, ", ");
-							result.emplace_back(RegisterToken, GetRegisterName((enum Register)(j + base)));
+								result.AddToken(TextToken, ", ");
+							result.AddToken(RegisterToken, GetRegisterName((enum Register)(j + base)));
 							first = false;
 						}
 					}
-					result.emplace_back(BraceToken, "}");
-					result.emplace_back(OperationToken, crt[instr.operands[i].flags.wb]);
+					result.AddToken(BraceToken, "}");
+					result.AddToken(OperationToken, crt[instr.operands[i].flags.wb]);
 				}
 				break;
 			case REG_SPEC:
-				result.emplace_back(RegisterToken, get_spec_register_name(instr.operands[i].regs));
+				result.AddToken(RegisterToken, get_spec_register_name(instr.operands[i].regs));
 				break;
 			case REG_BANKED:
-				result.emplace_back(RegisterToken, get_banked_register_name(instr.operands[i].regb));
+				result.AddToken(RegisterToken, get_banked_register_name(instr.operands[i].regb));
 				break;
 			case REG_COPROCP:
-				result.emplace_back(RegisterToken, get_coproc_register_p_name(instr.operands[i].regp));
+				result.AddToken(RegisterToken, get_coproc_register_p_name(instr.operands[i].regp));
 				break;
 			case REG_COPROCC:
-				result.emplace_back(RegisterToken, get_coproc_register_c_name(instr.operands[i].regc));
+				result.AddToken(RegisterToken, get_coproc_register_c_name(instr.operands[i].regc));
 				break;
 			case IFLAGS:
-				result.emplace_back(KeywordToken, get_iflag(instr.operands[i].iflag));
+				result.AddToken(KeywordToken, get_iflag(instr.operands[i].iflag));
 				break;
 				case ENDIAN_SPEC:
-				result.emplace_back(KeywordToken, get_endian(instr.operands[i].endian));
+				result.AddToken(KeywordToken, get_endian(instr.operands[i].endian));
 				break;
 			case DSB_OPTION:
-				result.emplace_back(KeywordToken, get_dsb_option(instr.operands[i].dsbOpt));
+				result.AddToken(KeywordToken, get_dsb_option(instr.operands[i].dsbOpt));
 				break;
 			case MEM_ALIGNED:
-				result.emplace_back(BraceToken, "[");
-				result.emplace_back(BeginMemoryOperandToken, "");
-				result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].reg));
+				result.AddToken(BraceToken, "[");
+				result.AddToken(BeginMemoryOperandToken, "");
+				result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].reg));
 				if (instr.operands[i].imm != 0)
 				{
-					result.emplace_back(OperationToken, ":");
+					result.AddToken(OperationToken, ":");
 					snprintf(tmpOperand, sizeof(tmpOperand), "%#x", instr.operands[i].imm);
-					result.emplace_back(IntegerToken, tmpOperand, instr.operands[i].imm);
+					result.AddToken(IntegerToken, tmpOperand, instr.operands[i].imm);
 				}
-				result.emplace_back(EndMemoryOperandToken, "");
-				result.emplace_back(BraceToken, "]");
-				result.emplace_back(OperationToken, wb[instr.operands[i].flags.wb]);
+				result.AddToken(EndMemoryOperandToken, "");
+				result.AddToken(BraceToken, "]");
+				result.AddToken(OperationToken, wb[instr.operands[i].flags.wb]);
 				break;
 			case MEM_OPTION:
-				result.emplace_back(BraceToken, "[");
-				result.emplace_back(BeginMemoryOperandToken, "");
-				result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].reg));
-				result.emplace_back(EndMemoryOperandToken, "");
-				result.emplace_back(BraceToken, "]");
-				result.emplace_back(TextToken, ", ");
-				result.emplace_back(BraceToken, "{");
+				result.AddToken(BraceToken, "[");
+				result.AddToken(BeginMemoryOperandToken, "");
+				result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].reg));
+				result.AddToken(EndMemoryOperandToken, "");
+				result.AddToken(BraceToken, "]");
+				result.AddToken(TextToken, ", ");
+				result.AddToken(BraceToken, "{");
 				GetImmToken(instr.operands[i], result);
-				result.emplace_back(BraceToken, "}");
+				result.AddToken(BraceToken, "}");
 				break;
 			case MEM_PRE_IDX:
-				result.emplace_back(BraceToken, "[");
-				result.emplace_back(BeginMemoryOperandToken, "");
+				result.AddToken(BraceToken, "[");
+				result.AddToken(BeginMemoryOperandToken, "");
 				if (instr.operands[i].flags.offsetRegUsed == 1)
 				{
-					result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].reg));
-					result.emplace_back(TextToken, ", ");
-					result.emplace_back(OperationToken, neg[instr.operands[i].flags.add == 1]);
+					result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].reg));
+					result.AddToken(TextToken, ", ");
+					result.AddToken(OperationToken, neg[instr.operands[i].flags.add == 1]);
 					if (instr.operands[i].imm == 0)
-						result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].offset));
+						result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].offset));
 					else if (instr.operands[i].shift == SHIFT_RRX)
 					{
-						result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].offset));
-						result.emplace_back(TextToken, ", ");
-						result.emplace_back(OperationToken, get_shift(instr.operands[i].shift));
+						result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].offset));
+						result.AddToken(TextToken, ", ");
+						result.AddToken(OperationToken, get_shift(instr.operands[i].shift));
 					}
 					else
 					{
-						result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].offset));
-						result.emplace_back(TextToken, ", ");
-						result.emplace_back(OperationToken, get_shift(instr.operands[i].shift));
-						result.emplace_back(TextToken, " ");
+						result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].offset));
+						result.AddToken(TextToken, ", ");
+						result.AddToken(OperationToken, get_shift(instr.operands[i].shift));
+						result.AddToken(TextToken, " ");
 						GetImmToken(instr.operands[i], result);
 					}
 				}
 				else
 				{
-					result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].reg));
-					result.emplace_back(TextToken, ", ");
+					result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].reg));
+					result.AddToken(TextToken, ", ");
 					GetSignedImmToken(instr.operands[i], result);
 				}
-				result.emplace_back(EndMemoryOperandToken, "");
-				result.emplace_back(BraceToken, "]");
-				result.emplace_back(OperationToken, "!");
+				result.AddToken(EndMemoryOperandToken, "");
+				result.AddToken(BraceToken, "]");
+				result.AddToken(OperationToken, "!");
 				break;
 				break;
 			case MEM_POST_IDX:
-				result.emplace_back(BraceToken, "[");
-				result.emplace_back(BeginMemoryOperandToken, "");
-				result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].reg));
-				result.emplace_back(EndMemoryOperandToken, "");
-				result.emplace_back(BraceToken, "]");
-				result.emplace_back(TextToken, ", ");
+				result.AddToken(BraceToken, "[");
+				result.AddToken(BeginMemoryOperandToken, "");
+				result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].reg));
+				result.AddToken(EndMemoryOperandToken, "");
+				result.AddToken(BraceToken, "]");
+				result.AddToken(TextToken, ", ");
 				if (instr.operands[i].flags.offsetRegUsed == 1)
 				{
-					result.emplace_back(OperationToken, neg[instr.operands[i].flags.add == 1]);
+					result.AddToken(OperationToken, neg[instr.operands[i].flags.add == 1]);
 					if (instr.operands[i].imm == 0)
-						result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].offset));
+						result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].offset));
 					else if (instr.operands[i].shift == SHIFT_RRX)
 					{
-						result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].offset));
-						result.emplace_back(TextToken, ", ");
-						result.emplace_back(OperationToken, get_shift(instr.operands[i].shift));
+						result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].offset));
+						result.AddToken(TextToken, ", ");
+						result.AddToken(OperationToken, get_shift(instr.operands[i].shift));
 					}
 					else
 					{
-						result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].offset));
-						result.emplace_back(TextToken, ", ");
-						result.emplace_back(OperationToken, get_shift(instr.operands[i].shift));
-						result.emplace_back(TextToken, " ");
+						result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].offset));
+						result.AddToken(TextToken, ", ");
+						result.AddToken(OperationToken, get_shift(instr.operands[i].shift));
+						result.AddToken(TextToken, " ");
 						GetImmToken(instr.operands[i], result);
 					}
 				}
@@ -1343,42 +1348,42 @@ public:
 				}
 				break;
 			case MEM_IMM:
-				result.emplace_back(BraceToken, "[");
-				result.emplace_back(BeginMemoryOperandToken, "");
-				result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].reg));
+				result.AddToken(BraceToken, "[");
+				result.AddToken(BeginMemoryOperandToken, "");
+				result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].reg));
 				switch (instr.operands[i].shift)
 				{
 					case SHIFT_NONE:
 						if (instr.operands[i].flags.offsetRegUsed == 1)
 						{
-							result.emplace_back(TextToken, ", ");
-							result.emplace_back(OperationToken, neg[instr.operands[i].flags.add == 1]);
-							result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].offset));
+							result.AddToken(TextToken, ", ");
+							result.AddToken(OperationToken, neg[instr.operands[i].flags.add == 1]);
+							result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].offset));
 						}
 						else if (instr.operands[i].imm != 0)// || instr.operands[i].flags.add == 0)
 						{
-							result.emplace_back(TextToken, ", ");
+							result.AddToken(TextToken, ", ");
 							GetSignedImmToken(instr.operands[i], result);
 						}
 						break;
 					case SHIFT_RRX:
-						result.emplace_back(TextToken, ", ");
-						result.emplace_back(OperationToken, neg[instr.operands[i].flags.add == 1]);
-						result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].offset));
-						result.emplace_back(TextToken, ", ");
-						result.emplace_back(OperationToken, get_shift(instr.operands[i].shift));
+						result.AddToken(TextToken, ", ");
+						result.AddToken(OperationToken, neg[instr.operands[i].flags.add == 1]);
+						result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].offset));
+						result.AddToken(TextToken, ", ");
+						result.AddToken(OperationToken, get_shift(instr.operands[i].shift));
 						break;
 					default:
-						result.emplace_back(TextToken, ", ");
-						result.emplace_back(OperationToken, neg[instr.operands[i].flags.add == 1]);
-						result.emplace_back(RegisterToken, GetRegisterName(instr.operands[i].offset));
-						result.emplace_back(TextToken, ", ");
-						result.emplace_back(OperationToken, get_shift(instr.operands[i].shift));
-						result.emplace_back(TextToken, " ");
+						result.AddToken(TextToken, ", ");
+						result.AddToken(OperationToken, neg[instr.operands[i].flags.add == 1]);
+						result.AddToken(RegisterToken, GetRegisterName(instr.operands[i].offset));
+						result.AddToken(TextToken, ", ");
+						result.AddToken(OperationToken, get_shift(instr.operands[i].shift));
+						result.AddToken(TextToken, " ");
 						GetImmToken(instr.operands[i], result);
 				}
-				result.emplace_back(EndMemoryOperandToken, "");
-				result.emplace_back(BraceToken, "]");
+				result.AddToken(EndMemoryOperandToken, "");
+				result.AddToken(BraceToken, "]");
 				break;
 			default:
 				LogError("operandClass %d\n", instr.operands[i].cls);
@@ -762,7 +762,55 @@ public:
 		return true;
 	}
 
+	virtual size_t GetInstructionInfoBatch(
+		const uint8_t* data, uint64_t addr, size_t len, InstructionInfo* results, size_t maxCount) override
+	{
+		// Classify the run first. Loads and stores always decode and never branch, and j and jal always decode
+		// with a target that follows from the word alone, so only the remaining words need the full decoder.
+		uint8_t classes[64];
+		size_t count = 0;
+		size_t offset = 0;
+		while (count < maxCount && len - offset >= 4)
+		{
+			size_t chunk = min(min(maxCount - count, (len - offset) / 4), sizeof(classes));
+			mips_classify(data + offset, chunk, classes, m_endian == BigEndian, m_decomposeFlags);
+			for (size_t i = 0; i < chunk; i++, offset += 4)
+			{
+				uint32_t insword = *(uint32_t*)(data + offset);
+				if (m_endian == BigEndian)
+					insword = bswap32(insword);
+				InstructionInfo& result = results[count];
+				if (classes[i] == MIPS_CLASS_LOAD_STORE)
+				{
+					result.length = 4;
+				}
+				else if ((insword & 0xF8000000) == 0x08000000)
+				{
+					// j and jal, the target replaces the low 28 bits of the address
+					uint64_t target = (addr + offset) & ~(uint64_t)0x0FFFFFFF;
+					target += (uint64_t)(insword & 0x03FFFFFF) << 2;
+					result.length = 4;
+					result.AddBranch((insword & 0x04000000) ? CallDestination : UnconditionalBranch, target, nullptr, 1);
+				}
+				else
+				{
+					Instruction instr;
+					if (!Disassemble(data + offset, addr + offset, len - offset, instr))
+						return count;
+					SetInstructionInfoForInstruction(addr + offset, instr, result);
+				}
+				count++;
+			}
+		}
+		return count;
+	}
+
 	virtual bool GetInstructionText(const uint8_t* data, uint64_t addr, size_t& len, vector<InstructionTextToken>& result) override
+	{
+		return GetInstructionTextFromTokens(data, addr, len, result);
+	}
+
+	virtual bool GetInstructionTextTokens(const uint8_t* data, uint64_t addr, size_t& len, InstructionTextTokenSink& result) override
 	{
 		Instruction instr;
 		char operand[64];
@@ -785,8 +833,8 @@ public:
 		else
 			padding[1] = '\0';
 
-		result.emplace_back(InstructionToken, operation);
-		result.emplace_back(TextToken, padding);
+		result.AddToken(InstructionToken, operation);
+		result.AddToken(TextToken, padding);
 		for (size_t i = 0; i < MAX_OPERANDS; i++)
 		{
 			if (instr.operands[i].operandClass == NONE)
@@ -796,7 +844,7 @@ public:
 			uint64_t label_imm = instr.operands[i].immediate;
 
 			if (i != 0)
-				result.emplace_back(OperandSeparatorToken, ", ");
+				result.AddToken(OperandSeparatorToken, ", ");
 
 			switch (instr.operands[i].operandClass)
 			{
@@ -810,11 +858,11 @@ public:
 				else
 					snprintf(operand, sizeof(operand), "%#x", imm);
 
-				result.emplace_back(IntegerToken, operand, imm);
+				result.AddToken(IntegerToken, operand, imm);
 				break;
 			case LABEL:
 				snprintf(operand, sizeof(operand), "%#" PRIx64, label_imm);
-				result.emplace_back(PossibleAddressToken, operand, imm);
+				result.AddToken(PossibleAddressToken, operand, imm);
 				break;
 			case REG:
 				reg = get_register((Reg)instr.operands[i].reg);
@@ -822,7 +870,7 @@ public:
 				{
 					return false;
 				}
-				result.emplace_back(RegisterToken, reg);
+				result.AddToken(RegisterToken, reg);
 				break;
 			case FLAG:
 				reg = get_flag((Flag)instr.operands[i].reg);
@@ -830,7 +878,7 @@ public:
 				{
 					return false;
 				}
-				result.push_back(InstructionTextToken(RegisterToken, reg));
+				result.AddToken(RegisterToken, reg);
 				break;
 			case HINT:
 				reg = get_hint((Hint)instr.operands[i].reg);
@@ -838,10 +886,10 @@ public:
 				{
 					return false;
 				}
-				result.emplace_back(RegisterToken, reg);
+				result.AddToken(RegisterToken, reg);
 				break;
 			case MEM_IMM:
-				result.emplace_back(BeginMemoryOperandToken, "");
+				result.AddToken(BeginMemoryOperandToken, "");
 				if (imm != 0)
 				{
 					if (imm < -9)
@@ -852,32 +900,32 @@ public:
 						snprintf(operand, sizeof(operand), "%d", imm);
 					else
 						snprintf(operand, sizeof(operand), "%#x", imm);
-					result.emplace_back(IntegerToken, operand, imm);
+					result.AddToken(IntegerToken, operand, imm);
 				}
 				if (instr.operands[i].reg == REG_ZERO)
 					break;
-				result.emplace_back(BraceToken, "(");
+				result.AddToken(BraceToken, "(");
 				reg = get_register((Reg)instr.operands[i].reg);
 				if (reg == NULL)
 					return false;
-				result.emplace_back(RegisterToken, reg);
-				result.emplace_back(BraceToken, ")");
-				result.emplace_back(EndMemoryOperandToken, "");
+				result.AddToken(RegisterToken, reg);
+				result.AddToken(BraceToken, ")");
+				result.AddToken(EndMemoryOperandToken, "");
 				break;
 			case MEM_REG:
-				result.emplace_back(BeginMemoryOperandToken, "");
+				result.AddToken(BeginMemoryOperandToken, "");
 				reg = get_register((Reg)imm);
 				if (reg == NULL)
 					return false;
-				result.emplace_back(RegisterToken, reg);
-				result.emplace_back(BraceToken, "(");
+				result.AddToken(RegisterToken, reg);
+				result.AddToken(BraceToken, "(");
 
 				reg = get_register((Reg)instr.operands[i].reg);
 				if (reg == NULL)
 					return false;
-				result.emplace_back(RegisterToken, reg);
-				result.emplace_back(BraceToken, ")");
-				result.emplace_back(EndMemoryOperandToken, "");
+				result.AddToken(RegisterToken, reg);
+				result.AddToken(BraceToken, ")");
+				result.AddToken(EndMemoryOperandToken, "");
 				break;
 			default:
 				LogError("operandClass %x\n", instr.operands[i].operandClass);
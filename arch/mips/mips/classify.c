@@ -0,0 +1,296 @@
+/* Coarse classification of MIPS instruction words.
+
+   Prescans over code (looking for calls, returns, lui targets, or just for data that can't be code)
+   only need to know which of a handful of classes a word falls in, not its operands. Every class is
+   a mask/value compare on the raw word, so a buffer can be classified a vector of words at a time:
+   each rule is an AND and a compare-equal per vector. Unlike AArch64 the rules overlap (jr $ra is
+   also a jr, bbit0 sits in the lwc2 slot), so the per-rule results are combined with a max and the
+   classes are numbered by precedence.
+
+   Big endian words are classified by byte swapping the rules rather than the words. The classes
+   are deliberately shallow: a word classified as anything but MIPS_CLASS_INVALID may still fail to
+   decode, except that every MIPS_CLASS_LOAD_STORE word decodes for both MIPS32 and MIPS64.
+
+   `test classify <corpus>` checks the vector paths against the scalar one and against the decoder. */
+
+#include "mips.h"
+
+#ifdef __cplusplus
+using namespace mips;
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CLASSIFY_SSE2
+	#include <emmintrin.h>
+#endif
+
+#if defined(CLASSIFY_SSE2) && defined(__GNUC__)
+	#define CLASSIFY_AVX2
+	#include <immintrin.h>
+#endif
+
+struct ClassifyRule
+{
+	uint32_t mask;
+	uint32_t value;
+	uint32_t cls;
+};
+
+static const struct ClassifyRule classify_rules[] = {
+    {0x80000000, 0x80000000, MIPS_CLASS_LOAD_STORE}, /* primary opcodes 0x20-0x3f */
+    {0xFF400000, 0x49400000, MIPS_CLASS_LOAD_STORE}, /* lwc2, swc2, ldc2, sdc2 in cop2 */
+    {0xFC000000, 0xEC000000, MIPS_CLASS_INVALID},    /* 0x3b */
+    {0xFC000000, 0x78000000, MIPS_CLASS_INVALID},    /* 0x1e */
+    {0xFC000000, 0x3C000000, MIPS_CLASS_LUI},        /* lui */
+    {0xFC000000, 0x08000000, MIPS_CLASS_BRANCH},     /* j */
+    {0xFC000000, 0x0C000000, MIPS_CLASS_CALL},       /* jal */
+    {0xFC000000, 0x74000000, MIPS_CLASS_CALL},       /* jalx */
+    {0xF0000000, 0x10000000, MIPS_CLASS_BRANCH},     /* beq, bne, blez, bgtz */
+    {0xF0000000, 0x50000000, MIPS_CLASS_BRANCH},     /* beql, bnel, blezl, bgtzl */
+    {0xFC1C0000, 0x04000000, MIPS_CLASS_BRANCH},     /* bltz, bgez, bltzl, bgezl */
+    {0xFC1C0000, 0x04100000, MIPS_CLASS_CALL},       /* bltzal, bgezal, bltzall, bgezall */
+    {0xFC00003F, 0x00000008, MIPS_CLASS_BRANCH},     /* jr, jr.hb */
+    {0xFFE0003F, 0x03E00008, MIPS_CLASS_RETURN},     /* jr $ra, jr.hb $ra */
+    {0xFC00003F, 0x00000009, MIPS_CLASS_CALL},       /* jalr, jalr.hb */
+    {0xFE00003F, 0x42000018, MIPS_CLASS_RETURN},     /* eret */
+    {0xFFE00000, 0x45000000, MIPS_CLASS_BRANCH},     /* bc1f, bc1t, bc1fl, bc1tl */
+    {0xFFE00000, 0x45200000, MIPS_CLASS_BRANCH},     /* bc1eqz */
+    {0xFFE00000, 0x45A00000, MIPS_CLASS_BRANCH},     /* bc1nez */
+    {0xFFE00000, 0x49000000, MIPS_CLASS_BRANCH},     /* bc2f, bc2t, bc2fl, bc2tl */
+    {0xFFE00000, 0x49200000, MIPS_CLASS_BRANCH},     /* bc2eqz */
+    {0xFFE00000, 0x49A00000, MIPS_CLASS_BRANCH},     /* bc2nez */
+};
+
+/* only with DECOMPOSE_FLAGS_CAVIUM */
+static const struct ClassifyRule cavium_rules[] = {
+    {0xCC000000, 0xC8000000, MIPS_CLASS_BRANCH}, /* bbit0, bbit032, bbit1, bbit132 in the lwc2, ldc2, swc2, sdc2 slots */
+};
+
+#define CLASSIFY_RULE_COUNT (sizeof(classify_rules) / sizeof(classify_rules[0]))
+#define CAVIUM_RULE_COUNT (sizeof(cavium_rules) / sizeof(cavium_rules[0]))
+#define MAX_RULE_COUNT (CLASSIFY_RULE_COUNT + CAVIUM_RULE_COUNT)
+
+/* the rules for one call, in the byte order of the words as loaded on a little endian host */
+struct ClassifyRules
+{
+	size_t count;
+	struct ClassifyRule rule[MAX_RULE_COUNT];
+};
+
+static inline uint32_t bswap32(uint32_t x)
+{
+	return (x >> 24) | ((x >> 8) & 0xFF00) | ((x << 8) & 0xFF0000) | (x << 24);
+}
+
+static inline uint32_t load_word(const uint8_t* data, uint32_t bigEndian)
+{
+	if (bigEndian)
+		return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) |
+		       (uint32_t)data[3];
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+	       ((uint32_t)data[3] << 24);
+}
+
+static inline uint32_t apply_rules(const struct ClassifyRule* rules, size_t count, uint32_t insword, uint32_t cls)
+{
+	for (size_t i = 0; i < count; i++)
+		if ((insword & rules[i].mask) == rules[i].value && rules[i].cls > cls)
+			cls = rules[i].cls;
+	return cls;
+}
+
+enum MipsWordClass mips_classify_word(uint32_t insword, uint32_t flags)
+{
+	uint32_t cls = apply_rules(classify_rules, CLASSIFY_RULE_COUNT, insword, MIPS_CLASS_OTHER);
+	if (flags & DECOMPOSE_FLAGS_CAVIUM)
+		cls = apply_rules(cavium_rules, CAVIUM_RULE_COUNT, insword, cls);
+	return (enum MipsWordClass)cls;
+}
+
+static void classify_scalar(
+    const uint8_t* data, size_t count, uint8_t* classes, uint32_t bigEndian, uint32_t flags)
+{
+	for (size_t i = 0; i < count; i++)
+		classes[i] = (uint8_t)mips_classify_word(load_word(data + i * 4, bigEndian), flags);
+}
+
+#if defined(CLASSIFY_SSE2) || defined(CLASSIFY_AVX2)
+static void get_rules(uint32_t bigEndian, uint32_t flags, struct ClassifyRules* rules)
+{
+	rules->count = 0;
+	for (size_t i = 0; i < CLASSIFY_RULE_COUNT; i++)
+		rules->rule[rules->count++] = classify_rules[i];
+	if (flags & DECOMPOSE_FLAGS_CAVIUM)
+		for (size_t i = 0; i < CAVIUM_RULE_COUNT; i++)
+			rules->rule[rules->count++] = cavium_rules[i];
+	if (bigEndian)
+	{
+		for (size_t i = 0; i < rules->count; i++)
+		{
+			rules->rule[i].mask = bswap32(rules->rule[i].mask);
+			rules->rule[i].value = bswap32(rules->rule[i].value);
+		}
+	}
+}
+#endif
+
+#ifdef CLASSIFY_SSE2
+struct ClassifyVectors
+{
+	size_t count;
+	__m128i mask[MAX_RULE_COUNT];
+	__m128i value[MAX_RULE_COUNT];
+	__m128i cls[MAX_RULE_COUNT];
+};
+
+/* SSE2 has no 32-bit max, but the classes are small enough that a 16-bit max per half gives the same result */
+static inline __m128i classify_sse2_4(__m128i words, const struct ClassifyVectors* v)
+{
+	__m128i result = _mm_setzero_si128();
+	for (size_t i = 0; i < v->count; i++)
+	{
+		__m128i hit = _mm_cmpeq_epi32(_mm_and_si128(words, v->mask[i]), v->value[i]);
+		result = _mm_max_epi16(result, _mm_and_si128(hit, v->cls[i]));
+	}
+	return result;
+}
+
+/* 16 words per iteration, narrowed to 16 class bytes */
+static size_t classify_sse2(const uint8_t* data, size_t count, uint8_t* classes, const struct ClassifyRules* rules)
+{
+	struct ClassifyVectors v;
+	v.count = rules->count;
+	for (size_t i = 0; i < rules->count; i++)
+	{
+		v.mask[i] = _mm_set1_epi32((int)rules->rule[i].mask);
+		v.value[i] = _mm_set1_epi32((int)rules->rule[i].value);
+		v.cls[i] = _mm_set1_epi32((int)rules->rule[i].cls);
+	}
+
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m128i* src = (const __m128i*)(data + i * 4);
+		__m128i a = classify_sse2_4(_mm_loadu_si128(src + 0), &v);
+		__m128i b = classify_sse2_4(_mm_loadu_si128(src + 1), &v);
+		__m128i c = classify_sse2_4(_mm_loadu_si128(src + 2), &v);
+		__m128i d = classify_sse2_4(_mm_loadu_si128(src + 3), &v);
+		__m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+		_mm_storeu_si128((__m128i*)(classes + i), packed);
+	}
+	return i;
+}
+#endif
+
+#ifdef CLASSIFY_AVX2
+struct ClassifyVectors256
+{
+	size_t count;
+	__m256i mask[MAX_RULE_COUNT];
+	__m256i value[MAX_RULE_COUNT];
+	__m256i cls[MAX_RULE_COUNT];
+};
+
+__attribute__((target("avx2"))) static inline __m256i classify_avx2_8(
+    __m256i words, const struct ClassifyVectors256* v)
+{
+	__m256i result = _mm256_setzero_si256();
+	for (size_t i = 0; i < v->count; i++)
+	{
+		__m256i hit = _mm256_cmpeq_epi32(_mm256_and_si256(words, v->mask[i]), v->value[i]);
+		result = _mm256_max_epi32(result, _mm256_and_si256(hit, v->cls[i]));
+	}
+	return result;
+}
+
+/* 32 words per iteration. The packs work within 128-bit lanes, which leaves the dwords of the result
+   interleaved as 0,2,4,6,1,3,5,7 and the final permute puts them back in order. */
+__attribute__((target("avx2"))) static size_t classify_avx2(
+    const uint8_t* data, size_t count, uint8_t* classes, const struct ClassifyRules* rules)
+{
+	struct ClassifyVectors256 v;
+	v.count = rules->count;
+	for (size_t i = 0; i < rules->count; i++)
+	{
+		v.mask[i] = _mm256_set1_epi32((int)rules->rule[i].mask);
+		v.value[i] = _mm256_set1_epi32((int)rules->rule[i].value);
+		v.cls[i] = _mm256_set1_epi32((int)rules->rule[i].cls);
+	}
+
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32)
+	{
+		const __m256i* src = (const __m256i*)(data + i * 4);
+		__m256i a = classify_avx2_8(_mm256_loadu_si256(src + 0), &v);
+		__m256i b = classify_avx2_8(_mm256_loadu_si256(src + 1), &v);
+		__m256i c = classify_avx2_8(_mm256_loadu_si256(src + 2), &v);
+		__m256i d = classify_avx2_8(_mm256_loadu_si256(src + 3), &v);
+		__m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+		_mm256_storeu_si256((__m256i*)(classes + i), _mm256_permutevar8x32_epi32(packed, order));
+	}
+	return i;
+}
+
+/* called from any analysis thread, every thread computes the same answer so a relaxed atomic is enough */
+static int have_avx2(void)
+{
+	static int cached = -1;
+	int result = __atomic_load_n(&cached, __ATOMIC_RELAXED);
+	if (result < 0)
+	{
+		__builtin_cpu_init();
+		result = __builtin_cpu_supports("avx2") ? 1 : 0;
+		__atomic_store_n(&cached, result, __ATOMIC_RELAXED);
+	}
+	return result;
+}
+#endif
+
+void mips_classify_with(const uint8_t* data, size_t count, uint8_t* classes, uint32_t bigEndian, uint32_t flags,
+    enum MipsClassifyImpl impl)
+{
+	size_t done = 0;
+#if defined(CLASSIFY_SSE2) || defined(CLASSIFY_AVX2)
+	struct ClassifyRules rules;
+	/* below one vector iteration there is nothing to set the rules up for */
+	if (impl != MIPS_CLASSIFY_SCALAR && count >= 16)
+		get_rules(bigEndian, flags, &rules);
+#endif
+	switch (impl)
+	{
+#ifdef CLASSIFY_AVX2
+	case MIPS_CLASSIFY_AVX2:
+		if (count >= 32 && have_avx2())
+			done = classify_avx2(data, count, classes, &rules);
+		break;
+#endif
+#ifdef CLASSIFY_SSE2
+	case MIPS_CLASSIFY_SSE2:
+		if (count >= 16)
+			done = classify_sse2(data, count, classes, &rules);
+		break;
+#endif
+	default:
+		break;
+	}
+	classify_scalar(data + done * 4, count - done, classes + done, bigEndian, flags);
+}
+
+enum MipsClassifyImpl mips_classify_best_impl(void)
+{
+#ifdef CLASSIFY_AVX2
+	if (have_avx2())
+		return MIPS_CLASSIFY_AVX2;
+#endif
+#ifdef CLASSIFY_SSE2
+	return MIPS_CLASSIFY_SSE2;
+#else
+	return MIPS_CLASSIFY_SCALAR;
+#endif
+}
+
+void mips_classify(const uint8_t* data, size_t count, uint8_t* classes, uint32_t bigEndian, uint32_t flags)
+{
+	mips_classify_with(data, count, classes, bigEndian, flags, mips_classify_best_impl());
+}
@@ -1631,6 +1631,7 @@ uint32_t mips_decompose_instruction(
 			case MIPS_BGEZAL:
 				if (ins.r.rs == 0)
 					instruction->operation = MIPS_BAL;
+				break;
 			case MIPS_SYNC:
 				if ((flags & DECOMPOSE_FLAGS_CAVIUM) != 0)
 				{
@@ -1098,6 +1098,24 @@ namespace mips
 	typedef union combined combined;
 #endif
 
+	//Coarse word classes, see mips_classify(). Numbered by precedence: where
+	//two classification rules match the same word, the higher class wins.
+	enum MipsWordClass {
+		MIPS_CLASS_OTHER = 0,
+		MIPS_CLASS_LOAD_STORE, //primary opcodes 0x20-0x3f, and lwc2, swc2, ldc2, sdc2 in cop2
+		MIPS_CLASS_LUI,
+		MIPS_CLASS_BRANCH,     //b*, bc1*, bc2*, j, jr other than jr $ra, Cavium bbit*
+		MIPS_CLASS_CALL,       //bal, b*al*, jal, jalr, jalx
+		MIPS_CLASS_RETURN,     //jr $ra, eret
+		MIPS_CLASS_INVALID     //primary opcodes 0x1e and 0x3b, which nothing decodes
+	};
+
+	enum MipsClassifyImpl {
+		MIPS_CLASSIFY_SCALAR = 0,
+		MIPS_CLASSIFY_SSE2,
+		MIPS_CLASSIFY_AVX2
+	};
+
 
 #ifdef __cplusplus
 	extern "C" {
@@ -1120,6 +1138,27 @@ namespace mips
 				char* outBuffer,
 				uint32_t outBufferSize);
 
+		//Classify `count` instruction words at `data`, writing one enum MipsWordClass
+		//byte per word to `classes`. `flags` takes the DECOMPOSE_FLAGS_* of mips_decompose,
+		//only DECOMPOSE_FLAGS_CAVIUM changes the result.
+		void mips_classify(
+				const uint8_t* data,
+				size_t count,
+				uint8_t* classes,
+				uint32_t bigEndian,
+				uint32_t flags);
+		enum MipsWordClass mips_classify_word(uint32_t insword, uint32_t flags);
+
+		//The same with an explicit implementation, unsupported ones fall back to scalar
+		void mips_classify_with(
+				const uint8_t* data,
+				size_t count,
+				uint8_t* classes,
+				uint32_t bigEndian,
+				uint32_t flags,
+				enum MipsClassifyImpl impl);
+		enum MipsClassifyImpl mips_classify_best_impl(void);
+
 		const char* get_operation(Operation operation);
 		const char* get_register(Reg reg);
 		const char* get_flag(enum Flag flag);
@@ -1,5 +1,5 @@
 /* build me, debug me:
-gcc -g test.c mips.c -o test
+gcc -g test.c mips.c classify.c -o test
 lldb ./test -- e28f007b
 b mips_decompose
 b mips_disassemble
@@ -8,6 +8,7 @@ b mips_disassemble
 #include <stdio.h>
 #include <stdint.h>
 #include <inttypes.h>
+#include <time.h>
 
 #include "mips.h"
 
@@ -40,6 +41,208 @@ int disassemble(uint32_t insword, uint64_t address, enum MipsVersion version, ch
 		exit(-1); \
 	}
 
+/* The class the decoder implies for a word, or -1 if the decoded operation says nothing about it */
+static int expected_class(const Instruction *instr)
+{
+	switch(instr->operation) {
+		case MIPS_B:
+		case MIPS_J:
+		case MIPS_BEQ:
+		case MIPS_BEQL:
+		case MIPS_BEQZ:
+		case MIPS_BNE:
+		case MIPS_BNEL:
+		case MIPS_BNEZ:
+		case MIPS_BGEZ:
+		case MIPS_BGEZL:
+		case MIPS_BGTZ:
+		case MIPS_BGTZL:
+		case MIPS_BLEZ:
+		case MIPS_BLEZL:
+		case MIPS_BLTZ:
+		case MIPS_BLTZL:
+		case MIPS_BC1F:
+		case MIPS_BC1FL:
+		case MIPS_BC1T:
+		case MIPS_BC1TL:
+		case MIPS_BC1EQZ:
+		case MIPS_BC1NEZ:
+		case MIPS_BC1ANY2:
+		case MIPS_BC1ANY4:
+		case MIPS_BC2F:
+		case MIPS_BC2FL:
+		case MIPS_BC2T:
+		case MIPS_BC2TL:
+		case MIPS_BC2EQZ:
+		case MIPS_BC2NEZ:
+		case CNMIPS_BBIT0:
+		case CNMIPS_BBIT032:
+		case CNMIPS_BBIT1:
+		case CNMIPS_BBIT132:
+			return MIPS_CLASS_BRANCH;
+		case MIPS_JR:
+		case MIPS_JR_HB:
+			return instr->operands[0].reg == REG_RA ? MIPS_CLASS_RETURN : MIPS_CLASS_BRANCH;
+		case MIPS_BAL:
+		case MIPS_BGEZAL:
+		case MIPS_BGEZALL:
+		case MIPS_BLTZAL:
+		case MIPS_BLTZALL:
+		case MIPS_JAL:
+		case MIPS_JALR:
+		case MIPS_JALR_HB:
+		case MIPS_JALX:
+			return MIPS_CLASS_CALL;
+		case MIPS_ERET:
+			return MIPS_CLASS_RETURN;
+		case MIPS_LUI:
+			return MIPS_CLASS_LUI;
+		case MIPS_LB:
+		case MIPS_LBU:
+		case MIPS_LH:
+		case MIPS_LHU:
+		case MIPS_LW:
+		case MIPS_LWL:
+		case MIPS_LWR:
+		case MIPS_LWU:
+		case MIPS_LD:
+		case MIPS_LL:
+		case MIPS_LLD:
+		case MIPS_LWC1:
+		case MIPS_LWC2:
+		case MIPS_LDC1:
+		case MIPS_LDC2:
+		case MIPS_SB:
+		case MIPS_SH:
+		case MIPS_SW:
+		case MIPS_SWL:
+		case MIPS_SWR:
+		case MIPS_SD:
+		case MIPS_SDL:
+		case MIPS_SDR:
+		case MIPS_SC:
+		case MIPS_SCD:
+		case MIPS_SWC1:
+		case MIPS_SWC2:
+		case MIPS_SDC1:
+		case MIPS_SDC2:
+		case MIPS_CACHE:
+		case MIPS_PREF:
+			return MIPS_CLASS_LOAD_STORE;
+		default:
+			return -1;
+	}
+}
+
+/* Check the vector classifiers against the scalar one and the decoder over a corpus of little endian
+   instruction words, for both byte orders and with and without the Cavium extensions, then time each
+   implementation. */
+static int classify(const char *path, int passes)
+{
+	static const char *names[3] = {"scalar", "sse2", "avx2"};
+	static const uint32_t flag_sets[2] = {DECOMPOSE_FLAGS_PSEUDO_OP, DECOMPOSE_FLAGS_PSEUDO_OP | DECOMPOSE_FLAGS_CAVIUM};
+	FILE *fp = fopen(path, "rb");
+	if(!fp) {
+		printf("ERROR: unable to open %s\n", path);
+		return -1;
+	}
+	fseek(fp, 0, SEEK_END);
+	size_t count = ftell(fp) / sizeof(uint32_t);
+	fseek(fp, 0, SEEK_SET);
+	uint8_t *corpus[2] = {malloc(count * 4), malloc(count * 4)};
+	uint8_t *classes[3] = {malloc(count + 1), malloc(count + 1), malloc(count + 1)};
+	uint8_t *swapped = malloc(count + 1);
+	if(!corpus[0] || !corpus[1] || !classes[0] || !classes[1] || !classes[2] || !swapped ||
+	  fread(corpus[0], sizeof(uint32_t), count, fp) != count) {
+		printf("ERROR: unable to read %s\n", path);
+		fclose(fp);
+		for(int i = 0; i < 2; i++)
+			free(corpus[i]);
+		for(int i = 0; i < 3; i++)
+			free(classes[i]);
+		free(swapped);
+		return -1;
+	}
+	fclose(fp);
+
+	/* the same words in big endian order */
+	for(size_t i = 0; i < count * 4; i++)
+		corpus[1][i] = corpus[0][(i & ~(size_t)3) + 3 - (i & 3)];
+
+	enum MipsClassifyImpl best = mips_classify_best_impl();
+	size_t mismatches = 0, histogram[MIPS_CLASS_INVALID + 1] = {0};
+
+	for(int f = 0; f < 2; f++) {
+		/* vector paths against scalar, over every tail length so the remainder loops are covered too */
+		for(int impl = MIPS_CLASSIFY_SCALAR; impl <= (int)best; impl++) {
+			size_t tail = count < 64 ? count : 64;
+			for(size_t n = count - tail; n <= count; n++) {
+				classes[impl][n] = 0xFF;
+				mips_classify_with(corpus[0], n, classes[impl], 0, flag_sets[f], (enum MipsClassifyImpl)impl);
+				if(classes[impl][n] != 0xFF) {
+					printf("ERROR: %s wrote past %zu words\n", names[impl], n);
+					mismatches++;
+				}
+			}
+			if(impl != MIPS_CLASSIFY_SCALAR && memcmp(classes[impl], classes[0], count)) {
+				printf("ERROR: %s disagrees with scalar\n", names[impl]);
+				mismatches++;
+			}
+			mips_classify_with(corpus[1], count, swapped, 1, flag_sets[f], (enum MipsClassifyImpl)impl);
+			if(memcmp(swapped, classes[0], count)) {
+				printf("ERROR: %s big endian disagrees with little endian\n", names[impl]);
+				mismatches++;
+			}
+		}
+
+		/* scalar against the decoder, for both versions the architectures use */
+		for(size_t i = 0; i < count; i++) {
+			uint32_t insword;
+			memcpy(&insword, corpus[0] + i * 4, sizeof(insword));
+			int cls = classes[0][i];
+			if(f == 0)
+				histogram[cls]++;
+			for(int v = 0; v < 2; v++) {
+				Instruction instr;
+				memset(&instr, 0, sizeof(instr));
+				int rc = mips_decompose(&insword, 4, &instr, v ? MIPS_64 : MIPS_32, i * 4, 0, flag_sets[f]);
+				int expected = rc ? -1 : expected_class(&instr);
+				if((rc && cls == MIPS_CLASS_LOAD_STORE) ||
+				  (expected != -1 && cls != expected) ||
+				  (expected == -1 && !rc && cls != MIPS_CLASS_OTHER)) {
+					if(mismatches++ < 16)
+						printf("MISMATCH %08X: class %d, decoder %d (rc %d, flags %d)\n", insword, cls, expected,
+							rc, flag_sets[f]);
+				}
+			}
+		}
+	}
+	printf("%zu words: %zu other, %zu load/store, %zu lui, %zu branch, %zu call, %zu return, %zu invalid, "
+		"%zu mismatches\n",
+		count, histogram[MIPS_CLASS_OTHER], histogram[MIPS_CLASS_LOAD_STORE], histogram[MIPS_CLASS_LUI],
+		histogram[MIPS_CLASS_BRANCH], histogram[MIPS_CLASS_CALL], histogram[MIPS_CLASS_RETURN],
+		histogram[MIPS_CLASS_INVALID], mismatches);
+
+	/* time */
+	double delta[3];
+	for(int impl = MIPS_CLASSIFY_SCALAR; impl <= (int)best; impl++) {
+		clock_t t0 = clock();
+		for(int pass = 0; pass < passes; pass++)
+			mips_classify_with(corpus[1], count, classes[impl], 1, DECOMPOSE_FLAGS_PSEUDO_OP,
+				(enum MipsClassifyImpl)impl);
+		delta[impl] = (double)(clock() - t0) / CLOCKS_PER_SEC;
+		printf("%6s: %.0f words/s (%.2fx scalar)\n", names[impl], (double)count * passes / delta[impl],
+			delta[0] / delta[impl]);
+	}
+
+	for(int i = 0; i < 2; i++)
+		free(corpus[i]);
+	for(int i = 0; i < 3; i++)
+		free(classes[i]);
+	free(swapped);
+	return mismatches ? -1 : 0;
+}
+
 int main(int ac, char **av)
 {
 	char instxt[4096];
@@ -49,6 +252,7 @@ int main(int ac, char **av)
 		printf("\t%s [<address>] <instruction_word>\n", av[0]);
 		printf("\t%s <instruction_word>\n", av[0]);
 		printf("\t%s test\n", av[0]);
+		printf("\t%s classify <file of little endian words> [passes]\n", av[0]);
 		printf("examples:\n");
 		printf("\t%s 0 14E00003\n", av[0]);
 		printf("\t%s 00405A58 14E00003\n", av[0]);
@@ -56,6 +260,9 @@ int main(int ac, char **av)
 		exit(-1);
 	}
 
+	if(ac >= 3 && !strcmp(av[1], "classify"))
+		return classify(av[2], ac > 3 ? atoi(av[3]) : 1000);
+
 	if(ac == 2 && !strcmp(av[1], "test")) {
 		disassemble(0x14E00003, 0, MIPS_32, instxt);
 		ASSERT(!strcmp(instxt, "bne\t$a3, $zero, 0x10"));
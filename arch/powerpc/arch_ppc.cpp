@@ -14,6 +14,7 @@ using namespace BinaryNinja; // for ::LogDebug, etc.
 
 #include "disassembler.h"
 #include "assembler.h"
+#include "classify.h"
 
 #include "il.h"
 #include "util.h"
@@ -295,6 +296,18 @@ class PowerpcArchitecture: public Architecture
 		return result;
 	}
 
+	/* Info, text and IL for an instruction are requested separately, share one
+		decode between them. A decomp_result carries all of capstone's cs_detail,
+		the default cache size in bytes keeps that to a few dozen per thread. */
+	bool Decompose(const uint8_t* data, uint64_t addr, struct decomp_result* res)
+	{
+		return DecodeCached<struct decomp_result, 4>(data, addr, 4, *res, [&](struct decomp_result& decoded) -> size_t {
+			if (powerpc_decompose(data, 4, addr, endian == LittleEndian, &decoded, GetAddressSize() == 8, cs_mode_local))
+				return 0;
+			return 4;
+		});
+	}
+
 	public:
 
 	/* initialization list */
@@ -364,8 +377,8 @@ class PowerpcArchitecture: public Architecture
 		}
 
 		/* decompose the instruction to get branch info */
-		if(powerpc_decompose(data, 4, addr, endian == LittleEndian, &res, GetAddressSize() == 8, cs_mode_local)) {
-			MYLOG("ERROR: powerpc_decompose()\n");
+		if(!Decompose(data, addr, &res)) {
+			MYLOG("ERROR: Decompose()\n");
 			return false;
 		}
 
@@ -461,7 +474,53 @@ class PowerpcArchitecture: public Architecture
 		return true;
 	}
 
-	bool PrintLocalDisassembly(const uint8_t *data, uint64_t addr, size_t &len, vector<InstructionTextToken> &result, decomp_result* res)
+	virtual size_t GetInstructionInfoBatch(const uint8_t* data, uint64_t addr,
+		size_t len, InstructionInfo* results, size_t maxCount) override
+	{
+		/* Classify the run first. Loads and stores always decode and never
+			branch, and b/bl always decode with a target that follows from the
+			word alone, so only the remaining words need capstone. */
+		uint8_t classes[64];
+		size_t count = 0;
+		size_t offset = 0;
+		while (count < maxCount && len - offset >= 4)
+		{
+			size_t chunk = min(min(maxCount - count, (len - offset) / 4), sizeof(classes));
+			powerpc_classify(data + offset, chunk, classes, endian == BigEndian);
+			for (size_t i = 0; i < chunk; i++, offset += 4)
+			{
+				uint32_t raw_insn = *(const uint32_t *)(data + offset);
+				if (endian == BigEndian)
+					raw_insn = bswap32(raw_insn);
+
+				InstructionInfo& result = results[count];
+				if (classes[i] == PPC_CLASS_LOAD_STORE)
+				{
+					result.length = 4;
+				}
+				else if ((raw_insn >> 26) == 18)
+				{
+					/* same as GetInstructionInfo() */
+					uint64_t target = sign_extend(addressSize, raw_insn & 0x03fffffc, 25);
+					if (!(raw_insn & 2))
+					{
+						target += addr + offset;
+						ADDRMASK(addressSize, target);
+					}
+					result.length = 4;
+					result.AddBranch((raw_insn & 1) ? CallDestination : UnconditionalBranch, target);
+				}
+				else if (!GetInstructionInfo(data + offset, addr + offset, len - offset, result))
+				{
+					return count;
+				}
+				count++;
+			}
+		}
+		return count;
+	}
+
+	bool PrintLocalDisassembly(const uint8_t *data, uint64_t addr, size_t &len, InstructionTextTokenSink& result, decomp_result* res)
 	{
 		(void)addr;
 		char buf[16];
@@ -484,28 +543,28 @@ class PowerpcArchitecture: public Architecture
 		switch (local_op)
 		{
 		case PPC_INS_BN_FCMPO:
-			result.emplace_back(InstructionToken, insn->mnemonic);
-			result.emplace_back(TextToken, "   ");
+			result.AddToken(InstructionToken, insn->mnemonic);
+			result.AddToken(TextToken, "   ");
 			snprintf(buf, sizeof(buf), "cr%d", ppc->operands[0].reg - PPC_REG_CR0);
-			result.emplace_back(RegisterToken, buf);
-			result.emplace_back(OperandSeparatorToken, ", ");
+			result.AddToken(RegisterToken, buf);
+			result.AddToken(OperandSeparatorToken, ", ");
 			snprintf(buf, sizeof(buf), "f%d", ppc->operands[1].reg - PPC_REG_F0);
-			result.emplace_back(RegisterToken, buf);
-			result.emplace_back(OperandSeparatorToken, ", ");
+			result.AddToken(RegisterToken, buf);
+			result.AddToken(OperandSeparatorToken, ", ");
 			snprintf(buf, sizeof(buf), "f%d", ppc->operands[2].reg - PPC_REG_F0);
-			result.emplace_back(RegisterToken, buf);
+			result.AddToken(RegisterToken, buf);
 			break;
 		case PPC_INS_BN_XXPERMR:
-			result.emplace_back(InstructionToken, insn->mnemonic);
-			result.emplace_back(TextToken, " ");
+			result.AddToken(InstructionToken, insn->mnemonic);
+			result.AddToken(TextToken, " ");
 			snprintf(buf, sizeof(buf), "vs%d", ppc->operands[0].reg - PPC_REG_VS0);
-			result.emplace_back(RegisterToken, buf);
-			result.emplace_back(OperandSeparatorToken, ", ");
+			result.AddToken(RegisterToken, buf);
+			result.AddToken(OperandSeparatorToken, ", ");
 			snprintf(buf, sizeof(buf), "vs%d", ppc->operands[1].reg - PPC_REG_VS0);
-			result.emplace_back(RegisterToken, buf);
-			result.emplace_back(OperandSeparatorToken, ", ");
+			result.AddToken(RegisterToken, buf);
+			result.AddToken(OperandSeparatorToken, ", ");
 			snprintf(buf, sizeof(buf), "vs%d", ppc->operands[2].reg - PPC_REG_VS0);
-			result.emplace_back(RegisterToken, buf);
+			result.AddToken(RegisterToken, buf);
 			break;
 		default:
 			return false;
@@ -513,10 +572,15 @@ class PowerpcArchitecture: public Architecture
 		return true;
 	}
 
-	/* populate the vector result with InstructionTextToken
+	virtual bool GetInstructionText(const uint8_t* data, uint64_t addr, size_t& len, vector<InstructionTextToken>& result) override
+	{
+		return GetInstructionTextFromTokens(data, addr, len, result);
+	}
+
+	/* populate the token sink result with the instruction text
 
 	*/
-	virtual bool GetInstructionText(const uint8_t* data, uint64_t addr, size_t& len, vector<InstructionTextToken>& result) override
+	virtual bool GetInstructionTextTokens(const uint8_t* data, uint64_t addr, size_t& len, InstructionTextTokenSink& result) override
 	{
 		bool rc = false;
 		bool capstoneWorkaround = false;
@@ -539,8 +603,8 @@ class PowerpcArchitecture: public Architecture
 			// PerformLocalDisassembly(data, addr, len, &res, endian == BigEndian);
 			return PrintLocalDisassembly(data, addr, len, result, &res);
 		}
-		if(powerpc_decompose(data, 4, addr, endian == LittleEndian, &res, GetAddressSize() == 8, cs_mode_local)) {
-			MYLOG("ERROR: powerpc_decompose()\n");
+		if(!Decompose(data, addr, &res)) {
+			MYLOG("ERROR: Decompose()\n");
 			goto cleanup;
 		}
 
@@ -562,7 +626,7 @@ class PowerpcArchitecture: public Architecture
 		}
 
 		/* mnemonic */
-		result.emplace_back(InstructionToken, insn->mnemonic);
+		result.AddToken(InstructionToken, insn->mnemonic);
 
 		/* padding between mnemonic and operands */
 		memset(buf, ' ', 8);
@@ -571,7 +635,7 @@ class PowerpcArchitecture: public Architecture
 			buf[8-strlenMnem] = '\0';
 		else
 			buf[1] = '\0';
-		result.emplace_back(TextToken, buf);
+		result.AddToken(TextToken, buf);
 
 		/* operands */
 		for(int i=0; i<ppc->op_count; ++i) {
@@ -581,9 +645,9 @@ class PowerpcArchitecture: public Architecture
 				case PPC_OP_REG:
 					//MYLOG("pushing a register\n");
 					if (capstoneWorkaround || (insn->id == PPC_INS_ISEL && i == 3))
-						result.emplace_back(RegisterToken, GetFlagName(op->reg));
+						result.AddToken(RegisterToken, GetFlagName(op->reg));
 					else
-						result.emplace_back(RegisterToken, GetRegisterName(op->reg));
+						result.AddToken(RegisterToken, GetRegisterName(op->reg));
 					break;
 				case PPC_OP_IMM:
 					//MYLOG("pushing an integer\n");
@@ -596,7 +660,7 @@ class PowerpcArchitecture: public Architecture
 						case PPC_INS_BL:
 						case PPC_INS_BLA:
 							snprintf(buf, sizeof(buf), "0x%" PRIx64, op->imm);
-							result.emplace_back(CodeRelativeAddressToken, buf, (uint32_t) op->imm, 4);
+							result.AddToken(CodeRelativeAddressToken, buf, (uint32_t) op->imm, 4);
 							break;
 						case PPC_INS_ADDIS:
 						case PPC_INS_LIS:
@@ -604,36 +668,36 @@ class PowerpcArchitecture: public Architecture
 						case PPC_INS_XORIS:
 						case PPC_INS_ORI:
 							snprintf(buf, sizeof(buf), "0x%x", (uint16_t)op->imm);
-							result.emplace_back(IntegerToken, buf, (uint16_t) op->imm, 4);
+							result.AddToken(IntegerToken, buf, (uint16_t) op->imm, 4);
 							break;
 						default:
 							if (op->imm < 0 && op->imm > -0x10000)
 								snprintf(buf, sizeof(buf), "-0x%" PRIx64, -op->imm);
 							else
 								snprintf(buf, sizeof(buf), "0x%" PRIx64, op->imm);
-							result.emplace_back(IntegerToken, buf, op->imm, 4);
+							result.AddToken(IntegerToken, buf, op->imm, 4);
 					}
 
 					break;
 				case PPC_OP_MEM:
 					// eg: lwz r11, 8(r11)
 					snprintf(buf, sizeof(buf), "%d", op->mem.disp);
-					result.emplace_back(IntegerToken, buf, op->mem.disp, 4);
+					result.AddToken(IntegerToken, buf, op->mem.disp, 4);
 
-					result.emplace_back(BraceToken, "(");
-					result.emplace_back(RegisterToken, GetRegisterName(op->mem.base));
-					result.emplace_back(BraceToken, ")");
+					result.AddToken(BraceToken, "(");
+					result.AddToken(RegisterToken, GetRegisterName(op->mem.base));
+					result.AddToken(BraceToken, ")");
 					break;
 				case PPC_OP_CRX:
 				case PPC_OP_INVALID:
 				default:
 					//MYLOG("pushing a ???\n");
-					result.emplace_back(TextToken, "???");
+					result.AddToken(TextToken, "???");
 			}
 
 			if(i < ppc->op_count-1) {
 				//MYLOG("pushing a comma\n");
-				result.emplace_back(OperandSeparatorToken, ", ");
+				result.AddToken(OperandSeparatorToken, ", ");
 			}
 		}
 
@@ -786,8 +850,8 @@ class PowerpcArchitecture: public Architecture
 		if (DoesQualifyForLocalDisassembly(data, endian == BigEndian)) {
 			PerformLocalDisassembly(data, addr, len, &res, endian == BigEndian);
 		}
-		else if(powerpc_decompose(data, 4, addr, endian == LittleEndian, &res, GetAddressSize() == 8, cs_mode_local)) {
-			MYLOG("ERROR: powerpc_decompose()\n");
+		else if(!Decompose(data, addr, &res)) {
+			MYLOG("ERROR: Decompose()\n");
 			il.AddInstruction(il.Undefined());
 			goto cleanup;
 		}
@@ -0,0 +1,257 @@
+/******************************************************************************
+
+Coarse classification of instruction words.
+
+Prescans over code (looking for calls, returns, lis targets) only need to know
+which of a handful of classes a word falls in, not its operands, and capstone
+is by far the slowest part of an instruction info request. Every class is a
+mask/value compare on the raw word, so a buffer can be classified a vector of
+words at a time: each rule is an AND and a compare-equal per vector. The rules
+overlap (blr is also a bclr, bl is also a b), so the per-rule results are
+combined with a max and the classes are numbered by precedence.
+
+Big endian words are classified by byte swapping the rules rather than the
+words. The classes are shallow: nothing here says whether capstone decodes a
+word, except that PPC_CLASS_LOAD_STORE words have no reserved fields and
+decode in every mode.
+
+`test_disasm classify <file>` checks the vector paths against the scalar one.
+
+******************************************************************************/
+
+#include "classify.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define CLASSIFY_SSE2
+	#include <emmintrin.h>
+#endif
+
+#if defined(CLASSIFY_SSE2) && defined(__GNUC__)
+	#define CLASSIFY_AVX2
+	#include <immintrin.h>
+#endif
+
+struct classify_rule
+{
+	uint32_t mask;
+	uint32_t value;
+	uint32_t cls;
+};
+
+static const classify_rule classify_rules[] = {
+	{0xC0000000, 0x80000000, PPC_CLASS_LOAD_STORE}, /* 32-47: lwz, lwzu, lbz, lbzu, stw, stwu, stb, stbu, lhz, lhzu, lha, lhau, sth, sthu, lmw, stmw */
+	{0xE0000000, 0xC0000000, PPC_CLASS_LOAD_STORE}, /* 48-55: lfs, lfsu, lfd, lfdu, stfs, stfsu, stfd, stfdu */
+	{0xFC000000, 0x3C000000, PPC_CLASS_ADDIS},      /* addis */
+	{0xFC000000, 0x48000000, PPC_CLASS_BRANCH},     /* b, ba */
+	{0xFC000001, 0x48000001, PPC_CLASS_CALL},       /* bl, bla */
+	{0xFC000000, 0x40000000, PPC_CLASS_BRANCH},     /* bc, bca */
+	{0xFC000001, 0x40000001, PPC_CLASS_CALL},       /* bcl, bcla */
+	{0xFC0007FE, 0x4C000020, PPC_CLASS_BRANCH},     /* bclr */
+	{0xFC0007FF, 0x4C000021, PPC_CLASS_CALL},       /* bclrl */
+	{0xFC0007FE, 0x4C000420, PPC_CLASS_BRANCH},     /* bcctr */
+	{0xFC0007FF, 0x4C000421, PPC_CLASS_CALL},       /* bcctrl */
+	{0xFE8007FF, 0x4E800020, PPC_CLASS_RETURN},     /* bclr with BO branching always, blr */
+	{0xFC0007FF, 0x4C000064, PPC_CLASS_RETURN},     /* rfi */
+	{0xFC0007FF, 0x4C000024, PPC_CLASS_RETURN},     /* rfid */
+};
+
+#define CLASSIFY_RULE_COUNT (sizeof(classify_rules) / sizeof(classify_rules[0]))
+
+static inline uint32_t swap_word(uint32_t x)
+{
+	return (x >> 24) | ((x >> 8) & 0xFF00) | ((x << 8) & 0xFF0000) | (x << 24);
+}
+
+static inline uint32_t load_word(const uint8_t *data, bool bigendian)
+{
+	if (bigendian)
+		return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+ppc_word_class_t powerpc_classify_word(uint32_t insword)
+{
+	uint32_t cls = PPC_CLASS_OTHER;
+	for (size_t i = 0; i < CLASSIFY_RULE_COUNT; i++)
+		if ((insword & classify_rules[i].mask) == classify_rules[i].value && classify_rules[i].cls > cls)
+			cls = classify_rules[i].cls;
+	return (ppc_word_class_t)cls;
+}
+
+static void classify_scalar(const uint8_t *data, size_t count, uint8_t *classes, bool bigendian)
+{
+	for (size_t i = 0; i < count; i++)
+		classes[i] = (uint8_t)powerpc_classify_word(load_word(data + i * 4, bigendian));
+}
+
+#if defined(CLASSIFY_SSE2) || defined(CLASSIFY_AVX2)
+/* the rules in the byte order of the words as loaded on a little endian host */
+static void get_rules(bool bigendian, classify_rule *rules)
+{
+	for (size_t i = 0; i < CLASSIFY_RULE_COUNT; i++)
+	{
+		rules[i] = classify_rules[i];
+		if (bigendian)
+		{
+			rules[i].mask = swap_word(rules[i].mask);
+			rules[i].value = swap_word(rules[i].value);
+		}
+	}
+}
+#endif
+
+#ifdef CLASSIFY_SSE2
+struct classify_vectors
+{
+	__m128i mask[CLASSIFY_RULE_COUNT];
+	__m128i value[CLASSIFY_RULE_COUNT];
+	__m128i cls[CLASSIFY_RULE_COUNT];
+};
+
+/* SSE2 has no 32-bit max, but the classes are small enough that a 16-bit max per half gives the same result */
+static inline __m128i classify_sse2_4(__m128i words, const classify_vectors *v)
+{
+	__m128i result = _mm_setzero_si128();
+	for (size_t i = 0; i < CLASSIFY_RULE_COUNT; i++)
+	{
+		__m128i hit = _mm_cmpeq_epi32(_mm_and_si128(words, v->mask[i]), v->value[i]);
+		result = _mm_max_epi16(result, _mm_and_si128(hit, v->cls[i]));
+	}
+	return result;
+}
+
+/* 16 words per iteration, narrowed to 16 class bytes */
+static size_t classify_sse2(const uint8_t *data, size_t count, uint8_t *classes, const classify_rule *rules)
+{
+	classify_vectors v;
+	for (size_t i = 0; i < CLASSIFY_RULE_COUNT; i++)
+	{
+		v.mask[i] = _mm_set1_epi32((int)rules[i].mask);
+		v.value[i] = _mm_set1_epi32((int)rules[i].value);
+		v.cls[i] = _mm_set1_epi32((int)rules[i].cls);
+	}
+
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m128i *src = (const __m128i *)(data + i * 4);
+		__m128i a = classify_sse2_4(_mm_loadu_si128(src + 0), &v);
+		__m128i b = classify_sse2_4(_mm_loadu_si128(src + 1), &v);
+		__m128i c = classify_sse2_4(_mm_loadu_si128(src + 2), &v);
+		__m128i d = classify_sse2_4(_mm_loadu_si128(src + 3), &v);
+		__m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+		_mm_storeu_si128((__m128i *)(classes + i), packed);
+	}
+	return i;
+}
+#endif
+
+#ifdef CLASSIFY_AVX2
+struct classify_vectors256
+{
+	__m256i mask[CLASSIFY_RULE_COUNT];
+	__m256i value[CLASSIFY_RULE_COUNT];
+	__m256i cls[CLASSIFY_RULE_COUNT];
+};
+
+__attribute__((target("avx2"))) static inline __m256i classify_avx2_8(__m256i words, const classify_vectors256 *v)
+{
+	__m256i result = _mm256_setzero_si256();
+	for (size_t i = 0; i < CLASSIFY_RULE_COUNT; i++)
+	{
+		__m256i hit = _mm256_cmpeq_epi32(_mm256_and_si256(words, v->mask[i]), v->value[i]);
+		result = _mm256_max_epi32(result, _mm256_and_si256(hit, v->cls[i]));
+	}
+	return result;
+}
+
+/* 32 words per iteration. The packs work within 128-bit lanes, which leaves the dwords of the result
+   interleaved as 0,2,4,6,1,3,5,7 and the final permute puts them back in order. */
+__attribute__((target("avx2"))) static size_t classify_avx2(
+	const uint8_t *data, size_t count, uint8_t *classes, const classify_rule *rules)
+{
+	classify_vectors256 v;
+	for (size_t i = 0; i < CLASSIFY_RULE_COUNT; i++)
+	{
+		v.mask[i] = _mm256_set1_epi32((int)rules[i].mask);
+		v.value[i] = _mm256_set1_epi32((int)rules[i].value);
+		v.cls[i] = _mm256_set1_epi32((int)rules[i].cls);
+	}
+
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32)
+	{
+		const __m256i *src = (const __m256i *)(data + i * 4);
+		__m256i a = classify_avx2_8(_mm256_loadu_si256(src + 0), &v);
+		__m256i b = classify_avx2_8(_mm256_loadu_si256(src + 1), &v);
+		__m256i c = classify_avx2_8(_mm256_loadu_si256(src + 2), &v);
+		__m256i d = classify_avx2_8(_mm256_loadu_si256(src + 3), &v);
+		__m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+		_mm256_storeu_si256((__m256i *)(classes + i), _mm256_permutevar8x32_epi32(packed, order));
+	}
+	return i;
+}
+
+/* called from any analysis thread, every thread computes the same answer so a relaxed atomic is enough */
+static bool have_avx2(void)
+{
+	static int cached = -1;
+	int result = __atomic_load_n(&cached, __ATOMIC_RELAXED);
+	if (result < 0)
+	{
+		__builtin_cpu_init();
+		result = __builtin_cpu_supports("avx2") ? 1 : 0;
+		__atomic_store_n(&cached, result, __ATOMIC_RELAXED);
+	}
+	return result != 0;
+}
+#endif
+
+void powerpc_classify_with(const uint8_t *data, size_t count, uint8_t *classes, bool bigendian,
+	ppc_classify_impl_t impl)
+{
+	size_t done = 0;
+#if defined(CLASSIFY_SSE2) || defined(CLASSIFY_AVX2)
+	classify_rule rules[CLASSIFY_RULE_COUNT];
+	/* below one vector iteration there is nothing to set the rules up for */
+	if (impl != PPC_CLASSIFY_SCALAR && count >= 16)
+		get_rules(bigendian, rules);
+#endif
+	switch (impl)
+	{
+#ifdef CLASSIFY_AVX2
+	case PPC_CLASSIFY_AVX2:
+		if (count >= 32 && have_avx2())
+			done = classify_avx2(data, count, classes, rules);
+		break;
+#endif
+#ifdef CLASSIFY_SSE2
+	case PPC_CLASSIFY_SSE2:
+		if (count >= 16)
+			done = classify_sse2(data, count, classes, rules);
+		break;
+#endif
+	default:
+		break;
+	}
+	classify_scalar(data + done * 4, count - done, classes + done, bigendian);
+}
+
+ppc_classify_impl_t powerpc_classify_best_impl(void)
+{
+#ifdef CLASSIFY_AVX2
+	if (have_avx2())
+		return PPC_CLASSIFY_AVX2;
+#endif
+#ifdef CLASSIFY_SSE2
+	return PPC_CLASSIFY_SSE2;
+#else
+	return PPC_CLASSIFY_SCALAR;
+#endif
+}
+
+void powerpc_classify(const uint8_t *data, size_t count, uint8_t *classes, bool bigendian)
+{
+	powerpc_classify_with(data, count, classes, bigendian, powerpc_classify_best_impl());
+}
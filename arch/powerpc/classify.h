@@ -0,0 +1,34 @@
+/* Coarse classification of instruction words, see classify.cpp. This doesn't
+depend on capstone, so prescans and test harnesses can use it on their own. */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* numbered by precedence: where rules overlap the highest class wins */
+enum ppc_word_class_t {
+	PPC_CLASS_OTHER = 0,
+	PPC_CLASS_LOAD_STORE, /* primary opcodes 32-55: lwz through stfdu */
+	PPC_CLASS_ADDIS,      /* addis, lis */
+	PPC_CLASS_BRANCH,     /* b, ba, bc, bca, bclr and bcctr other than blr */
+	PPC_CLASS_CALL,       /* any of those with LK set */
+	PPC_CLASS_RETURN      /* blr (bclr with BO branching always), rfi, rfid */
+};
+
+enum ppc_classify_impl_t {
+	PPC_CLASSIFY_SCALAR = 0,
+	PPC_CLASSIFY_SSE2,
+	PPC_CLASSIFY_AVX2
+};
+
+/* classify `count` words at `data`, writing one ppc_word_class_t per word to `classes` */
+void powerpc_classify(const uint8_t *data, size_t count, uint8_t *classes, bool bigendian);
+
+/* one word, already in host order */
+ppc_word_class_t powerpc_classify_word(uint32_t insword);
+
+/* for tests and benchmarks: force an implementation, falling back to scalar where it's unavailable */
+void powerpc_classify_with(const uint8_t *data, size_t count, uint8_t *classes, bool bigendian,
+	ppc_classify_impl_t impl);
+ppc_classify_impl_t powerpc_classify_best_impl(void);
@@ -19,6 +19,12 @@ architecture plugin picture.
 thread_local csh handle_lil = 0;
 thread_local csh handle_big = 0;
 
+/* cs_disasm() allocates an instruction and its detail on every call, which we'd
+	then copy out and free again, so instead decode into one buffer per handle
+	with cs_disasm_iter() */
+thread_local cs_insn *insn_lil = 0;
+thread_local cs_insn *insn_big = 0;
+
 int DoesQualifyForLocalDisassembly(const uint8_t *data, bool bigendian)
 {
 	uint32_t insword = *(uint32_t *)data;
@@ -188,6 +194,14 @@ powerpc_init(int cs_mode_arg)
 	cs_option(handle_big, CS_OPT_DETAIL, CS_OPT_ON);
 	cs_option(handle_lil, CS_OPT_DETAIL, CS_OPT_ON);
 
+	/* after CS_OPT_DETAIL, so these get a detail buffer too */
+	insn_big = cs_malloc(handle_big);
+	insn_lil = cs_malloc(handle_lil);
+	if(!insn_big || !insn_lil) {
+		MYLOG("ERROR: cs_malloc()\n");
+		goto cleanup;
+	}
+
 	rc = 0;
 	cleanup:
 	if(rc) {
@@ -200,6 +214,16 @@ powerpc_init(int cs_mode_arg)
 extern "C" void
 powerpc_release(void)
 {
+	if(insn_lil) {
+		cs_free(insn_lil, 1);
+		insn_lil = 0;
+	}
+
+	if(insn_big) {
+		cs_free(insn_big, 1);
+		insn_big = 0;
+	}
+
 	if(handle_lil) {
 		cs_close(&handle_lil);
 		handle_lil = 0;
@@ -265,22 +289,32 @@ powerpc_decompose(const uint8_t *data, int size, uint64_t addr, bool lil_end,
 
 	csh handle;
 	struct cs_struct *hand_tmp = 0;
-	cs_insn *insn = 0; /* instruction information
-					cs_disasm() will allocate array of cs_insn here */
+	cs_insn *insn = 0;
+	const uint8_t *code = data;
+	size_t code_size = size;
+	uint64_t code_addr = addr;
 
 	/* which handle to use?
 		BIG end or LITTLE end? */
 	handle = handle_big;
-	if(lil_end) handle = handle_lil;
+	insn = insn_big;
+	if(lil_end) {
+		handle = handle_lil;
+		insn = insn_lil;
+	}
 	res->handle = handle;
 
+	if(!insn) {
+		MYLOG("ERROR: not initialized\n");
+		goto cleanup;
+	}
+
 	hand_tmp = (struct cs_struct *)handle;
 	hand_tmp->mode = (cs_mode)((int)hand_tmp->mode | cs_mode_arg);
 
 	/* call */
-	size_t n = cs_disasm(handle, data, size, addr, 1, &insn);
-	if(n != 1) {
-		MYLOG("ERROR: cs_disasm() returned %" PRIdPTR " (cs_errno:%d)\n", n, cs_errno(handle));
+	if(!cs_disasm_iter(handle, &code, &code_size, &code_addr, insn)) {
+		MYLOG("ERROR: cs_disasm_iter() failed (cs_errno:%d)\n", cs_errno(handle));
 		goto cleanup;
 	}
 
@@ -293,10 +327,6 @@ powerpc_decompose(const uint8_t *data, int size, uint64_t addr, bool lil_end,
 
 	rc = 0;
 	cleanup:
-	if(insn) {
-		cs_free(insn, 1);
-		insn = 0;
-	}
 	return rc;
 }
 
@@ -5,8 +5,11 @@ Tests just the disassembler part (NOT the architecture plugin).
 Provide command line arguments for different cool tests.
 Like `./test repl` to get an interactive disassembler
 Like `./test speed` to get a timed test of instruction decomposition
+Like `./test bench code.bin` to time decomposition over real code, eg: a .text
+section dumped with `objcopy -O binary -j .text`
+Like `./test classify code.bin` to check and time the word classifier
 
-g++ -std=c++11 -O0 -g -I capstone/include -L./build/capstone test_disasm.cpp disassembler.cpp -o test_disasm -lcapstone
+g++ -std=c++11 -O0 -g -I capstone/include -L./build/capstone test_disasm.cpp disassembler.cpp classify.cpp -o test_disasm -lcapstone
 
 ******************************************************************************/
 
@@ -18,6 +21,7 @@ g++ -std=c++11 -O0 -g -I capstone/include -L./build/capstone test_disasm.cpp dis
 #include <unistd.h>
 
 #include "disassembler.h"
+#include "classify.h"
 
 int print_errors = 1;
 int cs_mode_local = 0;
@@ -123,12 +127,179 @@ int disas_instr_word(uint32_t instr_word, char *buf)
 	return rc;
 }
 
+/* decompose and print every word of a file of code, over and over */
+int bench(const char *path, int passes)
+{
+	int rc = -1;
+	FILE *fp = 0;
+	uint8_t *code = 0;
+	long size = 0;
+	size_t nwords = 0, ndisasms = 0;
+	char buf[256];
+	struct timespec t0, t1;
+	double ellapsed;
+
+	fp = fopen(path, "rb");
+	if(!fp) {
+		printf("ERROR: opening %s\n", path);
+		goto cleanup;
+	}
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	nwords = size / 4;
+	code = (uint8_t *)malloc(nwords * 4 + 1);
+	if(!code || fread(code, 4, nwords, fp) != nwords) {
+		printf("ERROR: reading %s\n", path);
+		goto cleanup;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for(int pass=0; pass<passes; ++pass) {
+		ndisasms = 0;
+		for(size_t i=0; i<nwords; ++i) {
+			struct decomp_result res = {0};
+			if(powerpc_decompose(code + i*4, 4, i*4, littleendian, &res, address_size_ == 8, cs_mode_local))
+				continue;
+			if(powerpc_disassemble(&res, buf, sizeof(buf)) == 0)
+				ndisasms++;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	ellapsed = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+	printf("%zu words, %zu disassembled, %d passes in %f seconds\n", nwords, ndisasms, passes, ellapsed);
+	printf("rate: %f instructions per second\n", (double)nwords * passes / ellapsed);
+
+	rc = 0;
+	cleanup:
+	if(code)
+		free(code);
+	if(fp)
+		fclose(fp);
+	return rc;
+}
+
+/* the classes spelled out by field rather than as mask/value rules */
+static int expected_class(uint32_t insword)
+{
+	uint32_t opcode = insword >> 26;
+	uint32_t bo = (insword >> 21) & 0x1f;
+	bool lk = insword & 1;
+
+	if(opcode >= 32 && opcode <= 55)
+		return PPC_CLASS_LOAD_STORE;
+	if(opcode == 15)
+		return PPC_CLASS_ADDIS;
+	if(opcode == 16 || opcode == 18)
+		return lk ? PPC_CLASS_CALL : PPC_CLASS_BRANCH;
+	if(opcode == 19) {
+		switch((insword >> 1) & 0x3ff) {
+			case 16:
+				if(!lk && (bo & 0x14) == 0x14)
+					return PPC_CLASS_RETURN;
+				return lk ? PPC_CLASS_CALL : PPC_CLASS_BRANCH;
+			case 528:
+				return lk ? PPC_CLASS_CALL : PPC_CLASS_BRANCH;
+			case 18: /* rfid */
+			case 50: /* rfi */
+				return lk ? PPC_CLASS_OTHER : PPC_CLASS_RETURN;
+		}
+	}
+	return PPC_CLASS_OTHER;
+}
+
+/* check every implementation against the field decode over a file of code in
+	both byte orders, check load/store words decode, then time each one */
+int classify(const char *path, int passes)
+{
+	int rc = -1;
+	FILE *fp = 0;
+	uint8_t *code = 0, *swapped = 0, *classes = 0;
+	long size = 0;
+	size_t nwords = 0, mismatches = 0, undecoded = 0;
+	static const char *impl_names[] = {"scalar", "sse2", "avx2"};
+
+	fp = fopen(path, "rb");
+	if(!fp) {
+		printf("ERROR: opening %s\n", path);
+		goto cleanup;
+	}
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	nwords = size / 4;
+	code = (uint8_t *)malloc(nwords * 4 + 1);
+	swapped = (uint8_t *)malloc(nwords * 4 + 1);
+	classes = (uint8_t *)malloc(nwords + 1);
+	if(!code || !swapped || !classes || fread(code, 4, nwords, fp) != nwords) {
+		printf("ERROR: reading %s\n", path);
+		goto cleanup;
+	}
+	for(size_t i=0; i<nwords*4; ++i)
+		swapped[i] = code[i ^ 3];
+
+	for(int impl=PPC_CLASSIFY_SCALAR; impl<=PPC_CLASSIFY_AVX2; ++impl) {
+		for(int big=0; big<2; ++big) {
+			const uint8_t *words = big ? swapped : code;
+			memset(classes, 0xff, nwords);
+			powerpc_classify_with(words, nwords, classes, big, (ppc_classify_impl_t)impl);
+			for(size_t i=0; i<nwords; ++i) {
+				uint32_t insword = *(uint32_t *)(code + i*4);
+				int expected = expected_class(insword);
+				if(classes[i] != expected || powerpc_classify_word(insword) != expected) {
+					if(mismatches++ < 16)
+						printf("%s %s endian: %08X classified %d, expected %d\n", impl_names[impl],
+							big ? "big" : "little", insword, classes[i], expected);
+				}
+			}
+		}
+	}
+
+	for(size_t i=0; i<nwords; ++i) {
+		uint32_t insword = *(uint32_t *)(code + i*4);
+		struct decomp_result res = {0};
+		if(powerpc_classify_word(insword) != PPC_CLASS_LOAD_STORE)
+			continue;
+		if(powerpc_decompose((const uint8_t *)&insword, 4, 0, true, &res, address_size_ == 8, cs_mode_local)) {
+			if(undecoded++ < 16)
+				printf("%08X classified as load/store but doesn't decode\n", insword);
+		}
+	}
+
+	printf("%zu words, %zu mismatches, %zu undecoded loads/stores\n", nwords, mismatches, undecoded);
+
+	for(int impl=PPC_CLASSIFY_SCALAR; impl<=PPC_CLASSIFY_AVX2; ++impl) {
+		clock_t t0 = clock();
+		for(int pass=0; pass<passes; ++pass)
+			powerpc_classify_with(code, nwords, classes, !littleendian, (ppc_classify_impl_t)impl);
+		clock_t t1 = clock();
+		double ellapsed = ((double)t1 - t0) / CLOCKS_PER_SEC;
+		printf("%s: %f words per second\n", impl_names[impl], (double)nwords * passes / ellapsed);
+	}
+
+	if(!mismatches && !undecoded)
+		rc = 0;
+	cleanup:
+	if(classes)
+		free(classes);
+	if(swapped)
+		free(swapped);
+	if(code)
+		free(code);
+	if(fp)
+		fclose(fp);
+	return rc;
+}
+
 void usage(const char* av0)
 {
 	printf("usage: %s [-p] [-q] [-s] [-b] repl/send\n", av0);
 	printf("p for ppc_ps, q for ppc_qpx, s for ppc_spe\n");
 	printf("b for big endian interprettation\n");
 	printf("send argument \"repl\" or \"speed\"\n");
+	printf("or \"bench <file> [passes]\" to time a file of code\n");
+	printf("or \"classify <file> [passes]\" to check and time the word classifier\n");
 }
 
 int main(int ac, char **av)
@@ -243,6 +414,24 @@ int main(int ac, char **av)
 			printf("current rate: %f instructions per second\n", (float)ndisasms/ellapsed);
 		}
 	}
+	else if(!strcasecmp(disasm_cmd, "bench")) {
+		if(optind + 1 >= ac) {
+			usage(av[0]);
+			goto cleanup;
+		}
+		int passes = (optind + 2 < ac) ? atoi(av[optind + 2]) : 10;
+		if(bench(av[optind + 1], passes > 0 ? passes : 1))
+			goto cleanup;
+	}
+	else if(!strcasecmp(disasm_cmd, "classify")) {
+		if(optind + 1 >= ac) {
+			usage(av[0]);
+			goto cleanup;
+		}
+		int passes = (optind + 2 < ac) ? atoi(av[optind + 2]) : 10;
+		if(classify(av[optind + 1], passes > 0 ? passes : 1))
+			goto cleanup;
+	}
 	else {
 		printf("ERROR: dunno what to do with \"%s\"\n", av[1]);
 		goto cleanup;
@@ -0,0 +1,326 @@
+//! Coarse classification of instruction parcels.
+//!
+//! Prescans over code (looking for calls, returns, `lui`/`auipc` targets, or just for data that
+//! can't be code) only need to know which of a handful of classes an instruction falls in, not
+//! its operands. Every class is a mask/value compare on the raw bits, so a buffer can be
+//! classified a vector at a time: each rule is an AND and a compare-equal per vector. The rules
+//! overlap (`ret` is also a `jalr`, `jal ra` is also a `jal`), so the per-rule results are
+//! combined with a max and the classes are numbered by precedence.
+//!
+//! With the C extension an instruction can start at any 16-bit parcel, and where the previous
+//! one ends is only known by walking the stream, so every parcel is classified as if an
+//! instruction started there. The caller picks out the parcels that really start one from the
+//! length in their low bits.
+//!
+//! The classes are shallow: an instruction classified as anything but [`InstrClass::Invalid`]
+//! may still fail to decode, except that [`InstrClass::LoadStore`] instructions decode for both
+//! RV32 and RV64. The compressed rules assume the C extension.
+
+/// Numbered by precedence: where rules overlap the highest class wins.
+#[derive(Copy, Clone, Debug, Eq, PartialEq, Ord, PartialOrd)]
+#[repr(u8)]
+pub enum InstrClass {
+    Other = 0,
+    /// lb, lh, lw, lbu, lhu, sb, sh, sw, c.lw, c.sw, c.lwsp, c.swsp
+    LoadStore,
+    /// lui, auipc
+    Upper,
+    /// b*, c.beqz, c.bnez, and jal, jalr, c.j, c.jr not covered below
+    Branch,
+    /// jal, jalr and c.jalr with a link register
+    Call,
+    /// ret, c.jr ra, uret, sret, mret
+    Return,
+    /// the all zero parcel and anything longer than 32 bits, which nothing decodes
+    Invalid,
+}
+
+impl InstrClass {
+    pub fn from_u8(class: u8) -> Option<Self> {
+        use InstrClass::*;
+
+        Some(match class {
+            0 => Other,
+            1 => LoadStore,
+            2 => Upper,
+            3 => Branch,
+            4 => Call,
+            5 => Return,
+            6 => Invalid,
+            _ => return None,
+        })
+    }
+}
+
+/// An implementation of [`classify`], see [`classify_with`].
+#[derive(Copy, Clone, Debug, Eq, PartialEq)]
+pub enum ClassifyImpl {
+    Scalar,
+    Sse2,
+    Avx2,
+}
+
+#[derive(Copy, Clone)]
+struct Rule {
+    mask: u32,
+    value: u32,
+    class: InstrClass,
+}
+
+const fn rule(mask: u32, value: u32, class: InstrClass) -> Rule {
+    Rule { mask, value, class }
+}
+
+// rd (or rs1 for the compressed jumps) != 0, one rule per bit of bits 7-11
+macro_rules! nonzero_reg_rules {
+    ($mask:expr, $value:expr, $class:expr) => {
+        [
+            rule($mask | 0x080, $value | 0x080, $class),
+            rule($mask | 0x100, $value | 0x100, $class),
+            rule($mask | 0x200, $value | 0x200, $class),
+            rule($mask | 0x400, $value | 0x400, $class),
+            rule($mask | 0x800, $value | 0x800, $class),
+        ]
+    };
+}
+
+const fn concat<const N: usize>(parts: &[&[Rule]]) -> [Rule; N] {
+    let mut out = [rule(0, 1, InstrClass::Other); N];
+    let mut n = 0;
+    let mut p = 0;
+    while p < parts.len() {
+        let mut i = 0;
+        while i < parts[p].len() {
+            out[n] = parts[p][i];
+            n += 1;
+            i += 1;
+        }
+        p += 1;
+    }
+    assert!(n == N);
+    out
+}
+
+const RULE_COUNT: usize = 47;
+
+// Compressed rules only look at the low 16 bits and 32-bit rules always include the low two
+// bits, so neither ever matches the other's encodings.
+const RULES: [Rule; RULE_COUNT] = {
+    use InstrClass::*;
+
+    concat(&[
+        &[
+            rule(0x0000001F, 0x0000001F, Invalid),   // 48 bits and longer
+            rule(0x0000FFFF, 0x00000000, Invalid),   // defined illegal
+            rule(0x0000607F, 0x00000003, LoadStore), // lb, lh
+            rule(0x0000707F, 0x00002003, LoadStore), // lw
+            rule(0x0000607F, 0x00004003, LoadStore), // lbu, lhu
+            rule(0x0000607F, 0x00000023, LoadStore), // sb, sh
+            rule(0x0000707F, 0x00002023, LoadStore), // sw
+            rule(0x0000E003, 0x00004000, LoadStore), // c.lw
+            rule(0x0000E003, 0x0000C000, LoadStore), // c.sw
+            rule(0x0000E003, 0x0000C002, LoadStore), // c.swsp
+            rule(0x0000007F, 0x00000037, Upper),     // lui
+            rule(0x0000007F, 0x00000017, Upper),     // auipc
+            rule(0x0000007F, 0x00000063, Branch),    // beq, bne, blt, bge, bltu, bgeu
+            rule(0x0000007F, 0x0000006F, Branch),    // jal
+            rule(0x0000707F, 0x00000067, Branch),    // jalr
+            rule(0x0000E003, 0x0000A001, Branch),    // c.j
+            rule(0x0000C003, 0x0000C001, Branch),    // c.beqz, c.bnez
+            rule(0x000FFFFF, 0x00008067, Return),    // ret
+            rule(0x0000FFFF, 0x00008082, Return),    // c.jr ra
+            rule(0xFFFFFFFF, 0x00200073, Return),    // uret
+            rule(0xFFFFFFFF, 0x10200073, Return),    // sret
+            rule(0xFFFFFFFF, 0x30200073, Return),    // mret
+        ],
+        &nonzero_reg_rules!(0x0000E003, 0x00004002, LoadStore), // c.lwsp
+        &nonzero_reg_rules!(0x0000F07F, 0x00008002, Branch),    // c.jr
+        &nonzero_reg_rules!(0x0000007F, 0x0000006F, Call),      // jal
+        &nonzero_reg_rules!(0x0000707F, 0x00000067, Call),      // jalr
+        &nonzero_reg_rules!(0x0000F07F, 0x00009002, Call),      // c.jalr
+    ])
+};
+
+/// Classifies the instruction whose first parcel is the low half of `word`. For a compressed
+/// instruction the high half is ignored.
+pub fn classify_word(word: u32) -> InstrClass {
+    let mut class = InstrClass::Other;
+    for rule in RULES.iter() {
+        if word & rule.mask == rule.value && rule.class > class {
+            class = rule.class;
+        }
+    }
+    class
+}
+
+#[inline(always)]
+fn load_word(data: &[u8], parcel: usize) -> u32 {
+    let at = parcel * 2;
+    let lo = u16::from_le_bytes([data[at], data[at + 1]]) as u32;
+    let hi = match data.get(at + 2..at + 4) {
+        Some(bytes) => u16::from_le_bytes([bytes[0], bytes[1]]) as u32,
+        None => 0,
+    };
+    lo | hi << 16
+}
+
+fn classify_scalar(data: &[u8], classes: &mut [u8], start: usize, count: usize) {
+    for parcel in start..count {
+        classes[parcel] = classify_word(load_word(data, parcel)) as u8;
+    }
+}
+
+#[cfg(target_arch = "x86_64")]
+mod x86 {
+    use super::{RULES, RULE_COUNT};
+    use std::arch::x86_64::*;
+
+    struct Vectors128 {
+        mask: [__m128i; RULE_COUNT],
+        value: [__m128i; RULE_COUNT],
+        class: [__m128i; RULE_COUNT],
+    }
+
+    #[inline(always)]
+    unsafe fn classify_sse2_4(words: __m128i, v: &Vectors128) -> __m128i {
+        // SSE2 has no 32-bit max, but the classes are small enough that a 16-bit max per half
+        // gives the same result
+        let mut result = _mm_setzero_si128();
+        for i in 0..RULE_COUNT {
+            let hit = _mm_cmpeq_epi32(_mm_and_si128(words, v.mask[i]), v.value[i]);
+            result = _mm_max_epi16(result, _mm_and_si128(hit, v.class[i]));
+        }
+        result
+    }
+
+    // 16 parcels per iteration. Loading at every other parcel, once from the start and once two
+    // bytes in, gives the words of the even and odd parcels. Shifting the odd classes into the
+    // high half of each dword interleaves the two back into parcel order for the narrowing pack.
+    pub(super) unsafe fn classify_sse2(data: &[u8], classes: &mut [u8], count: usize) -> usize {
+        let mut v = Vectors128 {
+            mask: [_mm_setzero_si128(); RULE_COUNT],
+            value: [_mm_setzero_si128(); RULE_COUNT],
+            class: [_mm_setzero_si128(); RULE_COUNT],
+        };
+        for (i, rule) in RULES.iter().enumerate() {
+            v.mask[i] = _mm_set1_epi32(rule.mask as i32);
+            v.value[i] = _mm_set1_epi32(rule.value as i32);
+            v.class[i] = _mm_set1_epi32(rule.class as i32);
+        }
+
+        let mut i = 0;
+        while i + 16 <= count && i * 2 + 34 <= data.len() {
+            let src = data.as_ptr().add(i * 2);
+            let even0 = classify_sse2_4(_mm_loadu_si128(src as *const __m128i), &v);
+            let odd0 = classify_sse2_4(_mm_loadu_si128(src.add(2) as *const __m128i), &v);
+            let even1 = classify_sse2_4(_mm_loadu_si128(src.add(16) as *const __m128i), &v);
+            let odd1 = classify_sse2_4(_mm_loadu_si128(src.add(18) as *const __m128i), &v);
+            let lo = _mm_or_si128(even0, _mm_slli_epi32(odd0, 16));
+            let hi = _mm_or_si128(even1, _mm_slli_epi32(odd1, 16));
+            _mm_storeu_si128(
+                classes.as_mut_ptr().add(i) as *mut __m128i,
+                _mm_packus_epi16(lo, hi),
+            );
+            i += 16;
+        }
+        i
+    }
+
+    struct Vectors256 {
+        mask: [__m256i; RULE_COUNT],
+        value: [__m256i; RULE_COUNT],
+        class: [__m256i; RULE_COUNT],
+    }
+
+    #[inline]
+    #[target_feature(enable = "avx2")]
+    unsafe fn classify_avx2_8(words: __m256i, v: &Vectors256) -> __m256i {
+        let mut result = _mm256_setzero_si256();
+        for i in 0..RULE_COUNT {
+            let hit = _mm256_cmpeq_epi32(_mm256_and_si256(words, v.mask[i]), v.value[i]);
+            result = _mm256_max_epi32(result, _mm256_and_si256(hit, v.class[i]));
+        }
+        result
+    }
+
+    // 32 parcels per iteration, as for SSE2. The pack works within 128-bit lanes, which leaves
+    // the quadwords of the result as parcels 0-7, 16-23, 8-15, 24-31 and the final permute puts
+    // them back in order.
+    #[target_feature(enable = "avx2")]
+    pub(super) unsafe fn classify_avx2(data: &[u8], classes: &mut [u8], count: usize) -> usize {
+        let mut v = Vectors256 {
+            mask: [_mm256_setzero_si256(); RULE_COUNT],
+            value: [_mm256_setzero_si256(); RULE_COUNT],
+            class: [_mm256_setzero_si256(); RULE_COUNT],
+        };
+        for (i, rule) in RULES.iter().enumerate() {
+            v.mask[i] = _mm256_set1_epi32(rule.mask as i32);
+            v.value[i] = _mm256_set1_epi32(rule.value as i32);
+            v.class[i] = _mm256_set1_epi32(rule.class as i32);
+        }
+
+        let mut i = 0;
+        while i + 32 <= count && i * 2 + 66 <= data.len() {
+            let src = data.as_ptr().add(i * 2);
+            let even0 = classify_avx2_8(_mm256_loadu_si256(src as *const __m256i), &v);
+            let odd0 = classify_avx2_8(_mm256_loadu_si256(src.add(2) as *const __m256i), &v);
+            let even1 = classify_avx2_8(_mm256_loadu_si256(src.add(32) as *const __m256i), &v);
+            let odd1 = classify_avx2_8(_mm256_loadu_si256(src.add(34) as *const __m256i), &v);
+            let lo = _mm256_or_si256(even0, _mm256_slli_epi32(odd0, 16));
+            let hi = _mm256_or_si256(even1, _mm256_slli_epi32(odd1, 16));
+            let packed = _mm256_packus_epi16(lo, hi);
+            _mm256_storeu_si256(
+                classes.as_mut_ptr().add(i) as *mut __m256i,
+                _mm256_permute4x64_epi64(packed, 0b11_01_10_00),
+            );
+            i += 32;
+        }
+        i
+    }
+}
+
+/// Classifies `classes.len()` parcels of `data` (or as many as it holds), writing one
+/// [`InstrClass`] per parcel for an instruction starting there. Returns the number classified.
+pub fn classify(data: &[u8], classes: &mut [u8]) -> usize {
+    classify_with(data, classes, best_impl())
+}
+
+/// [`classify`] with a forced implementation, for tests and benchmarks. Falls back to scalar
+/// where it's unavailable.
+pub fn classify_with(data: &[u8], classes: &mut [u8], imp: ClassifyImpl) -> usize {
+    let count = classes.len().min(data.len() / 2);
+    #[allow(unused_mut)]
+    let mut done = 0;
+
+    #[cfg(target_arch = "x86_64")]
+    match imp {
+        // SAFETY: SSE2 is part of x86_64, and AVX2 is checked for
+        ClassifyImpl::Avx2 if is_x86_feature_detected!("avx2") => {
+            done = unsafe { x86::classify_avx2(data, classes, count) };
+        }
+        ClassifyImpl::Sse2 => {
+            done = unsafe { x86::classify_sse2(data, classes, count) };
+        }
+        _ => {}
+    }
+    #[cfg(not(target_arch = "x86_64"))]
+    let _ = imp;
+
+    classify_scalar(data, classes, done, count);
+    count
+}
+
+pub fn best_impl() -> ClassifyImpl {
+    #[cfg(target_arch = "x86_64")]
+    {
+        if is_x86_feature_detected!("avx2") {
+            ClassifyImpl::Avx2
+        } else {
+            ClassifyImpl::Sse2
+        }
+    }
+    #[cfg(not(target_arch = "x86_64"))]
+    {
+        ClassifyImpl::Scalar
+    }
+}
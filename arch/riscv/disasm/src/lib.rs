@@ -12,6 +12,8 @@ use std::mem;
 
 use byteorder::{ByteOrder, LittleEndian};
 
+pub mod classify;
+
 #[derive(Copy, Clone, Debug, Eq, PartialEq)]
 pub enum Error {
     TooShort,
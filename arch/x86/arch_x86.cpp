@@ -430,6 +430,23 @@ bool X86CommonArchitecture::Decode(const uint8_t* data, size_t len, xed_decoded_
 	}
 }
 
+bool X86CommonArchitecture::DecodeAt(const uint8_t* data, uint64_t addr, size_t len, xed_decoded_inst_t* xedd)
+{
+	// Info, text and IL for an instruction are requested separately, share one decode between them
+	bool ok = DecodeCached<xed_decoded_inst_t, XED_MAX_INSTRUCTION_BYTES>(data, addr, len, *xedd,
+		[&](xed_decoded_inst_t& result) -> size_t {
+			if (!Decode(data, len, &result))
+				return 0;
+			return xed_decoded_inst_get_length(&result);
+		});
+	if (!ok)
+		return false;
+
+	// A cached instruction still points at the bytes it was originally decoded from
+	xedd->_byte_array._dec = data;
+	return true;
+}
+
 size_t X86CommonArchitecture::GetAddressSizeBits()  const
 {
 	return GetAddressSize() * 8;
@@ -545,66 +562,66 @@ BNRegisterInfo X86CommonArchitecture::RegisterInfo(xed_reg_enum_t fullWidthReg,
 	return result;
 }
 
-void X86CommonArchitecture::GetAddressSizeToken(const short bytes, vector<InstructionTextToken>& result, const bool lowerCase)
+void X86CommonArchitecture::GetAddressSizeToken(const short bytes, InstructionTextTokenSink& result, const bool lowerCase)
 {
 	// Size
-	result.emplace_back(BeginMemoryOperandToken, "");
+	result.AddToken(BeginMemoryOperandToken, "");
 	switch (bytes)
 	{
 	case 1:
 		if (lowerCase)
-			result.emplace_back(KeywordToken, "byte ");
+			result.AddToken(KeywordToken, "byte ");
 		else
-			result.emplace_back(KeywordToken, "BYTE ");
+			result.AddToken(KeywordToken, "BYTE ");
 		break;
 	case 2:
 		if (lowerCase)
-			result.emplace_back(KeywordToken, "word ");
+			result.AddToken(KeywordToken, "word ");
 		else
-			result.emplace_back(KeywordToken, "WORD ");
+			result.AddToken(KeywordToken, "WORD ");
 		break;
 	case 4:
 		if (lowerCase)
-			result.emplace_back(KeywordToken, "dword ");
+			result.AddToken(KeywordToken, "dword ");
 		else
-			result.emplace_back(KeywordToken, "DWORD ");
+			result.AddToken(KeywordToken, "DWORD ");
 		break;
 	case 8:
 		if (lowerCase)
-			result.emplace_back(KeywordToken, "qword ");
+			result.AddToken(KeywordToken, "qword ");
 		else
-			result.emplace_back(KeywordToken, "QWORD ");
+			result.AddToken(KeywordToken, "QWORD ");
 		break;
 	case 10:
 		if (lowerCase)
-			result.emplace_back(KeywordToken, "tword ");
+			result.AddToken(KeywordToken, "tword ");
 		else
-			result.emplace_back(KeywordToken, "TWORD ");
+			result.AddToken(KeywordToken, "TWORD ");
 		break;
 	case 16:
 		if (lowerCase)
-			result.emplace_back(KeywordToken, "xmmword ");
+			result.AddToken(KeywordToken, "xmmword ");
 		else
-			result.emplace_back(KeywordToken, "XMMWORD ");
+			result.AddToken(KeywordToken, "XMMWORD ");
 		break;
 	case 32:
 		if (lowerCase)
-			result.emplace_back(KeywordToken, "ymmword ");
+			result.AddToken(KeywordToken, "ymmword ");
 		else
-			result.emplace_back(KeywordToken, "YMMWORD ");
+			result.AddToken(KeywordToken, "YMMWORD ");
 		break;
 	case 64:
 		if (lowerCase)
-			result.emplace_back(KeywordToken, "zmmword ");
+			result.AddToken(KeywordToken, "zmmword ");
 		else
-			result.emplace_back(KeywordToken, "ZMMWORD ");
+			result.AddToken(KeywordToken, "ZMMWORD ");
 		break;
 	default:
 		break;
 	}
 }
 
-unsigned short X86CommonArchitecture::GetInstructionOpcode(const xed_decoded_inst_t* const xedd, const xed_operand_values_t* const ov, vector<InstructionTextToken>& result) const
+unsigned short X86CommonArchitecture::GetInstructionOpcode(const xed_decoded_inst_t* const xedd, const xed_operand_values_t* const ov, InstructionTextTokenSink& result) const
 {
 	string opcode = "";
 	if (xed_decoded_inst_has_mpx_prefix(xedd))
@@ -735,22 +752,22 @@ unsigned short X86CommonArchitecture::GetInstructionOpcode(const xed_decoded_ins
 		for (char& c : opcode)
 			c = toupper(c);
 
-	result.emplace_back(InstructionToken, opcode);
+	result.AddToken(InstructionToken, opcode);
 
 	return (unsigned short)opcode.length();
 }
 
-void X86CommonArchitecture::GetInstructionPadding(const unsigned int instruction_name_length, vector<InstructionTextToken>& result) const
+void X86CommonArchitecture::GetInstructionPadding(const unsigned int instruction_name_length, InstructionTextTokenSink& result) const
 {
 	string padding = "";
 	const short min = 7 < instruction_name_length ? 7 : instruction_name_length;
 	for (unsigned short delim = 0; delim < (8 - min); ++delim)
 		padding += ' ';
-	result.emplace_back(TextToken, padding);
+	result.AddToken(TextToken, padding);
 }
 
 // (in theory) Exactly how XED wants the world to see x86
-void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t len, const xed_operand_values_t* const ov, const xed_inst_t* const xi, vector<InstructionTextToken>& result) const
+void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t len, const xed_operand_values_t* const ov, const xed_inst_t* const xi, InstructionTextTokenSink& result) const
 {
 	xed_reg_enum_t extra_index_operand = XED_REG_INVALID;
 
@@ -767,7 +784,7 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				(op_name == XED_OPERAND_MEM0 || op_name == XED_OPERAND_MEM1))
 			{
 				if (op_name == XED_OPERAND_MEM1)
-					result.emplace_back(OperandSeparatorToken, m_disassembly_options.separator);
+					result.AddToken(OperandSeparatorToken, m_disassembly_options.separator);
 			}
 			else
 				continue;
@@ -800,7 +817,7 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 			if (m_disassembly_options.lowerCase)
 				for (char& c : reg)
 					c = tolower(c);
-			result.emplace_back(RegisterToken, reg);
+			result.AddToken(RegisterToken, reg);
 			break;
 		}
 		case XED_OPERAND_AGEN:
@@ -809,10 +826,10 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 			GetAddressSizeToken(xed_decoded_inst_operand_length_bits(xedd, opIndex) / 8, result, m_disassembly_options.lowerCase);
 
 			if (m_disassembly_options.lowerCase)
-				result.emplace_back(KeywordToken, "ptr ");
+				result.AddToken(KeywordToken, "ptr ");
 			else
-				result.emplace_back(KeywordToken, "PTR ");
-			result.emplace_back(BraceToken, "[");
+				result.AddToken(KeywordToken, "PTR ");
+			result.AddToken(BraceToken, "[");
 
 			// Segment
 			const xed_reg_enum_t seg = xed_decoded_inst_get_seg_reg(xedd, 0);
@@ -823,8 +840,8 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				if (m_disassembly_options.lowerCase)
 					for (char& c : seg_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, seg_str);
-				result.emplace_back(OperationToken, ":");
+				result.AddToken(RegisterToken, seg_str);
+				result.AddToken(OperationToken, ":");
 			}
 
 			bool started = false;
@@ -838,7 +855,7 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				if (m_disassembly_options.lowerCase)
 					for (char& c : base_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, base_str);
+				result.AddToken(RegisterToken, base_str);
 				started = true;
 			}
 			else if ((base == XED_REG_RIP) || (base == XED_REG_EIP) || (base == XED_REG_IP))
@@ -854,10 +871,10 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				else
 					sstream << "0x" << hex << uppercase << disp;
 
-				result.emplace_back(CodeRelativeAddressToken, sstream.str(), disp, GetAddressSize());
+				result.AddToken(CodeRelativeAddressToken, sstream.str(), disp, GetAddressSize());
 
-				result.emplace_back(EndMemoryOperandToken, "");
-				result.emplace_back(BraceToken, "]");
+				result.AddToken(EndMemoryOperandToken, "");
+				result.AddToken(BraceToken, "]");
 				break;
 			}
 
@@ -873,7 +890,7 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				else  // normal path
 				{
 					if (started)
-						result.emplace_back(OperationToken, "+");
+						result.AddToken(OperationToken, "+");
 					started = true;
 
 					string index_str(xed_reg_enum_t2str(index));
@@ -881,15 +898,15 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 						for (char& c : index_str)
 							c = tolower(c);
 
-					result.emplace_back(RegisterToken, index_str);
+					result.AddToken(RegisterToken, index_str);
 
 					const unsigned int scale = xed_decoded_inst_get_scale(xedd, 0);
 					if (scale != 1)
 					{
-						result.emplace_back(OperationToken, "*");
+						result.AddToken(OperationToken, "*");
 						stringstream sstream;
 						sstream << scale;
-						result.emplace_back(IntegerToken, sstream.str(), scale, 1);
+						result.AddToken(IntegerToken, sstream.str(), scale, 1);
 					}
 				}
 			}
@@ -910,11 +927,11 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				{
 					if (disp < 0)
 					{
-						result.emplace_back(OperationToken, "-");
+						result.AddToken(OperationToken, "-");
 						disp = -disp;
 					}
 					else
-						result.emplace_back(OperationToken, "+");
+						result.AddToken(OperationToken, "+");
 
 					if (disp_bytes == 2)
 						sstream << (uint16_t)disp;
@@ -924,25 +941,25 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 						sstream << (uint64_t)disp;
 					else
 						sstream << disp;
-					result.emplace_back(IntegerToken, sstream.str(), disp, disp_bytes);
+					result.AddToken(IntegerToken, sstream.str(), disp, disp_bytes);
 				}
 				else
 				{
 					sstream << disp;
 
 					if (validSegment)
-						result.emplace_back(IntegerToken, sstream.str(), disp, GetAddressSize());
+						result.AddToken(IntegerToken, sstream.str(), disp, GetAddressSize());
 					else
-						result.emplace_back(PossibleAddressToken, sstream.str(), disp, GetAddressSize());
+						result.AddToken(PossibleAddressToken, sstream.str(), disp, GetAddressSize());
 				}
 			}
 			else if (xed_operand_values_has_memory_displacement(ov) &&
 				((disp == 0) && (!started)))
 			{
-				result.emplace_back(IntegerToken, "0x0", disp, GetAddressSize());
+				result.AddToken(IntegerToken, "0x0", disp, GetAddressSize());
 			}
-			result.emplace_back(EndMemoryOperandToken, "");
-			result.emplace_back(BraceToken, "]");
+			result.AddToken(EndMemoryOperandToken, "");
+			result.AddToken(BraceToken, "]");
 
 			break;
 		}
@@ -951,9 +968,9 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 			GetAddressSizeToken(xed_decoded_inst_operand_length_bits(xedd, opIndex) / 8, result, m_disassembly_options.lowerCase);
 
 			if (m_disassembly_options.lowerCase)
-				result.emplace_back(KeywordToken, "ptr ");
+				result.AddToken(KeywordToken, "ptr ");
 			else
-				result.emplace_back(KeywordToken, "PTR ");
+				result.AddToken(KeywordToken, "PTR ");
 
 			// Segment
 			const xed_reg_enum_t seg = xed_decoded_inst_get_seg_reg(xedd, 1);
@@ -963,12 +980,12 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				if (m_disassembly_options.lowerCase)
 					for (char& c : seg_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, seg_str);
+				result.AddToken(RegisterToken, seg_str);
 
-				result.emplace_back(OperationToken, ":");
+				result.AddToken(OperationToken, ":");
 			}
 
-			result.emplace_back(BraceToken, "[");
+			result.AddToken(BraceToken, "[");
 			const xed_reg_enum_t base = xed_decoded_inst_get_base_reg(xedd, 1);
 			if (base != XED_REG_INVALID)
 			{
@@ -976,10 +993,10 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				if (m_disassembly_options.lowerCase)
 					for (char& c : base_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, base_str);
+				result.AddToken(RegisterToken, base_str);
 			}
-			result.emplace_back(EndMemoryOperandToken, "");
-			result.emplace_back(BraceToken, "]");
+			result.AddToken(EndMemoryOperandToken, "");
+			result.AddToken(BraceToken, "]");
 
 			break;
 		}
@@ -1021,18 +1038,18 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				}
 
 				if (immediateSize == addrSize)
-					result.emplace_back(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
 				else
-					result.emplace_back(IntegerToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(IntegerToken, sstream.str(), immediateValue, immediateSize);
 			}
 			else
 			{
 				const uint64_t immediateValue = xed_decoded_inst_get_unsigned_immediate(xedd);
 				sstream << immediateValue;
 				if (immediateSize == addrSize)
-					result.emplace_back(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
 				else
-					result.emplace_back(IntegerToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(IntegerToken, sstream.str(), immediateValue, immediateSize);
 			}
 			break;
 		}
@@ -1046,7 +1063,7 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				sstream << uppercase;
 
 			sstream << (uint16_t)xed_decoded_inst_get_second_immediate(xedd);
-			result.emplace_back(IntegerToken, sstream.str(), xed_decoded_inst_get_second_immediate(xedd), 1);
+			result.AddToken(IntegerToken, sstream.str(), xed_decoded_inst_get_second_immediate(xedd), 1);
 			break;
 		}
 		case XED_OPERAND_PTR:  // TODO...remove?
@@ -1059,7 +1076,7 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				sstream << uppercase;
 
 			sstream << xed_decoded_inst_get_branch_displacement(xedd);
-			result.emplace_back(PossibleAddressToken, sstream.str(), xed_decoded_inst_get_branch_displacement(xedd), 8);
+			result.AddToken(PossibleAddressToken, sstream.str(), xed_decoded_inst_get_branch_displacement(xedd), 8);
 			break;
 		}
 		case XED_OPERAND_RELBR:
@@ -1074,12 +1091,12 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 				sstream << uppercase;
 
 			sstream << relbr;
-			result.emplace_back(CodeRelativeAddressToken, sstream.str(), relbr, 8);
+			result.AddToken(CodeRelativeAddressToken, sstream.str(), relbr, 8);
 			break;
 		}
 		default:
 		{
-			result.emplace_back(KeywordToken, "unimplemented");
+			result.AddToken(KeywordToken, "unimplemented");
 		}  // default case of outer switch
 		}  // outer switch
 
@@ -1087,22 +1104,22 @@ void X86CommonArchitecture::GetOperandTextIntel(const xed_decoded_inst_t* const
 		if ((opIndex != xed_inst_noperands(xi)-1) &&
 			((xed_operand_operand_visibility(xed_inst_operand(xi, opIndex+1)) == XED_OPVIS_EXPLICIT) ||
 			(xed_operand_operand_visibility(xed_inst_operand(xi, opIndex+1)) == XED_OPVIS_IMPLICIT)))
-				result.emplace_back(OperandSeparatorToken, m_disassembly_options.separator);
+				result.AddToken(OperandSeparatorToken, m_disassembly_options.separator);
 	}
 
 	if (extra_index_operand != XED_REG_INVALID)
 	{
-		result.emplace_back(OperandSeparatorToken, m_disassembly_options.separator);
+		result.AddToken(OperandSeparatorToken, m_disassembly_options.separator);
 		string reg = xed_reg_enum_t2str(extra_index_operand);
 		if (m_disassembly_options.lowerCase)
 			for (char& c : reg)
 				c = tolower(c);
-		result.emplace_back(RegisterToken, reg);
+		result.AddToken(RegisterToken, reg);
 	}
 }
 
 // The syntax used by asmx86, that users are used to (also the only one that should be garenteed to roundtrip with asm)
-void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t len, const xed_operand_values_t* const ov, const xed_inst_t* const xi, vector<InstructionTextToken>& result) const
+void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t len, const xed_operand_values_t* const ov, const xed_inst_t* const xi, InstructionTextTokenSink& result) const
 {
 	xed_reg_enum_t extra_index_operand = XED_REG_INVALID;
 
@@ -1119,7 +1136,7 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				(op_name == XED_OPERAND_MEM0 || op_name == XED_OPERAND_MEM1))
 			{
 				if (op_name == XED_OPERAND_MEM1)
-					result.emplace_back(OperandSeparatorToken, m_disassembly_options.separator);
+					result.AddToken(OperandSeparatorToken, m_disassembly_options.separator);
 			}
 			else
 				continue;
@@ -1162,7 +1179,7 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				for (char& c : reg)
 					c = tolower(c);
 
-			result.emplace_back(RegisterToken, reg);
+			result.AddToken(RegisterToken, reg);
 
 			// handle the {z} modifier
 			if (XED_REG_K1 <= xedReg && xedReg <= XED_REG_K7)
@@ -1170,9 +1187,9 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				if(xed_decoded_inst_zeroing(xedd))
 				{
 					if (m_disassembly_options.lowerCase)
-						result.emplace_back(OperationToken, " {z}");
+						result.AddToken(OperationToken, " {z}");
 					else
-						result.emplace_back(OperationToken, " {Z}");
+						result.AddToken(OperationToken, " {Z}");
 				}
 			}
 
@@ -1185,7 +1202,7 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 			if (xed_inst_iclass(xi) != XED_ICLASS_LEA)
 				GetAddressSizeToken(xed_decoded_inst_operand_length_bits(xedd, opIndex) / 8, result, m_disassembly_options.lowerCase);
 
-			result.emplace_back(BraceToken, "[");
+			result.AddToken(BraceToken, "[");
 			// Segment
 			const xed_reg_enum_t seg = xed_decoded_inst_get_seg_reg(xedd, 0);
 			const bool validSegment = (seg != XED_REG_INVALID && !xed_operand_values_using_default_segment(ov, 0));
@@ -1195,8 +1212,8 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				if (m_disassembly_options.lowerCase)
 					for (char& c : seg_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, seg_str);
-				result.emplace_back(OperationToken, ":");
+				result.AddToken(RegisterToken, seg_str);
+				result.AddToken(OperationToken, ":");
 			}
 
 			bool started = false;
@@ -1210,15 +1227,15 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				if (m_disassembly_options.lowerCase)
 					for (char& c : base_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, base_str);
+				result.AddToken(RegisterToken, base_str);
 				started = true;
 			}
 			else if ((base == XED_REG_RIP) || (base == XED_REG_EIP) || (base == XED_REG_IP))
 			{
 				if (m_disassembly_options.lowerCase)
-					result.emplace_back(KeywordToken, "rel ");
+					result.AddToken(KeywordToken, "rel ");
 				else
-					result.emplace_back(KeywordToken, "REL ");
+					result.AddToken(KeywordToken, "REL ");
 
 				if (xed_operand_values_has_memory_displacement(ov))
 					disp += addr + len;
@@ -1231,10 +1248,10 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				else
 					sstream << "0x" << hex << uppercase << disp;
 
-				result.emplace_back(CodeRelativeAddressToken, sstream.str(), disp, GetAddressSize());
+				result.AddToken(CodeRelativeAddressToken, sstream.str(), disp, GetAddressSize());
 
-				result.emplace_back(EndMemoryOperandToken, "");
-				result.emplace_back(BraceToken, "]");
+				result.AddToken(EndMemoryOperandToken, "");
+				result.AddToken(BraceToken, "]");
 				break;
 			}
 
@@ -1250,7 +1267,7 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				else  // normal path
 				{
 					if (started)
-						result.emplace_back(OperationToken, "+");
+						result.AddToken(OperationToken, "+");
 					started = true;
 
 					string index_str(xed_reg_enum_t2str(index));
@@ -1258,15 +1275,15 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 						for (char& c : index_str)
 							c = tolower(c);
 
-					result.emplace_back(RegisterToken, index_str);
+					result.AddToken(RegisterToken, index_str);
 
 					const unsigned int scale = xed_decoded_inst_get_scale(xedd, 0);
 					if (scale != 1)
 					{
-						result.emplace_back(OperationToken, "*");
+						result.AddToken(OperationToken, "*");
 						stringstream sstream;
 						sstream << scale;
-						result.emplace_back(IntegerToken, sstream.str(), scale, 1);
+						result.AddToken(IntegerToken, sstream.str(), scale, 1);
 					}
 				}
 			}
@@ -1287,11 +1304,11 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				{
 					if (disp < 0)
 					{
-						result.emplace_back(OperationToken, "-");
+						result.AddToken(OperationToken, "-");
 						disp = -disp;
 					}
 					else
-						result.emplace_back(OperationToken, "+");
+						result.AddToken(OperationToken, "+");
 
 					if (disp_bytes == 2)
 						sstream << (uint16_t)disp;
@@ -1301,26 +1318,26 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 						sstream << (uint64_t)disp;
 					else
 						sstream << disp;
-					result.emplace_back(IntegerToken, sstream.str(), disp, disp_bytes);
+					result.AddToken(IntegerToken, sstream.str(), disp, disp_bytes);
 				}
 				else
 				{
 					sstream << disp;
 
 					if (validSegment)
-						result.emplace_back(IntegerToken, sstream.str(), disp, GetAddressSize());
+						result.AddToken(IntegerToken, sstream.str(), disp, GetAddressSize());
 					else
-						result.emplace_back(PossibleAddressToken, sstream.str(), disp, GetAddressSize());
+						result.AddToken(PossibleAddressToken, sstream.str(), disp, GetAddressSize());
 				}
 			}
 			else if (xed_operand_values_has_memory_displacement(ov) &&
 				((disp == 0) && (!started)))
 			{
-				result.emplace_back(IntegerToken, "0x0", disp, GetAddressSize());
+				result.AddToken(IntegerToken, "0x0", disp, GetAddressSize());
 			}
 
-			result.emplace_back(EndMemoryOperandToken, "");
-			result.emplace_back(BraceToken, "]");
+			result.AddToken(EndMemoryOperandToken, "");
+			result.AddToken(BraceToken, "]");
 
 			break;
 		}
@@ -1336,12 +1353,12 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				if (m_disassembly_options.lowerCase)
 					for (char& c : seg_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, seg_str);
+				result.AddToken(RegisterToken, seg_str);
 
-				result.emplace_back(OperationToken, ":");
+				result.AddToken(OperationToken, ":");
 			}
 
-			result.emplace_back(BraceToken, "[");
+			result.AddToken(BraceToken, "[");
 			const xed_reg_enum_t base = xed_decoded_inst_get_base_reg(xedd, 1);
 			if (base != XED_REG_INVALID)
 			{
@@ -1349,10 +1366,10 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				if (m_disassembly_options.lowerCase)
 					for (char& c : base_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, base_str);
+				result.AddToken(RegisterToken, base_str);
 			}
-			result.emplace_back(EndMemoryOperandToken, "");
-			result.emplace_back(BraceToken, "]");
+			result.AddToken(EndMemoryOperandToken, "");
+			result.AddToken(BraceToken, "]");
 
 			break;
 		}
@@ -1394,18 +1411,18 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				}
 
 				if (immediateSize == addrSize)
-					result.emplace_back(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
 				else
-					result.emplace_back(IntegerToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(IntegerToken, sstream.str(), immediateValue, immediateSize);
 			}
 			else
 			{
 				const uint64_t immediateValue = xed_decoded_inst_get_unsigned_immediate(xedd);
 				sstream << immediateValue;
 				if (immediateSize == addrSize)
-					result.emplace_back(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
 				else
-					result.emplace_back(IntegerToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(IntegerToken, sstream.str(), immediateValue, immediateSize);
 			}
 			break;
 		}
@@ -1419,7 +1436,7 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				sstream << uppercase;
 
 			sstream << (uint16_t)xed_decoded_inst_get_second_immediate(xedd);
-			result.emplace_back(IntegerToken, sstream.str(), xed_decoded_inst_get_second_immediate(xedd), 1);
+			result.AddToken(IntegerToken, sstream.str(), xed_decoded_inst_get_second_immediate(xedd), 1);
 			break;
 		}
 		case XED_OPERAND_PTR:
@@ -1432,7 +1449,7 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				sstream << uppercase;
 
 			sstream << xed_decoded_inst_get_branch_displacement(xedd);
-			result.emplace_back(PossibleAddressToken, sstream.str(), xed_decoded_inst_get_branch_displacement(xedd), 8);
+			result.AddToken(PossibleAddressToken, sstream.str(), xed_decoded_inst_get_branch_displacement(xedd), 8);
 			break;
 		}
 		case XED_OPERAND_RELBR:
@@ -1443,7 +1460,7 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 			if ((xed_decoded_inst_get_iclass(xedd) == XED_ICLASS_CALL_NEAR) && (relbr == (int64_t)(addr + xed_decoded_inst_get_length(xedd))))
 			{
 				sstream << "$+" << xed_decoded_inst_get_length(xedd);
-				result.emplace_back(OperationToken, sstream.str());
+				result.AddToken(OperationToken, sstream.str());
 				break;
 			}
 
@@ -1454,15 +1471,15 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 				sstream << uppercase;
 
 			sstream << relbr;
-			result.emplace_back(CodeRelativeAddressToken, sstream.str(), relbr, 8);
+			result.AddToken(CodeRelativeAddressToken, sstream.str(), relbr, 8);
 			break;
 		}
 		default:
 		{
 			if (m_disassembly_options.lowerCase)
-				result.emplace_back(KeywordToken, "unimplemented ");
+				result.AddToken(KeywordToken, "unimplemented ");
 			else
-				result.emplace_back(KeywordToken, "UNIMPLEMENTED ");
+				result.AddToken(KeywordToken, "UNIMPLEMENTED ");
 		}  // default case of outer switch
 		}  // outer switch
 
@@ -1470,21 +1487,21 @@ void X86CommonArchitecture::GetOperandTextBNIntel(const xed_decoded_inst_t* cons
 		if ((opIndex != xed_inst_noperands(xi)-1) &&
 			((xed_operand_operand_visibility(xed_inst_operand(xi, opIndex+1)) == XED_OPVIS_EXPLICIT) ||
 				(xed_operand_operand_visibility(xed_inst_operand(xi, opIndex+1)) == XED_OPVIS_IMPLICIT)))
-				result.emplace_back(OperandSeparatorToken, m_disassembly_options.separator);
+				result.AddToken(OperandSeparatorToken, m_disassembly_options.separator);
 	}
 
 	if (extra_index_operand != XED_REG_INVALID)
 	{
-		result.emplace_back(OperandSeparatorToken, m_disassembly_options.separator);
+		result.AddToken(OperandSeparatorToken, m_disassembly_options.separator);
 		string reg = xed_reg_enum_t2str(extra_index_operand);
 		if (m_disassembly_options.lowerCase)
 			for (char& c : reg)
 				c = tolower(c);
-		result.emplace_back(RegisterToken, reg);
+		result.AddToken(RegisterToken, reg);
 	}
 }
 
-void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t len, const xed_operand_values_t* const ov, const xed_inst_t* const xi, vector<InstructionTextToken>& result) const
+void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t len, const xed_operand_values_t* const ov, const xed_inst_t* const xi, InstructionTextTokenSink& result) const
 {
 	unsigned i,j;
 	unsigned noperands = xed_inst_noperands(xi);
@@ -1522,7 +1539,7 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				(op_name == XED_OPERAND_MEM0 || op_name == XED_OPERAND_MEM1))
 			{
 				if (op_name == XED_OPERAND_MEM1)
-					result.emplace_back(OperandSeparatorToken, m_disassembly_options.separator);
+					result.AddToken(OperandSeparatorToken, m_disassembly_options.separator);
 			}
 			else
 			{
@@ -1557,7 +1574,7 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 			if (m_disassembly_options.lowerCase)
 				for (char& c : reg)
 					c = tolower(c);
-			result.emplace_back(RegisterToken, reg);
+			result.AddToken(RegisterToken, reg);
 			break;
 		}
 		case XED_OPERAND_AGEN:
@@ -1566,10 +1583,10 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 			GetAddressSizeToken(xed_decoded_inst_operand_length_bits(xedd, i) / 8, result, m_disassembly_options.lowerCase);
 
 			if (m_disassembly_options.lowerCase)
-				result.emplace_back(KeywordToken, "ptr ");
+				result.AddToken(KeywordToken, "ptr ");
 			else
-				result.emplace_back(KeywordToken, "PTR ");
-			result.emplace_back(BraceToken, "[");
+				result.AddToken(KeywordToken, "PTR ");
+			result.AddToken(BraceToken, "[");
 
 			// Segment
 			const xed_reg_enum_t seg = xed_decoded_inst_get_seg_reg(xedd, 0);
@@ -1581,8 +1598,8 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				if (m_disassembly_options.lowerCase)
 					for (char& c : seg_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, seg_str);
-				result.emplace_back(OperationToken, ":");
+				result.AddToken(RegisterToken, seg_str);
+				result.AddToken(OperationToken, ":");
 			}
 
 			bool started = false;
@@ -1597,7 +1614,7 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				if (m_disassembly_options.lowerCase)
 					for (char& c : base_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, base_str);
+				result.AddToken(RegisterToken, base_str);
 				started = true;
 			}
 			else if ((base == XED_REG_RIP) || (base == XED_REG_EIP) || (base == XED_REG_IP))
@@ -1613,10 +1630,10 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				else
 					sstream << "0x" << hex << uppercase << disp;
 
-				result.emplace_back(CodeRelativeAddressToken, sstream.str(), disp, GetAddressSize());
+				result.AddToken(CodeRelativeAddressToken, sstream.str(), disp, GetAddressSize());
 
-				result.emplace_back(EndMemoryOperandToken, "");
-				result.emplace_back(BraceToken, "]");
+				result.AddToken(EndMemoryOperandToken, "");
+				result.AddToken(BraceToken, "]");
 				break;
 			}
 
@@ -1624,7 +1641,7 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 			if (index != XED_REG_INVALID)
 			{
 				if (started)
-					result.emplace_back(OperationToken, "+");
+					result.AddToken(OperationToken, "+");
 				started = true;
 
 				string index_str(xed_reg_enum_t2str(index));
@@ -1633,15 +1650,15 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 					for (char& c : index_str)
 						c = tolower(c);
 
-				result.emplace_back(RegisterToken, index_str);
+				result.AddToken(RegisterToken, index_str);
 
 				const unsigned int scale = xed_decoded_inst_get_scale(xedd, 0);
 				if (scale != 1)
 				{
-					result.emplace_back(OperationToken, "*");
+					result.AddToken(OperationToken, "*");
 					stringstream sstream;
 					sstream << scale;
-					result.emplace_back(IntegerToken, sstream.str(), scale, 1);
+					result.AddToken(IntegerToken, sstream.str(), scale, 1);
 				}
 			}
 
@@ -1661,11 +1678,11 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				{
 					if (disp < 0)
 					{
-						result.emplace_back(OperationToken, "-");
+						result.AddToken(OperationToken, "-");
 						disp = -disp;
 					}
 					else
-						result.emplace_back(OperationToken, "+");
+						result.AddToken(OperationToken, "+");
 
 					if (disp_bytes == 2)
 						sstream << (uint16_t)disp;
@@ -1675,25 +1692,25 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 						sstream << (uint64_t)disp;
 					else
 						sstream << disp;
-					result.emplace_back(IntegerToken, sstream.str(), disp, disp_bytes);
+					result.AddToken(IntegerToken, sstream.str(), disp, disp_bytes);
 				}
 				else
 				{
 					sstream << disp;
 
 					if (validSegment)
-						result.emplace_back(IntegerToken, sstream.str(), disp, GetAddressSize());
+						result.AddToken(IntegerToken, sstream.str(), disp, GetAddressSize());
 					else
-						result.emplace_back(PossibleAddressToken, sstream.str(), disp, GetAddressSize());
+						result.AddToken(PossibleAddressToken, sstream.str(), disp, GetAddressSize());
 				}
 			}
 			else if (xed_operand_values_has_memory_displacement(ov) &&
 				((disp == 0) && (!started)))
 			{
-				result.emplace_back(IntegerToken, "0x0", disp, GetAddressSize());
+				result.AddToken(IntegerToken, "0x0", disp, GetAddressSize());
 			}
-			result.emplace_back(EndMemoryOperandToken, "");
-			result.emplace_back(BraceToken, "]");
+			result.AddToken(EndMemoryOperandToken, "");
+			result.AddToken(BraceToken, "]");
 
 			break;
 		}
@@ -1703,9 +1720,9 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 			GetAddressSizeToken(xed_decoded_inst_operand_length_bits(xedd, i) / 8, result, m_disassembly_options.lowerCase);
 
 			if (m_disassembly_options.lowerCase)
-				result.emplace_back(KeywordToken, "ptr ");
+				result.AddToken(KeywordToken, "ptr ");
 			else
-				result.emplace_back(KeywordToken, "PTR ");
+				result.AddToken(KeywordToken, "PTR ");
 
 			// Segment
 			const xed_reg_enum_t seg = xed_decoded_inst_get_seg_reg(xedd, 1);
@@ -1716,12 +1733,12 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				if (m_disassembly_options.lowerCase)
 					for (char& c : seg_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, seg_str);
+				result.AddToken(RegisterToken, seg_str);
 
-				result.emplace_back(OperationToken, ":");
+				result.AddToken(OperationToken, ":");
 			}
 
-			result.emplace_back(BraceToken, "[");
+			result.AddToken(BraceToken, "[");
 			const xed_reg_enum_t base = xed_decoded_inst_get_base_reg(xedd, 1);
 			if (base != XED_REG_INVALID)
 			{
@@ -1730,10 +1747,10 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				if (m_disassembly_options.lowerCase)
 					for (char& c : base_str)
 						c = tolower(c);
-				result.emplace_back(RegisterToken, base_str);
+				result.AddToken(RegisterToken, base_str);
 			}
-			result.emplace_back(EndMemoryOperandToken, "");
-			result.emplace_back(BraceToken, "]");
+			result.AddToken(EndMemoryOperandToken, "");
+			result.AddToken(BraceToken, "]");
 
 			break;
 		}
@@ -1776,18 +1793,18 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				}
 
 				if (immediateSize == addrSize)
-					result.emplace_back(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
 				else
-					result.emplace_back(IntegerToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(IntegerToken, sstream.str(), immediateValue, immediateSize);
 			}
 			else
 			{
 				const uint64_t immediateValue = xed_decoded_inst_get_unsigned_immediate(xedd);
 				sstream << immediateValue;
 				if (immediateSize == addrSize)
-					result.emplace_back(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(PossibleAddressToken, sstream.str(), immediateValue, immediateSize);
 				else
-					result.emplace_back(IntegerToken, sstream.str(), immediateValue, immediateSize);
+					result.AddToken(IntegerToken, sstream.str(), immediateValue, immediateSize);
 			}
 			break;
 		}
@@ -1802,7 +1819,7 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				sstream << uppercase;
 
 			sstream << (uint16_t)xed_decoded_inst_get_second_immediate(xedd);
-			result.emplace_back(IntegerToken, sstream.str(), xed_decoded_inst_get_second_immediate(xedd), 1);
+			result.AddToken(IntegerToken, sstream.str(), xed_decoded_inst_get_second_immediate(xedd), 1);
 			break;
 		}
 
@@ -1816,7 +1833,7 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				sstream << uppercase;
 
 			sstream << xed_decoded_inst_get_branch_displacement(xedd);
-			result.emplace_back(PossibleAddressToken, sstream.str(), xed_decoded_inst_get_branch_displacement(xedd), 8);
+			result.AddToken(PossibleAddressToken, sstream.str(), xed_decoded_inst_get_branch_displacement(xedd), 8);
 			break;
 
 		}
@@ -1833,13 +1850,13 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				sstream << uppercase;
 
 			sstream << relbr;
-			result.emplace_back(CodeRelativeAddressToken, sstream.str(), relbr, 8);
+			result.AddToken(CodeRelativeAddressToken, sstream.str(), relbr, 8);
 			break;
 		}
 
 		default:
 		{
-			result.emplace_back(KeywordToken, "unimplemented");
+			result.AddToken(KeywordToken, "unimplemented");
 		}  // default case of outer switch
 		}  // outer switch
 
@@ -1850,7 +1867,7 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				((xed_operand_operand_visibility(xed_inst_operand(xi, i+1)) == XED_OPVIS_EXPLICIT) ||
 				(xed_operand_operand_visibility(xed_inst_operand(xi, i+1)) == XED_OPVIS_IMPLICIT)))
 			{
-					result.emplace_back(OperandSeparatorToken, m_disassembly_options.separator);
+					result.AddToken(OperandSeparatorToken, m_disassembly_options.separator);
 			}
 		}
 		else
@@ -1859,14 +1876,14 @@ void X86CommonArchitecture::GetOperandTextATT(const xed_decoded_inst_t* const xe
 				((xed_operand_operand_visibility(xed_inst_operand(xi, noperands - j - 2)) == XED_OPVIS_EXPLICIT) ||
 				(xed_operand_operand_visibility(xed_inst_operand(xi, noperands - j - 2)) == XED_OPVIS_IMPLICIT)))
 			{
-					result.emplace_back(OperandSeparatorToken, m_disassembly_options.separator);
+					result.AddToken(OperandSeparatorToken, m_disassembly_options.separator);
 			}
 		}
 
 	}
 }
 
-void X86CommonArchitecture::GetOperandTextXED(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t, const xed_operand_values_t* const, const xed_inst_t* const, vector<InstructionTextToken>& result) const
+void X86CommonArchitecture::GetOperandTextXED(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t, const xed_operand_values_t* const, const xed_inst_t* const, InstructionTextTokenSink& result) const
 {
 	char out_buffer[100];
 	if (!xed_format_context(XED_SYNTAX_XED, xedd, out_buffer, 100, addr, 0, 0))
@@ -1884,10 +1901,10 @@ void X86CommonArchitecture::GetOperandTextXED(const xed_decoded_inst_t* const xe
 	// Convert To String
 	string outstring(out_buffer+i);
 
-	result.emplace_back(TextToken, outstring);
+	result.AddToken(TextToken, outstring);
 }
 
-void X86CommonArchitecture::GetOperandText(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t len, const xed_operand_values_t* const ov, const xed_inst_t* const xi, vector<InstructionTextToken>& result) const
+void X86CommonArchitecture::GetOperandText(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t len, const xed_operand_values_t* const ov, const xed_inst_t* const xi, InstructionTextTokenSink& result) const
 {
 	switch (m_disassembly_options.df)
 	{
@@ -2020,7 +2037,7 @@ bool X86CommonArchitecture::GetInstructionInfo(const uint8_t* data, uint64_t add
 		LogError("Invalid Processor Mode");
 		return false;
 	}
-	if (!Decode(data, maxLen, &xedd))
+	if (!DecodeAt(data, addr, maxLen, &xedd))
 		return false;
 
 	SetInstructionInfoForInstruction(addr, result, &xedd);
@@ -2028,7 +2045,47 @@ bool X86CommonArchitecture::GetInstructionInfo(const uint8_t* data, uint64_t add
 }
 
 
+size_t X86CommonArchitecture::GetInstructionInfoBatch(const uint8_t* data, uint64_t addr, size_t len, InstructionInfo* results, size_t maxCount)
+{
+	xed_decoded_inst_t xedd;
+	switch (m_bits)
+	{
+	case 64:
+		xed_decoded_inst_set_mode(&xedd, XED_MACHINE_MODE_LONG_64, XED_ADDRESS_WIDTH_64b);
+		break;
+	case 32:
+		xed_decoded_inst_set_mode(&xedd, XED_MACHINE_MODE_LEGACY_32, XED_ADDRESS_WIDTH_32b);
+		break;
+	case 16:
+		xed_decoded_inst_set_mode(&xedd, XED_MACHINE_MODE_LEGACY_16, XED_ADDRESS_WIDTH_16b);
+		break;
+	default:
+		LogError("Invalid Processor Mode");
+		return 0;
+	}
+
+	// Decoding keeps the mode, so one decoded instruction serves the whole run
+	size_t count = 0;
+	size_t offset = 0;
+	while (count < maxCount && offset < len)
+	{
+		if (!DecodeAt(data + offset, addr + offset, len - offset, &xedd))
+			break;
+		SetInstructionInfoForInstruction(addr + offset, results[count], &xedd);
+		offset += results[count].length;
+		count++;
+	}
+	return count;
+}
+
+
 bool X86CommonArchitecture::GetInstructionText(const uint8_t* data, uint64_t addr, size_t& len, vector<InstructionTextToken>& result)
+{
+	return GetInstructionTextFromTokens(data, addr, len, result);
+}
+
+
+bool X86CommonArchitecture::GetInstructionTextTokens(const uint8_t* data, uint64_t addr, size_t& len, InstructionTextTokenSink& result)
 {
 	xed_decoded_inst_t xedd;
 	switch (m_bits)
@@ -2047,7 +2104,7 @@ bool X86CommonArchitecture::GetInstructionText(const uint8_t* data, uint64_t add
 		return false;
 	}
 
-	if (Decode(data, len, &xedd))
+	if (DecodeAt(data, addr, len, &xedd))
 	{
 		len = xed_decoded_inst_get_length(&xedd);
 
@@ -2090,7 +2147,7 @@ bool X86CommonArchitecture::GetInstructionLowLevelIL(const uint8_t* data, uint64
 		LogError("Invalid Processor Mode");
 		return false;
 	}
-	if (!Decode(data, len, &xedd))
+	if (!DecodeAt(data, addr, len, &xedd))
 	{
 		il.AddInstruction(il.Undefined());
 		return false;
@@ -25,6 +25,8 @@ protected:
 	DISASSEMBLY_OPTIONS m_disassembly_options;
 
 	bool Decode(const uint8_t* data, size_t len, xed_decoded_inst_t* xedd);
+	// Decode through the architecture's decode cache, for instructions at a known address
+	bool DecodeAt(const uint8_t* data, uint64_t addr, size_t len, xed_decoded_inst_t* xedd);
 
 	size_t GetAddressSizeBits()  const;
 	uint64_t GetAddressMask() const;
@@ -34,20 +36,20 @@ protected:
 	string GetSizeString(const size_t size) const;
 
 	BNRegisterInfo RegisterInfo(xed_reg_enum_t fullWidthReg, size_t offset, size_t size, bool zeroExtend = false);
-	static void GetAddressSizeToken(const short bytes, vector<InstructionTextToken>& result, const bool lowerCase);
+	static void GetAddressSizeToken(const short bytes, InstructionTextTokenSink& result, const bool lowerCase);
 	unsigned short GetInstructionOpcode(const xed_decoded_inst_t* const xedd,
-        const xed_operand_values_t* const ov, vector<InstructionTextToken>& result) const;
-	void GetInstructionPadding(const unsigned int instruction_name_length, vector<InstructionTextToken>& result) const;
+        const xed_operand_values_t* const ov, InstructionTextTokenSink& result) const;
+	void GetInstructionPadding(const unsigned int instruction_name_length, InstructionTextTokenSink& result) const;
 	void GetOperandTextIntel(const xed_decoded_inst_t* const xedd, const uint64_t addr,const size_t len,
-        const xed_operand_values_t* const ov, const xed_inst_t* const xi, vector<InstructionTextToken>& result) const;
+        const xed_operand_values_t* const ov, const xed_inst_t* const xi, InstructionTextTokenSink& result) const;
 	void GetOperandTextBNIntel(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t len,
-        const xed_operand_values_t* const ov, const xed_inst_t* const xi, vector<InstructionTextToken>& result) const;
+        const xed_operand_values_t* const ov, const xed_inst_t* const xi, InstructionTextTokenSink& result) const;
 	void GetOperandTextATT(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t len,
-        const xed_operand_values_t* const ov, const xed_inst_t* const xi, vector<InstructionTextToken>& result) const;
+        const xed_operand_values_t* const ov, const xed_inst_t* const xi, InstructionTextTokenSink& result) const;
 	void GetOperandTextXED(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t,
-        const xed_operand_values_t* const, const xed_inst_t* const, vector<InstructionTextToken>& result) const;
+        const xed_operand_values_t* const, const xed_inst_t* const, InstructionTextTokenSink& result) const;
 	void GetOperandText(const xed_decoded_inst_t* const xedd, const uint64_t addr, const size_t len,
-        const xed_operand_values_t* const ov, const xed_inst_t* const xi, vector<InstructionTextToken>& result) const;
+        const xed_operand_values_t* const ov, const xed_inst_t* const xi, InstructionTextTokenSink& result) const;
 
 
 public:
@@ -56,7 +58,9 @@ public:
 	virtual vector<uint32_t> GetGlobalRegisters() override;
 	virtual vector<uint32_t> GetSystemRegisters() override;
 	virtual bool GetInstructionInfo(const uint8_t* data, uint64_t addr, size_t maxLen, InstructionInfo& result) override;
+	virtual size_t GetInstructionInfoBatch(const uint8_t* data, uint64_t addr, size_t len, InstructionInfo* results, size_t maxCount) override;
 	virtual bool GetInstructionText(const uint8_t* data, uint64_t addr, size_t& len, vector<InstructionTextToken>& result) override;
+	virtual bool GetInstructionTextTokens(const uint8_t* data, uint64_t addr, size_t& len, InstructionTextTokenSink& result) override;
 
     virtual bool GetInstructionLowLevelIL(const uint8_t* data, uint64_t addr, size_t& len, LowLevelILFunction& il) override;
 	virtual size_t GetFlagWriteLowLevelIL(BNLowLevelILOperation op, size_t size, uint32_t flagWriteType,
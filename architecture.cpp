@@ -183,6 +183,108 @@ vector<InstructionTextToken> InstructionTextToken::ConvertInstructionTextTokenLi
 }
 
 
+size_t InstructionTextTokenSink::AddText(string_view text)
+{
+	size_t offset = m_text.size();
+	m_text.insert(m_text.end(), text.begin(), text.end());
+	m_text.push_back('\0');
+	return offset;
+}
+
+
+void InstructionTextTokenSink::AddToken(BNInstructionTextTokenType type, string_view text, uint64_t value, size_t size,
+    size_t operand, uint8_t confidence, uint64_t width)
+{
+	AddToken(type, NoTokenContext, text, 0, value, size, operand, confidence, width);
+}
+
+
+void InstructionTextTokenSink::AddToken(BNInstructionTextTokenType type, BNInstructionTextTokenContext context,
+    string_view text, uint64_t address, uint64_t value, size_t size, size_t operand, uint8_t confidence, uint64_t width)
+{
+	if (width == InstructionTextToken::WidthIsByteCount)
+		width = text.size();
+	size_t textOffset = AddText(text);
+	m_tokens.push_back({type, textOffset, value, width, size, operand, context, confidence, address,
+		m_typeNames.size(), 0, BN_INVALID_EXPR});
+}
+
+
+void InstructionTextTokenSink::AddToken(const InstructionTextToken& token)
+{
+	size_t textOffset = AddText(token.text);
+	size_t typeNamesOffset = m_typeNames.size();
+	for (auto& name : token.typeNames)
+		m_typeNames.push_back(AddText(name));
+	m_tokens.push_back({token.type, textOffset, token.value, token.width, token.size, token.operand, token.context,
+		token.confidence, token.address, typeNamesOffset, token.typeNames.size(), token.exprIndex});
+}
+
+
+void InstructionTextTokenSink::Clear()
+{
+	m_tokens.clear();
+	m_text.clear();
+	m_typeNames.clear();
+}
+
+
+void InstructionTextTokenSink::AppendTo(vector<InstructionTextToken>& result) const
+{
+	result.reserve(result.size() + m_tokens.size());
+	for (auto& token : m_tokens)
+	{
+		vector<string> typeNames;
+		typeNames.reserve(token.namesCount);
+		for (size_t i = 0; i < token.namesCount; i++)
+			typeNames.emplace_back(&m_text[m_typeNames[token.typeNamesOffset + i]]);
+		result.emplace_back(token.type, token.context, &m_text[token.textOffset], token.address, token.value,
+			token.size, token.operand, token.confidence, typeNames, token.width);
+		result.back().exprIndex = token.exprIndex;
+	}
+}
+
+
+BNInstructionTextToken* InstructionTextTokenSink::CreateInstructionTextTokenList() const
+{
+	// Tokens, then type name pointers, then text, all in one block
+	size_t tokenBytes = m_tokens.size() * sizeof(BNInstructionTextToken);
+	size_t typeNameBytes = m_typeNames.size() * sizeof(char*);
+	uint8_t* block = (uint8_t*)::operator new(tokenBytes + typeNameBytes + m_text.size());
+	BNInstructionTextToken* result = (BNInstructionTextToken*)block;
+	char** typeNames = (char**)(block + tokenBytes);
+	char* text = (char*)(block + tokenBytes + typeNameBytes);
+	if (!m_text.empty())
+		memcpy(text, m_text.data(), m_text.size());
+	for (size_t i = 0; i < m_typeNames.size(); i++)
+		typeNames[i] = text + m_typeNames[i];
+
+	for (size_t i = 0; i < m_tokens.size(); i++)
+	{
+		const Token& token = m_tokens[i];
+		result[i].type = token.type;
+		result[i].text = text + token.textOffset;
+		result[i].value = token.value;
+		result[i].width = token.width;
+		result[i].size = token.size;
+		result[i].operand = token.operand;
+		result[i].context = token.context;
+		result[i].confidence = token.confidence;
+		result[i].address = token.address;
+		result[i].typeNames = token.namesCount ? typeNames + token.typeNamesOffset : nullptr;
+		result[i].namesCount = token.namesCount;
+		result[i].exprIndex = token.exprIndex;
+	}
+	return result;
+}
+
+
+void InstructionTextTokenSink::FreeInstructionTextTokenList(BNInstructionTextToken* tokens)
+{
+	::operator delete(tokens);
+}
+
+
 Architecture::Architecture(BNArchitecture* arch)
 {
 	m_object = arch;
@@ -264,13 +366,58 @@ bool Architecture::GetInstructionInfoCallback(
 }
 
 
+size_t Architecture::GetInstructionInfoBatchCallback(void* ctxt, const uint8_t* data, uint64_t addr, size_t len,
+    BNInstructionInfo* results, size_t maxCount)
+{
+	CallbackRef<Architecture> arch(ctxt);
+
+	// Decode through a fixed size buffer, so a batch doesn't allocate no matter how many instructions are requested
+	InstructionInfo info[32];
+	size_t count = 0;
+	size_t offset = 0;
+	while (count < maxCount && offset < len)
+	{
+		size_t chunk = min(maxCount - count, sizeof(info) / sizeof(info[0]));
+		for (size_t i = 0; i < chunk; i++)
+		{
+			info[i] = InstructionInfo();
+			info[i].delaySlots = results[count + i].delaySlots;
+		}
+
+		size_t decoded = arch->GetInstructionInfoBatch(data + offset, addr + offset, len - offset, info, chunk);
+		for (size_t i = 0; i < decoded; i++)
+		{
+			results[count + i] = info[i];
+			offset += info[i].length;
+		}
+		count += decoded;
+		if (decoded < chunk)
+			break;
+	}
+	return count;
+}
+
+
 bool Architecture::GetInstructionTextCallback(
     void* ctxt, const uint8_t* data, uint64_t addr, size_t* len, BNInstructionTextToken** result, size_t* count)
 {
 	CallbackRef<Architecture> arch(ctxt);
 
-	vector<InstructionTextToken> tokens;
-	bool ok = arch->GetInstructionText(data, addr, *len, tokens);
+	// One sink per thread is reused so its buffers only grow once. Getting the text can call back into the core for
+	// another architecture (hooks, extensions), so a nested call gets a sink of its own.
+	static thread_local InstructionTextTokenSink threadTokens;
+	static thread_local bool threadTokensInUse = false;
+	struct ThreadTokensLease
+	{
+		bool nested;
+		ThreadTokensLease() : nested(threadTokensInUse) { threadTokensInUse = true; }
+		~ThreadTokensLease() { threadTokensInUse = nested; }
+	} lease;
+	InstructionTextTokenSink nestedTokens;
+	InstructionTextTokenSink& tokens = lease.nested ? nestedTokens : threadTokens;
+	tokens.Clear();
+
+	bool ok = arch->GetInstructionTextTokens(data, addr, *len, tokens);
 	if (!ok)
 	{
 		*result = nullptr;
@@ -278,22 +425,15 @@ bool Architecture::GetInstructionTextCallback(
 		return false;
 	}
 
-	*count = tokens.size();
-	*result = InstructionTextToken::CreateInstructionTextTokenList(tokens);
+	*count = tokens.GetCount();
+	*result = tokens.CreateInstructionTextTokenList();
 	return true;
 }
 
 
-void Architecture::FreeInstructionTextCallback(BNInstructionTextToken* tokens, size_t count)
+void Architecture::FreeInstructionTextCallback(BNInstructionTextToken* tokens, size_t)
 {
-	for (size_t i = 0; i < count; i++)
-	{
-		BNFreeString(tokens[i].text);
-		for (size_t j = 0; j < tokens[j].namesCount; j++)
-			BNFreeString(tokens[i].typeNames[j]);
-		delete[] tokens[i].typeNames;
-	}
-	delete[] tokens;
+	InstructionTextTokenSink::FreeInstructionTextTokenList(tokens);
 }
 
 
@@ -301,8 +441,8 @@ bool Architecture::GetInstructionLowLevelILCallback(
     void* ctxt, const uint8_t* data, uint64_t addr, size_t* len, BNLowLevelILFunction* il)
 {
 	CallbackRef<Architecture> arch(ctxt);
-	Ref<LowLevelILFunction> func(new LowLevelILFunction(BNNewLowLevelILFunctionReference(il)));
-	return arch->GetInstructionLowLevelIL(data, addr, *len, *func);
+	BorrowedCoreObject<LowLevelILFunction> func(il);
+	return arch->GetInstructionLowLevelIL(data, addr, *len, func);
 }
 
 
@@ -508,8 +648,8 @@ size_t Architecture::GetFlagWriteLowLevelILCallback(void* ctxt, BNLowLevelILOper
     BNLowLevelILFunction* il)
 {
 	CallbackRef<Architecture> arch(ctxt);
-	Ref<LowLevelILFunction> func(new LowLevelILFunction(BNNewLowLevelILFunctionReference(il)));
-	return arch->GetFlagWriteLowLevelIL(op, size, flagWriteType, flag, operands, operandCount, *func);
+	BorrowedCoreObject<LowLevelILFunction> func(il);
+	return arch->GetFlagWriteLowLevelIL(op, size, flagWriteType, flag, operands, operandCount, func);
 }
 
 
@@ -517,16 +657,16 @@ size_t Architecture::GetFlagConditionLowLevelILCallback(
     void* ctxt, BNLowLevelILFlagCondition cond, uint32_t semClass, BNLowLevelILFunction* il)
 {
 	CallbackRef<Architecture> arch(ctxt);
-	Ref<LowLevelILFunction> func(new LowLevelILFunction(BNNewLowLevelILFunctionReference(il)));
-	return arch->GetFlagConditionLowLevelIL(cond, semClass, *func);
+	BorrowedCoreObject<LowLevelILFunction> func(il);
+	return arch->GetFlagConditionLowLevelIL(cond, semClass, func);
 }
 
 
 size_t Architecture::GetSemanticFlagGroupLowLevelILCallback(void* ctxt, uint32_t semGroup, BNLowLevelILFunction* il)
 {
 	CallbackRef<Architecture> arch(ctxt);
-	Ref<LowLevelILFunction> func(new LowLevelILFunction(BNNewLowLevelILFunctionReference(il)));
-	return arch->GetSemanticFlagGroupLowLevelIL(semGroup, *func);
+	BorrowedCoreObject<LowLevelILFunction> func(il);
+	return arch->GetSemanticFlagGroupLowLevelIL(semGroup, func);
 }
 
 
@@ -844,6 +984,7 @@ void Architecture::Register(Architecture* arch)
 	callbacks.alwaysBranch = AlwaysBranchCallback;
 	callbacks.invertBranch = InvertBranchCallback;
 	callbacks.skipAndReturnValue = SkipAndReturnValueCallback;
+	callbacks.getInstructionInfoBatch = GetInstructionInfoBatchCallback;
 	arch->Register(&callbacks);
 }
 
@@ -873,6 +1014,53 @@ vector<Ref<Architecture>> Architecture::GetList()
 }
 
 
+void Architecture::RecordDecodeCacheLookup(bool hit)
+{
+	// Counted per thread and published in batches, so that threads decoding in parallel don't contend on the
+	// shared counters
+	struct PendingLookups
+	{
+		Architecture* arch = nullptr;
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+
+		// Architectures that decode through the cache are registered and never freed, so the last batch can
+		// still be published when the thread exits
+		~PendingLookups() { Publish(); }
+
+		void Publish()
+		{
+			if (arch)
+			{
+				arch->m_decodeCacheHits.fetch_add(hits, memory_order_relaxed);
+				arch->m_decodeCacheMisses.fetch_add(misses, memory_order_relaxed);
+			}
+			hits = 0;
+			misses = 0;
+		}
+	};
+	static thread_local PendingLookups pending;
+
+	if (pending.arch != this)
+	{
+		pending.Publish();
+		pending.arch = this;
+	}
+	if (hit)
+		pending.hits++;
+	else
+		pending.misses++;
+	if (pending.hits + pending.misses >= 256)
+		pending.Publish();
+}
+
+
+ArchitectureDecodeCacheStatistics Architecture::GetDecodeCacheStatistics() const
+{
+	return {m_decodeCacheHits.load(memory_order_relaxed), m_decodeCacheMisses.load(memory_order_relaxed)};
+}
+
+
 string Architecture::GetName() const
 {
 	char* name = BNGetArchitectureName(m_object);
@@ -917,6 +1105,48 @@ Ref<Architecture> Architecture::GetAssociatedArchitectureByAddress(uint64_t&)
 }
 
 
+bool Architecture::GetInstructionTextTokens(
+    const uint8_t* data, uint64_t addr, size_t& len, InstructionTextTokenSink& result)
+{
+	vector<InstructionTextToken> tokens;
+	if (!GetInstructionText(data, addr, len, tokens))
+		return false;
+	for (auto& token : tokens)
+		result.AddToken(token);
+	return true;
+}
+
+
+bool Architecture::GetInstructionTextFromTokens(
+    const uint8_t* data, uint64_t addr, size_t& len, vector<InstructionTextToken>& result)
+{
+	InstructionTextTokenSink tokens;
+	if (!GetInstructionTextTokens(data, addr, len, tokens))
+		return false;
+	tokens.AppendTo(result);
+	return true;
+}
+
+
+size_t Architecture::GetInstructionInfoBatch(
+    const uint8_t* data, uint64_t addr, size_t len, InstructionInfo* results, size_t maxCount)
+{
+	size_t count = 0;
+	size_t offset = 0;
+	while (count < maxCount && offset < len)
+	{
+		InstructionInfo& info = results[count];
+		if (!GetInstructionInfo(data + offset, addr + offset, len - offset, info))
+			break;
+		if (info.length == 0 || info.length > len - offset)
+			break;
+		offset += info.length;
+		count++;
+	}
+	return count;
+}
+
+
 bool Architecture::GetInstructionLowLevelIL(const uint8_t*, uint64_t, size_t&, LowLevelILFunction& il)
 {
 	il.AddInstruction(il.Undefined());
@@ -1465,6 +1695,19 @@ bool CoreArchitecture::GetInstructionInfo(const uint8_t* data, uint64_t addr, si
 }
 
 
+size_t CoreArchitecture::GetInstructionInfoBatch(
+    const uint8_t* data, uint64_t addr, size_t len, InstructionInfo* results, size_t maxCount)
+{
+	static_assert(sizeof(InstructionInfo) == sizeof(BNInstructionInfo), "results are passed to the core as an array");
+
+	// BNGetInstructionInfoBatch was added in core ABI version 97, older cores only decode one instruction per call
+	static const bool coreHasBatch = BNGetCurrentCoreABIVersion() >= 97;
+	if (!coreHasBatch)
+		return Architecture::GetInstructionInfoBatch(data, addr, len, results, maxCount);
+	return BNGetInstructionInfoBatch(m_object, data, addr, len, results, maxCount);
+}
+
+
 bool CoreArchitecture::GetInstructionText(
     const uint8_t* data, uint64_t addr, size_t& len, std::vector<InstructionTextToken>& result)
 {
@@ -2289,6 +2532,14 @@ ArchitectureHook::ArchitectureHook(Architecture* base) : CoreArchitecture(nullpt
 }
 
 
+size_t ArchitectureHook::GetInstructionInfoBatch(
+    const uint8_t* data, uint64_t addr, size_t len, InstructionInfo* results, size_t maxCount)
+{
+	// Hooks that only override GetInstructionInfo must still see every instruction of a batch
+	return Architecture::GetInstructionInfoBatch(data, addr, len, results, maxCount);
+}
+
+
 void ArchitectureHook::Register(BNCustomArchitecture* callbacks)
 {
 	AddRefForRegistration();
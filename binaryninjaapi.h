@@ -27,7 +27,9 @@
 	#define FMT_UNICODE 0
 #endif
 #include <cstddef>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <unordered_map>
@@ -384,6 +386,26 @@ namespace BinaryNinja {
 		T* GetPtr() const { return m_obj; }
 	};
 
+	/*! Wraps a core object for the duration of a callback, borrowing the caller's reference to it
+
+		Meant to live on the stack of a callback. Creating it doesn't allocate or take a core reference. Refs taken to
+		it while it is alive add their own core reference as usual, but it is never deleted through them, so it must
+		not be used after the callback returns.
+
+	    \ingroup refcount
+	*/
+	template <class T>
+	class BorrowedCoreObject : public T
+	{
+	public:
+		template <class Handle>
+		explicit BorrowedCoreObject(Handle* obj) : T(obj)
+		{
+			// Stands in for the caller's reference, so the count never drops to zero while borrowed
+			this->AddRefForCallback();
+		}
+	};
+
 	/*!
 		\ingroup confidence
 	*/
@@ -2412,6 +2434,60 @@ namespace BinaryNinja {
 		    const BNInstructionTextToken* tokens, size_t count);
 	};
 
+	/*! InstructionTextTokenSink collects instruction text tokens without allocating for each token
+
+		Token text is copied into one shared character buffer and tokens without type names don't allocate a type name
+		list. Once the buffers of a reused sink have grown, adding tokens doesn't allocate at all. The finished list is
+		handed to the core as a single allocation by CreateInstructionTextTokenList.
+
+		\ingroup architectures
+	*/
+	class InstructionTextTokenSink
+	{
+		struct Token
+		{
+			BNInstructionTextTokenType type;
+			size_t textOffset;
+			uint64_t value;
+			uint64_t width;
+			size_t size, operand;
+			BNInstructionTextTokenContext context;
+			uint8_t confidence;
+			uint64_t address;
+			size_t typeNamesOffset;
+			size_t namesCount;
+			size_t exprIndex;
+		};
+
+		std::vector<Token> m_tokens;
+		std::vector<char> m_text;
+		std::vector<size_t> m_typeNames;
+
+		size_t AddText(std::string_view text);
+
+	  public:
+		void AddToken(BNInstructionTextTokenType type, std::string_view text, uint64_t value = 0, size_t size = 0,
+		    size_t operand = BN_INVALID_OPERAND, uint8_t confidence = BN_FULL_CONFIDENCE,
+		    uint64_t width = InstructionTextToken::WidthIsByteCount);
+		void AddToken(BNInstructionTextTokenType type, BNInstructionTextTokenContext context, std::string_view text,
+		    uint64_t address, uint64_t value = 0, size_t size = 0, size_t operand = BN_INVALID_OPERAND,
+		    uint8_t confidence = BN_FULL_CONFIDENCE, uint64_t width = InstructionTextToken::WidthIsByteCount);
+		void AddToken(const InstructionTextToken& token);
+
+		size_t GetCount() const { return m_tokens.size(); }
+		bool IsEmpty() const { return m_tokens.empty(); }
+		void Clear();
+
+		void AppendTo(std::vector<InstructionTextToken>& result) const;
+
+		/*! Creates a token list for the core in a single allocation
+
+			\return Token list that must be freed with FreeInstructionTextTokenList
+		*/
+		BNInstructionTextToken* CreateInstructionTextTokenList() const;
+		static void FreeInstructionTextTokenList(BNInstructionTextToken* tokens);
+	};
+
 	class UndoEntry;
 
 	/*!
@@ -4174,6 +4250,33 @@ namespace BinaryNinja {
 		std::string name;
 	};
 
+	/*! A run of consecutive elements of one type, such as a relocation or exception table
+
+		Unlike an array DataVariable, the core does not materialize a table as a whole. Linear view renders
+		elements as they are scrolled into view, and references into the table resolve to the element
+		containing them. Elements are labeled from the symbol at the start of the table, if any.
+
+		\note Structured tables need core ABI version 94 or later. The bundled loaders only define them when their
+		\c useStructuredTables load setting is enabled.
+
+		\ingroup binaryview
+	*/
+	struct StructuredTable
+	{
+		StructuredTable() {}
+		StructuredTable(uint64_t a, Type* t, uint64_t s, uint64_t c, bool d) :
+		    address(a), elementType(t), elementSize(s), elementCount(c), autoDefined(d)
+		{}
+
+		uint64_t address = 0;
+		Ref<Type> elementType;
+		uint64_t elementSize = 0;
+		uint64_t elementCount = 0;
+		bool autoDefined = false;
+
+		uint64_t GetEnd() const { return address + elementSize * elementCount; }
+	};
+
 	/*!
 		\ingroup binaryview
 	*/
@@ -5060,6 +5163,21 @@ namespace BinaryNinja {
 
 		void DefineRelocation(Architecture* arch, BNRelocationInfo& info, uint64_t target, uint64_t reloc);
 		void DefineRelocation(Architecture* arch, BNRelocationInfo& info, Ref<Symbol> target, uint64_t reloc);
+
+		/*! Define many relocations in one call
+
+			Each definition targets either an address, or the entry of \c symbols selected by its \c symbol index.
+			Use BN_NO_RELOCATION_SYMBOL for address targets. Loaders defining relocations in bulk should prefer
+			RelocationBatch, which builds the symbol table and submits in chunks.
+
+			\note On cores older than ABI version 99 the relocations are defined one at a time.
+
+			\param arch Architecture of the relocations
+			\param relocs Relocation definitions
+			\param symbols Symbols referenced by index from \c relocs
+		*/
+		void DefineRelocations(Architecture* arch, std::vector<BNRelocationDefinition>& relocs,
+			const std::vector<Ref<Symbol>>& symbols);
 		std::vector<std::pair<uint64_t, uint64_t>> GetRelocationRanges() const;
 		std::vector<std::pair<uint64_t, uint64_t>> GetRelocationRangesAtAddress(uint64_t addr) const;
 		std::vector<std::pair<uint64_t, uint64_t>> GetRelocationRangesInRange(uint64_t addr, size_t size) const;
@@ -5094,6 +5212,30 @@ namespace BinaryNinja {
 		Ref<Function> AddFunctionForAnalysis(
 			Platform* platform, uint64_t addr, bool autoDiscovered = false, Type* type = nullptr);
 
+		/*! Add new functions of the given platform at each of the given virtual addresses
+
+			Loaders that know many function starts up front (exception tables, LC_FUNCTION_STARTS, .eh_frame_hdr)
+			should use this rather than calling AddFunctionForAnalysis per start, so the core can queue them
+			in one go and spread their analysis across its workers. Unlike AddFunctionForAnalysis, the
+			created functions are not returned.
+
+			\note On cores older than ABI version 98 the functions are added one at a time.
+
+		    \param platform Platform for the functions to be loaded
+		    \param addrs Virtual addresses of the functions to be loaded
+		    \param autoDiscovered true if the functions were automatically discovered, false if created by user
+		*/
+		void AddFunctionsForAnalysis(Platform* platform, const std::vector<uint64_t>& addrs, bool autoDiscovered = false);
+
+		/*! Add new functions of the given platform at each of `count` virtual addresses
+
+		    \param platform Platform for the functions to be loaded
+		    \param addrs Virtual addresses of the functions to be loaded
+		    \param count Number of addresses in `addrs`
+		    \param autoDiscovered true if the functions were automatically discovered, false if created by user
+		*/
+		void AddFunctionsForAnalysis(Platform* platform, const uint64_t* addrs, size_t count, bool autoDiscovered = false);
+
 		/*! adds an virtual address to start analysis from for a given platform
 
 		    \param platform Platform for the entry point analysis
@@ -5207,6 +5349,37 @@ namespace BinaryNinja {
 		*/
 		bool GetDataVariableAtAddress(uint64_t addr, DataVariable& var);
 
+		/*! Define a StructuredTable of `count` elements of `elementType` starting at `addr`
+
+			Use this instead of an array DataVariable, or a DataVariable per element, for large tables of
+			homogeneous entries. Any table already at `addr` is replaced.
+
+			\param addr virtual address of the first element
+			\param elementType Type of each element
+			\param count Number of elements
+		*/
+		void DefineStructuredTable(uint64_t addr, Ref<Type> elementType, uint64_t count);
+
+		/*! Remove the StructuredTable starting at `addr`
+
+			\param addr virtual address of the first element
+		*/
+		void UndefineStructuredTable(uint64_t addr);
+
+		/*! Get the StructuredTables defined in the current BinaryView
+
+			\return The tables, ordered by address
+		*/
+		std::vector<StructuredTable> GetStructuredTables();
+
+		/*! Get the StructuredTable containing a given address
+
+			\param addr Address anywhere inside the table
+			\param table Reference to a StructuredTable to write to
+			\return Whether `addr` is inside a StructuredTable
+		*/
+		bool GetStructuredTableContaining(uint64_t addr, StructuredTable& table);
+
 		/*! Get a list of functions within this BinaryView
 
 		    \return vector of Functions within the BinaryView
@@ -7570,6 +7743,135 @@ namespace BinaryNinja {
 		bool IsEndOfFile() const;
 	};
 
+	/*! MappedBinaryReader reads like a BinaryReader, but serves reads from a pinned span of the view's data
+
+		Every BinaryReader read is a call into the core, which adds up when a loader parses a symbol or relocation
+		table field by field. Map() reads a span of the view (typically a whole table) in one go, after which
+		reads that fall inside it are decoded inline from memory. Reads that are not entirely inside the span go
+		through a regular BinaryReader, so a MappedBinaryReader with nothing mapped behaves like one.
+
+		The span is a snapshot of the view's contents at the time of the Map() call.
+
+		\ingroup binaryview
+	*/
+	class MappedBinaryReader
+	{
+		BinaryReader m_reader;
+		Ref<BinaryView> m_view;
+		BNEndianness m_endian;
+		std::vector<uint8_t> m_data;
+		uint64_t m_start = 0;
+		uint64_t m_offset = 0;
+
+		const uint8_t* MappedAt(size_t len) const
+		{
+			if (m_offset < m_start || m_offset - m_start > m_data.size() || m_data.size() - (m_offset - m_start) < len)
+				return nullptr;
+			return m_data.data() + (m_offset - m_start);
+		}
+
+		template <typename T>
+		bool TryReadInt(T& result)
+		{
+			const uint8_t* data = MappedAt(sizeof(T));
+			if (!data)
+				return TryReadUnmapped(result);
+			T value = 0;
+			for (size_t i = 0; i < sizeof(T); i++)
+				value |= (T)data[i] << (8 * (m_endian == LittleEndian ? i : sizeof(T) - 1 - i));
+			result = value;
+			m_offset += sizeof(T);
+			return true;
+		}
+
+		template <typename T>
+		T ReadInt()
+		{
+			T result;
+			if (!TryReadInt(result))
+				throw ReadException();
+			return result;
+		}
+
+		bool TryReadUnmapped(uint8_t& result);
+		bool TryReadUnmapped(uint16_t& result);
+		bool TryReadUnmapped(uint32_t& result);
+		bool TryReadUnmapped(uint64_t& result);
+
+	  public:
+		/*! Create a MappedBinaryReader with nothing mapped
+
+			\param data BinaryView to read from
+			\param endian Byte order to read with. One of LittleEndian, BigEndian
+		*/
+		MappedBinaryReader(BinaryView* data, BNEndianness endian = LittleEndian);
+		MappedBinaryReader(const MappedBinaryReader&) = delete;
+		MappedBinaryReader& operator=(const MappedBinaryReader&) = delete;
+
+		/*! Pin `[start, start + len)` of the view, replacing any previous span
+
+			If only part of the range is readable, the readable prefix is mapped.
+
+			\param start Offset of the span in the view
+			\param len Length of the span
+			\return Whether the whole range was mapped
+		*/
+		bool Map(uint64_t start, size_t len);
+
+		/*! Release the mapped span, all further reads go through the core
+		*/
+		void Unmap();
+
+		uint64_t GetMappedStart() const { return m_start; }
+		size_t GetMappedLength() const { return m_data.size(); }
+
+		BNEndianness GetEndianness() const { return m_endian; }
+		void SetEndianness(BNEndianness endian);
+
+		uint64_t GetOffset() const { return m_offset; }
+		void Seek(uint64_t offset) { m_offset = offset; }
+		void SeekRelative(int64_t offset) { m_offset += offset; }
+
+		/*! Read from the current cursor position into buffer `dest`
+
+		    \throws ReadException
+			\param dest Address to write the read bytes to
+			\param len Number of bytes to write
+		*/
+		void Read(void* dest, size_t len)
+		{
+			if (!TryRead(dest, len))
+				throw ReadException();
+		}
+		DataBuffer Read(size_t len);
+
+		bool TryRead(void* dest, size_t len);
+
+		uint8_t Read8() { return ReadInt<uint8_t>(); }
+		uint16_t Read16() { return ReadInt<uint16_t>(); }
+		uint32_t Read32() { return ReadInt<uint32_t>(); }
+		uint64_t Read64() { return ReadInt<uint64_t>(); }
+
+		bool TryRead8(uint8_t& result) { return TryReadInt(result); }
+		bool TryRead16(uint16_t& result) { return TryReadInt(result); }
+		bool TryRead32(uint32_t& result) { return TryReadInt(result); }
+		bool TryRead64(uint64_t& result) { return TryReadInt(result); }
+
+		/*! Read a pointer (size of BinaryView::GetAddressSize()) from the current cursor position
+
+		    \throws ReadException
+		    \return The value that was read
+		*/
+		uint64_t ReadPointer();
+
+		/*! Read a null-terminated string from the current cursor position
+
+			\param maxLength Maximum length of the string, default is no limit (-1)
+			\return the string, up to the first failed read
+		*/
+		std::string ReadCString(size_t maxLength = -1);
+	};
+
 	/*! Raised whenever a write is performed out of bounds.
 
 		\ingroup binaryview
@@ -7895,6 +8197,15 @@ namespace BinaryNinja {
 
 	typedef size_t ExprId;
 
+	/*!
+		\ingroup architectures
+	*/
+	struct ArchitectureDecodeCacheStatistics
+	{
+		uint64_t hits;
+		uint64_t misses;
+	};
+
 	/*! The Architecture class is the base class for all CPU architectures. This provides disassembly, assembly,
 	    patching, and IL translation lifting for a given architecture.
 
@@ -7902,9 +8213,84 @@ namespace BinaryNinja {
 	*/
 	class Architecture : public StaticCoreRefCountObject<BNArchitecture>
 	{
+		std::atomic<uint64_t> m_decodeCacheHits {0};
+		std::atomic<uint64_t> m_decodeCacheMisses {0};
+
+		void RecordDecodeCacheLookup(bool hit);
+
 	  protected:
 		std::string m_nameForRegister;
 
+		/*! Decodes the instruction at \c addr through a per-thread cache of recently decoded instructions
+
+			Architectures that decode the same bytes separately for GetInstructionInfo, GetInstructionText and
+			GetInstructionLowLevelIL can opt in by routing their decoder through this, so that one decode serves all
+			of them. Entries are keyed by architecture, address and instruction bytes, so patched bytes are decoded
+			again. Failed decodes are not cached.
+
+			\tparam T Decoded instruction type, must be trivially copyable
+			\tparam MaxLength Maximum instruction length in bytes
+			\tparam Entries Number of instructions cached per thread, must be a power of two. Defaults to as many as
+				fit in \c DecodeCacheBytes, as one cache is kept per thread for every instantiation
+			\param[in] data pointer to the instruction data
+			\param[in] addr address of the instruction
+			\param[in] maxLen Maximum length of the instruction data to read
+			\param[out] result Decoded instruction
+			\param[in] decode Called as <tt>size_t decode(T& result)</tt> on a miss, returns the length of the decoded
+				instruction or 0 if it could not be decoded
+			\return Whether the instruction was decoded
+		*/
+		static constexpr size_t DecodeCacheBytes = 64 * 1024;
+
+		static constexpr size_t DefaultDecodeCacheEntries(size_t entrySize)
+		{
+			size_t entries = 1;
+			while (entries * 2 * entrySize <= DecodeCacheBytes)
+				entries *= 2;
+			return entries;
+		}
+
+		template <typename T, size_t MaxLength,
+		    size_t Entries = DefaultDecodeCacheEntries(sizeof(T) + MaxLength + 3 * sizeof(uint64_t)), typename Decoder>
+		bool DecodeCached(const uint8_t* data, uint64_t addr, size_t maxLen, T& result, Decoder&& decode)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "decoded instructions are cached by copy");
+			static_assert(Entries != 0 && (Entries & (Entries - 1)) == 0, "cache size must be a power of two");
+
+			struct Entry
+			{
+				const Architecture* arch;
+				uint64_t addr;
+				size_t length;
+				uint8_t bytes[MaxLength];
+				T decoded;
+			};
+			static thread_local std::vector<Entry> cache(Entries);
+
+			Entry& entry = cache[(size_t)((addr * 0x9e3779b97f4a7c15ULL) >> 32) & (Entries - 1)];
+			if (entry.arch == this && entry.addr == addr && entry.length <= maxLen
+			    && memcmp(entry.bytes, data, entry.length) == 0)
+			{
+				RecordDecodeCacheLookup(true);
+				result = entry.decoded;
+				return true;
+			}
+
+			RecordDecodeCacheLookup(false);
+			size_t length = decode(result);
+			if (length == 0)
+				return false;
+			if (length <= MaxLength && length <= maxLen)
+			{
+				entry.arch = this;
+				entry.addr = addr;
+				entry.length = length;
+				memcpy(entry.bytes, data, length);
+				entry.decoded = result;
+			}
+			return true;
+		}
+
 		Architecture(BNArchitecture* arch);
 
 		static void InitCallback(void* ctxt, BNArchitecture* obj);
@@ -7917,6 +8303,8 @@ namespace BinaryNinja {
 		static BNArchitecture* GetAssociatedArchitectureByAddressCallback(void* ctxt, uint64_t* addr);
 		static bool GetInstructionInfoCallback(
 		    void* ctxt, const uint8_t* data, uint64_t addr, size_t maxLen, BNInstructionInfo* result);
+		static size_t GetInstructionInfoBatchCallback(void* ctxt, const uint8_t* data, uint64_t addr, size_t len,
+		    BNInstructionInfo* results, size_t maxCount);
 		static bool GetInstructionTextCallback(void* ctxt, const uint8_t* data, uint64_t addr, size_t* len,
 		    BNInstructionTextToken** result, size_t* count);
 		static void FreeInstructionTextCallback(BNInstructionTextToken* tokens, size_t count);
@@ -8041,6 +8429,15 @@ namespace BinaryNinja {
 
 		virtual Ref<Architecture> GetAssociatedArchitectureByAddress(uint64_t& addr);
 
+		/*! Get the hit and miss counts of the decode cache used through DecodeCached
+
+			Lookups are counted per thread and added to these totals in batches, so the most recent lookups of each
+			thread may not be included yet.
+
+			\return Decode cache statistics, all zero for architectures that don't use the cache
+		*/
+		ArchitectureDecodeCacheStatistics GetDecodeCacheStatistics() const;
+
 		/*! Retrieves an InstructionInfo struct for the instruction at the given virtual address
 
 		 	\note Architecture subclasses should implement this method.
@@ -8070,8 +8467,30 @@ namespace BinaryNinja {
 		*/
 		virtual bool GetInstructionInfo(const uint8_t* data, uint64_t addr, size_t maxLen, InstructionInfo& result) = 0;
 
+		/*! Retrieves InstructionInfo structs for consecutive instructions starting at the given virtual address
+
+			Decoding stops at the first instruction that can't be decoded or doesn't fit in \c len bytes, or once
+			\c maxCount instructions have been decoded. Each instruction starts where the previous one ended, no
+			matter what kind of branch it is.
+
+			\note The default implementation calls GetInstructionInfo for each instruction. Architecture subclasses
+			can override this to decode runs of instructions without the per instruction call overhead.
+
+			\param[in] data pointer to the instruction data to retrieve info for
+			\param[in] addr address of the first instruction
+			\param[in] len length of the instruction data
+			\param[out] results array of at least \c maxCount InstructionInfo structs
+			\param[in] maxCount maximum number of instructions to decode
+			\return Number of instructions for which info was retrieved
+		*/
+		virtual size_t GetInstructionInfoBatch(
+		    const uint8_t* data, uint64_t addr, size_t len, InstructionInfo* results, size_t maxCount);
+
 		/*! Retrieves a list of InstructionTextTokens
 
+			\note Architecture subclasses must implement this method. Architectures that produce their text through
+			GetInstructionTextTokens can implement it by returning GetInstructionTextFromTokens.
+
 			\param[in] data pointer to the instruction data to retrieve text for
 			\param[in] addr address of the instruction data to retrieve text for
 			\param[out] len will be written to with the length of the instruction data which was translated
@@ -8081,6 +8500,35 @@ namespace BinaryNinja {
 		virtual bool GetInstructionText(
 		    const uint8_t* data, uint64_t addr, size_t& len, std::vector<InstructionTextToken>& result) = 0;
 
+		/*! Retrieves InstructionTextTokens into a token sink
+
+			This is what is used when the core requests disassembly text. The default implementation calls
+			GetInstructionText and copies its tokens into the sink. Overriding it avoids allocating every token
+			separately.
+
+			\param[in] data pointer to the instruction data to retrieve text for
+			\param[in] addr address of the instruction data to retrieve text for
+			\param[out] len will be written to with the length of the instruction data which was translated
+			\param[out] result sink the tokens are added to
+			\return Whether instruction info was successfully retrieved.
+		*/
+		virtual bool GetInstructionTextTokens(
+		    const uint8_t* data, uint64_t addr, size_t& len, InstructionTextTokenSink& result);
+
+		/*! Implements GetInstructionText by calling GetInstructionTextTokens
+
+			\note Only use this from architectures that override GetInstructionTextTokens, otherwise the two call
+			each other forever.
+
+			\param[in] data pointer to the instruction data to retrieve text for
+			\param[in] addr address of the instruction data to retrieve text for
+			\param[out] len will be written to with the length of the instruction data which was translated
+			\param[out] result
+			\return Whether instruction info was successfully retrieved.
+		*/
+		bool GetInstructionTextFromTokens(
+		    const uint8_t* data, uint64_t addr, size_t& len, std::vector<InstructionTextToken>& result);
+
 		/*! Translates an instruction at addr and appends it onto the LowLevelILFunction& il.
 
 		    \note Architecture subclasses should implement this method.
@@ -8482,6 +8930,8 @@ namespace BinaryNinja {
 		virtual Ref<Architecture> GetAssociatedArchitectureByAddress(uint64_t& addr) override;
 		virtual bool GetInstructionInfo(
 		    const uint8_t* data, uint64_t addr, size_t maxLen, InstructionInfo& result) override;
+		virtual size_t GetInstructionInfoBatch(
+		    const uint8_t* data, uint64_t addr, size_t len, InstructionInfo* results, size_t maxCount) override;
 		virtual bool GetInstructionText(
 		    const uint8_t* data, uint64_t addr, size_t& len, std::vector<InstructionTextToken>& result) override;
 		virtual bool GetInstructionLowLevelIL(
@@ -8639,6 +9089,8 @@ namespace BinaryNinja {
 
 	  public:
 		ArchitectureHook(Architecture* base);
+		virtual size_t GetInstructionInfoBatch(
+		    const uint8_t* data, uint64_t addr, size_t len, InstructionInfo* results, size_t maxCount) override;
 	};
 
 	class Structure;
@@ -11673,6 +12125,21 @@ namespace BinaryNinja {
 		{}
 	};
 
+	/*! Read-only copy of every expression of an IL function, used by the `GetSnapshot` methods of the IL function
+		classes.
+
+		\tparam T Core instruction type of the IL level
+	*/
+	template <typename T>
+	struct ILFunctionSnapshot
+	{
+		std::vector<T> exprs;
+		// Expression index of each instruction
+		std::vector<size_t> instructionExprs;
+		// Instruction index of each expression
+		std::vector<size_t> exprInstructions;
+	};
+
 	struct LowLevelILInstruction;
 	struct RegisterOrFlag;
 	struct SSARegister;
@@ -12979,6 +13446,20 @@ namespace BinaryNinja {
 		size_t GetInstructionCount() const;
 		size_t GetExprCount() const;
 
+		/*! Copies every expression, and the mapping between instructions and expressions, out of the core.
+
+			The returned function refers to the same IL, but answers `GetRawExpr`, `GetInstruction`, `GetExpr`,
+			`GetIndexForInstruction`, `GetInstructionForExpr` and the instruction and expression counts from the copy.
+			Instructions obtained from it, and their operands, lists and maps, are therefore read without any further
+			calls into the core. Everything else is passed through to the live function.
+
+			The copy is not updated when the IL is modified, take a new snapshot afterwards.
+
+			\return A snapshot of this function
+		*/
+		Ref<LowLevelILFunction> GetSnapshot() const;
+		bool IsSnapshot() const { return m_snapshot != nullptr; }
+
 		void UpdateInstructionOperand(size_t i, size_t operandIndex, ExprId value);
 		void ReplaceExpr(size_t expr, size_t newExpr);
 		void SetExprAttributes(size_t expr, uint32_t attributes);
@@ -13088,6 +13569,9 @@ namespace BinaryNinja {
 		}
 
 		Ref<FlowGraph> CreateFunctionGraph(DisassemblySettings* settings = nullptr);
+
+	  private:
+		std::shared_ptr<const ILFunctionSnapshot<BNLowLevelILInstruction>> m_snapshot;
 	};
 
 	/*!
@@ -13354,6 +13838,20 @@ namespace BinaryNinja {
 		size_t GetInstructionCount() const;
 		size_t GetExprCount() const;
 
+		/*! Copies every expression, and the mapping between instructions and expressions, out of the core.
+
+			The returned function refers to the same IL, but answers `GetRawExpr`, `GetInstruction`, `GetExpr`,
+			`GetIndexForInstruction`, `GetInstructionForExpr` and the instruction and expression counts from the copy.
+			Instructions obtained from it, and their operands, lists and maps, are therefore read without any further
+			calls into the core. Everything else is passed through to the live function.
+
+			The copy is not updated when the IL is modified, take a new snapshot afterwards.
+
+			\return A snapshot of this function
+		*/
+		Ref<MediumLevelILFunction> GetSnapshot() const;
+		bool IsSnapshot() const { return m_snapshot != nullptr; }
+
 		void UpdateInstructionOperand(size_t i, size_t operandIndex, ExprId value);
 		void MarkInstructionForRemoval(size_t i);
 		void ReplaceInstruction(size_t i, ExprId expr);
@@ -13469,6 +13967,9 @@ namespace BinaryNinja {
 		std::set<size_t> GetLiveInstructionsForVariable(const Variable& var, bool includeLastUse = true);
 
 		Variable GetSplitVariableForDefinition(const Variable& var, size_t instrIndex);
+
+	  private:
+		std::shared_ptr<const ILFunctionSnapshot<BNMediumLevelILInstruction>> m_snapshot;
 	};
 
 	struct HighLevelILInstruction;
@@ -13688,6 +14189,20 @@ namespace BinaryNinja {
 		size_t GetInstructionCount() const;
 		size_t GetExprCount() const;
 
+		/*! Copies every expression, and the mapping between instructions and expressions, out of the core.
+
+			The returned function refers to the same IL, but answers `GetRawExpr`, `GetRawNonASTExpr`, `GetInstruction`, `GetExpr`,
+			`GetIndexForInstruction`, `GetInstructionForExpr` and the instruction and expression counts from the copy.
+			Instructions obtained from it, and their operands, lists and maps, are therefore read without any further
+			calls into the core. Everything else is passed through to the live function.
+
+			The copy is not updated when the IL is modified, take a new snapshot afterwards.
+
+			\return A snapshot of this function
+		*/
+		Ref<HighLevelILFunction> GetSnapshot() const;
+		bool IsSnapshot() const { return m_snapshot != nullptr; }
+
 		std::vector<Ref<BasicBlock>> GetBasicBlocks() const;
 		Ref<BasicBlock> GetBasicBlockForInstruction(size_t i) const;
 
@@ -13757,6 +14272,11 @@ namespace BinaryNinja {
 		std::set<Variable> GetVariables();
 		std::set<Variable> GetAliasedVariables();
 		std::set<SSAVariable> GetSSAVariables();
+
+	  private:
+		// Expressions in `m_snapshot` are the full AST form, these are the same expressions without it.
+		std::shared_ptr<const ILFunctionSnapshot<BNHighLevelILInstruction>> m_snapshot;
+		std::shared_ptr<const std::vector<BNHighLevelILInstruction>> m_nonASTSnapshot;
 	};
 
 	struct LineFormatterSettings
@@ -18481,6 +19001,35 @@ namespace BinaryNinja {
 		void Process();
 	};
 
+	/*! Accumulates relocation definitions and submits them to the core in chunks
+
+		Symbols referenced by more than one relocation are only passed to the core once per chunk. Any
+		pending relocations are submitted when the batch is destroyed.
+
+		\ingroup binaryview
+	*/
+	class RelocationBatch
+	{
+		Ref<BinaryView> m_view;
+		Ref<Architecture> m_arch;
+		size_t m_chunkSize;
+		std::vector<BNRelocationDefinition> m_relocs;
+		std::vector<Ref<Symbol>> m_symbols;
+		std::unordered_map<BNSymbol*, size_t> m_symbolIndices;
+
+		void Append(const BNRelocationInfo& info, uint64_t target, size_t symbol, uint64_t reloc);
+
+	public:
+		RelocationBatch(BinaryView* view, Architecture* arch, size_t chunkSize = 0x10000);
+		~RelocationBatch();
+		RelocationBatch(const RelocationBatch&) = delete;
+		RelocationBatch& operator=(const RelocationBatch&) = delete;
+
+		void Define(const BNRelocationInfo& info, uint64_t target, uint64_t reloc);
+		void Define(const BNRelocationInfo& info, Ref<Symbol> target, uint64_t reloc);
+		void Flush();
+	};
+
 	struct BaseAddressDetectionSettings
 	{
 		std::string Architecture;
@@ -37,7 +37,7 @@
 // Current ABI version for linking to the core. This is incremented any time
 // there are changes to the API that affect linking, including new functions,
 // new types, or modifications to existing functions or types.
-#define BN_CURRENT_CORE_ABI_VERSION 92
+#define BN_CURRENT_CORE_ABI_VERSION 99
 
 // Minimum ABI version that is supported for loading of plugins. Plugins that
 // are linked to an ABI version less than this will not be able to load and
@@ -99,6 +99,7 @@
 #define BN_INVALID_OPERAND       0xffffffff
 
 #define BN_INVALID_EXPR ((size_t)-1)
+#define BN_NO_RELOCATION_SYMBOL ((size_t)-1)
 
 #define BN_MAX_STRING_LENGTH 128
 
@@ -1174,6 +1175,15 @@ extern "C"
 		uint8_t typeConfidence;
 	} BNDataVariable;
 
+	typedef struct BNStructuredTable
+	{
+		uint64_t address;
+		BNType* elementType;
+		uint64_t elementSize;
+		uint64_t elementCount;
+		bool autoDefined;
+	} BNStructuredTable;
+
 	typedef struct BNDataVariableAndName
 	{
 		uint64_t address;
@@ -1753,6 +1763,14 @@ extern "C"
 		struct BNRelocationInfo* next;  // Link to relocation another related relocation
 	} BNRelocationInfo;
 
+	typedef struct BNRelocationDefinition
+	{
+		BNRelocationInfo info;
+		uint64_t target;  // Target address, used when symbol is BN_NO_RELOCATION_SYMBOL
+		size_t symbol;    // Index into the symbol table passed alongside the definitions
+		uint64_t reloc;   // Address of the relocation
+	} BNRelocationDefinition;
+
 	typedef struct BNInstructionTextToken
 	{
 		BNInstructionTextTokenType type;
@@ -1899,6 +1917,10 @@ extern "C"
 		bool (*alwaysBranch)(void* ctxt, uint8_t* data, uint64_t addr, size_t len);
 		bool (*invertBranch)(void* ctxt, uint8_t* data, uint64_t addr, size_t len);
 		bool (*skipAndReturnValue)(void* ctxt, uint8_t* data, uint64_t addr, size_t len, uint64_t value);
+
+		// Added in ABI version 97, only read for plugins built against 97 or later. May be null.
+		size_t (*getInstructionInfoBatch)(void* ctxt, const uint8_t* data, uint64_t addr, size_t len,
+		    BNInstructionInfo* results, size_t maxCount);
 	} BNCustomArchitecture;
 
 	typedef struct BNCustomPlatform
@@ -4135,6 +4157,8 @@ extern "C"
 
 	BINARYNINJACOREAPI void BNDefineRelocation(BNBinaryView* view, BNArchitecture* arch, BNRelocationInfo* info, uint64_t target, uint64_t reloc);
 	BINARYNINJACOREAPI void BNDefineSymbolRelocation(BNBinaryView* view, BNArchitecture* arch, BNRelocationInfo* info, BNSymbol* target, uint64_t reloc);
+	BINARYNINJACOREAPI void BNDefineRelocations(BNBinaryView* view, BNArchitecture* arch,
+		BNRelocationDefinition* relocs, size_t count, BNSymbol** symbols, size_t symbolCount);
 	BINARYNINJACOREAPI BNRange* BNGetRelocationRanges(BNBinaryView* view, size_t* count);
 	BINARYNINJACOREAPI BNRange* BNGetRelocationRangesAtAddress(BNBinaryView* view, uint64_t addr, size_t* count);
 	BINARYNINJACOREAPI BNRange* BNGetRelocationRangesInRange(BNBinaryView* view, uint64_t addr, uint64_t size, size_t* count);
@@ -4422,6 +4446,8 @@ extern "C"
 	BINARYNINJACOREAPI BNArchitecture* BNGetAssociatedArchitectureByAddress(BNArchitecture* arch, uint64_t* addr);
 	BINARYNINJACOREAPI bool BNGetInstructionInfo(
 	    BNArchitecture* arch, const uint8_t* data, uint64_t addr, size_t maxLen, BNInstructionInfo* result);
+	BINARYNINJACOREAPI size_t BNGetInstructionInfoBatch(BNArchitecture* arch, const uint8_t* data, uint64_t addr,
+	    size_t len, BNInstructionInfo* results, size_t maxCount);
 	BINARYNINJACOREAPI bool BNGetInstructionText(BNArchitecture* arch, const uint8_t* data, uint64_t addr, size_t* len,
 	    BNInstructionTextToken** result, size_t* count);
 	BINARYNINJACOREAPI bool BNGetInstructionLowLevelIL(
@@ -4531,6 +4557,8 @@ extern "C"
 	BINARYNINJACOREAPI void BNAddAnalysisOption(BNBinaryView* view, const char* name);
 	BINARYNINJACOREAPI BNFunction* BNAddFunctionForAnalysis(
 		BNBinaryView* view, BNPlatform* platform, uint64_t addr, bool autoDiscovered, BNType* type);
+	BINARYNINJACOREAPI void BNAddFunctionsForAnalysis(
+		BNBinaryView* view, BNPlatform* platform, const uint64_t* addrs, size_t count, bool autoDiscovered);
 	BINARYNINJACOREAPI void BNAddEntryPointForAnalysis(BNBinaryView* view, BNPlatform* platform, uint64_t addr);
 	BINARYNINJACOREAPI void BNRemoveAnalysisFunction(BNBinaryView* view, BNFunction* func, bool updateRefs);
 	BINARYNINJACOREAPI BNFunction* BNCreateUserFunction(BNBinaryView* view, BNPlatform* platform, uint64_t addr);
@@ -5169,6 +5197,14 @@ extern "C"
 		BNDataVariableAndNameAndDebugParser* vars, size_t count);
 	BINARYNINJACOREAPI bool BNGetDataVariableAtAddress(BNBinaryView* view, uint64_t addr, BNDataVariable* var);
 
+	BINARYNINJACOREAPI void BNDefineStructuredTable(
+		BNBinaryView* view, uint64_t addr, BNType* elementType, uint64_t elementCount);
+	BINARYNINJACOREAPI void BNUndefineStructuredTable(BNBinaryView* view, uint64_t addr);
+	BINARYNINJACOREAPI BNStructuredTable* BNGetStructuredTables(BNBinaryView* view, size_t* count);
+	BINARYNINJACOREAPI bool BNGetStructuredTableContaining(BNBinaryView* view, uint64_t addr, BNStructuredTable* table);
+	BINARYNINJACOREAPI void BNFreeStructuredTable(BNStructuredTable* table);
+	BINARYNINJACOREAPI void BNFreeStructuredTables(BNStructuredTable* tables, size_t count);
+
 	BINARYNINJACOREAPI bool BNParseTypeString(BNBinaryView* view, const char* text, BNQualifiedNameAndType* result,
 	    char** errors, BNQualifiedNameList* typesAllowRedefinition, bool importDepencencies);
 	BINARYNINJACOREAPI bool BNParseTypesString(BNBinaryView* view, const char* text, const char* const* options, size_t optionCount,
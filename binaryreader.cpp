@@ -515,3 +515,138 @@ string BinaryReader::ReadCString(size_t maxSize)
 	}
 	return result;
 }
+
+
+MappedBinaryReader::MappedBinaryReader(BinaryView* data, BNEndianness endian) :
+	m_reader(data, endian), m_view(data), m_endian(endian)
+{
+}
+
+
+bool MappedBinaryReader::Map(uint64_t start, size_t len)
+{
+	Unmap();
+
+	// Don't trust table sizes from headers with allocating
+	uint64_t end = m_view->GetEnd();
+	if (start >= end)
+		return len == 0;
+	size_t available = (end - start < len) ? (size_t)(end - start) : len;
+
+	m_data.resize(available);
+	m_data.resize(BNReadViewData(m_view->GetObject(), m_data.data(), start, available));
+	m_start = start;
+	return m_data.size() == len;
+}
+
+
+void MappedBinaryReader::Unmap()
+{
+	m_data.clear();
+	m_data.shrink_to_fit();
+	m_start = 0;
+}
+
+
+void MappedBinaryReader::SetEndianness(BNEndianness endian)
+{
+	m_endian = endian;
+	m_reader.SetEndianness(endian);
+}
+
+
+DataBuffer MappedBinaryReader::Read(size_t len)
+{
+	DataBuffer result(len);
+	Read(result.GetData(), len);
+	return result;
+}
+
+
+bool MappedBinaryReader::TryRead(void* dest, size_t len)
+{
+	if (const uint8_t* data = MappedAt(len))
+	{
+		memcpy(dest, data, len);
+		m_offset += len;
+		return true;
+	}
+
+	m_reader.Seek(m_offset);
+	if (!m_reader.TryRead(dest, len))
+		return false;
+	m_offset += len;
+	return true;
+}
+
+
+bool MappedBinaryReader::TryReadUnmapped(uint8_t& result)
+{
+	m_reader.Seek(m_offset);
+	if (!m_reader.TryRead8(result))
+		return false;
+	m_offset += sizeof(result);
+	return true;
+}
+
+
+bool MappedBinaryReader::TryReadUnmapped(uint16_t& result)
+{
+	m_reader.Seek(m_offset);
+	if (!m_reader.TryRead16(result))
+		return false;
+	m_offset += sizeof(result);
+	return true;
+}
+
+
+bool MappedBinaryReader::TryReadUnmapped(uint32_t& result)
+{
+	m_reader.Seek(m_offset);
+	if (!m_reader.TryRead32(result))
+		return false;
+	m_offset += sizeof(result);
+	return true;
+}
+
+
+bool MappedBinaryReader::TryReadUnmapped(uint64_t& result)
+{
+	m_reader.Seek(m_offset);
+	if (!m_reader.TryRead64(result))
+		return false;
+	m_offset += sizeof(result);
+	return true;
+}
+
+
+uint64_t MappedBinaryReader::ReadPointer()
+{
+	switch (m_view->GetAddressSize())
+	{
+	case 1:
+		return Read8();
+	case 2:
+		return Read16();
+	case 4:
+		return Read32();
+	case 8:
+		return Read64();
+	default:
+		throw ReadException();
+	}
+}
+
+
+string MappedBinaryReader::ReadCString(size_t maxSize)
+{
+	string result;
+	for (size_t i = 0; i < maxSize; i++)
+	{
+		uint8_t cur;
+		if (!TryRead8(cur) || cur == 0)
+			break;
+		result.push_back((char)cur);
+	}
+	return result;
+}
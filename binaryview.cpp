@@ -1693,6 +1693,32 @@ void BinaryView::DefineRelocation(Architecture* arch, BNRelocationInfo& info, Re
 }
 
 
+void BinaryView::DefineRelocations(Architecture* arch, vector<BNRelocationDefinition>& relocs,
+	const vector<Ref<Symbol>>& symbols)
+{
+	// BNDefineRelocations was added in core ABI version 99, older cores only define one relocation per call
+	static const bool coreHasBatch = BNGetCurrentCoreABIVersion() >= 99;
+	if (!coreHasBatch)
+	{
+		for (auto& reloc : relocs)
+		{
+			if (reloc.symbol == BN_NO_RELOCATION_SYMBOL)
+				BNDefineRelocation(m_object, arch->GetObject(), &reloc.info, reloc.target, reloc.reloc);
+			else
+				BNDefineSymbolRelocation(
+					m_object, arch->GetObject(), &reloc.info, symbols[reloc.symbol]->GetObject(), reloc.reloc);
+		}
+		return;
+	}
+
+	vector<BNSymbol*> apiSymbols;
+	apiSymbols.reserve(symbols.size());
+	for (auto& symbol : symbols)
+		apiSymbols.push_back(symbol->GetObject());
+	BNDefineRelocations(m_object, arch->GetObject(), relocs.data(), relocs.size(), apiSymbols.data(), apiSymbols.size());
+}
+
+
 vector<pair<uint64_t, uint64_t>> BinaryView::GetRelocationRanges() const
 {
 	size_t count = 0;
@@ -1983,6 +2009,30 @@ Ref<Function> BinaryView::AddFunctionForAnalysis(Platform* platform, uint64_t ad
 }
 
 
+void BinaryView::AddFunctionsForAnalysis(Platform* platform, const vector<uint64_t>& addrs, bool autoDiscovered)
+{
+	AddFunctionsForAnalysis(platform, addrs.data(), addrs.size(), autoDiscovered);
+}
+
+
+void BinaryView::AddFunctionsForAnalysis(Platform* platform, const uint64_t* addrs, size_t count, bool autoDiscovered)
+{
+	// BNAddFunctionsForAnalysis was added in core ABI version 98, older cores only add one function per call
+	static const bool coreHasBatch = BNGetCurrentCoreABIVersion() >= 98;
+	if (!coreHasBatch)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			BNFunction* func = BNAddFunctionForAnalysis(m_object, platform->GetObject(), addrs[i], autoDiscovered, nullptr);
+			if (func)
+				BNFreeFunction(func);
+		}
+		return;
+	}
+	BNAddFunctionsForAnalysis(m_object, platform->GetObject(), addrs, count, autoDiscovered);
+}
+
+
 void BinaryView::AddEntryPointForAnalysis(Platform* platform, uint64_t addr)
 {
 	BNAddEntryPointForAnalysis(m_object, platform->GetObject(), addr);
@@ -2124,6 +2174,51 @@ bool BinaryView::GetDataVariableAtAddress(uint64_t addr, DataVariable& var)
 }
 
 
+void BinaryView::DefineStructuredTable(uint64_t addr, Ref<Type> elementType, uint64_t count)
+{
+	BNDefineStructuredTable(m_object, addr, elementType->GetObject(), count);
+}
+
+
+void BinaryView::UndefineStructuredTable(uint64_t addr)
+{
+	BNUndefineStructuredTable(m_object, addr);
+}
+
+
+vector<StructuredTable> BinaryView::GetStructuredTables()
+{
+	size_t count;
+	BNStructuredTable* tables = BNGetStructuredTables(m_object, &count);
+
+	vector<StructuredTable> result;
+	result.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		result.emplace_back(tables[i].address, new Type(BNNewTypeReference(tables[i].elementType)),
+			tables[i].elementSize, tables[i].elementCount, tables[i].autoDefined);
+	}
+
+	BNFreeStructuredTables(tables, count);
+	return result;
+}
+
+
+bool BinaryView::GetStructuredTableContaining(uint64_t addr, StructuredTable& table)
+{
+	table = StructuredTable();
+
+	BNStructuredTable result;
+	if (!BNGetStructuredTableContaining(m_object, addr, &result))
+		return false;
+
+	table = StructuredTable(result.address, new Type(BNNewTypeReference(result.elementType)), result.elementSize,
+		result.elementCount, result.autoDefined);
+	BNFreeStructuredTable(&result);
+	return true;
+}
+
+
 vector<Ref<Function>> BinaryView::GetAnalysisFunctionList()
 {
 	size_t count;
@@ -5580,3 +5675,54 @@ void SymbolQueue::Process()
 {
 	BNProcessSymbolQueue(m_object);
 }
+
+
+RelocationBatch::RelocationBatch(BinaryView* view, Architecture* arch, size_t chunkSize) :
+	m_view(view), m_arch(arch), m_chunkSize(chunkSize ? chunkSize : 1)
+{
+}
+
+
+RelocationBatch::~RelocationBatch()
+{
+	Flush();
+}
+
+
+void RelocationBatch::Append(const BNRelocationInfo& info, uint64_t target, size_t symbol, uint64_t reloc)
+{
+	BNRelocationDefinition def;
+	def.info = info;
+	def.target = target;
+	def.symbol = symbol;
+	def.reloc = reloc;
+	m_relocs.push_back(def);
+	if (m_relocs.size() >= m_chunkSize)
+		Flush();
+}
+
+
+void RelocationBatch::Define(const BNRelocationInfo& info, uint64_t target, uint64_t reloc)
+{
+	Append(info, target, BN_NO_RELOCATION_SYMBOL, reloc);
+}
+
+
+void RelocationBatch::Define(const BNRelocationInfo& info, Ref<Symbol> target, uint64_t reloc)
+{
+	auto [it, inserted] = m_symbolIndices.try_emplace(target->GetObject(), m_symbols.size());
+	if (inserted)
+		m_symbols.push_back(target);
+	Append(info, 0, it->second, reloc);
+}
+
+
+void RelocationBatch::Flush()
+{
+	if (m_relocs.empty())
+		return;
+	m_view->DefineRelocations(m_arch, m_relocs, m_symbols);
+	m_relocs.clear();
+	m_symbols.clear();
+	m_symbolIndices.clear();
+}
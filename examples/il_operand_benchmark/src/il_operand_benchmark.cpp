@@ -0,0 +1,164 @@
+// Compares operand index lookups through the per-operation hash maps (`operationOperandIndex`) against the dense
+// compile-time tables (`operationOperandIndexTable`) that `GetOperandIndexForUsage` uses. The maps are still
+// computed at startup by walking the operand usage lists, separately from the tables, so a wrong table entry shows
+// up as a lookup mismatch.
+//
+// A synthetic pool of instructions is generated from the operand usage lists of each IL, then walked the way the
+// operand accessors do: every usage an instruction has is looked up, followed by a usage it doesn't have (as in a
+// `GetSourceExpr` on an operation without a source). No binary is loaded, so this only needs the API library.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "binaryninjacore.h"
+#include "binaryninjaapi.h"
+#include "lowlevelilinstruction.h"
+#include "mediumlevelilinstruction.h"
+#include "highlevelilinstruction.h"
+
+using namespace BinaryNinja;
+using namespace std;
+
+
+template <typename Instruction, typename Usage>
+struct SyntheticInstruction
+{
+	Instruction instr;
+	vector<Usage> usages;
+};
+
+
+template <typename Instruction, typename Operation, typename Usage>
+static vector<SyntheticInstruction<Instruction, Usage>> GeneratePool(
+    const unordered_map<Operation, vector<Usage>>& operationOperandUsage, size_t count)
+{
+	vector<pair<Operation, const vector<Usage>*>> operations;
+	for (auto& i : operationOperandUsage)
+		operations.emplace_back(i.first, &i.second);
+	sort(operations.begin(), operations.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+	mt19937 rng(0x5eed);
+	uniform_int_distribution<size_t> pick(0, operations.size() - 1);
+	vector<SyntheticInstruction<Instruction, Usage>> pool(count);
+	for (auto& entry : pool)
+	{
+		auto& operation = operations[pick(rng)];
+		entry.instr.operation = operation.first;
+		entry.usages = *operation.second;
+	}
+	return pool;
+}
+
+
+template <typename Operation, typename Usage>
+static bool MapLookup(const unordered_map<Operation, unordered_map<Usage, size_t>>& operationOperandIndex,
+    Operation operation, Usage usage, size_t& operandIndex)
+{
+	auto operationIter = operationOperandIndex.find(operation);
+	if (operationIter == operationOperandIndex.end())
+		return false;
+	auto usageIter = operationIter->second.find(usage);
+	if (usageIter == operationIter->second.end())
+		return false;
+	operandIndex = usageIter->second;
+	return true;
+}
+
+
+template <typename F>
+static double TimeMilliseconds(size_t iterations, F&& f)
+{
+	auto start = chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++)
+		f();
+	auto end = chrono::steady_clock::now();
+	return chrono::duration<double, milli>(end - start).count() / iterations;
+}
+
+
+template <typename Base, typename Instruction, typename Operation, typename Usage>
+static bool Benchmark(const char* name, Usage probe, size_t poolSize, size_t iterations)
+{
+	auto pool = GeneratePool<Instruction>(Base::operationOperandUsage, poolSize);
+
+	// Both lookups have to agree before their timings mean anything.
+	size_t lookups = 0;
+	for (auto& entry : pool)
+	{
+		vector<Usage> usages = entry.usages;
+		usages.push_back(probe);
+		for (auto usage : usages)
+		{
+			size_t mapIndex = 0, tableIndex = 0;
+			bool inMap = MapLookup(Base::operationOperandIndex, entry.instr.operation, usage, mapIndex);
+			bool inTable = entry.instr.GetOperandIndexForUsage(usage, tableIndex);
+			if (inMap != inTable || mapIndex != tableIndex)
+			{
+				fprintf(stderr, "%s: lookup mismatch for operation %d usage %d\n", name, (int)entry.instr.operation,
+				    (int)usage);
+				return false;
+			}
+			lookups++;
+		}
+	}
+
+	size_t mapSum = 0;
+	double mapTime = TimeMilliseconds(iterations, [&]() {
+		for (auto& entry : pool)
+		{
+			size_t operandIndex;
+			for (auto usage : entry.usages)
+				if (MapLookup(Base::operationOperandIndex, entry.instr.operation, usage, operandIndex))
+					mapSum += operandIndex;
+			if (MapLookup(Base::operationOperandIndex, entry.instr.operation, probe, operandIndex))
+				mapSum += operandIndex;
+		}
+	});
+
+	size_t tableSum = 0;
+	double tableTime = TimeMilliseconds(iterations, [&]() {
+		for (auto& entry : pool)
+		{
+			size_t operandIndex;
+			for (auto usage : entry.usages)
+				if (entry.instr.GetOperandIndexForUsage(usage, operandIndex))
+					tableSum += operandIndex;
+			if (entry.instr.GetOperandIndexForUsage(probe, operandIndex))
+				tableSum += operandIndex;
+		}
+	});
+
+	if (mapSum != tableSum)
+	{
+		fprintf(stderr, "%s: checksum mismatch\n", name);
+		return false;
+	}
+
+	printf("%-5s %10zu %14.3f %14.3f %10.2fx\n", name, lookups, mapTime, tableTime, mapTime / tableTime);
+	return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+	size_t poolSize = argc > 1 ? strtoul(argv[1], nullptr, 0) : 100000;
+	size_t iterations = argc > 2 ? strtoul(argv[2], nullptr, 0) : 20;
+	if (poolSize == 0 || iterations == 0)
+	{
+		fprintf(stderr, "usage: %s [pool size] [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	printf("%-5s %10s %14s %14s %11s\n", "il", "lookups", "map (ms)", "table (ms)", "speedup");
+	bool ok = Benchmark<LowLevelILInstructionBase, LowLevelILInstruction, BNLowLevelILOperation>(
+	    "llil", SourceExprLowLevelOperandUsage, poolSize, iterations);
+	ok &= Benchmark<MediumLevelILInstructionBase, MediumLevelILInstruction, BNMediumLevelILOperation>(
+	    "mlil", SourceExprMediumLevelOperandUsage, poolSize, iterations);
+	ok &= Benchmark<HighLevelILInstructionBase, HighLevelILInstruction, BNHighLevelILOperation>(
+	    "hlil", SourceExprHighLevelOperandUsage, poolSize, iterations);
+	return ok ? 0 : 1;
+}
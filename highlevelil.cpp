@@ -162,12 +162,16 @@ ExprId HighLevelILFunction::AddSSAVariableList(const vector<SSAVariable>& vars)
 
 BNHighLevelILInstruction HighLevelILFunction::GetRawExpr(size_t i) const
 {
+	if (m_snapshot && i < m_snapshot->exprs.size())
+		return m_snapshot->exprs[i];
 	return BNGetHighLevelILByIndex(m_object, i, true);
 }
 
 
 BNHighLevelILInstruction HighLevelILFunction::GetRawNonASTExpr(size_t i) const
 {
+	if (m_nonASTSnapshot && i < m_nonASTSnapshot->size())
+		return (*m_nonASTSnapshot)[i];
 	return BNGetHighLevelILByIndex(m_object, i, false);
 }
 
@@ -195,28 +199,73 @@ HighLevelILInstruction HighLevelILFunction::GetExpr(size_t i, bool asFullAst)
 
 size_t HighLevelILFunction::GetIndexForInstruction(size_t i) const
 {
+	if (m_snapshot && i < m_snapshot->instructionExprs.size())
+		return m_snapshot->instructionExprs[i];
 	return BNGetHighLevelILIndexForInstruction(m_object, i);
 }
 
 
 size_t HighLevelILFunction::GetInstructionForExpr(size_t expr) const
 {
+	if (m_snapshot && expr < m_snapshot->exprInstructions.size())
+		return m_snapshot->exprInstructions[expr];
 	return BNGetHighLevelILInstructionForExpr(m_object, expr);
 }
 
 
 size_t HighLevelILFunction::GetInstructionCount() const
 {
+	if (m_snapshot)
+		return m_snapshot->instructionExprs.size();
 	return BNGetHighLevelILInstructionCount(m_object);
 }
 
 
 size_t HighLevelILFunction::GetExprCount() const
 {
+	if (m_snapshot)
+		return m_snapshot->exprs.size();
 	return BNGetHighLevelILExprCount(m_object);
 }
 
 
+Ref<HighLevelILFunction> HighLevelILFunction::GetSnapshot() const
+{
+	Ref<HighLevelILFunction> result = new HighLevelILFunction(BNNewHighLevelILFunctionReference(m_object));
+	if (m_snapshot)
+	{
+		result->m_snapshot = m_snapshot;
+		result->m_nonASTSnapshot = m_nonASTSnapshot;
+		return result;
+	}
+
+	// The core has no bulk accessor, so this is one pass of per-index calls up front instead of one (or more) per
+	// operand access later.
+	auto snapshot = std::make_shared<ILFunctionSnapshot<BNHighLevelILInstruction>>();
+	size_t exprCount = BNGetHighLevelILExprCount(m_object);
+	size_t instrCount = BNGetHighLevelILInstructionCount(m_object);
+	snapshot->exprs.reserve(exprCount);
+	snapshot->exprInstructions.reserve(exprCount);
+	for (size_t i = 0; i < exprCount; i++)
+	{
+		snapshot->exprs.push_back(BNGetHighLevelILByIndex(m_object, i, true));
+		snapshot->exprInstructions.push_back(BNGetHighLevelILInstructionForExpr(m_object, i));
+	}
+	snapshot->instructionExprs.reserve(instrCount);
+	for (size_t i = 0; i < instrCount; i++)
+		snapshot->instructionExprs.push_back(BNGetHighLevelILIndexForInstruction(m_object, i));
+
+	auto nonAST = std::make_shared<std::vector<BNHighLevelILInstruction>>();
+	nonAST->reserve(exprCount);
+	for (size_t i = 0; i < exprCount; i++)
+		nonAST->push_back(BNGetHighLevelILByIndex(m_object, i, false));
+
+	result->m_snapshot = std::move(snapshot);
+	result->m_nonASTSnapshot = std::move(nonAST);
+	return result;
+}
+
+
 vector<Ref<BasicBlock>> HighLevelILFunction::GetBasicBlocks() const
 {
 	size_t count;
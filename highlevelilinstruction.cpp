@@ -19,6 +19,7 @@
 // IN THE SOFTWARE.
 
 #include <string.h>
+#include <initializer_list>
 #ifdef BINARYNINJACORE_LIBRARY
 	#include "highlevelilfunction.h"
 	#include "highlevelilssafunction.h"
@@ -37,7 +38,30 @@ using namespace std;
 #endif
 
 
-unordered_map<HighLevelILOperandUsage, HighLevelILOperandType> HighLevelILInstructionBase::operandTypeForUsage = {
+struct HighLevelILOperandTypeForUsage
+{
+	HighLevelILOperandUsage usage;
+	HighLevelILOperandType type;
+};
+
+
+struct HighLevelILOperationOperandUsages
+{
+	BNHighLevelILOperation operation;
+	size_t count;
+	HighLevelILOperandUsage usages[8];
+
+	constexpr HighLevelILOperationOperandUsages(
+	    BNHighLevelILOperation op, std::initializer_list<HighLevelILOperandUsage> list) :
+	    operation(op), count(list.size()), usages {}
+	{
+		for (size_t i = 0; i < count; i++)
+			usages[i] = list.begin()[i];
+	}
+};
+
+
+static constexpr HighLevelILOperandTypeForUsage s_operandTypeForUsage[] = {
     {SourceExprHighLevelOperandUsage, ExprHighLevelOperand},
     {VariableHighLevelOperandUsage, VariableHighLevelOperand},
     {DestVariableHighLevelOperandUsage, VariableHighLevelOperand},
@@ -77,8 +101,8 @@ unordered_map<HighLevelILOperandUsage, HighLevelILOperandType> HighLevelILInstru
     {DestMemoryVersionHighLevelOperandUsage, IndexHighLevelOperand}};
 
 
-unordered_map<BNHighLevelILOperation, vector<HighLevelILOperandUsage>>
-    HighLevelILInstructionBase::operationOperandUsage = {{HLIL_NOP, {}}, {HLIL_BREAK, {}}, {HLIL_CONTINUE, {}},
+static constexpr HighLevelILOperationOperandUsages s_operationOperandUsage[] = {
+    {HLIL_NOP, {}}, {HLIL_BREAK, {}}, {HLIL_CONTINUE, {}},
         {HLIL_NORET, {}}, {HLIL_BP, {}}, {HLIL_UNDEF, {}}, {HLIL_UNIMPL, {}}, {HLIL_UNREACHABLE, {}},
         {HLIL_BLOCK, {BlockExprsHighLevelOperandUsage}},
         {HLIL_IF, {ConditionExprHighLevelOperandUsage, TrueExprHighLevelOperandUsage, FalseExprHighLevelOperandUsage}},
@@ -199,6 +223,84 @@ unordered_map<BNHighLevelILOperation, vector<HighLevelILOperandUsage>>
         {HLIL_FCMP_UO, {LeftExprHighLevelOperandUsage, RightExprHighLevelOperandUsage}}};
 
 
+static constexpr HighLevelILOperandType GetOperandTypeForUsage(HighLevelILOperandUsage usage)
+{
+	for (auto& entry : s_operandTypeForUsage)
+	{
+		if (entry.usage == usage)
+			return entry.type;
+	}
+	return HighLevelILOperandType();
+}
+
+
+static constexpr HighLevelILOperandIndexTable GetOperandIndexTable()
+{
+	HighLevelILOperandIndexTable result {};
+	for (auto& operation : result.index)
+	{
+		for (auto& operand : operation)
+			operand = HighLevelILOperandIndexTable::InvalidIndex;
+	}
+
+	for (auto& operation : s_operationOperandUsage)
+	{
+		size_t operand = 0;
+		for (size_t i = 0; i < operation.count; i++)
+		{
+			HighLevelILOperandUsage usage = operation.usages[i];
+			result.index[operation.operation][usage] = (uint8_t)operand;
+			switch (GetOperandTypeForUsage(usage))
+			{
+			case SSAVariableHighLevelOperand:
+			case SSAVariableListHighLevelOperand:
+			case ExprListHighLevelOperand:
+			case IndexListHighLevelOperand:
+				// SSA variables and lists take two operand slots
+				operand += 2;
+				break;
+			default:
+				operand++;
+				break;
+			}
+		}
+	}
+	return result;
+}
+
+
+// Evaluated at compile time so a usage list that doesn't fit the table fails the build
+static constexpr HighLevelILOperandIndexTable s_operandIndexTable = GetOperandIndexTable();
+const HighLevelILOperandIndexTable HighLevelILInstructionBase::operationOperandIndexTable = s_operandIndexTable;
+
+
+static unordered_map<HighLevelILOperandUsage, HighLevelILOperandType> GetOperandTypesForUsages()
+{
+	unordered_map<HighLevelILOperandUsage, HighLevelILOperandType> result;
+	result.reserve(sizeof(s_operandTypeForUsage) / sizeof(s_operandTypeForUsage[0]));
+	for (auto& entry : s_operandTypeForUsage)
+		result.emplace(entry.usage, entry.type);
+	// Usages that operations refer to but that have no entry of their own resolve to the default type
+	for (auto& operation : s_operationOperandUsage)
+	{
+		for (size_t i = 0; i < operation.count; i++)
+			result.emplace(operation.usages[i], GetOperandTypeForUsage(operation.usages[i]));
+	}
+	return result;
+}
+
+
+static unordered_map<BNHighLevelILOperation, vector<HighLevelILOperandUsage>> GetOperandUsagesForOperations()
+{
+	unordered_map<BNHighLevelILOperation, vector<HighLevelILOperandUsage>> result;
+	result.reserve(sizeof(s_operationOperandUsage) / sizeof(s_operationOperandUsage[0]));
+	for (auto& operation : s_operationOperandUsage)
+		result.emplace(
+		    operation.operation, vector<HighLevelILOperandUsage>(operation.usages, operation.usages + operation.count));
+	return result;
+}
+
+
 static unordered_map<BNHighLevelILOperation, unordered_map<HighLevelILOperandUsage, size_t>>
     GetOperandIndexForOperandUsages()
 {
@@ -231,6 +333,10 @@ static unordered_map<BNHighLevelILOperation, unordered_map<HighLevelILOperandUsa
 }
 
 
+unordered_map<HighLevelILOperandUsage, HighLevelILOperandType>
+    HighLevelILInstructionBase::operandTypeForUsage = GetOperandTypesForUsages();
+unordered_map<BNHighLevelILOperation, vector<HighLevelILOperandUsage>>
+    HighLevelILInstructionBase::operationOperandUsage = GetOperandUsagesForOperations();
 unordered_map<BNHighLevelILOperation, unordered_map<HighLevelILOperandUsage, size_t>>
     HighLevelILInstructionBase::operationOperandIndex = GetOperandIndexForOperandUsages();
 
@@ -1037,7 +1143,7 @@ HighLevelILInstruction HighLevelILInstructionBase::GetParent() const
 }
 
 
-void HighLevelILInstruction::CollectSubExprs(stack<size_t>& toProcess) const
+void HighLevelILInstruction::CollectSubExprs(vector<size_t>& toProcess) const
 {
 	vector<HighLevelILInstruction> exprs;
 	switch (operation)
@@ -1045,152 +1151,152 @@ void HighLevelILInstruction::CollectSubExprs(stack<size_t>& toProcess) const
 	case HLIL_BLOCK:
 		exprs = GetBlockExprs<HLIL_BLOCK>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
+			toProcess.push_back(i->exprIndex);
 		break;
 	case HLIL_IF:
 		if (ast)
 		{
-			toProcess.push(GetFalseExpr<HLIL_IF>().exprIndex);
-			toProcess.push(GetTrueExpr<HLIL_IF>().exprIndex);
+			toProcess.push_back(GetFalseExpr<HLIL_IF>().exprIndex);
+			toProcess.push_back(GetTrueExpr<HLIL_IF>().exprIndex);
 		}
-		toProcess.push(GetConditionExpr<HLIL_IF>().exprIndex);
+		toProcess.push_back(GetConditionExpr<HLIL_IF>().exprIndex);
 		break;
 	case HLIL_WHILE:
 		if (ast)
-			toProcess.push(GetLoopExpr<HLIL_WHILE>().exprIndex);
-		toProcess.push(GetConditionExpr<HLIL_WHILE>().exprIndex);
+			toProcess.push_back(GetLoopExpr<HLIL_WHILE>().exprIndex);
+		toProcess.push_back(GetConditionExpr<HLIL_WHILE>().exprIndex);
 		break;
 	case HLIL_WHILE_SSA:
 		if (ast)
-			toProcess.push(GetLoopExpr<HLIL_WHILE_SSA>().exprIndex);
-		toProcess.push(GetConditionExpr<HLIL_WHILE_SSA>().exprIndex);
-		toProcess.push(GetConditionPhiExpr<HLIL_WHILE_SSA>().exprIndex);
+			toProcess.push_back(GetLoopExpr<HLIL_WHILE_SSA>().exprIndex);
+		toProcess.push_back(GetConditionExpr<HLIL_WHILE_SSA>().exprIndex);
+		toProcess.push_back(GetConditionPhiExpr<HLIL_WHILE_SSA>().exprIndex);
 		break;
 	case HLIL_DO_WHILE:
-		toProcess.push(GetConditionExpr<HLIL_DO_WHILE>().exprIndex);
+		toProcess.push_back(GetConditionExpr<HLIL_DO_WHILE>().exprIndex);
 		if (ast)
-			toProcess.push(GetLoopExpr<HLIL_DO_WHILE>().exprIndex);
+			toProcess.push_back(GetLoopExpr<HLIL_DO_WHILE>().exprIndex);
 		break;
 	case HLIL_DO_WHILE_SSA:
-		toProcess.push(GetConditionExpr<HLIL_DO_WHILE_SSA>().exprIndex);
-		toProcess.push(GetConditionPhiExpr<HLIL_DO_WHILE_SSA>().exprIndex);
+		toProcess.push_back(GetConditionExpr<HLIL_DO_WHILE_SSA>().exprIndex);
+		toProcess.push_back(GetConditionPhiExpr<HLIL_DO_WHILE_SSA>().exprIndex);
 		if (ast)
-			toProcess.push(GetLoopExpr<HLIL_DO_WHILE_SSA>().exprIndex);
+			toProcess.push_back(GetLoopExpr<HLIL_DO_WHILE_SSA>().exprIndex);
 		break;
 	case HLIL_FOR:
 		if (ast)
-			toProcess.push(GetLoopExpr<HLIL_FOR>().exprIndex);
-		toProcess.push(GetUpdateExpr<HLIL_FOR>().exprIndex);
-		toProcess.push(GetConditionExpr<HLIL_FOR>().exprIndex);
-		toProcess.push(GetInitExpr<HLIL_FOR>().exprIndex);
+			toProcess.push_back(GetLoopExpr<HLIL_FOR>().exprIndex);
+		toProcess.push_back(GetUpdateExpr<HLIL_FOR>().exprIndex);
+		toProcess.push_back(GetConditionExpr<HLIL_FOR>().exprIndex);
+		toProcess.push_back(GetInitExpr<HLIL_FOR>().exprIndex);
 		break;
 	case HLIL_FOR_SSA:
 		if (ast)
-			toProcess.push(GetLoopExpr<HLIL_FOR_SSA>().exprIndex);
-		toProcess.push(GetUpdateExpr<HLIL_FOR_SSA>().exprIndex);
-		toProcess.push(GetConditionExpr<HLIL_FOR_SSA>().exprIndex);
-		toProcess.push(GetConditionPhiExpr<HLIL_FOR_SSA>().exprIndex);
-		toProcess.push(GetInitExpr<HLIL_FOR_SSA>().exprIndex);
+			toProcess.push_back(GetLoopExpr<HLIL_FOR_SSA>().exprIndex);
+		toProcess.push_back(GetUpdateExpr<HLIL_FOR_SSA>().exprIndex);
+		toProcess.push_back(GetConditionExpr<HLIL_FOR_SSA>().exprIndex);
+		toProcess.push_back(GetConditionPhiExpr<HLIL_FOR_SSA>().exprIndex);
+		toProcess.push_back(GetInitExpr<HLIL_FOR_SSA>().exprIndex);
 		break;
 	case HLIL_SWITCH:
 		if (ast)
 		{
 			exprs = GetCases<HLIL_SWITCH>();
 			for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-				toProcess.push(i->exprIndex);
-			toProcess.push(GetDefaultExpr<HLIL_SWITCH>().exprIndex);
+				toProcess.push_back(i->exprIndex);
+			toProcess.push_back(GetDefaultExpr<HLIL_SWITCH>().exprIndex);
 		}
-		toProcess.push(GetConditionExpr<HLIL_SWITCH>().exprIndex);
+		toProcess.push_back(GetConditionExpr<HLIL_SWITCH>().exprIndex);
 		break;
 	case HLIL_CASE:
 		if (ast)
-			toProcess.push(GetTrueExpr<HLIL_CASE>().exprIndex);
+			toProcess.push_back(GetTrueExpr<HLIL_CASE>().exprIndex);
 		exprs = GetValueExprs<HLIL_CASE>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
+			toProcess.push_back(i->exprIndex);
 		break;
 	case HLIL_VAR_INIT:
-		toProcess.push(GetSourceExpr<HLIL_VAR_INIT>().exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_VAR_INIT>().exprIndex);
 		break;
 	case HLIL_VAR_INIT_SSA:
-		toProcess.push(GetSourceExpr<HLIL_VAR_INIT_SSA>().exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_VAR_INIT_SSA>().exprIndex);
 		break;
 	case HLIL_ASSIGN:
-		toProcess.push(GetDestExpr<HLIL_ASSIGN>().exprIndex);
-		toProcess.push(GetSourceExpr<HLIL_ASSIGN>().exprIndex);
+		toProcess.push_back(GetDestExpr<HLIL_ASSIGN>().exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_ASSIGN>().exprIndex);
 		break;
 	case HLIL_ASSIGN_UNPACK:
 		exprs = GetDestExprs<HLIL_ASSIGN_UNPACK>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
-		toProcess.push(GetSourceExpr<HLIL_ASSIGN_UNPACK>().exprIndex);
+			toProcess.push_back(i->exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_ASSIGN_UNPACK>().exprIndex);
 		break;
 	case HLIL_ASSIGN_MEM_SSA:
-		toProcess.push(GetDestExpr<HLIL_ASSIGN_MEM_SSA>().exprIndex);
-		toProcess.push(GetSourceExpr<HLIL_ASSIGN_MEM_SSA>().exprIndex);
+		toProcess.push_back(GetDestExpr<HLIL_ASSIGN_MEM_SSA>().exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_ASSIGN_MEM_SSA>().exprIndex);
 		break;
 	case HLIL_ASSIGN_UNPACK_MEM_SSA:
 		exprs = GetDestExprs<HLIL_ASSIGN_UNPACK_MEM_SSA>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
-		toProcess.push(GetSourceExpr<HLIL_ASSIGN_UNPACK_MEM_SSA>().exprIndex);
+			toProcess.push_back(i->exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_ASSIGN_UNPACK_MEM_SSA>().exprIndex);
 		break;
 	case HLIL_STRUCT_FIELD:
-		toProcess.push(GetSourceExpr<HLIL_STRUCT_FIELD>().exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_STRUCT_FIELD>().exprIndex);
 		break;
 	case HLIL_ARRAY_INDEX:
-		toProcess.push(GetSourceExpr<HLIL_ARRAY_INDEX>().exprIndex);
-		toProcess.push(GetIndexExpr<HLIL_ARRAY_INDEX>().exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_ARRAY_INDEX>().exprIndex);
+		toProcess.push_back(GetIndexExpr<HLIL_ARRAY_INDEX>().exprIndex);
 		break;
 	case HLIL_ARRAY_INDEX_SSA:
-		toProcess.push(GetSourceExpr<HLIL_ARRAY_INDEX_SSA>().exprIndex);
-		toProcess.push(GetIndexExpr<HLIL_ARRAY_INDEX_SSA>().exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_ARRAY_INDEX_SSA>().exprIndex);
+		toProcess.push_back(GetIndexExpr<HLIL_ARRAY_INDEX_SSA>().exprIndex);
 		break;
 	case HLIL_SPLIT:
-		toProcess.push(GetLowExpr<HLIL_SPLIT>().exprIndex);
-		toProcess.push(GetHighExpr<HLIL_SPLIT>().exprIndex);
+		toProcess.push_back(GetLowExpr<HLIL_SPLIT>().exprIndex);
+		toProcess.push_back(GetHighExpr<HLIL_SPLIT>().exprIndex);
 		break;
 	case HLIL_DEREF_FIELD:
-		toProcess.push(GetSourceExpr<HLIL_DEREF_FIELD>().exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_DEREF_FIELD>().exprIndex);
 		break;
 	case HLIL_DEREF_SSA:
-		toProcess.push(GetSourceExpr<HLIL_DEREF_SSA>().exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_DEREF_SSA>().exprIndex);
 		break;
 	case HLIL_DEREF_FIELD_SSA:
-		toProcess.push(GetSourceExpr<HLIL_DEREF_FIELD_SSA>().exprIndex);
+		toProcess.push_back(GetSourceExpr<HLIL_DEREF_FIELD_SSA>().exprIndex);
 		break;
 	case HLIL_CALL:
-		toProcess.push(GetDestExpr<HLIL_CALL>().exprIndex);
+		toProcess.push_back(GetDestExpr<HLIL_CALL>().exprIndex);
 		exprs = GetParameterExprs<HLIL_CALL>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
+			toProcess.push_back(i->exprIndex);
 		break;
 	case HLIL_SYSCALL:
 		exprs = GetParameterExprs<HLIL_SYSCALL>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
+			toProcess.push_back(i->exprIndex);
 		break;
 	case HLIL_TAILCALL:
-		toProcess.push(GetDestExpr<HLIL_TAILCALL>().exprIndex);
+		toProcess.push_back(GetDestExpr<HLIL_TAILCALL>().exprIndex);
 		exprs = GetParameterExprs<HLIL_TAILCALL>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
+			toProcess.push_back(i->exprIndex);
 		break;
 	case HLIL_CALL_SSA:
-		toProcess.push(GetDestExpr<HLIL_CALL_SSA>().exprIndex);
+		toProcess.push_back(GetDestExpr<HLIL_CALL_SSA>().exprIndex);
 		exprs = GetParameterExprs<HLIL_CALL_SSA>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
+			toProcess.push_back(i->exprIndex);
 		break;
 	case HLIL_SYSCALL_SSA:
 		exprs = GetParameterExprs<HLIL_SYSCALL_SSA>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
+			toProcess.push_back(i->exprIndex);
 		break;
 	case HLIL_RET:
 		exprs = GetSourceExprs<HLIL_RET>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
+			toProcess.push_back(i->exprIndex);
 		break;
 	case HLIL_DEREF:
 	case HLIL_ADDRESS_OF:
@@ -1212,7 +1318,7 @@ void HighLevelILInstruction::CollectSubExprs(stack<size_t>& toProcess) const
 	case HLIL_FLOOR:
 	case HLIL_CEIL:
 	case HLIL_FTRUNC:
-		toProcess.push(AsOneOperand().GetSourceExpr().exprIndex);
+		toProcess.push_back(AsOneOperand().GetSourceExpr().exprIndex);
 		break;
 	case HLIL_ADD:
 	case HLIL_SUB:
@@ -1259,26 +1365,26 @@ void HighLevelILInstruction::CollectSubExprs(stack<size_t>& toProcess) const
 	case HLIL_FCMP_GT:
 	case HLIL_FCMP_O:
 	case HLIL_FCMP_UO:
-		toProcess.push(AsTwoOperand().GetRightExpr().exprIndex);
-		toProcess.push(AsTwoOperand().GetLeftExpr().exprIndex);
+		toProcess.push_back(AsTwoOperand().GetRightExpr().exprIndex);
+		toProcess.push_back(AsTwoOperand().GetLeftExpr().exprIndex);
 		break;
 	case HLIL_ADC:
 	case HLIL_SBB:
 	case HLIL_RLC:
 	case HLIL_RRC:
-		toProcess.push(AsTwoOperandWithCarry().GetCarryExpr().exprIndex);
-		toProcess.push(AsTwoOperandWithCarry().GetRightExpr().exprIndex);
-		toProcess.push(AsTwoOperandWithCarry().GetLeftExpr().exprIndex);
+		toProcess.push_back(AsTwoOperandWithCarry().GetCarryExpr().exprIndex);
+		toProcess.push_back(AsTwoOperandWithCarry().GetRightExpr().exprIndex);
+		toProcess.push_back(AsTwoOperandWithCarry().GetLeftExpr().exprIndex);
 		break;
 	case HLIL_INTRINSIC:
 		exprs = GetParameterExprs<HLIL_INTRINSIC>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
+			toProcess.push_back(i->exprIndex);
 		break;
 	case HLIL_INTRINSIC_SSA:
 		exprs = GetParameterExprs<HLIL_INTRINSIC_SSA>();
 		for (auto i = exprs.rbegin(); i != exprs.rend(); ++i)
-			toProcess.push(i->exprIndex);
+			toProcess.push_back(i->exprIndex);
 		break;
 	default:
 		break;
@@ -1286,58 +1392,34 @@ void HighLevelILInstruction::CollectSubExprs(stack<size_t>& toProcess) const
 }
 
 
-void HighLevelILInstruction::VisitExprs(const std::function<bool(const HighLevelILInstruction& expr)>& func) const
+void HighLevelILInstruction::CollectSubExprs(vector<HighLevelILInstruction>& toProcess) const
 {
-	stack<size_t> toProcess;
-	toProcess.push(exprIndex);
-	while (!toProcess.empty())
-	{
-		HighLevelILInstruction cur = function->GetExpr(toProcess.top(), ast);
-		toProcess.pop();
-		if (!func(cur))
-			continue;
-		cur.CollectSubExprs(toProcess);
-	}
+	vector<size_t> exprs;
+	CollectSubExprs(exprs);
+	for (size_t i : exprs)
+		toProcess.push_back(function->GetExpr(i, ast));
 }
 
 
-void HighLevelILInstruction::VisitExprs(const std::function<bool(const HighLevelILInstruction& expr)>& preFunc,
-	const std::function<void(const HighLevelILInstruction& expr)>& postFunc) const
+void HighLevelILInstruction::CollectSubExprs(stack<size_t>& toProcess) const
 {
-	stack<std::pair<HighLevelILInstruction, stack<size_t>>> toProcess;
-	HighLevelILInstruction cur = *this;
-	if (!preFunc(cur))
-		return;
+	vector<size_t> exprs;
+	CollectSubExprs(exprs);
+	for (size_t i : exprs)
+		toProcess.push(i);
+}
 
-	stack<size_t> subExprs;
-	cur.CollectSubExprs(subExprs);
 
-	while (true)
-	{
-		if (subExprs.size() == 0)
-		{
-			postFunc(cur);
+void HighLevelILInstruction::VisitExprs(const std::function<bool(const HighLevelILInstruction& expr)>& func) const
+{
+	VisitExprsT(func);
+}
 
-			if (toProcess.empty())
-				break;
-			cur = toProcess.top().first;
-			subExprs = toProcess.top().second;
-			toProcess.pop();
-		}
-		else
-		{
-			HighLevelILInstruction next = function->GetExpr(subExprs.top());
-			subExprs.pop();
 
-			if (preFunc(next))
-			{
-				toProcess.push(std::pair<HighLevelILInstruction, stack<size_t>>(cur, subExprs));
-				cur = next;
-				subExprs = stack<size_t>();
-				cur.CollectSubExprs(subExprs);
-			}
-		}
-	}
+void HighLevelILInstruction::VisitExprs(const std::function<bool(const HighLevelILInstruction& expr)>& preFunc,
+	const std::function<void(const HighLevelILInstruction& expr)>& postFunc) const
+{
+	VisitExprsT(preFunc, postFunc);
 }
 
 
@@ -2136,14 +2218,7 @@ bool HighLevelILInstruction::operator!=(const HighLevelILInstruction& other) con
 
 bool HighLevelILInstruction::GetOperandIndexForUsage(HighLevelILOperandUsage usage, size_t& operandIndex) const
 {
-	auto operationIter = HighLevelILInstructionBase::operationOperandIndex.find(operation);
-	if (operationIter == HighLevelILInstructionBase::operationOperandIndex.end())
-		return false;
-	auto usageIter = operationIter->second.find(usage);
-	if (usageIter == operationIter->second.end())
-		return false;
-	operandIndex = usageIter->second;
-	return true;
+	return HighLevelILInstructionBase::operationOperandIndexTable.Lookup(operation, usage, operandIndex);
 }
 
 
@@ -28,6 +28,7 @@
 #else
 	#include "binaryninjaapi.h"
 #endif
+#include "ilexprtraversal.h"
 #include "mediumlevelilinstruction.h"
 #include <fmt/core.h>
 
@@ -118,6 +119,32 @@ namespace BinaryNinja
 		SourceMemoryVersionsHighLevelOperandUsage,
 		DestMemoryVersionHighLevelOperandUsage
 	};
+
+	/*!
+		Dense operation x operand usage -> operand index table, generated at compile time from the operand usage
+		lists in highlevelilinstruction.cpp.
+
+		\ingroup highlevelil
+	*/
+	struct HighLevelILOperandIndexTable
+	{
+		static constexpr size_t OperationCount = HLIL_MEM_PHI + 1;
+		static constexpr size_t UsageCount = DestMemoryVersionHighLevelOperandUsage + 1;
+		static constexpr uint8_t InvalidIndex = 0xff;
+
+		uint8_t index[OperationCount][UsageCount];
+
+		bool Lookup(BNHighLevelILOperation operation, HighLevelILOperandUsage usage, size_t& operandIndex) const
+		{
+			if ((size_t)operation >= OperationCount || (size_t)usage >= UsageCount)
+				return false;
+			uint8_t result = index[operation][usage];
+			if (result == InvalidIndex)
+				return false;
+			operandIndex = result;
+			return true;
+		}
+	};
 }  // namespace BinaryNinjaCore
 
 namespace std {
@@ -337,6 +364,7 @@ namespace BinaryNinja
 		static _STD_UNORDERED_MAP<BNHighLevelILOperation, _STD_VECTOR<HighLevelILOperandUsage>> operationOperandUsage;
 		static _STD_UNORDERED_MAP<BNHighLevelILOperation, _STD_UNORDERED_MAP<HighLevelILOperandUsage, size_t>>
 		    operationOperandIndex;
+		static const HighLevelILOperandIndexTable operationOperandIndexTable;
 
 		HighLevelILOperandList GetOperands() const;
 
@@ -453,11 +481,76 @@ namespace BinaryNinja
 		    bool asFullAst, size_t instructionIndex);
 		HighLevelILInstruction(const HighLevelILInstructionBase& instr);
 
+		// Append or push the direct sub-expressions to `toProcess`, last one first, so taking them off the back visits
+		// them in order
+		void CollectSubExprs(_STD_VECTOR<size_t>& toProcess) const;
+		void CollectSubExprs(_STD_VECTOR<HighLevelILInstruction>& toProcess) const;
 		void CollectSubExprs(_STD_STACK<size_t>& toProcess) const;
+
 		void VisitExprs(const std::function<bool(const HighLevelILInstruction& expr)>& func) const;
 		void VisitExprs(const std::function<bool(const HighLevelILInstruction& expr)>& preFunc,
 			const std::function<void(const HighLevelILInstruction& expr)>& postFunc) const;
 
+		// Same as `VisitExprs`, but the visitors are inlined. `func` and `preFunc` return false to skip the
+		// sub-expressions of the expression they were called with.
+		template <typename F>
+		void VisitExprsT(F&& func) const
+		{
+			if (!func(*this))
+				return;
+			_STD_VECTOR<HighLevelILInstruction> toProcess;
+			CollectSubExprs(toProcess);
+			while (!toProcess.empty())
+			{
+				HighLevelILInstruction cur = std::move(toProcess.back());
+				toProcess.pop_back();
+				if (func(cur))
+					cur.CollectSubExprs(toProcess);
+			}
+		}
+
+		// `postFunc` is called after all sub-expressions of an expression have been visited, for each expression
+		// `preFunc` returned true for
+		template <typename Pre, typename Post>
+		void VisitExprsT(Pre&& preFunc, Post&& postFunc) const
+		{
+			struct Frame
+			{
+				HighLevelILInstruction expr;
+				// Where this expression's unvisited sub-expressions start in `toProcess`
+				size_t subExprs;
+			};
+
+			if (!preFunc(*this))
+				return;
+			_STD_VECTOR<Frame> frames;
+			_STD_VECTOR<HighLevelILInstruction> toProcess;
+			frames.push_back({*this, 0});
+			CollectSubExprs(toProcess);
+			while (!frames.empty())
+			{
+				if (toProcess.size() == frames.back().subExprs)
+				{
+					postFunc(frames.back().expr);
+					frames.pop_back();
+					continue;
+				}
+
+				HighLevelILInstruction next = std::move(toProcess.back());
+				toProcess.pop_back();
+				if (!preFunc(next))
+					continue;
+				size_t subExprs = toProcess.size();
+				next.CollectSubExprs(toProcess);
+				frames.push_back({std::move(next), subExprs});
+			}
+		}
+
+		ILExprTraversal<HighLevelILInstruction> TraverseExprs(ILExprTraversalOrder order = PreOrderILExprTraversal) const
+		{
+			return ILExprTraversal<HighLevelILInstruction>(*this, order);
+		}
+
 		ExprId CopyTo(HighLevelILFunction* dest) const;
 		ExprId CopyTo(HighLevelILFunction* dest,
 		    const std::function<ExprId(const HighLevelILInstruction& subExpr)>& subExprHandler) const;
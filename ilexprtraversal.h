@@ -0,0 +1,144 @@
+// Copyright (c) 2015-2024 Vector 35 Inc
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#ifdef BINARYNINJACORE_LIBRARY
+namespace BinaryNinjaCore
+#else
+namespace BinaryNinja
+#endif
+{
+	enum ILExprTraversalOrder
+	{
+		PreOrderILExprTraversal,
+		PostOrderILExprTraversal
+	};
+
+	/*!
+		Iterable range over the IDs of an IL expression and all of its sub-expressions.
+
+		Works for any of the IL instruction types, which provide `CollectSubExprs` to append their direct
+		sub-expressions, last one first. The tree is walked with an explicit stack, so deeply nested expressions don't
+		recurse.
+
+		Pre-order yields an expression before its sub-expressions, post-order after all of them. Sub-expressions are
+		yielded in the order `VisitExprs` visits them.
+	*/
+	template <typename Instruction>
+	class ILExprTraversal
+	{
+		Instruction m_root;
+		ILExprTraversalOrder m_order;
+
+	  public:
+		class Iterator
+		{
+			ILExprTraversalOrder m_order = PreOrderILExprTraversal;
+			Instruction m_current;
+			bool m_done = true;
+
+			// Pre-order: the expressions still to visit. Post-order: the path from the root to the current
+			// expression with the not yet visited siblings of each expression on it in between, `m_expanded` says
+			// which entries already had their sub-expressions pushed.
+			std::vector<Instruction> m_exprs;
+			std::vector<bool> m_expanded;
+
+			void Settle()
+			{
+				while (!m_expanded.back())
+				{
+					m_expanded.back() = true;
+					// Copied, collecting may reallocate `m_exprs`
+					Instruction expr = m_exprs.back();
+					expr.CollectSubExprs(m_exprs);
+					m_expanded.resize(m_exprs.size(), false);
+				}
+				m_current = m_exprs.back();
+			}
+
+		  public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = size_t;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const size_t*;
+			using reference = size_t;
+
+			Iterator() = default;
+
+			Iterator(const Instruction& root, ILExprTraversalOrder order) : m_order(order), m_done(false)
+			{
+				if (m_order == PreOrderILExprTraversal)
+				{
+					m_current = root;
+					return;
+				}
+				m_exprs.push_back(root);
+				m_expanded.push_back(false);
+				Settle();
+			}
+
+			// The expression the iterator is on, without having to look it up again by ID
+			const Instruction& GetExpr() const { return m_current; }
+
+			size_t operator*() const { return m_current.exprIndex; }
+
+			Iterator& operator++()
+			{
+				if (m_order == PreOrderILExprTraversal)
+				{
+					m_current.CollectSubExprs(m_exprs);
+					if (m_exprs.empty())
+					{
+						m_done = true;
+						return *this;
+					}
+					m_current = std::move(m_exprs.back());
+					m_exprs.pop_back();
+					return *this;
+				}
+
+				m_exprs.pop_back();
+				m_expanded.pop_back();
+				if (m_exprs.empty())
+				{
+					m_done = true;
+					return *this;
+				}
+				Settle();
+				return *this;
+			}
+
+			// Only comparisons against `end()` are meaningful
+			bool operator==(const Iterator& other) const { return m_done == other.m_done; }
+			bool operator!=(const Iterator& other) const { return m_done != other.m_done; }
+		};
+
+		ILExprTraversal(const Instruction& root, ILExprTraversalOrder order) : m_root(root), m_order(order) {}
+
+		Iterator begin() const { return Iterator(m_root, m_order); }
+		Iterator end() const { return Iterator(); }
+	};
+}  // namespace BinaryNinjaCore
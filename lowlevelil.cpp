@@ -534,6 +534,8 @@ ExprId LowLevelILFunction::Operand(size_t n, ExprId expr)
 
 BNLowLevelILInstruction LowLevelILFunction::GetRawExpr(size_t i) const
 {
+	if (m_snapshot && i < m_snapshot->exprs.size())
+		return m_snapshot->exprs[i];
 	return BNGetLowLevelILByIndex(m_object, i);
 }
 
@@ -559,28 +561,66 @@ LowLevelILInstruction LowLevelILFunction::GetExpr(size_t i)
 
 size_t LowLevelILFunction::GetIndexForInstruction(size_t i) const
 {
+	if (m_snapshot && i < m_snapshot->instructionExprs.size())
+		return m_snapshot->instructionExprs[i];
 	return BNGetLowLevelILIndexForInstruction(m_object, i);
 }
 
 
 size_t LowLevelILFunction::GetInstructionForExpr(size_t expr) const
 {
+	if (m_snapshot && expr < m_snapshot->exprInstructions.size())
+		return m_snapshot->exprInstructions[expr];
 	return BNGetLowLevelILInstructionForExpr(m_object, expr);
 }
 
 
 size_t LowLevelILFunction::GetInstructionCount() const
 {
+	if (m_snapshot)
+		return m_snapshot->instructionExprs.size();
 	return BNGetLowLevelILInstructionCount(m_object);
 }
 
 
 size_t LowLevelILFunction::GetExprCount() const
 {
+	if (m_snapshot)
+		return m_snapshot->exprs.size();
 	return BNGetLowLevelILExprCount(m_object);
 }
 
 
+Ref<LowLevelILFunction> LowLevelILFunction::GetSnapshot() const
+{
+	Ref<LowLevelILFunction> result = new LowLevelILFunction(BNNewLowLevelILFunctionReference(m_object));
+	if (m_snapshot)
+	{
+		result->m_snapshot = m_snapshot;
+		return result;
+	}
+
+	// The core has no bulk accessor, so this is one pass of per-index calls up front instead of one (or more) per
+	// operand access later.
+	auto snapshot = std::make_shared<ILFunctionSnapshot<BNLowLevelILInstruction>>();
+	size_t exprCount = BNGetLowLevelILExprCount(m_object);
+	size_t instrCount = BNGetLowLevelILInstructionCount(m_object);
+	snapshot->exprs.reserve(exprCount);
+	snapshot->exprInstructions.reserve(exprCount);
+	for (size_t i = 0; i < exprCount; i++)
+	{
+		snapshot->exprs.push_back(BNGetLowLevelILByIndex(m_object, i));
+		snapshot->exprInstructions.push_back(BNGetLowLevelILInstructionForExpr(m_object, i));
+	}
+	snapshot->instructionExprs.reserve(instrCount);
+	for (size_t i = 0; i < instrCount; i++)
+		snapshot->instructionExprs.push_back(BNGetLowLevelILIndexForInstruction(m_object, i));
+
+	result->m_snapshot = std::move(snapshot);
+	return result;
+}
+
+
 void LowLevelILFunction::UpdateInstructionOperand(size_t i, size_t operandIndex, ExprId value)
 {
 	BNUpdateLowLevelILOperand(m_object, i, operandIndex, value);
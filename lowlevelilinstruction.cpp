@@ -18,7 +18,9 @@
 // FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
 // IN THE SOFTWARE.
 
+#include <algorithm>
 #include <cstring>
+#include <initializer_list>
 #ifdef BINARYNINJACORE_LIBRARY
 	#include "lowlevelilfunction.h"
 	#include "lowlevelilssafunction.h"
@@ -36,7 +38,30 @@ using namespace std;
 #endif
 
 
-unordered_map<LowLevelILOperandUsage, LowLevelILOperandType> LowLevelILInstructionBase::operandTypeForUsage = {
+struct LowLevelILOperandTypeForUsage
+{
+	LowLevelILOperandUsage usage;
+	LowLevelILOperandType type;
+};
+
+
+struct LowLevelILOperationOperandUsages
+{
+	BNLowLevelILOperation operation;
+	size_t count;
+	LowLevelILOperandUsage usages[8];
+
+	constexpr LowLevelILOperationOperandUsages(
+	    BNLowLevelILOperation op, std::initializer_list<LowLevelILOperandUsage> list) :
+	    operation(op), count(list.size()), usages {}
+	{
+		for (size_t i = 0; i < count; i++)
+			usages[i] = list.begin()[i];
+	}
+};
+
+
+static constexpr LowLevelILOperandTypeForUsage s_operandTypeForUsage[] = {
     {SourceExprLowLevelOperandUsage, ExprLowLevelOperand},
     {SourceRegisterLowLevelOperandUsage, RegisterLowLevelOperand},
     {SourceRegisterStackLowLevelOperandUsage, RegisterStackLowLevelOperand},
@@ -84,8 +109,8 @@ unordered_map<LowLevelILOperandUsage, LowLevelILOperandType> LowLevelILInstructi
     {RegisterStackAdjustmentsLowLevelOperandUsage, RegisterStackAdjustmentsLowLevelOperand}};
 
 
-unordered_map<BNLowLevelILOperation, vector<LowLevelILOperandUsage>> LowLevelILInstructionBase::operationOperandUsage =
-    {{LLIL_NOP, {}}, {LLIL_POP, {}}, {LLIL_NORET, {}}, {LLIL_SYSCALL, {}}, {LLIL_BP, {}}, {LLIL_UNDEF, {}},
+static constexpr LowLevelILOperationOperandUsages s_operationOperandUsage[] = {
+    {LLIL_NOP, {}}, {LLIL_POP, {}}, {LLIL_NORET, {}}, {LLIL_SYSCALL, {}}, {LLIL_BP, {}}, {LLIL_UNDEF, {}},
         {LLIL_UNIMPL, {}}, {LLIL_SET_REG, {DestRegisterLowLevelOperandUsage, SourceExprLowLevelOperandUsage}},
         {LLIL_SET_REG_SPLIT,
             {HighRegisterLowLevelOperandUsage, LowRegisterLowLevelOperandUsage, SourceExprLowLevelOperandUsage}},
@@ -226,6 +251,127 @@ unordered_map<BNLowLevelILOperation, vector<LowLevelILOperandUsage>> LowLevelILI
         {LLIL_FCMP_UO, {LeftExprLowLevelOperandUsage, RightExprLowLevelOperandUsage}}};
 
 
+static constexpr LowLevelILOperandType GetOperandTypeForUsage(LowLevelILOperandUsage usage)
+{
+	for (auto& entry : s_operandTypeForUsage)
+	{
+		if (entry.usage == usage)
+			return entry.type;
+	}
+	return LowLevelILOperandType();
+}
+
+
+static constexpr LowLevelILOperandIndexTable GetOperandIndexTable()
+{
+	LowLevelILOperandIndexTable result {};
+	for (auto& operation : result.index)
+	{
+		for (auto& operand : operation)
+			operand = LowLevelILOperandIndexTable::InvalidIndex;
+	}
+
+	for (auto& operation : s_operationOperandUsage)
+	{
+		size_t operand = 0;
+		for (size_t i = 0; i < operation.count; i++)
+		{
+			LowLevelILOperandUsage usage = operation.usages[i];
+			result.index[operation.operation][usage] = (uint8_t)operand;
+			switch (usage)
+			{
+			case HighSSARegisterLowLevelOperandUsage:
+			case LowSSARegisterLowLevelOperandUsage:
+			case PartialSSARegisterStackSourceLowLevelOperandUsage:
+			case TopSSARegisterLowLevelOperandUsage:
+				// Represented as subexpression, so only takes one slot even though it is an SSA register
+				operand++;
+				break;
+			case ParameterExprsLowLevelOperandUsage:
+				if (operand == 0)
+				{
+					// Represented as a counted list
+					operand += 2;
+				}
+				else
+				{
+					// Represented as subexpression, so only takes one slot even though it is a list
+					operand++;
+				}
+				break;
+			case OutputSSARegistersLowLevelOperandUsage:
+				// OutputMemoryVersionLowLevelOperandUsage follows at same operand
+				break;
+			case StackSSARegisterLowLevelOperandUsage:
+				// StackMemoryVersionLowLevelOperandUsage follows at same operand
+				break;
+			case DestSSARegisterStackLowLevelOperandUsage:
+				// PartialSSARegisterStackSourceLowLevelOperandUsage follows at same operand
+				break;
+			case OutputMemoryIntrinsicLowLevelOperandUsage:
+				// OutputMemoryVersionLowLevelOperandUsage follows at same operand
+				break;
+			default:
+				switch (GetOperandTypeForUsage(usage))
+				{
+				case SSARegisterLowLevelOperand:
+				case SSARegisterStackLowLevelOperand:
+				case SSAFlagLowLevelOperand:
+				case IndexListLowLevelOperand:
+				case IndexMapLowLevelOperand:
+				case SSARegisterListLowLevelOperand:
+				case SSARegisterStackListLowLevelOperand:
+				case SSAFlagListLowLevelOperand:
+				case RegisterStackAdjustmentsLowLevelOperand:
+				case RegisterOrFlagListLowLevelOperand:
+				case SSARegisterOrFlagListLowLevelOperand:
+					// SSA registers/flags and lists take two operand slots
+					operand += 2;
+					break;
+				default:
+					operand++;
+					break;
+				}
+				break;
+			}
+		}
+	}
+	return result;
+}
+
+
+// Evaluated at compile time so a usage list that doesn't fit the table fails the build
+static constexpr LowLevelILOperandIndexTable s_operandIndexTable = GetOperandIndexTable();
+const LowLevelILOperandIndexTable LowLevelILInstructionBase::operationOperandIndexTable = s_operandIndexTable;
+
+
+static unordered_map<LowLevelILOperandUsage, LowLevelILOperandType> GetOperandTypesForUsages()
+{
+	unordered_map<LowLevelILOperandUsage, LowLevelILOperandType> result;
+	result.reserve(sizeof(s_operandTypeForUsage) / sizeof(s_operandTypeForUsage[0]));
+	for (auto& entry : s_operandTypeForUsage)
+		result.emplace(entry.usage, entry.type);
+	// Usages that operations refer to but that have no entry of their own resolve to the default type
+	for (auto& operation : s_operationOperandUsage)
+	{
+		for (size_t i = 0; i < operation.count; i++)
+			result.emplace(operation.usages[i], GetOperandTypeForUsage(operation.usages[i]));
+	}
+	return result;
+}
+
+
+static unordered_map<BNLowLevelILOperation, vector<LowLevelILOperandUsage>> GetOperandUsagesForOperations()
+{
+	unordered_map<BNLowLevelILOperation, vector<LowLevelILOperandUsage>> result;
+	result.reserve(sizeof(s_operationOperandUsage) / sizeof(s_operationOperandUsage[0]));
+	for (auto& operation : s_operationOperandUsage)
+		result.emplace(
+		    operation.operation, vector<LowLevelILOperandUsage>(operation.usages, operation.usages + operation.count));
+	return result;
+}
+
+
 static unordered_map<BNLowLevelILOperation, unordered_map<LowLevelILOperandUsage, size_t>>
     GetOperandIndexForOperandUsages()
 {
@@ -302,6 +448,10 @@ static unordered_map<BNLowLevelILOperation, unordered_map<LowLevelILOperandUsage
 }
 
 
+unordered_map<LowLevelILOperandUsage, LowLevelILOperandType>
+    LowLevelILInstructionBase::operandTypeForUsage = GetOperandTypesForUsages();
+unordered_map<BNLowLevelILOperation, vector<LowLevelILOperandUsage>>
+    LowLevelILInstructionBase::operationOperandUsage = GetOperandUsagesForOperations();
 unordered_map<BNLowLevelILOperation, unordered_map<LowLevelILOperandUsage, size_t>>
     LowLevelILInstructionBase::operationOperandIndex = GetOperandIndexForOperandUsages();
 
@@ -1840,107 +1990,107 @@ void LowLevelILInstructionBase::ClearAttribute(BNILInstructionAttribute attribut
 }
 
 
-void LowLevelILInstruction::VisitExprs(const std::function<bool(const LowLevelILInstruction& expr)>& func) const
+void LowLevelILInstruction::CollectSubExprs(vector<LowLevelILInstruction>& toProcess) const
 {
-	if (!func(*this))
-		return;
+	// Collected in order, then reversed so the first one is on top
+	size_t first = toProcess.size();
 	switch (operation)
 	{
 	case LLIL_SET_REG:
-		GetSourceExpr<LLIL_SET_REG>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_SET_REG>());
 		break;
 	case LLIL_SET_REG_SPLIT:
-		GetSourceExpr<LLIL_SET_REG_SPLIT>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_SET_REG_SPLIT>());
 		break;
 	case LLIL_SET_REG_SSA:
-		GetSourceExpr<LLIL_SET_REG_SSA>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_SET_REG_SSA>());
 		break;
 	case LLIL_SET_REG_SSA_PARTIAL:
-		GetSourceExpr<LLIL_SET_REG_SSA_PARTIAL>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_SET_REG_SSA_PARTIAL>());
 		break;
 	case LLIL_SET_REG_SPLIT_SSA:
-		GetSourceExpr<LLIL_SET_REG_SPLIT_SSA>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_SET_REG_SPLIT_SSA>());
 		break;
 	case LLIL_SET_REG_STACK_REL:
-		GetDestExpr<LLIL_SET_REG_STACK_REL>().VisitExprs(func);
-		GetSourceExpr<LLIL_SET_REG_STACK_REL>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_SET_REG_STACK_REL>());
+		toProcess.push_back(GetSourceExpr<LLIL_SET_REG_STACK_REL>());
 		break;
 	case LLIL_REG_STACK_PUSH:
-		GetSourceExpr<LLIL_REG_STACK_PUSH>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_REG_STACK_PUSH>());
 		break;
 	case LLIL_SET_REG_STACK_REL_SSA:
-		GetDestExpr<LLIL_SET_REG_STACK_REL_SSA>().VisitExprs(func);
-		GetSourceExpr<LLIL_SET_REG_STACK_REL_SSA>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_SET_REG_STACK_REL_SSA>());
+		toProcess.push_back(GetSourceExpr<LLIL_SET_REG_STACK_REL_SSA>());
 		break;
 	case LLIL_SET_REG_STACK_ABS_SSA:
-		GetSourceExpr<LLIL_SET_REG_STACK_ABS_SSA>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_SET_REG_STACK_ABS_SSA>());
 		break;
 	case LLIL_SET_FLAG:
-		GetSourceExpr<LLIL_SET_FLAG>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_SET_FLAG>());
 		break;
 	case LLIL_SET_FLAG_SSA:
-		GetSourceExpr<LLIL_SET_FLAG_SSA>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_SET_FLAG_SSA>());
 		break;
 	case LLIL_REG_STACK_REL:
-		GetSourceExpr<LLIL_REG_STACK_REL>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_REG_STACK_REL>());
 		break;
 	case LLIL_REG_STACK_FREE_REL:
-		GetDestExpr<LLIL_REG_STACK_FREE_REL>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_REG_STACK_FREE_REL>());
 		break;
 	case LLIL_REG_STACK_REL_SSA:
-		GetSourceExpr<LLIL_REG_STACK_REL_SSA>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_REG_STACK_REL_SSA>());
 		break;
 	case LLIL_REG_STACK_FREE_REL_SSA:
-		GetDestExpr<LLIL_REG_STACK_FREE_REL_SSA>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_REG_STACK_FREE_REL_SSA>());
 		break;
 	case LLIL_LOAD:
-		GetSourceExpr<LLIL_LOAD>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_LOAD>());
 		break;
 	case LLIL_LOAD_SSA:
-		GetSourceExpr<LLIL_LOAD_SSA>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<LLIL_LOAD_SSA>());
 		break;
 	case LLIL_STORE:
-		GetDestExpr<LLIL_STORE>().VisitExprs(func);
-		GetSourceExpr<LLIL_STORE>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_STORE>());
+		toProcess.push_back(GetSourceExpr<LLIL_STORE>());
 		break;
 	case LLIL_STORE_SSA:
-		GetDestExpr<LLIL_STORE_SSA>().VisitExprs(func);
-		GetSourceExpr<LLIL_STORE_SSA>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_STORE_SSA>());
+		toProcess.push_back(GetSourceExpr<LLIL_STORE_SSA>());
 		break;
 	case LLIL_JUMP:
-		GetDestExpr<LLIL_JUMP>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_JUMP>());
 		break;
 	case LLIL_JUMP_TO:
-		GetDestExpr<LLIL_JUMP_TO>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_JUMP_TO>());
 		break;
 	case LLIL_IF:
-		GetConditionExpr<LLIL_IF>().VisitExprs(func);
+		toProcess.push_back(GetConditionExpr<LLIL_IF>());
 		break;
 	case LLIL_CALL:
-		GetDestExpr<LLIL_CALL>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_CALL>());
 		break;
 	case LLIL_CALL_STACK_ADJUST:
-		GetDestExpr<LLIL_CALL_STACK_ADJUST>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_CALL_STACK_ADJUST>());
 		break;
 	case LLIL_TAILCALL:
-		GetDestExpr<LLIL_TAILCALL>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_TAILCALL>());
 		break;
 	case LLIL_CALL_SSA:
-		GetDestExpr<LLIL_CALL_SSA>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_CALL_SSA>());
 		for (auto i : GetParameterExprs<LLIL_CALL_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case LLIL_SYSCALL_SSA:
 		for (auto i : GetParameterExprs<LLIL_SYSCALL_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case LLIL_TAILCALL_SSA:
-		GetDestExpr<LLIL_TAILCALL_SSA>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_TAILCALL_SSA>());
 		for (auto i : GetParameterExprs<LLIL_TAILCALL_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case LLIL_RET:
-		GetDestExpr<LLIL_RET>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<LLIL_RET>());
 		break;
 	case LLIL_PUSH:
 	case LLIL_NEG:
@@ -1960,7 +2110,7 @@ void LowLevelILInstruction::VisitExprs(const std::function<bool(const LowLevelIL
 	case LLIL_FLOOR:
 	case LLIL_CEIL:
 	case LLIL_FTRUNC:
-		AsOneOperand().GetSourceExpr().VisitExprs(func);
+		toProcess.push_back(AsOneOperand().GetSourceExpr());
 		break;
 	case LLIL_ADD:
 	case LLIL_SUB:
@@ -2007,40 +2157,47 @@ void LowLevelILInstruction::VisitExprs(const std::function<bool(const LowLevelIL
 	case LLIL_FCMP_GT:
 	case LLIL_FCMP_O:
 	case LLIL_FCMP_UO:
-		AsTwoOperand().GetLeftExpr().VisitExprs(func);
-		AsTwoOperand().GetRightExpr().VisitExprs(func);
+		toProcess.push_back(AsTwoOperand().GetLeftExpr());
+		toProcess.push_back(AsTwoOperand().GetRightExpr());
 		break;
 	case LLIL_ADC:
 	case LLIL_SBB:
 	case LLIL_RLC:
 	case LLIL_RRC:
-		AsTwoOperandWithCarry().GetLeftExpr().VisitExprs(func);
-		AsTwoOperandWithCarry().GetRightExpr().VisitExprs(func);
-		AsTwoOperandWithCarry().GetCarryExpr().VisitExprs(func);
+		toProcess.push_back(AsTwoOperandWithCarry().GetLeftExpr());
+		toProcess.push_back(AsTwoOperandWithCarry().GetRightExpr());
+		toProcess.push_back(AsTwoOperandWithCarry().GetCarryExpr());
 		break;
 	case LLIL_INTRINSIC:
 		for (auto i : GetParameterExprs<LLIL_INTRINSIC>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case LLIL_INTRINSIC_SSA:
 		for (auto i : GetParameterExprs<LLIL_INTRINSIC_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case LLIL_MEMORY_INTRINSIC_SSA:
 		for (auto i : GetParameterExprs<LLIL_MEMORY_INTRINSIC_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case LLIL_SEPARATE_PARAM_LIST_SSA:
 		for (auto i : GetParameterExprs<LLIL_SEPARATE_PARAM_LIST_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case LLIL_SHARED_PARAM_SLOT_SSA:
 		for (auto i : GetParameterExprs<LLIL_SHARED_PARAM_SLOT_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	default:
 		break;
 	}
+	std::reverse(toProcess.begin() + first, toProcess.end());
+}
+
+
+void LowLevelILInstruction::VisitExprs(const std::function<bool(const LowLevelILInstruction& expr)>& func) const
+{
+	VisitExprsT(func);
 }
 
 
@@ -2353,14 +2510,7 @@ ExprId LowLevelILInstruction::CopyTo(
 
 bool LowLevelILInstruction::GetOperandIndexForUsage(LowLevelILOperandUsage usage, size_t& operandIndex) const
 {
-	auto operationIter = LowLevelILInstructionBase::operationOperandIndex.find(operation);
-	if (operationIter == LowLevelILInstructionBase::operationOperandIndex.end())
-		return false;
-	auto usageIter = operationIter->second.find(usage);
-	if (usageIter == operationIter->second.end())
-		return false;
-	operandIndex = usageIter->second;
-	return true;
+	return LowLevelILInstructionBase::operationOperandIndexTable.Lookup(operation, usage, operandIndex);
 }
 
 
@@ -28,6 +28,7 @@
 #else
 	#include "binaryninjaapi.h"
 #endif
+#include "ilexprtraversal.h"
 
 #ifdef BINARYNINJACORE_LIBRARY
 namespace BinaryNinjaCore
@@ -246,6 +247,32 @@ namespace BinaryNinja
 		RegisterStackAdjustmentsLowLevelOperandUsage,
 		OffsetLowLevelOperandUsage
 	};
+
+	/*!
+		Dense operation x operand usage -> operand index table, generated at compile time from the operand usage
+		lists in lowlevelilinstruction.cpp.
+
+		\ingroup lowlevelil
+	*/
+	struct LowLevelILOperandIndexTable
+	{
+		static constexpr size_t OperationCount = LLIL_MEM_PHI + 1;
+		static constexpr size_t UsageCount = OffsetLowLevelOperandUsage + 1;
+		static constexpr uint8_t InvalidIndex = 0xff;
+
+		uint8_t index[OperationCount][UsageCount];
+
+		bool Lookup(BNLowLevelILOperation operation, LowLevelILOperandUsage usage, size_t& operandIndex) const
+		{
+			if ((size_t)operation >= OperationCount || (size_t)usage >= UsageCount)
+				return false;
+			uint8_t result = index[operation][usage];
+			if (result == InvalidIndex)
+				return false;
+			operandIndex = result;
+			return true;
+		}
+	};
 }  // namespace BinaryNinjaCore
 
 namespace std {
@@ -697,6 +724,7 @@ namespace BinaryNinja
 		static _STD_UNORDERED_MAP<BNLowLevelILOperation, _STD_VECTOR<LowLevelILOperandUsage>> operationOperandUsage;
 		static _STD_UNORDERED_MAP<BNLowLevelILOperation, _STD_UNORDERED_MAP<LowLevelILOperandUsage, size_t>>
 		    operationOperandIndex;
+		static const LowLevelILOperandIndexTable operationOperandIndexTable;
 
 		LowLevelILOperandList GetOperands() const;
 
@@ -813,8 +841,35 @@ namespace BinaryNinja
 		    LowLevelILFunction* func, const BNLowLevelILInstruction& instr, size_t expr, size_t instrIdx);
 		LowLevelILInstruction(const LowLevelILInstructionBase& instr);
 
+		// Appends the direct sub-expressions to `toProcess`, last one first, so popping them off the back visits them
+		// in order
+		void CollectSubExprs(_STD_VECTOR<LowLevelILInstruction>& toProcess) const;
+
 		void VisitExprs(const std::function<bool(const LowLevelILInstruction& expr)>& func) const;
 
+		// Same as `VisitExprs`, but the visitor is inlined and the tree is walked with an explicit stack. `func` returns
+		// false to skip the sub-expressions of the expression it was called with.
+		template <typename F>
+		void VisitExprsT(F&& func) const
+		{
+			if (!func(*this))
+				return;
+			_STD_VECTOR<LowLevelILInstruction> toProcess;
+			CollectSubExprs(toProcess);
+			while (!toProcess.empty())
+			{
+				LowLevelILInstruction cur = std::move(toProcess.back());
+				toProcess.pop_back();
+				if (func(cur))
+					cur.CollectSubExprs(toProcess);
+			}
+		}
+
+		ILExprTraversal<LowLevelILInstruction> TraverseExprs(ILExprTraversalOrder order = PreOrderILExprTraversal) const
+		{
+			return ILExprTraversal<LowLevelILInstruction>(*this, order);
+		}
+
 		ExprId CopyTo(LowLevelILFunction* dest) const;
 		ExprId CopyTo(LowLevelILFunction* dest,
 		    const std::function<ExprId(const LowLevelILInstruction& subExpr)>& subExprHandler) const;
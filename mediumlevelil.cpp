@@ -232,6 +232,8 @@ ExprId MediumLevelILFunction::AddSSAVariableList(const vector<SSAVariable>& vars
 
 BNMediumLevelILInstruction MediumLevelILFunction::GetRawExpr(size_t i) const
 {
+	if (m_snapshot && i < m_snapshot->exprs.size())
+		return m_snapshot->exprs[i];
 	return BNGetMediumLevelILByIndex(m_object, i);
 }
 
@@ -257,28 +259,66 @@ MediumLevelILInstruction MediumLevelILFunction::GetExpr(size_t i)
 
 size_t MediumLevelILFunction::GetIndexForInstruction(size_t i) const
 {
+	if (m_snapshot && i < m_snapshot->instructionExprs.size())
+		return m_snapshot->instructionExprs[i];
 	return BNGetMediumLevelILIndexForInstruction(m_object, i);
 }
 
 
 size_t MediumLevelILFunction::GetInstructionForExpr(size_t expr) const
 {
+	if (m_snapshot && expr < m_snapshot->exprInstructions.size())
+		return m_snapshot->exprInstructions[expr];
 	return BNGetMediumLevelILInstructionForExpr(m_object, expr);
 }
 
 
 size_t MediumLevelILFunction::GetInstructionCount() const
 {
+	if (m_snapshot)
+		return m_snapshot->instructionExprs.size();
 	return BNGetMediumLevelILInstructionCount(m_object);
 }
 
 
 size_t MediumLevelILFunction::GetExprCount() const
 {
+	if (m_snapshot)
+		return m_snapshot->exprs.size();
 	return BNGetMediumLevelILExprCount(m_object);
 }
 
 
+Ref<MediumLevelILFunction> MediumLevelILFunction::GetSnapshot() const
+{
+	Ref<MediumLevelILFunction> result = new MediumLevelILFunction(BNNewMediumLevelILFunctionReference(m_object));
+	if (m_snapshot)
+	{
+		result->m_snapshot = m_snapshot;
+		return result;
+	}
+
+	// The core has no bulk accessor, so this is one pass of per-index calls up front instead of one (or more) per
+	// operand access later.
+	auto snapshot = std::make_shared<ILFunctionSnapshot<BNMediumLevelILInstruction>>();
+	size_t exprCount = BNGetMediumLevelILExprCount(m_object);
+	size_t instrCount = BNGetMediumLevelILInstructionCount(m_object);
+	snapshot->exprs.reserve(exprCount);
+	snapshot->exprInstructions.reserve(exprCount);
+	for (size_t i = 0; i < exprCount; i++)
+	{
+		snapshot->exprs.push_back(BNGetMediumLevelILByIndex(m_object, i));
+		snapshot->exprInstructions.push_back(BNGetMediumLevelILInstructionForExpr(m_object, i));
+	}
+	snapshot->instructionExprs.reserve(instrCount);
+	for (size_t i = 0; i < instrCount; i++)
+		snapshot->instructionExprs.push_back(BNGetMediumLevelILIndexForInstruction(m_object, i));
+
+	result->m_snapshot = std::move(snapshot);
+	return result;
+}
+
+
 void MediumLevelILFunction::UpdateInstructionOperand(size_t i, size_t operandIndex, ExprId value)
 {
 	BNUpdateMediumLevelILOperand(m_object, i, operandIndex, value);
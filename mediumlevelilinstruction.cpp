@@ -18,7 +18,9 @@
 // FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
 // IN THE SOFTWARE.
 
+#include <algorithm>
 #include <cstring>
+#include <initializer_list>
 #ifdef BINARYNINJACORE_LIBRARY
 	#include "mediumlevelilfunction.h"
 	#include "mediumlevelilssafunction.h"
@@ -36,7 +38,30 @@ using namespace std;
 #endif
 
 
-unordered_map<MediumLevelILOperandUsage, MediumLevelILOperandType> MediumLevelILInstructionBase::operandTypeForUsage = {
+struct MediumLevelILOperandTypeForUsage
+{
+	MediumLevelILOperandUsage usage;
+	MediumLevelILOperandType type;
+};
+
+
+struct MediumLevelILOperationOperandUsages
+{
+	BNMediumLevelILOperation operation;
+	size_t count;
+	MediumLevelILOperandUsage usages[8];
+
+	constexpr MediumLevelILOperationOperandUsages(
+	    BNMediumLevelILOperation op, std::initializer_list<MediumLevelILOperandUsage> list) :
+	    operation(op), count(list.size()), usages {}
+	{
+		for (size_t i = 0; i < count; i++)
+			usages[i] = list.begin()[i];
+	}
+};
+
+
+static constexpr MediumLevelILOperandTypeForUsage s_operandTypeForUsage[] = {
     {SourceExprMediumLevelOperandUsage, ExprMediumLevelOperand},
     {SourceVariableMediumLevelOperandUsage, VariableMediumLevelOperand},
     {SourceSSAVariableMediumLevelOperandUsage, SSAVariableMediumLevelOperand},
@@ -78,8 +103,8 @@ unordered_map<MediumLevelILOperandUsage, MediumLevelILOperandType> MediumLevelIL
     {SourceSSAVariablesMediumLevelOperandUsages, SSAVariableListMediumLevelOperand}};
 
 
-unordered_map<BNMediumLevelILOperation, vector<MediumLevelILOperandUsage>>
-    MediumLevelILInstructionBase::operationOperandUsage = {{MLIL_NOP, {}}, {MLIL_NORET, {}}, {MLIL_BP, {}},
+static constexpr MediumLevelILOperationOperandUsages s_operationOperandUsage[] = {
+    {MLIL_NOP, {}}, {MLIL_NORET, {}}, {MLIL_BP, {}},
         {MLIL_UNDEF, {}}, {MLIL_UNIMPL, {}},
         {MLIL_SET_VAR, {DestVariableMediumLevelOperandUsage, SourceExprMediumLevelOperandUsage}},
         {MLIL_SET_VAR_FIELD,
@@ -243,6 +268,107 @@ unordered_map<BNMediumLevelILOperation, vector<MediumLevelILOperandUsage>>
         {MLIL_FCMP_UO, {LeftExprMediumLevelOperandUsage, RightExprMediumLevelOperandUsage}}};
 
 
+static constexpr MediumLevelILOperandType GetOperandTypeForUsage(MediumLevelILOperandUsage usage)
+{
+	for (auto& entry : s_operandTypeForUsage)
+	{
+		if (entry.usage == usage)
+			return entry.type;
+	}
+	return MediumLevelILOperandType();
+}
+
+
+static constexpr MediumLevelILOperandIndexTable GetOperandIndexTable()
+{
+	MediumLevelILOperandIndexTable result {};
+	for (auto& operation : result.index)
+	{
+		for (auto& operand : operation)
+			operand = MediumLevelILOperandIndexTable::InvalidIndex;
+	}
+
+	for (auto& operation : s_operationOperandUsage)
+	{
+		size_t operand = 0;
+		for (size_t i = 0; i < operation.count; i++)
+		{
+			MediumLevelILOperandUsage usage = operation.usages[i];
+			result.index[operation.operation][usage] = (uint8_t)operand;
+			switch (usage)
+			{
+			case PartialSSAVariableSourceMediumLevelOperandUsage:
+				// SSA variables are usually two slots, but this one has a previously defined
+				// variables and thus only takes one slot
+				operand++;
+				break;
+			case OutputVariablesSubExprMediumLevelOperandUsage:
+			case UntypedParameterExprsMediumLevelOperandUsage:
+				// Represented as subexpression, so only takes one slot even though it is a list
+				operand++;
+				break;
+			case OutputSSAVariablesSubExprMediumLevelOperandUsage:
+				// OutputSSAMemoryVersionMediumLevelOperandUsage follows at same operand
+				break;
+			case UntypedParameterSSAExprsMediumLevelOperandUsage:
+				// ParameterSSAMemoryVersionMediumLevelOperandUsage follows at same operand
+				break;
+			default:
+				switch (GetOperandTypeForUsage(usage))
+				{
+				case SSAVariableMediumLevelOperand:
+				case IndexListMediumLevelOperand:
+				case IndexMapMediumLevelOperand:
+				case VariableListMediumLevelOperand:
+				case SSAVariableListMediumLevelOperand:
+				case ExprListMediumLevelOperand:
+					// SSA variables and lists take two operand slots
+					operand += 2;
+					break;
+				default:
+					operand++;
+					break;
+				}
+				break;
+			}
+		}
+	}
+	return result;
+}
+
+
+// Evaluated at compile time so a usage list that doesn't fit the table fails the build
+static constexpr MediumLevelILOperandIndexTable s_operandIndexTable = GetOperandIndexTable();
+const MediumLevelILOperandIndexTable MediumLevelILInstructionBase::operationOperandIndexTable = s_operandIndexTable;
+
+
+static unordered_map<MediumLevelILOperandUsage, MediumLevelILOperandType> GetOperandTypesForUsages()
+{
+	unordered_map<MediumLevelILOperandUsage, MediumLevelILOperandType> result;
+	result.reserve(sizeof(s_operandTypeForUsage) / sizeof(s_operandTypeForUsage[0]));
+	for (auto& entry : s_operandTypeForUsage)
+		result.emplace(entry.usage, entry.type);
+	// Usages that operations refer to but that have no entry of their own resolve to the default type
+	for (auto& operation : s_operationOperandUsage)
+	{
+		for (size_t i = 0; i < operation.count; i++)
+			result.emplace(operation.usages[i], GetOperandTypeForUsage(operation.usages[i]));
+	}
+	return result;
+}
+
+
+static unordered_map<BNMediumLevelILOperation, vector<MediumLevelILOperandUsage>> GetOperandUsagesForOperations()
+{
+	unordered_map<BNMediumLevelILOperation, vector<MediumLevelILOperandUsage>> result;
+	result.reserve(sizeof(s_operationOperandUsage) / sizeof(s_operationOperandUsage[0]));
+	for (auto& operation : s_operationOperandUsage)
+		result.emplace(operation.operation,
+		    vector<MediumLevelILOperandUsage>(operation.usages, operation.usages + operation.count));
+	return result;
+}
+
+
 static unordered_map<BNMediumLevelILOperation, unordered_map<MediumLevelILOperandUsage, size_t>>
     GetOperandIndexForOperandUsages()
 {
@@ -298,6 +424,10 @@ static unordered_map<BNMediumLevelILOperation, unordered_map<MediumLevelILOperan
 }
 
 
+unordered_map<MediumLevelILOperandUsage, MediumLevelILOperandType>
+    MediumLevelILInstructionBase::operandTypeForUsage = GetOperandTypesForUsages();
+unordered_map<BNMediumLevelILOperation, vector<MediumLevelILOperandUsage>>
+    MediumLevelILInstructionBase::operationOperandUsage = GetOperandUsagesForOperations();
 unordered_map<BNMediumLevelILOperation, unordered_map<MediumLevelILOperandUsage, size_t>>
     MediumLevelILInstructionBase::operationOperandIndex = GetOperandIndexForOperandUsages();
 
@@ -1390,119 +1520,119 @@ void MediumLevelILInstructionBase::ClearAttribute(BNILInstructionAttribute attri
 }
 
 
-void MediumLevelILInstruction::VisitExprs(const std::function<bool(const MediumLevelILInstruction& expr)>& func) const
+void MediumLevelILInstruction::CollectSubExprs(vector<MediumLevelILInstruction>& toProcess) const
 {
-	if (!func(*this))
-		return;
+	// Collected in order, then reversed so the first one is on top
+	size_t first = toProcess.size();
 	switch (operation)
 	{
 	case MLIL_SET_VAR:
-		GetSourceExpr<MLIL_SET_VAR>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<MLIL_SET_VAR>());
 		break;
 	case MLIL_SET_VAR_SSA:
-		GetSourceExpr<MLIL_SET_VAR_SSA>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<MLIL_SET_VAR_SSA>());
 		break;
 	case MLIL_SET_VAR_ALIASED:
-		GetSourceExpr<MLIL_SET_VAR_ALIASED>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<MLIL_SET_VAR_ALIASED>());
 		break;
 	case MLIL_SET_VAR_SPLIT:
-		GetSourceExpr<MLIL_SET_VAR_SPLIT>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<MLIL_SET_VAR_SPLIT>());
 		break;
 	case MLIL_SET_VAR_SPLIT_SSA:
-		GetSourceExpr<MLIL_SET_VAR_SPLIT_SSA>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<MLIL_SET_VAR_SPLIT_SSA>());
 		break;
 	case MLIL_SET_VAR_FIELD:
-		GetSourceExpr<MLIL_SET_VAR_FIELD>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<MLIL_SET_VAR_FIELD>());
 		break;
 	case MLIL_SET_VAR_SSA_FIELD:
-		GetSourceExpr<MLIL_SET_VAR_SSA_FIELD>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<MLIL_SET_VAR_SSA_FIELD>());
 		break;
 	case MLIL_SET_VAR_ALIASED_FIELD:
-		GetSourceExpr<MLIL_SET_VAR_ALIASED_FIELD>().VisitExprs(func);
+		toProcess.push_back(GetSourceExpr<MLIL_SET_VAR_ALIASED_FIELD>());
 		break;
 	case MLIL_CALL:
-		GetDestExpr<MLIL_CALL>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_CALL>());
 		for (auto i : GetParameterExprs<MLIL_CALL>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_CALL_UNTYPED:
-		GetDestExpr<MLIL_CALL_UNTYPED>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_CALL_UNTYPED>());
 		for (auto i : GetParameterExprs<MLIL_CALL_UNTYPED>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_CALL_SSA:
-		GetDestExpr<MLIL_CALL_SSA>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_CALL_SSA>());
 		for (auto i : GetParameterExprs<MLIL_CALL_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_CALL_UNTYPED_SSA:
-		GetDestExpr<MLIL_CALL_UNTYPED_SSA>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_CALL_UNTYPED_SSA>());
 		for (auto i : GetParameterExprs<MLIL_CALL_UNTYPED_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_SYSCALL:
 		for (auto i : GetParameterExprs<MLIL_SYSCALL>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_SYSCALL_UNTYPED:
 		for (auto i : GetParameterExprs<MLIL_SYSCALL_UNTYPED>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_SYSCALL_SSA:
 		for (auto i : GetParameterExprs<MLIL_SYSCALL_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_SYSCALL_UNTYPED_SSA:
 		for (auto i : GetParameterExprs<MLIL_SYSCALL_UNTYPED_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_TAILCALL:
-		GetDestExpr<MLIL_TAILCALL>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_TAILCALL>());
 		for (auto i : GetParameterExprs<MLIL_TAILCALL>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_TAILCALL_UNTYPED:
-		GetDestExpr<MLIL_TAILCALL_UNTYPED>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_TAILCALL_UNTYPED>());
 		for (auto i : GetParameterExprs<MLIL_TAILCALL_UNTYPED>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_TAILCALL_SSA:
-		GetDestExpr<MLIL_TAILCALL_SSA>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_TAILCALL_SSA>());
 		for (auto i : GetParameterExprs<MLIL_TAILCALL_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_TAILCALL_UNTYPED_SSA:
-		GetDestExpr<MLIL_TAILCALL_UNTYPED_SSA>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_TAILCALL_UNTYPED_SSA>());
 		for (auto i : GetParameterExprs<MLIL_TAILCALL_UNTYPED_SSA>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_SEPARATE_PARAM_LIST:
 		for (auto i : GetParameterExprs<MLIL_SEPARATE_PARAM_LIST>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_SHARED_PARAM_SLOT:
 		for (auto i : GetParameterExprs<MLIL_SHARED_PARAM_SLOT>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_RET:
 		for (auto i : GetSourceExprs<MLIL_RET>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_STORE:
-		GetDestExpr<MLIL_STORE>().VisitExprs(func);
-		GetSourceExpr<MLIL_STORE>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_STORE>());
+		toProcess.push_back(GetSourceExpr<MLIL_STORE>());
 		break;
 	case MLIL_STORE_STRUCT:
-		GetDestExpr<MLIL_STORE_STRUCT>().VisitExprs(func);
-		GetSourceExpr<MLIL_STORE_STRUCT>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_STORE_STRUCT>());
+		toProcess.push_back(GetSourceExpr<MLIL_STORE_STRUCT>());
 		break;
 	case MLIL_STORE_SSA:
-		GetDestExpr<MLIL_STORE_SSA>().VisitExprs(func);
-		GetSourceExpr<MLIL_STORE_SSA>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_STORE_SSA>());
+		toProcess.push_back(GetSourceExpr<MLIL_STORE_SSA>());
 		break;
 	case MLIL_STORE_STRUCT_SSA:
-		GetDestExpr<MLIL_STORE_STRUCT_SSA>().VisitExprs(func);
-		GetSourceExpr<MLIL_STORE_STRUCT_SSA>().VisitExprs(func);
+		toProcess.push_back(GetDestExpr<MLIL_STORE_STRUCT_SSA>());
+		toProcess.push_back(GetSourceExpr<MLIL_STORE_STRUCT_SSA>());
 		break;
 	case MLIL_NEG:
 	case MLIL_NOT:
@@ -1529,7 +1659,7 @@ void MediumLevelILInstruction::VisitExprs(const std::function<bool(const MediumL
 	case MLIL_FLOOR:
 	case MLIL_CEIL:
 	case MLIL_FTRUNC:
-		AsOneOperand().GetSourceExpr().VisitExprs(func);
+		toProcess.push_back(AsOneOperand().GetSourceExpr());
 		break;
 	case MLIL_ADD:
 	case MLIL_SUB:
@@ -1576,29 +1706,36 @@ void MediumLevelILInstruction::VisitExprs(const std::function<bool(const MediumL
 	case MLIL_FCMP_GT:
 	case MLIL_FCMP_O:
 	case MLIL_FCMP_UO:
-		AsTwoOperand().GetLeftExpr().VisitExprs(func);
-		AsTwoOperand().GetRightExpr().VisitExprs(func);
+		toProcess.push_back(AsTwoOperand().GetLeftExpr());
+		toProcess.push_back(AsTwoOperand().GetRightExpr());
 		break;
 	case MLIL_ADC:
 	case MLIL_SBB:
 	case MLIL_RLC:
 	case MLIL_RRC:
-		AsTwoOperandWithCarry().GetLeftExpr().VisitExprs(func);
-		AsTwoOperandWithCarry().GetRightExpr().VisitExprs(func);
-		AsTwoOperandWithCarry().GetCarryExpr().VisitExprs(func);
+		toProcess.push_back(AsTwoOperandWithCarry().GetLeftExpr());
+		toProcess.push_back(AsTwoOperandWithCarry().GetRightExpr());
+		toProcess.push_back(AsTwoOperandWithCarry().GetCarryExpr());
 		break;
 	case MLIL_INTRINSIC:
 		for (auto i : GetParameterExprs<MLIL_INTRINSIC>())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	case MLIL_INTRINSIC_SSA:
 	case MLIL_MEMORY_INTRINSIC_SSA:
 		for (auto i : GetParameterExprs())
-			i.VisitExprs(func);
+			toProcess.push_back(i);
 		break;
 	default:
 		break;
 	}
+	std::reverse(toProcess.begin() + first, toProcess.end());
+}
+
+
+void MediumLevelILInstruction::VisitExprs(const std::function<bool(const MediumLevelILInstruction& expr)>& func) const
+{
+	VisitExprsT(func);
 }
 
 
@@ -1931,14 +2068,7 @@ ExprId MediumLevelILInstruction::CopyTo(MediumLevelILFunction* dest,
 
 bool MediumLevelILInstruction::GetOperandIndexForUsage(MediumLevelILOperandUsage usage, size_t& operandIndex) const
 {
-	auto operationIter = MediumLevelILInstructionBase::operationOperandIndex.find(operation);
-	if (operationIter == MediumLevelILInstructionBase::operationOperandIndex.end())
-		return false;
-	auto usageIter = operationIter->second.find(usage);
-	if (usageIter == operationIter->second.end())
-		return false;
-	operandIndex = usageIter->second;
-	return true;
+	return MediumLevelILInstructionBase::operationOperandIndexTable.Lookup(operation, usage, operandIndex);
 }
 
 
@@ -29,6 +29,7 @@
 #else
 	#include "binaryninjaapi.h"
 #endif
+#include "ilexprtraversal.h"
 
 #ifdef BINARYNINJACORE_LIBRARY
 namespace BinaryNinjaCore
@@ -136,6 +137,32 @@ namespace BinaryNinja
 		ParameterSSAMemoryVersionMediumLevelOperandUsage,
 		SourceSSAVariablesMediumLevelOperandUsages
 	};
+
+	/*!
+		Dense operation x operand usage -> operand index table, generated at compile time from the operand usage
+		lists in mediumlevelilinstruction.cpp.
+
+		\ingroup mediumlevelil
+	*/
+	struct MediumLevelILOperandIndexTable
+	{
+		static constexpr size_t OperationCount = MLIL_MEM_PHI + 1;
+		static constexpr size_t UsageCount = SourceSSAVariablesMediumLevelOperandUsages + 1;
+		static constexpr uint8_t InvalidIndex = 0xff;
+
+		uint8_t index[OperationCount][UsageCount];
+
+		bool Lookup(BNMediumLevelILOperation operation, MediumLevelILOperandUsage usage, size_t& operandIndex) const
+		{
+			if ((size_t)operation >= OperationCount || (size_t)usage >= UsageCount)
+				return false;
+			uint8_t result = index[operation][usage];
+			if (result == InvalidIndex)
+				return false;
+			operandIndex = result;
+			return true;
+		}
+	};
 }  // namespace BinaryNinjaCore
 
 namespace std {
@@ -442,6 +469,7 @@ namespace BinaryNinja
 		    operationOperandUsage;
 		static _STD_UNORDERED_MAP<BNMediumLevelILOperation, _STD_UNORDERED_MAP<MediumLevelILOperandUsage, size_t>>
 		    operationOperandIndex;
+		static const MediumLevelILOperandIndexTable operationOperandIndexTable;
 
 		MediumLevelILOperandList GetOperands() const;
 
@@ -570,8 +598,35 @@ namespace BinaryNinja
 		    MediumLevelILFunction* func, const BNMediumLevelILInstruction& instr, size_t expr, size_t instrIdx);
 		MediumLevelILInstruction(const MediumLevelILInstructionBase& instr);
 
+		// Appends the direct sub-expressions to `toProcess`, last one first, so popping them off the back visits them
+		// in order
+		void CollectSubExprs(_STD_VECTOR<MediumLevelILInstruction>& toProcess) const;
+
 		void VisitExprs(const std::function<bool(const MediumLevelILInstruction& expr)>& func) const;
 
+		// Same as `VisitExprs`, but the visitor is inlined and the tree is walked with an explicit stack. `func` returns
+		// false to skip the sub-expressions of the expression it was called with.
+		template <typename F>
+		void VisitExprsT(F&& func) const
+		{
+			if (!func(*this))
+				return;
+			_STD_VECTOR<MediumLevelILInstruction> toProcess;
+			CollectSubExprs(toProcess);
+			while (!toProcess.empty())
+			{
+				MediumLevelILInstruction cur = std::move(toProcess.back());
+				toProcess.pop_back();
+				if (func(cur))
+					cur.CollectSubExprs(toProcess);
+			}
+		}
+
+		ILExprTraversal<MediumLevelILInstruction> TraverseExprs(ILExprTraversalOrder order = PreOrderILExprTraversal) const
+		{
+			return ILExprTraversal<MediumLevelILInstruction>(*this, order);
+		}
+
 		ExprId CopyTo(MediumLevelILFunction* dest) const;
 		ExprId CopyTo(MediumLevelILFunction* dest,
 		    const std::function<ExprId(const MediumLevelILInstruction& subExpr)>& subExprHandler) const;
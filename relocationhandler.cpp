@@ -82,9 +82,9 @@ size_t RelocationHandler::GetOperandForExternalRelocationCallback(
     void* ctxt, const uint8_t* data, uint64_t addr, size_t length, BNLowLevelILFunction* il, BNRelocation* reloc)
 {
 	CallbackRef<RelocationHandler> handler(ctxt);
-	Ref<LowLevelILFunction> func(new LowLevelILFunction(BNNewLowLevelILFunctionReference(il)));
+	BorrowedCoreObject<LowLevelILFunction> func(il);
 	Ref<Relocation> relocObj = new Relocation(BNNewRelocationReference(reloc));
-	return handler->GetOperandForExternalRelocation(data, addr, length, func, relocObj);
+	return handler->GetOperandForExternalRelocation(data, addr, length, &func, relocObj);
 }
 
 
@@ -3219,6 +3219,8 @@ where
         alwaysBranch: Some(cb_always_branch::<A>),
         invertBranch: Some(cb_invert_branch::<A>),
         skipAndReturnValue: Some(cb_skip_and_return_value::<A>),
+        // Without a batch callback the core falls back to getInstructionInfo.
+        getInstructionInfoBatch: None,
     };
 
     unsafe {
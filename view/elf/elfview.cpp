@@ -133,10 +133,10 @@ ElfView::ElfView(BinaryView* data, bool parseOnly): BinaryView("ELF", data->GetF
 		header.headerSize, header.programHeaderSize, header.programHeaderCount, header.sectionHeaderSize,
 		header.sectionHeaderCount, header.stringTable);
 
-	BinaryReader reader(data);
-	reader.SetEndianness(m_endian);
+	MappedBinaryReader reader(data, m_endian);
 
 	// Parse program headers
+	reader.Map(header.programHeaderOffset, header.programHeaderCount * header.programHeaderSize);
 	reader.Seek(header.programHeaderOffset);
 	for (size_t i = 0; i < header.programHeaderCount; i++)
 	{
@@ -196,6 +196,7 @@ ElfView::ElfView(BinaryView* data, bool parseOnly): BinaryView("ELF", data->GetF
 	// Parse section headers
 	try
 	{
+		reader.Map(header.sectionHeaderOffset, header.sectionHeaderCount * header.sectionHeaderSize);
 		reader.Seek(header.sectionHeaderOffset);
 		m_logger->LogDebug("Section List");
 		for (size_t i = 0; i < header.sectionHeaderCount; i++)
@@ -338,7 +339,7 @@ static BNSymbolBinding TranslateELFBindingType(uint8_t type)
 }
 
 
-bool ElfView::ParseSymbolTableEntry(BinaryReader& reader, ElfSymbolTableEntry& entry, uint64_t sym,
+bool ElfView::ParseSymbolTableEntry(MappedBinaryReader& reader, ElfSymbolTableEntry& entry, uint64_t sym,
 	const Elf64SectionHeader& symbolTable, const Elf64SectionHeader& stringTable, bool dynamic)
 {
 	try
@@ -408,7 +409,7 @@ bool ElfView::ParseSymbolTableEntry(BinaryReader& reader, ElfSymbolTableEntry& e
 	return true;
 }
 
-void ElfView::GetRelocEntries(BinaryReader& reader, const vector<Elf64SectionHeader>& sections,
+void ElfView::GetRelocEntries(MappedBinaryReader& reader, const vector<Elf64SectionHeader>& sections,
 	bool implicit, vector<ELFRelocEntry>& result)
 {
 	size_t relocSize = m_elf32 ? 8 : 16;
@@ -417,6 +418,7 @@ void ElfView::GetRelocEntries(BinaryReader& reader, const vector<Elf64SectionHea
 
 	for (auto& section : sections)
 	{
+		reader.Map(section.offset, section.size);
 		for (uint64_t j = 0; j < section.size / relocSize; j++)
 		{
 			reader.Seek(section.offset + (j * relocSize));
@@ -444,8 +446,8 @@ bool ElfView::Init()
 {
 	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
 	// Add segments for the program headers
-	BinaryReader reader(GetParentView());
-	BinaryReader virtualReader(this);
+	MappedBinaryReader reader(GetParentView());
+	MappedBinaryReader virtualReader(this);
 
 	uint64_t initialImageBase = 0;
 	bool initialImageBaseSet = false;
@@ -469,6 +471,8 @@ bool ElfView::Init()
 	m_extractMangledTypes = viewSettings->Get<bool>("analysis.extractTypesFromMangledNames", this);
 	m_simplifyTemplates = viewSettings->Get<bool>("analysis.types.templateSimplifier", this);
 
+	// Symbol and relocation tables are array DataVariables unless the core supports structured tables
+	bool useStructuredTables = false;
 	Ref<Settings> settings = GetLoadSettings(GetTypeName());
 	if (settings)
 	{
@@ -484,6 +488,9 @@ bool ElfView::Init()
 				m_arch = m_plat->GetArchitecture();
 			}
 		}
+
+		if (settings->Contains("loader.elf.useStructuredTables"))
+			useStructuredTables = settings->Get<bool>("loader.elf.useStructuredTables", this);
 	}
 
 	int64_t imageBaseAdjustment = 0;
@@ -790,6 +797,7 @@ bool ElfView::Init()
 		try
 		{
 			uint64_t adjustedVirtualAddr = m_dynamicTable.virtualAddress + imageBaseAdjustment;
+			reader.Map(adjustedVirtualAddr - dynSeg->GetStart() + dynSeg->GetDataOffset(), m_dynamicTable.fileSize);
 			reader.Seek(adjustedVirtualAddr - dynSeg->GetStart() + dynSeg->GetDataOffset());
 
 			Elf64SectionHeader plt;
@@ -1427,6 +1435,8 @@ bool ElfView::Init()
 				if (!m_objectFile)
 					symTable = &dynamicSymbolTable;
 
+				// Relocations are submitted in chunks, symbol lookups below never depend on relocated data
+				RelocationBatch relocations(this, m_arch);
 				size_t anonymousEntryCount = 0;
 				for (auto& relocInfo : m_relocationInfo)
 				{
@@ -1438,7 +1448,7 @@ bool ElfView::Init()
 					if ((relocInfo.symbolIndex == 0) || (relocInfo.type == UnhandledRelocation))
 					{
 						relocInfo.baseRelative = imageBaseAdjustment != 0;
-						DefineRelocation(m_arch, relocInfo, imageBaseAdjustment, relocInfo.address);
+						relocations.Define(relocInfo, imageBaseAdjustment, relocInfo.address);
 					}
 					else
 					{
@@ -1460,7 +1470,7 @@ bool ElfView::Init()
 							// Section relative relocation
 							if (auto section = GetSectionByName(entry.name); section)
 							{
-								DefineRelocation(m_arch, relocInfo, section->GetStart(), relocInfo.address);
+								relocations.Define(relocInfo, section->GetStart(), relocInfo.address);
 								continue;
 							}
 						}
@@ -1504,7 +1514,7 @@ bool ElfView::Init()
 							auto symbol = GetSymbolByRawName(entry.name, GetExternalNameSpace());
 							if (symbol)
 							{
-								DefineRelocation(m_arch, relocInfo, symbol, relocInfo.address);
+								relocations.Define(relocInfo, symbol, relocInfo.address);
 								continue;
 							}
 						}
@@ -1515,7 +1525,7 @@ bool ElfView::Init()
 							auto symbol = GetSymbolByAddress(target);
 							if (symbol)
 							{
-								DefineRelocation(m_arch, relocInfo, symbol, relocInfo.address);
+								relocations.Define(relocInfo, symbol, relocInfo.address);
 								continue;
 							}
 						}
@@ -1526,11 +1536,12 @@ bool ElfView::Init()
 						{
 							if (symbol->GetAddress() == relocInfo.address)
 								continue;
-							DefineRelocation(m_arch, relocInfo, symbol, relocInfo.address);
+							relocations.Define(relocInfo, symbol, relocInfo.address);
 							break;
 						}
 					}
 				}
+				relocations.Flush();
 			}
 		}
 		catch (ReadException&)
@@ -1700,6 +1711,44 @@ bool ElfView::Init()
 		}
 	}
 
+	// Seed analysis with the function starts recorded in the .eh_frame_hdr search table
+	bool processEhFrameHdr = true;
+	if (settings && settings->Contains("loader.elf.processEhFrameHdr"))
+		processEhFrameHdr = settings->Get<bool>("loader.elf.processEhFrameHdr", this);
+	if (processEhFrameHdr)
+	{
+		for (const auto& i : m_programHeaders)
+		{
+			if (i.type != ELF_PT_GNU_EH_FRAME)
+				continue;
+
+			vector<uint64_t> ehStarts;
+			try
+			{
+				ParseEhFrameHdr(virtualReader, i.virtualAddress + imageBaseAdjustment, i.memorySize,
+					imageBaseAdjustment, ehStarts);
+			}
+			catch (ReadException&)
+			{
+				m_logger->LogWarn("Failed to parse .eh_frame_hdr at %#" PRIx64, i.virtualAddress + imageBaseAdjustment);
+			}
+			virtualReader.Unmap();
+
+			map<Ref<Platform>, vector<uint64_t>> functionStarts;
+			for (uint64_t target : ehStarts)
+			{
+				if (!IsOffsetExecutable(target))
+					continue;
+				Ref<Platform> targetPlatform = platform->GetAssociatedPlatformByAddress(target);
+				functionStarts[targetPlatform].push_back(target);
+			}
+			m_logger->LogDebug("Found %zu function starts in .eh_frame_hdr", ehStarts.size());
+			for (auto& [targetPlatform, starts] : functionStarts)
+				AddFunctionsForAnalysis(targetPlatform, starts);
+			break;
+		}
+	}
+
 	// Sometimes ELF will specify Thumb entry points w/o the bottom bit set
 	// To deal with this we delay adding entry points until after symbols have been resolved
 	// and ALL the functions have been created. This allows us to query the existing functions
@@ -2281,7 +2330,10 @@ bool ElfView::Init()
 		{
 			auto defineAuxSymTableForView = [&](Ref<BinaryView> view) {
 				QualifiedName symTableTypeName = view->DefineType(symTableTypeId, symTableName, symTableType);
-				view->DefineDataVariable(m_auxSymbolTable.offset, Type::ArrayType(Type::NamedType(this, symTableTypeName), m_auxSymbolTable.size / m_auxSymbolTableEntrySize));
+				if (useStructuredTables)
+					view->DefineStructuredTable(m_auxSymbolTable.offset, Type::NamedType(this, symTableTypeName), m_auxSymbolTable.size / m_auxSymbolTableEntrySize);
+				else
+					view->DefineDataVariable(m_auxSymbolTable.offset, Type::ArrayType(Type::NamedType(this, symTableTypeName), m_auxSymbolTable.size / m_auxSymbolTableEntrySize));
 				view->DefineAutoSymbol(new Symbol(DataSymbol, "__elf_symbol_table", m_auxSymbolTable.offset, NoBinding));
 			};
 			defineAuxSymTableForView(this);
@@ -2291,7 +2343,10 @@ bool ElfView::Init()
 		if (m_symbolTableSection.offset)
 		{
 			QualifiedName symTableTypeName = GetParentView()->DefineType(symTableTypeId, symTableName, symTableType);
-			GetParentView()->DefineDataVariable(m_symbolTableSection.offset, Type::ArrayType(Type::NamedType(this, symTableTypeName), m_symbolTableSection.size / m_auxSymbolTableEntrySize));
+			if (useStructuredTables)
+				GetParentView()->DefineStructuredTable(m_symbolTableSection.offset, Type::NamedType(this, symTableTypeName), m_symbolTableSection.size / m_auxSymbolTableEntrySize);
+			else
+				GetParentView()->DefineDataVariable(m_symbolTableSection.offset, Type::ArrayType(Type::NamedType(this, symTableTypeName), m_symbolTableSection.size / m_auxSymbolTableEntrySize));
 			GetParentView()->DefineAutoSymbol(new Symbol(DataSymbol, "__elf_symbol_table", m_symbolTableSection.offset, NoBinding));
 		}
 	}
@@ -2315,8 +2370,11 @@ bool ElfView::Init()
 		const string relocationTableTypeId = Type::GenerateAutoTypeId("elf", relocationTableName);
 
 		QualifiedName relocTableTypeName = DefineType(relocationTableTypeId, relocationTableName, relocationTableType);
-		DefineDataVariable(m_relocSection.offset,
-			Type::ArrayType(Type::NamedType(this, relocTableTypeName), m_relocSection.size / m_relocSection.entrySize));
+		if (useStructuredTables)
+			DefineStructuredTable(m_relocSection.offset, Type::NamedType(this, relocTableTypeName), m_relocSection.size / m_relocSection.entrySize);
+		else
+			DefineDataVariable(m_relocSection.offset,
+				Type::ArrayType(Type::NamedType(this, relocTableTypeName), m_relocSection.size / m_relocSection.entrySize));
 		DefineAutoSymbol(new Symbol(DataSymbol, "__elf_rel_table", m_relocSection.offset, NoBinding));
 	}
 
@@ -2342,9 +2400,12 @@ bool ElfView::Init()
 
 		QualifiedName relocaTableTypeName =
 			DefineType(relocationATableTypeId, relocationATableName, relocationATableType);
-		DefineDataVariable(m_relocaSection.offset,
-			Type::ArrayType(
-				Type::NamedType(this, relocaTableTypeName), m_relocaSection.size / m_relocaSection.entrySize));
+		if (useStructuredTables)
+			DefineStructuredTable(m_relocaSection.offset, Type::NamedType(this, relocaTableTypeName), m_relocaSection.size / m_relocaSection.entrySize);
+		else
+			DefineDataVariable(m_relocaSection.offset,
+				Type::ArrayType(
+					Type::NamedType(this, relocaTableTypeName), m_relocaSection.size / m_relocaSection.entrySize));
 		DefineAutoSymbol(new Symbol(DataSymbol, "__elf_rela_table", m_relocaSection.offset, NoBinding));
 	}
 
@@ -2605,7 +2666,7 @@ void ElfView::ApplyTypesToStringTable(const Elf64SectionHeader& section, const i
 }
 
 
-string ElfView::ReadStringTable(BinaryReader& reader, const Elf64SectionHeader& section, uint64_t offset)
+string ElfView::ReadStringTable(MappedBinaryReader& reader, const Elf64SectionHeader& section, uint64_t offset)
 {
 	if (offset == 0 || offset > section.size)
 		return "";
@@ -2632,7 +2693,7 @@ string ElfView::ReadStringTable(BinaryReader& reader, const Elf64SectionHeader&
 
 
 // http://refspecs.linuxfoundation.org/ELF/ppc64/PPC-elf64abi-1.9.html#FUNC-DES
-bool ElfView::DerefPpc64Descriptor(BinaryReader& reader, uint64_t addr, uint64_t& result)
+bool ElfView::DerefPpc64Descriptor(MappedBinaryReader& reader, uint64_t addr, uint64_t& result)
 {
 	/* must be 64-bit ELF, arch PPC64 */
 	if (m_elf32 || m_commonHeader.arch != EM_PPC64)
@@ -2655,6 +2716,156 @@ bool ElfView::DerefPpc64Descriptor(BinaryReader& reader, uint64_t addr, uint64_t
 }
 
 
+static bool ReadEncodedPointer(MappedBinaryReader& reader, uint8_t encoding, uint64_t dataRel, size_t addressSize,
+	int64_t absoluteBias, uint64_t& result)
+{
+	uint64_t base = reader.GetOffset();
+	uint64_t value = 0;
+	switch (encoding & 0x0f)
+	{
+	case DW_EH_PE_absptr:
+		value = (addressSize == 4) ? reader.Read32() : reader.Read64();
+		break;
+	case DW_EH_PE_uleb128:
+	case DW_EH_PE_sleb128:
+	{
+		uint8_t byte;
+		size_t shift = 0;
+		do
+		{
+			byte = reader.Read8();
+			if (shift < 64)
+				value |= (uint64_t)(byte & 0x7f) << shift;
+			shift += 7;
+		} while (byte & 0x80);
+		if (((encoding & 0x0f) == DW_EH_PE_sleb128) && (shift < 64) && (byte & 0x40))
+			value |= ~(uint64_t)0 << shift;
+		break;
+	}
+	case DW_EH_PE_udata2:
+		value = reader.Read16();
+		break;
+	case DW_EH_PE_udata4:
+		value = reader.Read32();
+		break;
+	case DW_EH_PE_udata8:
+		value = reader.Read64();
+		break;
+	case DW_EH_PE_sdata2:
+		value = (int64_t)(int16_t)reader.Read16();
+		break;
+	case DW_EH_PE_sdata4:
+		value = (int64_t)(int32_t)reader.Read32();
+		break;
+	case DW_EH_PE_sdata8:
+		value = reader.Read64();
+		break;
+	default:
+		return false;
+	}
+
+	switch (encoding & 0x70)
+	{
+	case DW_EH_PE_absptr:
+		value += absoluteBias;
+		break;
+	case DW_EH_PE_pcrel:
+		value += base;
+		break;
+	case DW_EH_PE_datarel:
+		value += dataRel;
+		break;
+	default:
+		return false;
+	}
+
+	// Indirect pointers would need the target to be relocated first, which hasn't happened yet
+	if (encoding & DW_EH_PE_indirect)
+		return false;
+
+	if (addressSize == 4)
+		value &= 0xffffffff;
+	result = value;
+	return true;
+}
+
+
+// https://refspecs.linuxfoundation.org/LSB_5.0.0/LSB-Core-generic/LSB-Core-generic/ehframechpt.html
+bool ElfView::ParseEhFrameHdr(MappedBinaryReader& reader, uint64_t start, uint64_t size, int64_t imageBaseAdjustment,
+	vector<uint64_t>& starts)
+{
+	if (size < 4)
+		return false;
+
+	reader.Map(start, size);
+	reader.Seek(start);
+	uint8_t version = reader.Read8();
+	uint8_t ehFramePtrEnc = reader.Read8();
+	uint8_t fdeCountEnc = reader.Read8();
+	uint8_t tableEnc = reader.Read8();
+	if (version != 1)
+	{
+		m_logger->LogDebug("Unsupported .eh_frame_hdr version %d", version);
+		return false;
+	}
+
+	// Without a binary search table there's nothing to seed from
+	if (fdeCountEnc == DW_EH_PE_omit || tableEnc == DW_EH_PE_omit)
+		return false;
+
+	uint64_t ehFramePtr, fdeCount;
+	if ((ehFramePtrEnc != DW_EH_PE_omit)
+		&& !ReadEncodedPointer(reader, ehFramePtrEnc, start, m_addressSize, imageBaseAdjustment, ehFramePtr))
+		return false;
+	if (!ReadEncodedPointer(reader, fdeCountEnc, start, m_addressSize, 0, fdeCount))
+		return false;
+
+	size_t entrySize;
+	switch (tableEnc & 0x0f)
+	{
+	case DW_EH_PE_udata2:
+	case DW_EH_PE_sdata2:
+		entrySize = 2;
+		break;
+	case DW_EH_PE_udata4:
+	case DW_EH_PE_sdata4:
+		entrySize = 4;
+		break;
+	case DW_EH_PE_udata8:
+	case DW_EH_PE_sdata8:
+		entrySize = 8;
+		break;
+	case DW_EH_PE_absptr:
+		entrySize = m_addressSize;
+		break;
+	default:
+		// The table is only searchable with fixed size entries
+		return false;
+	}
+
+	uint64_t tableOffset = reader.GetOffset() - start;
+	if (tableOffset > size)
+		return false;
+	uint64_t maxCount = (size - tableOffset) / (entrySize * 2);
+	if (fdeCount > maxCount)
+	{
+		m_logger->LogWarn(".eh_frame_hdr claims %" PRIu64 " entries but only has room for %" PRIu64, fdeCount, maxCount);
+		fdeCount = maxCount;
+	}
+
+	starts.reserve(starts.size() + fdeCount);
+	for (uint64_t i = 0; i < fdeCount; i++)
+	{
+		uint64_t initialLocation;
+		if (!ReadEncodedPointer(reader, tableEnc, start, m_addressSize, imageBaseAdjustment, initialLocation))
+			return false;
+		reader.SeekRelative(entrySize);
+		starts.push_back(initialLocation);
+	}
+	return true;
+}
+
+
 void ElfView::ParseMiniDebugInfo()
 {
 	Ref<Section> gnuDebugdata = GetParentView()->GetSectionByName(".gnu_debugdata");
@@ -2693,11 +2904,12 @@ void ElfView::ParseMiniDebugInfo()
 }
 
 
-vector<ElfSymbolTableEntry> ElfView::ParseSymbolTable(BinaryReader& reader, const Elf64SectionHeader& symbolSection,
+vector<ElfSymbolTableEntry> ElfView::ParseSymbolTable(MappedBinaryReader& reader, const Elf64SectionHeader& symbolSection,
 	const Elf64SectionHeader& stringSection, bool dynamic, size_t startEntry)
 {
 	size_t size = (size_t)symbolSection.size / (m_elf32 ? 16 : 24);
 	vector<ElfSymbolTableEntry> result;
+	reader.Map(symbolSection.offset, symbolSection.size);
 	for (size_t i = startEntry; i < size; i++)
 	{
 		ElfSymbolTableEntry entry;
@@ -2964,6 +3176,21 @@ Ref<Settings> ElfViewType::GetLoadSettingsForData(BinaryView* data)
 			settings->UpdateProperty(override, "readOnly", false);
 	}
 
+	settings->RegisterSetting("loader.elf.useStructuredTables",
+			R"({
+			"title" : "Define ELF Tables as Structured Tables",
+			"type" : "boolean",
+			"default" : false,
+			"description" : "Define the symbol and relocation tables as structured tables instead of array data variables. Requires a core with structured table support."
+			})");
+
+	settings->RegisterSetting("loader.elf.processEhFrameHdr",
+			R"({
+			"title" : "Process ELF Exception Frame Header",
+			"type" : "boolean",
+			"default" : true,
+			"description" : "Add function starts sourced from the .eh_frame_hdr binary search table to the core for analysis."
+			})");
 
 	return settings;
 }
@@ -344,6 +344,21 @@
 #define R_ARM_TLS_DTPMOD32 0x11
 #define R_ARM_TLS_DTPOFF32 0x12
 
+// Pointer encodings used by .eh_frame_hdr (LSB Core, Exception Frames)
+#define DW_EH_PE_absptr   0x00
+#define DW_EH_PE_uleb128  0x01
+#define DW_EH_PE_udata2   0x02
+#define DW_EH_PE_udata4   0x03
+#define DW_EH_PE_udata8   0x04
+#define DW_EH_PE_sleb128  0x09
+#define DW_EH_PE_sdata2   0x0a
+#define DW_EH_PE_sdata4   0x0b
+#define DW_EH_PE_sdata8   0x0c
+#define DW_EH_PE_pcrel    0x10
+#define DW_EH_PE_datarel  0x30
+#define DW_EH_PE_indirect 0x80
+#define DW_EH_PE_omit     0xff
+
 namespace BinaryNinja
 {
 	class ElfFormatException: public std::exception
@@ -522,11 +537,11 @@ namespace BinaryNinja
 
 		void ApplyTypesToParentStringTable(const Elf64SectionHeader& section, const bool offset = true);
 		void ApplyTypesToStringTable(const Elf64SectionHeader& section, const int64_t imageBaseAdjustment, const bool offset = true);
-		std::string ReadStringTable(BinaryReader& view, const Elf64SectionHeader& section, uint64_t offset);
-		bool ParseSymbolTableEntry(BinaryReader& reader, ElfSymbolTableEntry& entry, uint64_t sym,
+		std::string ReadStringTable(MappedBinaryReader& view, const Elf64SectionHeader& section, uint64_t offset);
+		bool ParseSymbolTableEntry(MappedBinaryReader& reader, ElfSymbolTableEntry& entry, uint64_t sym,
 			const Elf64SectionHeader& symbolTable, const Elf64SectionHeader& stringTable, bool dynamic);
 
-		std::vector<ElfSymbolTableEntry> ParseSymbolTable(BinaryReader& reader, const Elf64SectionHeader& symbolTableSection,
+		std::vector<ElfSymbolTableEntry> ParseSymbolTable(MappedBinaryReader& reader, const Elf64SectionHeader& symbolTableSection,
 			const Elf64SectionHeader& section, bool dynamic, size_t startEntry=0);
 
 		virtual uint64_t PerformGetEntryPoint() const override;
@@ -535,9 +550,11 @@ namespace BinaryNinja
 		virtual BNEndianness PerformGetDefaultEndianness() const override;
 		virtual bool PerformIsRelocatable() const override;
 		virtual size_t PerformGetAddressSize() const override;
-		void GetRelocEntries(BinaryReader& reader, const std::vector<Elf64SectionHeader>& sections,
+		void GetRelocEntries(MappedBinaryReader& reader, const std::vector<Elf64SectionHeader>& sections,
 			bool implicit, std::vector<ELFRelocEntry>& result);
-		bool DerefPpc64Descriptor(BinaryReader& reader, uint64_t addr, uint64_t& result);
+		bool DerefPpc64Descriptor(MappedBinaryReader& reader, uint64_t addr, uint64_t& result);
+		bool ParseEhFrameHdr(MappedBinaryReader& reader, uint64_t start, uint64_t size, int64_t imageBaseAdjustment,
+			std::vector<uint64_t>& starts);
 
 		void ParseMiniDebugInfo();
 	public:
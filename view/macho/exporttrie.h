@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "machoview.h"
+
+namespace BinaryNinja
+{
+	/*!
+		Non-recursive walker for Mach-O export tries (LC_DYLD_INFO export data and LC_DYLD_EXPORTS_TRIE).
+
+		The trie is walked depth first using an explicit stack, and the symbol name is built up in a single prefix
+		buffer that is truncated back to the parent's length when moving to a sibling edge. No allocation is done per
+		node or per symbol beyond the growth of those two buffers.
+
+		Re-exports have no address in this image and are skipped.
+	*/
+	class ExportTrieWalker
+	{
+		struct Frame
+		{
+			const uint8_t* cursor;
+			uint8_t childrenRemaining;
+			size_t prefixLength;
+		};
+
+		const uint8_t* m_begin;
+		const uint8_t* m_end;
+		std::string m_prefix;
+		std::vector<Frame> m_stack;
+
+		uint64_t ReadULEB128(const uint8_t*& current) const
+		{
+			uint64_t result = 0;
+			int bit = 0;
+			do
+			{
+				if (current >= m_end || bit > 63)
+					throw ReadException();
+				result |= (uint64_t)(*current & 0x7f) << bit;
+				bit += 7;
+			} while (*current++ & 0x80);
+			return result;
+		}
+
+		template <typename F>
+		void VisitNode(const uint8_t* node, F& callback)
+		{
+			if (node >= m_end)
+				throw ReadException();
+
+			uint64_t terminalSize = ReadULEB128(node);
+			if (terminalSize > (uint64_t)(m_end - node))
+				throw ReadException();
+			const uint8_t* children = node + terminalSize;
+			if (terminalSize != 0)
+			{
+				uint64_t flags = ReadULEB128(node);
+				if (!(flags & EXPORT_SYMBOL_FLAGS_REEXPORT))
+					callback(std::string_view(m_prefix), flags, ReadULEB128(node));
+			}
+
+			if (children >= m_end)
+				throw ReadException();
+			uint8_t childCount = *children++;
+
+			// A well formed trie can't be deeper than it has bytes. Anything deeper has a cycle.
+			if (m_stack.size() >= (size_t)(m_end - m_begin))
+				throw ReadException();
+			m_stack.push_back({children, childCount, m_prefix.size()});
+		}
+
+	public:
+		ExportTrieWalker(const uint8_t* begin, const uint8_t* end) : m_begin(begin), m_end(end) {}
+
+		/*!
+			Calls `callback(std::string_view name, uint64_t flags, uint64_t imageOffset)` for every export.
+			`name` is only valid for the duration of the call.
+
+			\throws ReadException if the trie is malformed
+		*/
+		template <typename F>
+		void Walk(F&& callback)
+		{
+			m_prefix.clear();
+			m_stack.clear();
+			if (m_begin == m_end)
+				return;
+
+			VisitNode(m_begin, callback);
+			while (!m_stack.empty())
+			{
+				Frame& frame = m_stack.back();
+				if (frame.childrenRemaining == 0)
+				{
+					m_stack.pop_back();
+					continue;
+				}
+				frame.childrenRemaining--;
+
+				m_prefix.resize(frame.prefixLength);
+				if (frame.cursor >= m_end)
+					throw ReadException();
+				auto edge = (const uint8_t*)memchr(frame.cursor, 0, m_end - frame.cursor);
+				if (!edge)
+					throw ReadException();
+				m_prefix.append((const char*)frame.cursor, edge - frame.cursor);
+				edge++;
+
+				uint64_t next = ReadULEB128(edge);
+				if (next == 0 || next >= (uint64_t)(m_end - m_begin))
+					throw ReadException();
+				frame.cursor = edge;
+
+				// `frame` may be invalidated by the push in `VisitNode`.
+				VisitNode(m_begin + next, callback);
+			}
+		}
+	};
+
+
+	/*!
+		Compact, arena backed list of the exports in a trie.
+
+		Each entry is an (image offset, flags, name offset) record with names stored back to back, NUL terminated, in
+		a single string. Callers create `Symbol` objects from entries only when they actually apply them.
+	*/
+	class ExportTrie
+	{
+	public:
+		struct Entry
+		{
+			uint64_t imageOffset;
+			uint64_t flags;
+			uint32_t nameOffset;
+			uint32_t nameLength;
+		};
+
+	private:
+		std::vector<Entry> m_entries;
+		std::string m_names;
+
+	public:
+		/*!
+			Parses the trie in [begin, end). Exports with an empty name are skipped.
+
+			\throws ReadException if the trie is malformed
+		*/
+		static ExportTrie Parse(const uint8_t* begin, const uint8_t* end)
+		{
+			ExportTrie trie;
+			ExportTrieWalker(begin, end).Walk([&](std::string_view name, uint64_t flags, uint64_t imageOffset) {
+				if (name.empty())
+					return;
+				trie.m_entries.push_back({imageOffset, flags, (uint32_t)trie.m_names.size(), (uint32_t)name.size()});
+				trie.m_names.append(name);
+				trie.m_names.push_back('\0');
+			});
+			trie.m_entries.shrink_to_fit();
+			trie.m_names.shrink_to_fit();
+			return trie;
+		}
+
+		const std::vector<Entry>& GetEntries() const { return m_entries; }
+		size_t GetCount() const { return m_entries.size(); }
+		bool IsEmpty() const { return m_entries.empty(); }
+
+		// NUL terminated, so it can be passed directly to the core.
+		const char* GetName(const Entry& entry) const { return m_names.data() + entry.nameOffset; }
+		std::string_view GetNameView(const Entry& entry) const { return {GetName(entry), entry.nameLength}; }
+	};
+}  // namespace BinaryNinja
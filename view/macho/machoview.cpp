@@ -9,6 +9,7 @@
 #include <cxxabi.h>
 #endif
 #include "machoview.h"
+#include "exporttrie.h"
 #include "fatmachoview.h"
 #include "universalview.h"
 #include "lowlevelilinstruction.h"
@@ -190,15 +191,6 @@ static uint64_t readLEB128(DataBuffer& p, size_t end, size_t &offset)
 }
 
 
-uint64_t readValidULEB128(DataBuffer& buffer, size_t& cursor)
-{
-	uint64_t value = readLEB128(buffer, buffer.GetLength(), cursor);
-	if ((int64_t)value == -1)
-		throw ReadException();
-	return value;
-}
-
-
 MachoView::MachoView(const string& typeName, BinaryView* data, bool parseOnly): BinaryView(typeName, data->GetFile(), data),
 	m_universalImageOffset(0), m_parseOnly(parseOnly)
 {
@@ -975,6 +967,7 @@ void MachoView::ParseFunctionStarts(Platform* platform, uint64_t textBase, funct
 	BinaryReader reader(GetParentView());
 	reader.SetEndianness(m_endian);
 	reader.SetVirtualBase(m_universalImageOffset);
+	map<Ref<Platform>, vector<uint64_t>> starts;
 	try
 	{
 		if (m_header.ident.filetype == MH_DSYM)
@@ -1002,7 +995,7 @@ void MachoView::ParseFunctionStarts(Platform* platform, uint64_t textBase, funct
 				continue;
 			}
 			Ref<Platform> targetPlatform = platform->GetAssociatedPlatformByAddress(target);
-			AddFunctionForAnalysis(targetPlatform, target);
+			starts[targetPlatform].push_back(target);
 			m_logger->LogDebug("Adding function start: %#" PRIx64 "\n", curfunc);
 		}
 	}
@@ -1010,6 +1003,9 @@ void MachoView::ParseFunctionStarts(Platform* platform, uint64_t textBase, funct
 	{
 		m_logger->LogDebug("LC_FUNCTION_STARTS command invalid");
 	}
+
+	for (auto& [targetPlatform, addrs] : starts)
+		AddFunctionsForAnalysis(targetPlatform, addrs);
 }
 
 
@@ -2050,21 +2046,24 @@ bool MachoView::InitializeHeader(MachOHeader& header, bool isMainHeader, uint64_
 
 	EndBulkModifySymbols();
 
-	for (auto& relocation : header.rebaseRelocations)
-	{
-		uint64_t relocationLocation = relocation.address;
-		virtualReader.Seek(relocationLocation);
-		uint64_t target = virtualReader.ReadPointer();
-		uint64_t slidTarget = target + m_imageBaseAdjustment;
-		relocation.address = slidTarget;
-		DefineRelocation(m_arch, relocation, slidTarget, relocationLocation);
-		if (m_objcProcessor)
-			m_objcProcessor->AddRelocatedPointer(relocationLocation, slidTarget);
-	}
-	for (auto& [relocation, name] : header.externalRelocations)
 	{
-		if (auto symbol = GetSymbolByRawName(name, GetExternalNameSpace()); symbol)
-			DefineRelocation(m_arch, relocation, symbol, relocation.address);
+		RelocationBatch relocations(this, m_arch);
+		for (auto& relocation : header.rebaseRelocations)
+		{
+			uint64_t relocationLocation = relocation.address;
+			virtualReader.Seek(relocationLocation);
+			uint64_t target = virtualReader.ReadPointer();
+			uint64_t slidTarget = target + m_imageBaseAdjustment;
+			relocation.address = slidTarget;
+			relocations.Define(relocation, slidTarget, relocationLocation);
+			if (m_objcProcessor)
+				m_objcProcessor->AddRelocatedPointer(relocationLocation, slidTarget);
+		}
+		for (auto& [relocation, name] : header.externalRelocations)
+		{
+			if (auto symbol = GetSymbolByRawName(name, GetExternalNameSpace()); symbol)
+				relocations.Define(relocation, symbol, relocation.address);
+		}
 	}
 
 	auto relocationHandler = m_arch->GetRelocationHandler("Mach-O");
@@ -2076,6 +2075,7 @@ bool MachoView::InitializeHeader(MachOHeader& header, bool isMainHeader, uint64_
 			// For executables the relocations are attached to each of the sections
 			// In libraries these are zeroed out and collected in the dysymtab
 			vector<BNRelocationInfo> infoList;
+			MappedBinaryReader relocReader(GetParentView(), m_endian);
 			for (auto& section : header.sections)
 			{
 				if (section.nreloc == 0)
@@ -2092,11 +2092,12 @@ bool MachoView::InitializeHeader(MachOHeader& header, bool isMainHeader, uint64_
 					m_logger->LogError("Can't find section for %s", sectionName);
 					continue;
 				}
+				relocReader.Map(m_universalImageOffset + section.reloff, (size_t)section.nreloc * sizeof(relocation_info));
 				for (size_t i = 0; i < section.nreloc; i++)
 				{
 					relocation_info info;
-					reader.Seek(section.reloff + (i * sizeof(relocation_info)));
-					reader.Read(&info, sizeof(info));
+					relocReader.Seek(m_universalImageOffset + section.reloff + (i * sizeof(relocation_info)));
+					relocReader.Read(&info, sizeof(info));
 					BNRelocationInfo result;
 					memset(&result, 0, sizeof(result));
 					if (ParseRelocationEntry(info, sec->GetStart(), result))
@@ -2137,11 +2138,12 @@ bool MachoView::InitializeHeader(MachOHeader& header, bool isMainHeader, uint64_
 			infoList.clear();
 
 			// Handle local relocations for dynamic libraries
+			relocReader.Map(m_universalImageOffset + header.dysymtab.locreloff, (size_t)header.dysymtab.nlocrel * sizeof(relocation_info));
 			for (size_t i = 0; i < header.dysymtab.nlocrel; i++)
 			{
 				relocation_info info;
-				reader.Seek(header.dysymtab.locreloff + (i * sizeof(relocation_info)));
-				reader.Read(&info, sizeof(info));
+				relocReader.Seek(m_universalImageOffset + header.dysymtab.locreloff + (i * sizeof(relocation_info)));
+				relocReader.Read(&info, sizeof(info));
 				BNRelocationInfo result;
 				memset(&result, 0, sizeof(result));
 				if (ParseRelocationEntry(info, header.relocationBase, result))
@@ -2173,11 +2175,12 @@ bool MachoView::InitializeHeader(MachOHeader& header, bool isMainHeader, uint64_
 			infoList.clear();
 
 			// Handle external relocations for dynamic libraries
+			relocReader.Map(m_universalImageOffset + header.dysymtab.extreloff, (size_t)header.dysymtab.nextrel * sizeof(relocation_info));
 			for (size_t i = 0; i < header.dysymtab.nextrel; i++)
 			{
 				relocation_info info;
-				reader.Seek(header.dysymtab.extreloff + (i * sizeof(relocation_info)));
-				reader.Read(&info, sizeof(info));
+				relocReader.Seek(m_universalImageOffset + header.dysymtab.extreloff + (i * sizeof(relocation_info)));
+				relocReader.Read(&info, sizeof(info));
 				BNRelocationInfo result;
 				memset(&result, 0, sizeof(result));
 				if (ParseRelocationEntry(info, header.relocationBase, result))
@@ -2504,10 +2507,15 @@ bool MachoView::GetSectionPermissions(MachOHeader& header, uint64_t address, uin
 void MachoView::ParseExportTrie(BinaryReader& reader, linkedit_data_command exportTrie)
 {
 	try {
-		uint32_t endGuard = exportTrie.datasize;
 		DataBuffer buffer = GetParentView()->ReadBuffer(m_universalImageOffset + exportTrie.dataoff, exportTrie.datasize);
+		auto begin = static_cast<const uint8_t*>(buffer.GetData());
+		uint64_t viewStart = GetStart();
 
-		ReadExportNode(GetStart(), buffer, "", 0, endGuard);
+		ExportTrieWalker(begin, begin + buffer.GetLength()).Walk(
+			[&](std::string_view name, uint64_t flags, uint64_t imageOffset) {
+				auto symbolType = GetAnalysisFunctionsForAddress(viewStart + imageOffset).size() ? FunctionSymbol : DataSymbol;
+				DefineMachoSymbol(symbolType, std::string(name), imageOffset + viewStart, GlobalBinding, true);
+			});
 	}
 	catch (ReadException&)
 	{
@@ -2515,43 +2523,6 @@ void MachoView::ParseExportTrie(BinaryReader& reader, linkedit_data_command expo
 	}
 }
 
-void MachoView::ReadExportNode(uint64_t viewStart, DataBuffer& buffer, const std::string& currentText, size_t cursor, uint32_t endGuard)
-{
-	if (cursor > endGuard)
-		throw ReadException();
-
-	uint64_t terminalSize = readValidULEB128(buffer, cursor);
-	uint64_t childOffset = cursor + terminalSize;
-	if (terminalSize != 0) {
-		uint64_t imageOffset = 0;
-		uint64_t flags = readValidULEB128(buffer, cursor);
-		if (!(flags & EXPORT_SYMBOL_FLAGS_REEXPORT))
-		{
-			imageOffset = readValidULEB128(buffer, cursor);
-			auto symbolType = GetAnalysisFunctionsForAddress(viewStart + imageOffset).size() ? FunctionSymbol : DataSymbol;
-			DefineMachoSymbol(symbolType, currentText, imageOffset + viewStart, GlobalBinding, true);
-		}
-	}
-	cursor = childOffset;
-	uint8_t childCount = buffer[cursor];
-	cursor++;
-	if (cursor > endGuard)
-		throw ReadException();
-	for (uint8_t i = 0; i < childCount; ++i)
-	{
-		std::string childText;
-		while (buffer[cursor] != 0 & cursor <= endGuard)
-			childText.push_back(buffer[cursor++]);
-		cursor++;
-		if (cursor > endGuard)
-			throw ReadException();
-		auto next = readValidULEB128(buffer, cursor);
-		if (next == 0)
-			throw ReadException();
-		ReadExportNode(viewStart, buffer, currentText + childText, next, endGuard);
-	}
-}
-
 
 void MachoView::ParseRebaseTable(BinaryReader& reader, MachOHeader& header, uint32_t tableOffset, uint32_t tableSize)
 {
@@ -2887,7 +2858,9 @@ void MachoView::ParseSymbolTable(BinaryReader& reader, MachOHeader& header, cons
 		//Then process the symtab
 		if (header.stringListSize == 0)
 			return;
-		reader.Seek(symtab.symoff);
+		MappedBinaryReader symbolReader(GetParentView(), reader.GetEndianness());
+		symbolReader.Map(m_universalImageOffset + symtab.symoff, (size_t)symtab.nsyms * (m_addressSize == 4 ? 12 : 16));
+		symbolReader.Seek(m_universalImageOffset + symtab.symoff);
 
 		unordered_map<size_t, vector<std::pair<section_64*, size_t>>> stubSymbols;
 		for (auto& symbolStubs : header.symbolStubSections)
@@ -2929,11 +2902,11 @@ void MachoView::ParseSymbolTable(BinaryReader& reader, MachOHeader& header, cons
 		memset(&sym, 0, sizeof(sym));
 		for (size_t i = 0; i < symtab.nsyms; i++)
 		{
-			sym.n_strx = reader.Read32();
-			sym.n_type = reader.Read8();
-			sym.n_sect = reader.Read8();
-			sym.n_desc = reader.Read16();
-			sym.n_value = (m_addressSize == 4) ? reader.Read32() : reader.Read64();
+			sym.n_strx = symbolReader.Read32();
+			sym.n_type = symbolReader.Read8();
+			sym.n_sect = symbolReader.Read8();
+			sym.n_desc = symbolReader.Read16();
+			sym.n_value = (m_addressSize == 4) ? symbolReader.Read32() : symbolReader.Read64();
 			if (sym.n_value)
 				sym.n_value += m_imageBaseAdjustment;
 			if (sym.n_strx >= symtab.strsize || ((sym.n_type & N_TYPE) == N_INDR))
@@ -3086,6 +3059,9 @@ void MachoView::ParseChainedFixups(MachOHeader& header, linkedit_data_command ch
 	BinaryReader parentReader(GetParentView());
 	BinaryReader mappedReader(this);
 
+	// Each chain entry is read before its own relocation is defined, so rebases can be submitted in chunks
+	RelocationBatch relocations(this, m_arch);
+
 	try {
 		dyld_chained_fixups_header fixupsHeader {};
 		uint64_t fixupHeaderAddress = m_universalImageOffset + chainedFixups.dataoff;
@@ -3435,7 +3411,7 @@ void MachoView::ParseChainedFixups(MachOHeader& header, linkedit_data_command ch
 							}
 
 							reloc.address = GetStart() + (chainEntryAddress - m_universalImageOffset);
-							DefineRelocation(m_arch, reloc, entryOffset, reloc.address);
+							relocations.Define(reloc, entryOffset, reloc.address);
 
 							if (m_objcProcessor)
 							{
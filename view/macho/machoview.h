@@ -1367,8 +1367,6 @@ namespace BinaryNinja
 		bool ParseRelocationEntry(const relocation_info& info, uint64_t start, BNRelocationInfo& result);
 
 		void ParseExportTrie(BinaryReader& reader, linkedit_data_command exportTrie);
-		void ReadExportNode(uint64_t viewStart, DataBuffer& buffer, const std::string& currentText,
-			size_t cursor, uint32_t endGuard);
 
 		void ParseRebaseTable(BinaryReader& reader, MachOHeader& header, uint32_t tableOffset, uint32_t tableSize);
 		void ParseDynamicTable(BinaryReader& reader, MachOHeader& header, BNSymbolType type, uint32_t tableOffset, uint32_t tableSize,
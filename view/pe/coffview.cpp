@@ -60,7 +60,8 @@ void BinaryNinja::InitCOFFViewType()
 	g_coffViewType = &type;
 }
 
-COFFView::COFFView(BinaryView* data, bool parseOnly): BinaryView("COFF", data->GetFile(), data), m_parseOnly(parseOnly)
+COFFView::COFFView(BinaryView* data, bool parseOnly): BinaryView("COFF", data->GetFile(), data), m_parseOnly(parseOnly),
+	m_parentReader(data, LittleEndian)
 {
 	CreateLogger("BinaryView");
 	m_logger = CreateLogger("BinaryView.COFFView");
@@ -71,7 +72,7 @@ bool COFFView::Init()
 	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
 	map<string, size_t> usedSectionNames;
 
-	BinaryReader reader(GetParentView(), LittleEndian);
+	MappedBinaryReader reader(GetParentView(), LittleEndian);
 	uint64_t entryPointAddress;
 	Ref<Platform> platform;
 
@@ -244,6 +245,7 @@ bool COFFView::Init()
 		m_relocatable = true;
 
 		// Read sections
+		reader.Map(sectionHeadersOffset, (size_t)sectionCount * 40);
 		reader.Seek(sectionHeadersOffset);
 		BinaryReader sectionNameReader(GetParentView(), LittleEndian);
 		BeginBulkAddSegments();
@@ -914,6 +916,7 @@ bool COFFView::Init()
 
 			DefineAutoSymbol(new Symbol(DataSymbol, "__strtab", m_imageBase + stringTableBase + 4, NoBinding));
 
+			reader.Map(header.coffSymbolTable, (size_t)header.coffSymbolCount * sizeofCOFFSymbol);
 			for (size_t i = 0; i < header.coffSymbolCount; i++)
 			{
 				reader.Seek(header.coffSymbolTable + (i * sizeofCOFFSymbol));
@@ -1223,12 +1226,15 @@ bool COFFView::Init()
 			auto relocHandler = m_arch->GetRelocationHandler("COFF");
 			BeginBulkAddSegments();
 
+			// The symbol table is still mapped on `reader` from above, relocation records get their own span
+			MappedBinaryReader relocReader(GetParentView(), LittleEndian);
 			for (uint32_t i = 0; i < sectionCount; i++)
 			{
 				auto section = m_sections[i];
 				if (section.relocCount)
 				{
 					uint32_t relocsFileOffset = section.pointerToRelocs;
+					relocReader.Map(relocsFileOffset, (size_t)section.relocCount * sizeof(COFFRelocation));
 					auto relocsVirtualOffset = relocsFileOffset - section.pointerToRawData + section.virtualAddress;
 					DEBUG_COFF(m_logger->LogDebug("COFF: section %d reading %d relocations from raw_data: 0x%" PRIx32 " relocs: 0x%" PRIx32 " adjusted offset: %#" PRIx32 " final address: %#" PRIx32,
 						i, section.relocCount, section.pointerToRawData, relocsFileOffset, relocsVirtualOffset, m_imageBase + relocsVirtualOffset));
@@ -1239,10 +1245,10 @@ bool COFFView::Init()
 						uint64_t relocationOffset = relocsVirtualOffset + j * sizeof(COFFRelocation);
 						uint64_t relocationFileOffset = relocsFileOffset + j * sizeof(COFFRelocation);
 
-						reader.Seek(relocationFileOffset);
-						auto virtualAddress = reader.Read32();
-						auto symbolTableIndex = reader.Read32();
-						auto relocType = reader.Read16();
+						relocReader.Seek(relocationFileOffset);
+						auto virtualAddress = relocReader.Read32();
+						auto symbolTableIndex = relocReader.Read32();
+						auto relocType = relocReader.Read16();
 
 						Ref<Type> type = Type::NamedType(this, coffRelocTypeName);
 						DefineDataVariable(m_imageBase + relocationOffset, type);
@@ -1381,15 +1387,8 @@ bool COFFView::Init()
 
 uint64_t COFFView::RVAToFileOffset(uint64_t offset, bool except)
 {
-	for (auto& i : m_sections)
-	{
-		if ((offset >= i.virtualAddress) &&
-				(offset < (i.virtualAddress + i.sizeOfRawData)) && (i.virtualSize != 0))
-		{
-			uint64_t progOfs = offset - i.virtualAddress;
-			return i.pointerToRawData + progOfs;
-		}
-	}
+	if (auto section = m_fileSectionIndex.Find(m_sections, offset))
+		return section->pointerToRawData + (offset - section->virtualAddress);
 
 	if (!except)
 		return offset;
@@ -1400,11 +1399,8 @@ uint64_t COFFView::RVAToFileOffset(uint64_t offset, bool except)
 
 uint32_t COFFView::GetRVACharacteristics(uint64_t offset)
 {
-	for (auto& i : m_sections)
-	{
-		if ((offset >= i.virtualAddress) && (offset < (i.virtualAddress + i.virtualSize)) && (i.virtualSize != 0))
-			return i.characteristics;
-	}
+	if (auto section = m_virtualSectionIndex.Find(m_sections, offset))
+		return section->characteristics;
 	return 0;
 }
 
@@ -1438,28 +1434,22 @@ string COFFView::ReadString(uint64_t rva)
 
 uint16_t COFFView::Read16(uint64_t rva)
 {
-	uint64_t ofs = RVAToFileOffset(rva);
-	BinaryReader reader(GetParentView(), LittleEndian);
-	reader.Seek(ofs);
-	return reader.Read16();
+	m_parentReader.Seek(RVAToFileOffset(rva));
+	return m_parentReader.Read16();
 }
 
 
 uint32_t COFFView::Read32(uint64_t rva)
 {
-	uint64_t ofs = RVAToFileOffset(rva);
-	BinaryReader reader(GetParentView(), LittleEndian);
-	reader.Seek(ofs);
-	return reader.Read32();
+	m_parentReader.Seek(RVAToFileOffset(rva));
+	return m_parentReader.Read32();
 }
 
 
 uint64_t COFFView::Read64(uint64_t rva)
 {
-	uint64_t ofs = RVAToFileOffset(rva);
-	BinaryReader reader(GetParentView(), LittleEndian);
-	reader.Seek(ofs);
-	return reader.Read64();
+	m_parentReader.Seek(RVAToFileOffset(rva));
+	return m_parentReader.Read64();
 }
 
 
@@ -1488,16 +1478,7 @@ void COFFView::AddCOFFSymbol(BNSymbolType type, const string& dll, const string&
 	if (!(type == ExternalSymbol || type == ImportedDataSymbol || type == ImportedFunctionSymbol))
 	{
 		// Ensure symbol is within the executable
-		bool ok = false;
-		for (auto& i : m_sections)
-		{
-			if ((addr >= i.virtualAddress) && (addr < (i.virtualAddress + i.virtualSize)))
-			{
-				ok = true;
-				break;
-			}
-		}
-		if (!ok)
+		if (!m_virtualSectionIndex.Find(m_sections, addr))
 		{
 			m_logger->LogDebug("COFF: %s symbol %s at %#" PRIx64 " is not in any section", __func__, name.c_str(), addr);
 			return;
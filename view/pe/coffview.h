@@ -326,6 +326,9 @@ namespace BinaryNinja
 		uint64_t m_imageBase;
 		uint32_t m_sizeOfHeaders;
 		std::vector<COFFSection> m_sections;
+		SectionIndex<COFFSection> m_fileSectionIndex {SectionFileExtent<COFFSection>};
+		SectionIndex<COFFSection> m_virtualSectionIndex {SectionVirtualExtent<COFFSection>};
+		BinaryReader m_parentReader;
 		std::vector<COFFRelocation> m_relocs;
 		Ref<Architecture> m_arch;
 		Ref<Logger> m_logger;
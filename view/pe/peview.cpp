@@ -8,6 +8,7 @@
 #include <mutex>
 #include <sstream>
 #include <type_traits>
+#include <unordered_set>
 #include <utility>
 #include "peview.h"
 #include "coffview.h"
@@ -392,7 +393,8 @@ static string GetDebugTypeName(int type)
 }
 
 
-PEView::PEView(BinaryView* data, bool parseOnly) : BinaryView("PE", data->GetFile(), data), m_parseOnly(parseOnly)
+PEView::PEView(BinaryView* data, bool parseOnly) : BinaryView("PE", data->GetFile(), data), m_parseOnly(parseOnly),
+	m_parentReader(data, LittleEndian)
 {
 	CreateLogger("BinaryView");
 	m_logger = CreateLogger("BinaryView.PEView");
@@ -400,21 +402,43 @@ PEView::PEView(BinaryView* data, bool parseOnly) : BinaryView("PE", data->GetFil
 }
 
 
+namespace
+{
+	// Logs how long one of the parsing steps in PEView::Init took
+	class ParseTimer
+	{
+		Logger* m_logger;
+		const char* m_name;
+		std::chrono::steady_clock::time_point m_start;
+
+	public:
+		ParseTimer(Logger* logger, const char* name) : m_logger(logger), m_name(name), m_start(std::chrono::steady_clock::now()) {}
+		~ParseTimer()
+		{
+			std::chrono::duration<double> t = std::chrono::steady_clock::now() - m_start;
+			m_logger->LogDebug("Parsing %s took %.3f seconds", m_name, t.count());
+		}
+	};
+}  // namespace
+
+
 bool PEView::Init()
 {
 	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
 	map<string, size_t> usedSectionNames;
 
-	BinaryReader reader(GetParentView(), LittleEndian);
+	MappedBinaryReader reader(GetParentView(), LittleEndian);
 	Ref<Platform> platform;
 
 	Ref<Settings> settings;
+	bool useStructuredTables = false;
 	PEHeader header;
 	PEOptionalHeader opt;
 	memset(&opt, 0, sizeof(opt));
 
 	try
 	{
+		ParseTimer timer(m_logger, "PE headers");
 		// Read PE offset
 		reader.Seek(0x3c);
 		uint32_t peOfs = reader.Read32();
@@ -612,6 +636,9 @@ bool PEView::Init()
 					m_arch = platform->GetArchitecture();
 				}
 			}
+
+			if (settings->Contains("loader.pe.useStructuredTables"))
+				useStructuredTables = settings->Get<bool>("loader.pe.useStructuredTables", this);
 		}
 
 		// Apply architecture and platform
@@ -743,6 +770,7 @@ bool PEView::Init()
 			dataLength = std::min(std::max((uint64_t)m_sizeOfHeaders, sizeOfImage), dataLength);
 			AddAutoSegment(m_imageBase, sizeOfImage, 0, dataLength, SegmentReadable);
 		}
+		reader.Map(optionalHeaderOffset + header.optionalHeaderSize, header.sectionCount * 40);
 		reader.Seek(optionalHeaderOffset + header.optionalHeaderSize);
 		// Read sections
 		BinaryReader sectionNameReader(GetParentView(), LittleEndian);
@@ -1307,6 +1335,7 @@ bool PEView::Init()
 
 	try
 	{
+		ParseTimer timer(m_logger, "COFF symbol table");
 		// Process COFF symbol table
 		if (header.coffSymbolCount)
 		{
@@ -1318,6 +1347,7 @@ bool PEView::Init()
 				throw PEFormatException("invalid COFF string table size");
 			}
 
+			reader.Map(header.coffSymbolTable, header.coffSymbolCount * 18);
 			for (size_t i = 0; i < header.coffSymbolCount; i++)
 			{
 				reader.Seek(header.coffSymbolTable + (i * 18));
@@ -1417,6 +1447,7 @@ bool PEView::Init()
 
 	try
 	{
+		ParseTimer timer(m_logger, "import directory");
 		PEDataDirectory dir;
 		// Read import directory
 		if (m_dataDirs.size() > IMAGE_DIRECTORY_ENTRY_IMPORT)
@@ -1429,6 +1460,7 @@ bool PEView::Init()
 			size_t numImportEntries = 0;
 			vector<Ref<Metadata>> libraries;
 			vector<Ref<Metadata>> libraryFound;
+			reader.Map(RVAToFileOffset(dir.virtualAddress, false), dir.size);
 			while (true)
 			{
 				// Read in next directory entry
@@ -1517,6 +1549,11 @@ bool PEView::Init()
 				if ((entryOffset == 0) && (iatOffset != 0))
 					entryOffset = iatOffset;
 
+				// A separate lookup table is an untyped copy of the IAT, one table for it is enough
+				bool lookupTable = useStructuredTables && (entryOffset != 0) && (entryOffset != iatOffset);
+				uint32_t lookupTableStart = entryOffset;
+				size_t lookupTableCount = 0;
+
 				// TODO: entryOffset and iatOffset point to two copies of the same data
 				// We should make this second unused data a structure containing this information information
 				// and default it to collapsed...IDA Just doesn't show anything at all
@@ -1530,15 +1567,18 @@ bool PEView::Init()
 						entry = Read64(entryOffset);
 						isOrdinal = (entry & 0x8000000000000000LL) != 0;
 						entry &= 0x7fffffffffffffffLL;
-						DefineDataVariable(m_imageBase + entryOffset, Type::IntegerType(8, false));
+						if (!lookupTable)
+							DefineDataVariable(m_imageBase + entryOffset, Type::IntegerType(8, false));
 					}
 					else
 					{
 						entry = Read32(entryOffset);
 						isOrdinal = (entry & 0x80000000) != 0;
 						entry &= 0x7fffffff;
-						DefineDataVariable(m_imageBase + entryOffset, Type::IntegerType(4, false));
+						if (!lookupTable)
+							DefineDataVariable(m_imageBase + entryOffset, Type::IntegerType(4, false));
 					}
+					lookupTableCount++;
 					m_logger->LogDebug("Entry 0x%llx isOrdinal: %s\n", entry, isOrdinal ? "True" : "False");
 
 					if ((!isOrdinal) && (entry == 0))
@@ -1568,7 +1608,8 @@ bool PEView::Init()
 						DefineAutoSymbol(new Symbol(DataSymbol, "__export_name_ptr_table_" + to_string(numImportEntries) + "(" + dllName + ":" + func + ")", m_imageBase + entry, NoBinding));
 						DefineDataVariable(m_imageBase + entry + 2, Type::ArrayType(Type::IntegerType(1, true), func.size() + 1));
 						DefineAutoSymbol(new Symbol(DataSymbol, "__import_name_" + to_string(numImportEntries) + "(" + dllName + ":" + func + ")", m_imageBase + entry + 2, NoBinding));
-						DefineAutoSymbol(new Symbol(DataSymbol, "__import_lookup_table_" + to_string(numImportEntries) + "(" + dllName + ":" + func + ")", m_imageBase + entryOffset, NoBinding));
+						if (!lookupTable)
+							DefineAutoSymbol(new Symbol(DataSymbol, "__import_lookup_table_" + to_string(numImportEntries) + "(" + dllName + ":" + func + ")", m_imageBase + entryOffset, NoBinding));
 					}
 					m_logger->LogDebug("FuncString: %s\n", func.c_str());
 					AddPESymbol(ImportAddressSymbol, dllName, func, iatOffset, NoBinding, ordinal, typeLibs);
@@ -1590,6 +1631,12 @@ bool PEView::Init()
 					iatOffset += m_is64 ? 8 : 4;
 				}
 
+				if (lookupTable)
+				{
+					DefineStructuredTable(m_imageBase + lookupTableStart, Type::IntegerType(m_is64 ? 8 : 4, false), lookupTableCount);
+					DefineAutoSymbol(new Symbol(DataSymbol, "__import_lookup_table_" + to_string(numImportEntries) + "(" + dllName + ")", m_imageBase + lookupTableStart, NoBinding));
+				}
+
 				numImportEntries++;
 			}
 
@@ -1620,8 +1667,11 @@ bool PEView::Init()
 		m_logger->LogWarn("Failed to parse import directory: %s\n", e.what());
 	}
 
+	// Function starts found before a bad entry are still added after the try below
+	map<Ref<Platform>, vector<uint64_t>> functionStarts;
 	try
 	{
+		ParseTimer timer(m_logger, "exception directory");
 		if ((m_dataDirs.size() > IMAGE_DIRECTORY_ENTRY_EXCEPTION) && m_dataDirs[IMAGE_DIRECTORY_ENTRY_EXCEPTION].size)
 		{
 			// Create Exception Directory Table Entry Type
@@ -1664,17 +1714,27 @@ bool PEView::Init()
 				throw PEFormatException("invalid table size");
 			numExceptionEntries = m_dataDirs[IMAGE_DIRECTORY_ENTRY_EXCEPTION].size / entrySize;
 
-			// This DataVariable can end up creating a large array and rendering this in LinearView currently has performance implications
-			// So instead we just create separate structures not in an array
+			// Large x64 binaries have hundreds of thousands of entries, which is too many for an array DataVariable
+			// or a DataVariable per entry. With a core that supports structured tables they are one table that is
+			// only rendered as it is viewed, otherwise each entry is its own DataVariable.
 			Ref<Structure> exceptionEntryStruct = exceptionEntryBuilder.Finalize();
 			Ref<Type> exceptionEntryType = Type::StructureType(exceptionEntryStruct);
 			QualifiedName exceptionEntryName = string("Exception_Directory_Entry");
 			string exceptionEntryTypeId = Type::GenerateAutoTypeId("pe", exceptionEntryName);
 			QualifiedName exceptionEntryTypeName = DefineType(exceptionEntryTypeId, exceptionEntryName, exceptionEntryType);
-			for (size_t i = 0; i < numExceptionEntries; i++)
+			uint64_t exceptionTableAddr = m_imageBase + m_dataDirs[IMAGE_DIRECTORY_ENTRY_EXCEPTION].virtualAddress;
+			if (useStructuredTables)
 			{
-				DefineDataVariable(m_imageBase + m_dataDirs[IMAGE_DIRECTORY_ENTRY_EXCEPTION].virtualAddress + (entrySize * i), Type::NamedType(this, exceptionEntryTypeName));
-				DefineAutoSymbol(new Symbol(DataSymbol, "__exception_directory_entries(" + string(std::to_string(i)) + ")", m_imageBase + m_dataDirs[IMAGE_DIRECTORY_ENTRY_EXCEPTION].virtualAddress + (entrySize * i), NoBinding));
+				DefineStructuredTable(exceptionTableAddr, Type::NamedType(this, exceptionEntryTypeName), numExceptionEntries);
+				DefineAutoSymbol(new Symbol(DataSymbol, "__exception_directory_entries", exceptionTableAddr, NoBinding));
+			}
+			else
+			{
+				for (size_t i = 0; i < numExceptionEntries; i++)
+				{
+					DefineDataVariable(exceptionTableAddr + (entrySize * i), Type::NamedType(this, exceptionEntryTypeName));
+					DefineAutoSymbol(new Symbol(DataSymbol, "__exception_directory_entries(" + string(std::to_string(i)) + ")", exceptionTableAddr + (entrySize * i), NoBinding));
+				}
 			}
 
 			// parse exception table and add functions
@@ -1696,6 +1756,10 @@ bool PEView::Init()
 				QualifiedName unwindInfo = DefineType(unwindInfoTypeId, unwindInfoName, unwindInfoStructType);
 
 				BinaryReader unwindReader(GetParentView(), LittleEndian);
+				// Functions with the same unwind codes (and chained entries) share an UNWIND_INFO
+				unordered_set<uint32_t> definedUnwindInfo;
+				reader.Map(RVAToFileOffset(m_dataDirs[IMAGE_DIRECTORY_ENTRY_EXCEPTION].virtualAddress, false),
+					numExceptionEntries * entrySize);
 				for (size_t i = 0; i < numExceptionEntries; i++)
 				{
 					reader.Seek(RVAToFileOffset(m_dataDirs[IMAGE_DIRECTORY_ENTRY_EXCEPTION].virtualAddress + (i * entrySize)));
@@ -1707,11 +1771,13 @@ bool PEView::Init()
 						{
 							reader.SeekRelative(4);  // EndAddress
 							uint32_t unwindRva = reader.Read32();
-							DefineDataVariable(m_imageBase + unwindRva, Type::NamedType(this, unwindInfo));
+							bool newUnwindInfo = definedUnwindInfo.insert(unwindRva).second;
+							if (newUnwindInfo)
+								DefineDataVariable(m_imageBase + unwindRva, Type::NamedType(this, unwindInfo));
 							unwindReader.Seek(RVAToFileOffset(unwindRva));
 							uint32_t unwindInformation = unwindReader.Read32();
 							uint8_t unwindCodeCount = (unwindInformation >> 16) & 0xff;
-							if (unwindCodeCount > 0)
+							if (newUnwindInfo && unwindCodeCount > 0)
 								DefineDataVariable(m_imageBase + unwindRva + 4, Type::ArrayType(Type::IntegerType(2, false), unwindCodeCount));
 
 							auto current = m_imageBase + unwindRva + 4 + (unwindCodeCount * 2);
@@ -1720,12 +1786,14 @@ bool PEView::Init()
 
 							if (unwindInformation & (UNW_FLAG_CHAININFO << 3))
 							{
-								DefineDataVariable(current, Type::NamedType(this, exceptionEntryTypeName));
+								if (newUnwindInfo)
+									DefineDataVariable(current, Type::NamedType(this, exceptionEntryTypeName));
 								continue;
 							}
 							else if ((unwindInformation & (UNW_FLAG_UHANDLER << 3)) || (unwindInformation & (UNW_FLAG_EHANDLER << 3)))
 							{
-								DefineDataVariable(current, Type::IntegerType(4, false));
+								if (newUnwindInfo)
+									DefineDataVariable(current, Type::IntegerType(4, false));
 								// unwindReader.Seek(RVAToFileOffset(unwindRva + 8 + (unwindCodeCount * 2)));
 								// uint32_t count = unwindReader.Read32();
 								// DefineDataVariable(current + 4, Type::ArrayType(Type::IntegerType(4, false), 3));
@@ -1737,7 +1805,7 @@ bool PEView::Init()
 					}
 					uint64_t exceptionEntry = m_imageBase + beginAddress;
 					Ref<Platform> targetPlatform = platform->GetAssociatedPlatformByAddress(exceptionEntry);
-					AddFunctionForAnalysis(targetPlatform, exceptionEntry);
+					functionStarts[targetPlatform].push_back(exceptionEntry);
 				}
 			}
 		}
@@ -1747,8 +1815,12 @@ bool PEView::Init()
 		m_logger->LogWarn("Failed to parse exception directory: %s\n", e.what());
 	}
 
+	for (auto& [targetPlatform, starts] : functionStarts)
+		AddFunctionsForAnalysis(targetPlatform, starts);
+
 	try
 	{
+		ParseTimer timer(m_logger, "debug directory");
 		if (m_dataDirs.size() > IMAGE_DIRECTORY_ENTRY_DEBUG)
 		{
 			PEDataDirectory dir = m_dataDirs[IMAGE_DIRECTORY_ENTRY_DEBUG];
@@ -1874,6 +1946,7 @@ bool PEView::Init()
 
 	try
 	{
+		ParseTimer timer(m_logger, "TLS directory");
 		if (m_dataDirs.size() > IMAGE_DIRECTORY_ENTRY_TLS)
 		{
 			PEDataDirectory dir = m_dataDirs[IMAGE_DIRECTORY_ENTRY_TLS];
@@ -1988,6 +2061,7 @@ bool PEView::Init()
 
 	try
 	{
+		ParseTimer timer(m_logger, "delay import directory");
 		PEDataDirectory dir;
 		if (m_dataDirs.size() > IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT)
 			dir = m_dataDirs[IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT];
@@ -2177,6 +2251,7 @@ bool PEView::Init()
 
 	try
 	{
+		ParseTimer timer(m_logger, "load configuration directory");
 		if ((m_dataDirs.size() > IMAGE_DIRECTORY_ENTRY_LOAD_CONFIG) && (m_dataDirs[IMAGE_DIRECTORY_ENTRY_LOAD_CONFIG].size >= 40))
 		{
 			reader.Seek(RVAToFileOffset(m_dataDirs[IMAGE_DIRECTORY_ENTRY_LOAD_CONFIG].virtualAddress));
@@ -2430,6 +2505,7 @@ bool PEView::Init()
 
 	try
 	{
+		ParseTimer timer(m_logger, "export directory");
 		if ((m_dataDirs.size() > IMAGE_DIRECTORY_ENTRY_EXPORT) && (m_dataDirs[IMAGE_DIRECTORY_ENTRY_EXPORT].size >= 40))
 		{
 			PEExportDirectory dir;
@@ -2481,6 +2557,7 @@ bool PEView::Init()
 			DefineAutoSymbol(new Symbol(DataSymbol, tableName, m_imageBase + dir.addressOfFunctions, NoBinding));
 
 			vector<uint32_t> funcs;
+			reader.Map(RVAToFileOffset(dir.addressOfFunctions, false), (size_t)dir.functionCount * 4);
 			reader.Seek(RVAToFileOffset(dir.addressOfFunctions));
 			funcs.reserve(dir.functionCount);
 			for (uint32_t i = 0; i < dir.functionCount; i++)
@@ -2494,6 +2571,7 @@ bool PEView::Init()
 				DefineAutoSymbol(new Symbol(DataSymbol, tableName, m_imageBase + dir.addressOfNames, NoBinding));
 
 				nameAddrs.reserve(dir.nameCount);
+				reader.Map(RVAToFileOffset(dir.addressOfNames, false), (size_t)dir.nameCount * 4);
 				reader.Seek(RVAToFileOffset(dir.addressOfNames));
 				for (uint32_t i = 0; i < dir.nameCount; i++)
 					nameAddrs.push_back(reader.Read32());
@@ -2507,6 +2585,7 @@ bool PEView::Init()
 				DefineAutoSymbol(new Symbol(DataSymbol, tableName, m_imageBase + dir.addressOfNameOrdinals, NoBinding));
 
 				nameOrdinals.reserve(dir.nameCount);
+				reader.Map(RVAToFileOffset(dir.addressOfNameOrdinals, false), (size_t)dir.nameCount * 2);
 				reader.Seek(RVAToFileOffset(dir.addressOfNameOrdinals));
 				for (uint32_t i = 0; i < dir.nameCount; i++)
 					nameOrdinals.push_back(reader.Read16());
@@ -2582,6 +2661,7 @@ bool PEView::Init()
 
 	try
 	{
+		ParseTimer timer(m_logger, "relocation directory");
 		if (m_dataDirs.size() > IMAGE_DIRECTORY_ENTRY_BASERELOC)
 		{
 			PEDataDirectory dir = m_dataDirs[IMAGE_DIRECTORY_ENTRY_BASERELOC];
@@ -2650,6 +2730,7 @@ bool PEView::Init()
 
 	try
 	{
+		ParseTimer timer(m_logger, "resource directory");
 		//TODO: properly name tables, entries, data entries
 
 		PEDataDirectory dir;
@@ -2831,15 +2912,8 @@ bool PEView::Init()
 
 uint64_t PEView::RVAToFileOffset(uint64_t offset, bool except)
 {
-	for (auto& i : m_sections)
-	{
-		if ((offset >= i.virtualAddress) &&
-			(offset < (i.virtualAddress + i.sizeOfRawData)) && (i.virtualSize != 0))
-		{
-			uint64_t progOfs = offset - i.virtualAddress;
-			return i.pointerToRawData + progOfs;
-		}
-	}
+	if (auto section = m_fileSectionIndex.Find(m_sections, offset))
+		return section->pointerToRawData + (offset - section->virtualAddress);
 
 	if (!except)
 		return offset;
@@ -2850,11 +2924,8 @@ uint64_t PEView::RVAToFileOffset(uint64_t offset, bool except)
 
 uint32_t PEView::GetRVACharacteristics(uint64_t offset)
 {
-	for (auto& i : m_sections)
-	{
-		if ((offset >= i.virtualAddress) && (offset < (i.virtualAddress + i.virtualSize)) && (i.virtualSize != 0))
-			return i.characteristics;
-	}
+	if (auto section = m_virtualSectionIndex.Find(m_sections, offset))
+		return section->characteristics;
 	return 0;
 }
 
@@ -2888,28 +2959,22 @@ string PEView::ReadString(uint64_t rva)
 
 uint16_t PEView::Read16(uint64_t rva)
 {
-	uint64_t ofs = RVAToFileOffset(rva);
-	BinaryReader reader(GetParentView(), LittleEndian);
-	reader.Seek(ofs);
-	return reader.Read16();
+	m_parentReader.Seek(RVAToFileOffset(rva));
+	return m_parentReader.Read16();
 }
 
 
 uint32_t PEView::Read32(uint64_t rva)
 {
-	uint64_t ofs = RVAToFileOffset(rva);
-	BinaryReader reader(GetParentView(), LittleEndian);
-	reader.Seek(ofs);
-	return reader.Read32();
+	m_parentReader.Seek(RVAToFileOffset(rva));
+	return m_parentReader.Read32();
 }
 
 
 uint64_t PEView::Read64(uint64_t rva)
 {
-	uint64_t ofs = RVAToFileOffset(rva);
-	BinaryReader reader(GetParentView(), LittleEndian);
-	reader.Seek(ofs);
-	return reader.Read64();
+	m_parentReader.Seek(RVAToFileOffset(rva));
+	return m_parentReader.Read64();
 }
 
 
@@ -2928,16 +2993,7 @@ void PEView::AddPESymbol(BNSymbolType type, const string& dll, const string& nam
 	// Ensure symbol is within the executable
 	if (type != ExternalSymbol)
 	{
-		bool ok = false;
-		for (auto& i : m_sections)
-		{
-			if ((addr >= i.virtualAddress) && (addr < (i.virtualAddress + i.virtualSize)))
-			{
-				ok = true;
-				break;
-			}
-		}
-		if (!ok)
+		if (!m_virtualSectionIndex.Find(m_sections, addr))
 			return;
 	}
 
@@ -3124,6 +3180,14 @@ Ref<Settings> PEViewType::GetLoadSettingsForData(BinaryView* data)
 			"description" : "Add function starts sourced from the Exception Handling table (.pdata) to the core for analysis."
 			})");
 
+	settings->RegisterSetting("loader.pe.useStructuredTables",
+			R"({
+			"title" : "Define PE Tables as Structured Tables",
+			"type" : "boolean",
+			"default" : false,
+			"description" : "Define the exception directory and import lookup tables as structured tables instead of a data variable and symbol per entry. Requires a core with structured table support."
+			})");
+
 	settings->RegisterSetting("loader.pe.processSehTable",
 			R"({
 			"title" : "Process PE Structured Exception Handling Table",
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "binaryninjaapi.h"
+#include <algorithm>
 #include <exception>
+#include <map>
 
 #ifdef WIN32
 #pragma warning(disable: 4005)
@@ -444,6 +446,96 @@ namespace BinaryNinja
 		uint32_t reserved;
 	};
 
+	// RVA range of a section that is backed by file data
+	template <typename Section>
+	std::pair<uint64_t, uint64_t> SectionFileExtent(const Section& section)
+	{
+		if (section.virtualSize == 0)
+			return {0, 0};
+		return {section.virtualAddress, (uint64_t)section.virtualAddress + section.sizeOfRawData};
+	}
+
+	// RVA range of a section once loaded
+	template <typename Section>
+	std::pair<uint64_t, uint64_t> SectionVirtualExtent(const Section& section)
+	{
+		return {section.virtualAddress, (uint64_t)section.virtualAddress + section.virtualSize};
+	}
+
+	// Finds the section containing an RVA with a binary search, plus a check of the last hit first since
+	// table parsers tend to look up runs of nearby RVAs. Returns the same section a scan of the section
+	// table would, i.e. the first one in header order when sections overlap. The index is rebuilt whenever
+	// the number of sections changes, sections are only ever appended.
+	template <typename Section>
+	class SectionIndex
+	{
+		struct Range
+		{
+			uint64_t start;
+			uint64_t end;
+			size_t section;
+		};
+
+		std::pair<uint64_t, uint64_t> (*m_extent)(const Section&);
+		std::vector<Range> m_ranges;
+		size_t m_sectionCount = 0;
+		size_t m_lastHit = 0;
+
+		void Build(const std::vector<Section>& sections)
+		{
+			// Earlier sections take precedence, so each section only claims the parts of its extent that
+			// no earlier section covers
+			std::map<uint64_t, Range> claimed;
+			for (size_t i = 0; i < sections.size(); i++)
+			{
+				auto [start, end] = m_extent(sections[i]);
+				uint64_t cur = start;
+				auto next = claimed.upper_bound(cur);
+				if (next != claimed.begin() && std::prev(next)->second.end > cur)
+					cur = std::prev(next)->second.end;
+				while (cur < end)
+				{
+					next = claimed.lower_bound(cur);
+					uint64_t gapEnd = (next == claimed.end()) ? end : std::min(end, next->first);
+					if (gapEnd > cur)
+						claimed.emplace(cur, Range {cur, gapEnd, i});
+					if (next == claimed.end())
+						break;
+					cur = next->second.end;
+				}
+			}
+
+			m_ranges.clear();
+			m_ranges.reserve(claimed.size());
+			for (auto& [start, range] : claimed)
+				m_ranges.push_back(range);
+			m_sectionCount = sections.size();
+			m_lastHit = 0;
+		}
+
+	public:
+		explicit SectionIndex(std::pair<uint64_t, uint64_t> (*extent)(const Section&)) : m_extent(extent) {}
+
+		const Section* Find(const std::vector<Section>& sections, uint64_t rva)
+		{
+			if (sections.size() != m_sectionCount)
+				Build(sections);
+
+			if (m_lastHit < m_ranges.size() && rva >= m_ranges[m_lastHit].start && rva < m_ranges[m_lastHit].end)
+				return &sections[m_ranges[m_lastHit].section];
+
+			auto it = std::upper_bound(m_ranges.begin(), m_ranges.end(), rva,
+				[](uint64_t value, const Range& range) { return value < range.start; });
+			if (it == m_ranges.begin())
+				return nullptr;
+			--it;
+			if (rva >= it->end)
+				return nullptr;
+			m_lastHit = it - m_ranges.begin();
+			return &sections[it->section];
+		}
+	};
+
 	class PEView: public BinaryView
 	{
 		bool m_parseOnly, m_backedByDatabase;
@@ -454,6 +546,9 @@ namespace BinaryNinja
 		uint32_t m_sizeOfHeaders;
 		std::vector<PEDataDirectory> m_dataDirs;
 		std::vector<PESection> m_sections;
+		SectionIndex<PESection> m_fileSectionIndex {SectionFileExtent<PESection>};
+		SectionIndex<PESection> m_virtualSectionIndex {SectionVirtualExtent<PESection>};
+		BinaryReader m_parentReader;
 		Ref<Architecture> m_arch;
 		bool m_is64;
 		bool m_extractMangledTypes;
@@ -105,6 +105,9 @@ extern "C"
 	typedef struct BNDSCMemoryUsageInfo {
 		uint64_t sharedCacheRefs;
 		uint64_t mmapRefs;
+		uint64_t mmapHits;
+		uint64_t mmapMisses;
+		uint64_t mmapEvictions;
 	} BNDSCMemoryUsageInfo;
 
 	typedef struct BNDSCSymbolRep {
@@ -0,0 +1,105 @@
+#ifndef SHAREDCACHE_ADDRESSRANGEMAP_H
+#define SHAREDCACHE_ADDRESSRANGEMAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace SharedCacheCore {
+
+	/**
+	 * An immutable, sorted interval index mapping address ranges to values.
+	 *
+	 * Ranges passed to the constructor may overlap. Where they do, the range that appears earliest in the input
+	 * wins, which matches the behavior of a first-match linear scan over the same list. Internally the input is
+	 * flattened into disjoint, sorted ranges so that lookups are a single binary search.
+	 *
+	 * \tparam T Value type stored for each range. Should be cheap to copy.
+	 */
+	template <typename T>
+	class AddressRangeMap
+	{
+	public:
+		struct Entry
+		{
+			// [start, end)
+			uint64_t start;
+			uint64_t end;
+			T value;
+		};
+
+	private:
+		std::vector<Entry> m_entries;
+
+	public:
+		AddressRangeMap() = default;
+
+		explicit AddressRangeMap(const std::vector<Entry>& ranges)
+		{
+			// Sweep over every range boundary in address order, keeping track of which input ranges are active.
+			// The active range with the lowest input index owns the address space up to the next boundary.
+			std::vector<std::pair<uint64_t, size_t>> boundaries;
+			boundaries.reserve(ranges.size() * 2);
+			for (size_t i = 0; i < ranges.size(); i++)
+			{
+				if (ranges[i].start >= ranges[i].end)
+					continue;
+				boundaries.emplace_back(ranges[i].start, i);
+				boundaries.emplace_back(ranges[i].end, i);
+			}
+			std::sort(boundaries.begin(), boundaries.end());
+
+			std::set<size_t> active;
+			size_t lastOwner = SIZE_MAX;
+			for (size_t b = 0; b < boundaries.size();)
+			{
+				uint64_t address = boundaries[b].first;
+				for (; b < boundaries.size() && boundaries[b].first == address; b++)
+				{
+					size_t index = boundaries[b].second;
+					if (ranges[index].start == address)
+						active.insert(index);
+					else
+						active.erase(index);
+				}
+
+				size_t owner = active.empty() ? SIZE_MAX : *active.begin();
+				if (owner == lastOwner)
+					continue;
+
+				// Ownership changed at this boundary, close the current segment and start the next one.
+				if (lastOwner != SIZE_MAX)
+					m_entries.back().end = address;
+				if (owner != SIZE_MAX)
+					m_entries.push_back({address, address, ranges[owner].value});
+				lastOwner = owner;
+			}
+			m_entries.shrink_to_fit();
+		}
+
+		// Returns a pointer to the value owning `address`, or nullptr if no range contains it.
+		// The pointer is valid for the lifetime of this map.
+		const T* Find(uint64_t address) const
+		{
+			auto it = std::upper_bound(m_entries.begin(), m_entries.end(), address,
+				[](uint64_t addr, const Entry& entry) { return addr < entry.start; });
+			if (it == m_entries.begin())
+				return nullptr;
+			--it;
+			if (address >= it->end)
+				return nullptr;
+			return &it->value;
+		}
+
+		bool Contains(uint64_t address) const { return Find(address) != nullptr; }
+
+		size_t Size() const { return m_entries.size(); }
+
+		bool Empty() const { return m_entries.empty(); }
+	};
+
+}  // namespace SharedCacheCore
+
+#endif  // SHAREDCACHE_ADDRESSRANGEMAP_H
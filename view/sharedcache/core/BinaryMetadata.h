@@ -0,0 +1,335 @@
+#ifndef SHAREDCACHE_BINARYMETADATA_H
+#define SHAREDCACHE_BINARYMETADATA_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "rapidjson/rapidjson.h"
+
+namespace SharedCacheCore {
+
+	/**
+	 * Compact binary encoding of the SAX event stream that `MetadataSerializable` produces.
+	 *
+	 * The encoding is a direct translation of the JSON value tree: one tag byte per value, LEB128 varints for
+	 * integers (zigzag for signed values), and length prefixed strings. Object keys are kept, so loading is
+	 * still by name and `Store`/`Load` implementations are free to disagree on field order, exactly as with JSON.
+	 *
+	 * Strings are followed by a NUL so a decoded `rapidjson::Document` can point into the input buffer instead of
+	 * copying every string.
+	 *
+	 * Layout: "BNSC" magic, little endian uint32 format version, then exactly one root value.
+	 */
+	namespace BinaryMetadata {
+		constexpr uint8_t Magic[4] = {'B', 'N', 'S', 'C'};
+		constexpr uint32_t Version = 1;
+		constexpr size_t HeaderSize = sizeof(Magic) + sizeof(Version);
+
+		enum Tag : uint8_t
+		{
+			TagNull = 0,
+			TagFalse,
+			TagTrue,
+			TagUnsigned,
+			TagSigned,
+			TagDouble,
+			TagString,
+			TagStartObject,
+			TagEndObject,
+			TagStartArray,
+			TagEndArray,
+		};
+
+		inline bool IsBinaryMetadata(const uint8_t* data, size_t length)
+		{
+			if (length < HeaderSize || memcmp(data, Magic, sizeof(Magic)) != 0)
+				return false;
+			uint32_t version = 0;
+			for (size_t i = 0; i < sizeof(Version); i++)
+				version |= (uint32_t)data[sizeof(Magic) + i] << (i * 8);
+			return version == Version;
+		}
+	}  // namespace BinaryMetadata
+
+
+	/**
+	 * rapidjson SAX handler that writes the binary encoding.
+	 *
+	 * Implements the same interface as `rapidjson::Writer` so it can be driven by `Store` implementations or by
+	 * `rapidjson::Document::Accept`.
+	 */
+	class BinaryMetadataWriter
+	{
+		std::vector<uint8_t> m_output;
+
+		void WriteVarint(uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				m_output.push_back((uint8_t)(value | 0x80));
+				value >>= 7;
+			}
+			m_output.push_back((uint8_t)value);
+		}
+
+		bool WriteUnsigned(uint64_t value)
+		{
+			m_output.push_back(BinaryMetadata::TagUnsigned);
+			WriteVarint(value);
+			return true;
+		}
+
+		bool WriteSigned(int64_t value)
+		{
+			// Non-negative values are written as unsigned so they decode identically to the JSON path, where
+			// rapidjson also classifies any non-negative number as unsigned.
+			if (value >= 0)
+				return WriteUnsigned((uint64_t)value);
+			m_output.push_back(BinaryMetadata::TagSigned);
+			WriteVarint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+			return true;
+		}
+
+		bool WriteString(const char* str, rapidjson::SizeType length)
+		{
+			m_output.push_back(BinaryMetadata::TagString);
+			WriteVarint(length);
+			m_output.insert(m_output.end(), (const uint8_t*)str, (const uint8_t*)str + length);
+			m_output.push_back(0);
+			return true;
+		}
+
+	public:
+		BinaryMetadataWriter()
+		{
+			m_output.insert(m_output.end(), std::begin(BinaryMetadata::Magic), std::end(BinaryMetadata::Magic));
+			for (size_t i = 0; i < sizeof(BinaryMetadata::Version); i++)
+				m_output.push_back((uint8_t)(BinaryMetadata::Version >> (i * 8)));
+		}
+
+		bool Null()
+		{
+			m_output.push_back(BinaryMetadata::TagNull);
+			return true;
+		}
+
+		bool Bool(bool b)
+		{
+			m_output.push_back(b ? BinaryMetadata::TagTrue : BinaryMetadata::TagFalse);
+			return true;
+		}
+
+		bool Int(int i) { return WriteSigned(i); }
+		bool Uint(unsigned u) { return WriteUnsigned(u); }
+		bool Int64(int64_t i) { return WriteSigned(i); }
+		bool Uint64(uint64_t u) { return WriteUnsigned(u); }
+
+		bool Double(double d)
+		{
+			uint64_t bits;
+			memcpy(&bits, &d, sizeof(bits));
+			m_output.push_back(BinaryMetadata::TagDouble);
+			for (size_t i = 0; i < sizeof(bits); i++)
+				m_output.push_back((uint8_t)(bits >> (i * 8)));
+			return true;
+		}
+
+		// Only produced by the reader with kParseNumbersAsStringsFlag, which is never used for metadata.
+		bool RawNumber(const char*, rapidjson::SizeType, bool) { return false; }
+
+		bool String(const char* str, rapidjson::SizeType length, bool = false) { return WriteString(str, length); }
+		bool Key(const char* str, rapidjson::SizeType length, bool = false) { return WriteString(str, length); }
+
+		bool StartObject()
+		{
+			m_output.push_back(BinaryMetadata::TagStartObject);
+			return true;
+		}
+
+		bool EndObject(rapidjson::SizeType = 0)
+		{
+			m_output.push_back(BinaryMetadata::TagEndObject);
+			return true;
+		}
+
+		bool StartArray()
+		{
+			m_output.push_back(BinaryMetadata::TagStartArray);
+			return true;
+		}
+
+		bool EndArray(rapidjson::SizeType = 0)
+		{
+			m_output.push_back(BinaryMetadata::TagEndArray);
+			return true;
+		}
+
+		const std::vector<uint8_t>& GetOutput() const { return m_output; }
+		std::vector<uint8_t> TakeOutput() { return std::move(m_output); }
+	};
+
+
+	/**
+	 * Generator for `rapidjson::Document::Populate` that replays binary encoded metadata as SAX events.
+	 *
+	 * The input is validated as it is decoded: containers must nest and close properly, object members must be
+	 * key/value pairs with string keys, and there must be exactly one root value. On malformed input the generator
+	 * returns false and the document is left empty.
+	 *
+	 * With `inSitu` set, strings are handed to the handler without copying, so the input buffer must outlive the
+	 * document.
+	 */
+	class BinaryMetadataReader
+	{
+		struct Container
+		{
+			bool isObject;
+			rapidjson::SizeType count;
+		};
+
+		const uint8_t* m_cur;
+		const uint8_t* m_end;
+		bool m_inSitu;
+
+		bool ReadVarint(uint64_t& value)
+		{
+			value = 0;
+			for (int shift = 0; shift < 64; shift += 7)
+			{
+				if (m_cur >= m_end)
+					return false;
+				uint8_t byte = *m_cur++;
+				value |= (uint64_t)(byte & 0x7f) << shift;
+				if (!(byte & 0x80))
+					return true;
+			}
+			return false;
+		}
+
+	public:
+		BinaryMetadataReader(const uint8_t* data, size_t length, bool inSitu = false) :
+			m_cur(data), m_end(data + length), m_inSitu(inSitu)
+		{}
+
+		template <typename Handler>
+		bool operator()(Handler& handler)
+		{
+			if (!BinaryMetadata::IsBinaryMetadata(m_cur, m_end - m_cur))
+				return false;
+			m_cur += BinaryMetadata::HeaderSize;
+
+			std::vector<Container> stack;
+			bool haveRoot = false;
+			while (m_cur < m_end)
+			{
+				uint8_t tag = *m_cur++;
+				bool isEnd = tag == BinaryMetadata::TagEndObject || tag == BinaryMetadata::TagEndArray;
+				if (stack.empty())
+				{
+					if (haveRoot || isEnd)
+						return false;
+					haveRoot = true;
+				}
+				else if (!isEnd)
+				{
+					Container& parent = stack.back();
+					// Every even member of an object is its key.
+					if (parent.isObject && (parent.count % 2) == 0 && tag != BinaryMetadata::TagString)
+						return false;
+					parent.count++;
+				}
+
+				bool ok;
+				switch (tag)
+				{
+				case BinaryMetadata::TagNull:
+					ok = handler.Null();
+					break;
+				case BinaryMetadata::TagFalse:
+					ok = handler.Bool(false);
+					break;
+				case BinaryMetadata::TagTrue:
+					ok = handler.Bool(true);
+					break;
+				case BinaryMetadata::TagUnsigned:
+				{
+					uint64_t value;
+					if (!ReadVarint(value))
+						return false;
+					ok = handler.Uint64(value);
+					break;
+				}
+				case BinaryMetadata::TagSigned:
+				{
+					uint64_t value;
+					if (!ReadVarint(value))
+						return false;
+					ok = handler.Int64((int64_t)(value >> 1) ^ -(int64_t)(value & 1));
+					break;
+				}
+				case BinaryMetadata::TagDouble:
+				{
+					if (m_end - m_cur < 8)
+						return false;
+					uint64_t bits = 0;
+					for (size_t i = 0; i < sizeof(bits); i++)
+						bits |= (uint64_t)*m_cur++ << (i * 8);
+					double d;
+					memcpy(&d, &bits, sizeof(d));
+					ok = handler.Double(d);
+					break;
+				}
+				case BinaryMetadata::TagString:
+				{
+					uint64_t length;
+					if (!ReadVarint(length) || length >= (uint64_t)(m_end - m_cur) || m_cur[length] != 0)
+						return false;
+					const char* str = (const char*)m_cur;
+					m_cur += length + 1;
+					bool isKey = !stack.empty() && stack.back().isObject && (stack.back().count % 2) == 1;
+					if (isKey)
+						ok = handler.Key(str, (rapidjson::SizeType)length, !m_inSitu);
+					else
+						ok = handler.String(str, (rapidjson::SizeType)length, !m_inSitu);
+					break;
+				}
+				case BinaryMetadata::TagStartObject:
+					stack.push_back({true, 0});
+					ok = handler.StartObject();
+					break;
+				case BinaryMetadata::TagStartArray:
+					stack.push_back({false, 0});
+					ok = handler.StartArray();
+					break;
+				case BinaryMetadata::TagEndObject:
+				{
+					if (stack.empty() || !stack.back().isObject || (stack.back().count % 2) != 0)
+						return false;
+					rapidjson::SizeType count = stack.back().count;
+					stack.pop_back();
+					ok = handler.EndObject(count / 2);
+					break;
+				}
+				case BinaryMetadata::TagEndArray:
+				{
+					if (stack.empty() || stack.back().isObject)
+						return false;
+					rapidjson::SizeType count = stack.back().count;
+					stack.pop_back();
+					ok = handler.EndArray(count);
+					break;
+				}
+				default:
+					return false;
+				}
+				if (!ok)
+					return false;
+			}
+			return haveRoot && stack.empty();
+		}
+	};
+
+}  // namespace SharedCacheCore
+
+#endif  // SHAREDCACHE_BINARYMETADATA_H
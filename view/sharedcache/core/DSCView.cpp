@@ -15,6 +15,7 @@
 #include "DSCView.h"
 #include "view/macho/machoview.h"
 #include "SharedCache.h"
+#include <cinttypes>
 
 using namespace BinaryNinja;
 
@@ -608,16 +609,18 @@ bool DSCView::Init()
 	std::vector<SharedCacheCore::MemoryRegion> regionsMappedIntoMemory;
 	if (auto meta = GetParentView()->QueryMetadata(SharedCacheCore::SharedCacheMetadataTag))
 	{
-		std::string data = GetParentView()->GetStringMetadata(SharedCacheCore::SharedCacheMetadataTag);
-		std::stringstream ss;
-		ss.str(data);
-		rapidjson::Document result(rapidjson::kObjectType);
-
-		result.Parse(data.c_str());
+		SharedCacheCore::DeserializationContext context;
+		if (!context.ParseMetadata(meta) || !context.doc.IsObject())
+		{
+			LogError("Failed to parse shared cache metadata");
+			return false;
+		}
+		rapidjson::Document& result = context.doc;
 
 		if (result.HasMember("metadataVersion"))
 		{
-			if (result["metadataVersion"].GetInt() != METADATA_VERSION)
+			int version = result["metadataVersion"].GetInt();
+			if (version != METADATA_VERSION && version != SharedCacheCore::SharedCacheLegacyMetadataVersion)
 			{
 				LogError("Shared cache metadata version mismatch: expected %d, got %d", METADATA_VERSION,
 					result["metadataVersion"].GetInt());
@@ -647,16 +650,35 @@ bool DSCView::Init()
 
 		std::vector<std::pair<uint64_t, std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>>>> exportInfos;
 
-		for (const auto& obj1 : result["exportInfos"].GetArray())
+		if (result["metadataVersion"].GetInt() == SharedCacheCore::SharedCacheLegacyMetadataVersion)
 		{
-			std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>> innerVec;
-			for (const auto& obj2 : obj1["value"].GetArray())
+			// Legacy metadata keeps every image's exports in the main document
+			for (const auto& obj1 : result["exportInfos"].GetArray())
 			{
-				std::pair<BNSymbolType, std::string> innerPair = { (BNSymbolType)obj2["val1"].GetUint64(), obj2["val2"].GetString() };
-				innerVec.push_back({ obj2["key"].GetUint64(), innerPair });
+				std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>> innerVec;
+				for (const auto& obj2 : obj1["value"].GetArray())
+				{
+					std::pair<BNSymbolType, std::string> innerPair = {
+						(BNSymbolType)obj2["val1"].GetUint64(), obj2["val2"].GetString()};
+					innerVec.push_back({obj2["key"].GetUint64(), innerPair});
+				}
+
+				exportInfos.push_back({obj1["key"].GetUint64(), std::move(innerVec)});
 			}
+		}
+		else
+		{
+			for (const auto& imageBase : result["exportRecords"].GetArray())
+			{
+				std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>> innerVec;
+				if (!SharedCacheCore::SharedCache::LoadExportRecord(GetParentView(), imageBase.GetUint64(), innerVec))
+				{
+					LogWarn("Failed to load shared cache exports for image at 0x%" PRIx64, imageBase.GetUint64());
+					continue;
+				}
 
-			exportInfos.push_back({obj1["key"].GetUint64(), innerVec});
+				exportInfos.push_back({imageBase.GetUint64(), std::move(innerVec)});
+			}
 		}
 
 		BeginBulkModifySymbols();
@@ -812,6 +834,40 @@ Ref<Settings> DSCViewType::GetLoadSettingsForData(BinaryView* data)
 			"description" : "Add function starts sourced from the Function Starts tables to the core for analysis."
 			})");
 
+	settings->RegisterSetting("loader.dsc.exportTrieParsingThreads",
+		R"({
+			"title" : "Export Trie Parsing Threads",
+			"type" : "number",
+			"default" : 0,
+			"minValue" : 0,
+			"maxValue" : 256,
+			"description" : "Maximum number of threads used to parse image export tries when loading all symbols. 0 uses one thread per hardware thread, 1 parses serially."
+			})");
+
+	settings->RegisterSetting("loader.dsc.eagerSlideInfo",
+		R"({
+			"title" : "Apply Slide Info Eagerly",
+			"type" : "boolean",
+			"default" : false,
+			"description" : "Rebase every backing cache file in parallel during the initial load instead of as each file is first used."
+			})");
+
+	settings->RegisterSetting("loader.dsc.rebasedPageCacheDirectory",
+		R"({
+			"title" : "Rebased Page Cache Directory",
+			"type" : "string",
+			"default" : "",
+			"description" : "Directory used to store copies of cache files with slide info already applied. Later sessions, and other processes on the same machine, map these copies directly instead of rebasing again. Leave empty to disable."
+			})");
+
+	settings->RegisterSetting("loader.dsc.serializeMetadataAsJson",
+		R"({
+			"title" : "Store Metadata as JSON",
+			"type" : "boolean",
+			"default" : false,
+			"description" : "Store the shared cache state in the database as JSON instead of the compact binary encoding. Intended for debugging, JSON is significantly larger and slower to save and load."
+			})");
+
 	// Merge existing load settings if they exist. This allows for the selection of a specific object file from a Mach-O
 	// Universal file. The 'Universal' BinaryViewType generates a schema with 'loader.universal.architectures'. This
 	// schema contains an appropriate 'Mach-O' load schema for selecting a specific object file. The embedded schema
@@ -32,6 +32,9 @@
  *
  * Other ser/deser formats (rapidjson objects, strings) also exist. You can use these to achieve nesting, but probably
  avoid that.
+ *
+ * `AsMetadata()` uses the compact binary encoding from BinaryMetadata.h by default, `AsString()` is always JSON.
+ * Both decode into the same rapidjson document, so `Load` implementations don't need to know which was used.
  * */
 
 #include "binaryninjaapi.h"
@@ -40,6 +43,7 @@
 #include "rapidjson/prettywriter.h"
 #include "../api/sharedcachecore.h"
 #include "view/macho/machoview.h"
+#include "BinaryMetadata.h"
 
 #ifndef SHAREDCACHE_CORE_METADATASERIALIZABLE_HPP
 #define SHAREDCACHE_CORE_METADATASERIALIZABLE_HPP
@@ -57,11 +61,76 @@ using namespace BinaryNinja;
 
 struct DeserializationContext;
 
+enum class SerializationFormat
+{
+	Json,
+	Binary,
+};
+
+// Forwards SAX events to the writer for the context's format, so `Store` implementations can keep using
+// `context.writer` regardless of which one is in use.
+class SerializationWriter
+{
+	SerializationFormat m_format;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> m_json;
+	BinaryMetadataWriter m_binary;
+
+	friend struct SerializationContext;
+
+public:
+	SerializationWriter(rapidjson::StringBuffer& buffer, SerializationFormat format) :
+		m_format(format), m_json(buffer), m_binary()
+	{}
+
+	bool Null() { return m_format == SerializationFormat::Binary ? m_binary.Null() : m_json.Null(); }
+	bool Bool(bool b) { return m_format == SerializationFormat::Binary ? m_binary.Bool(b) : m_json.Bool(b); }
+	bool Int(int i) { return m_format == SerializationFormat::Binary ? m_binary.Int(i) : m_json.Int(i); }
+	bool Uint(unsigned u) { return m_format == SerializationFormat::Binary ? m_binary.Uint(u) : m_json.Uint(u); }
+	bool Int64(int64_t i) { return m_format == SerializationFormat::Binary ? m_binary.Int64(i) : m_json.Int64(i); }
+	bool Uint64(uint64_t u) { return m_format == SerializationFormat::Binary ? m_binary.Uint64(u) : m_json.Uint64(u); }
+	bool Double(double d) { return m_format == SerializationFormat::Binary ? m_binary.Double(d) : m_json.Double(d); }
+
+	bool String(const char* str, rapidjson::SizeType length, bool copy = false)
+	{
+		return m_format == SerializationFormat::Binary ? m_binary.String(str, length, copy) : m_json.String(str, length, copy);
+	}
+
+	bool Key(const char* str, rapidjson::SizeType length, bool copy = false)
+	{
+		return m_format == SerializationFormat::Binary ? m_binary.Key(str, length, copy) : m_json.Key(str, length, copy);
+	}
+
+	bool StartObject() { return m_format == SerializationFormat::Binary ? m_binary.StartObject() : m_json.StartObject(); }
+	bool EndObject(rapidjson::SizeType memberCount = 0)
+	{
+		return m_format == SerializationFormat::Binary ? m_binary.EndObject(memberCount) : m_json.EndObject(memberCount);
+	}
+	bool StartArray() { return m_format == SerializationFormat::Binary ? m_binary.StartArray() : m_json.StartArray(); }
+	bool EndArray(rapidjson::SizeType elementCount = 0)
+	{
+		return m_format == SerializationFormat::Binary ? m_binary.EndArray(elementCount) : m_json.EndArray(elementCount);
+	}
+};
+
 struct SerializationContext {
+	SerializationFormat format;
+	// Output for `SerializationFormat::Json`. Binary output is retrieved with `TakeBinary`.
 	rapidjson::StringBuffer buffer;
-	rapidjson::PrettyWriter<rapidjson::StringBuffer> writer;
+	SerializationWriter writer;
 
-	SerializationContext() : buffer(), writer(buffer) {
+	SerializationContext(SerializationFormat format = SerializationFormat::Json) :
+		format(format), buffer(), writer(buffer, format)
+	{
+	}
+
+	std::vector<uint8_t> TakeBinary() { return writer.m_binary.TakeOutput(); }
+
+	// Raw metadata for the binary format, a string for JSON.
+	Ref<Metadata> TakeMetadata()
+	{
+		if (format == SerializationFormat::Binary)
+			return new Metadata(TakeBinary());
+		return new Metadata(std::string(buffer.GetString(), buffer.GetSize()));
 	}
 
 	template <typename T>
@@ -73,6 +142,36 @@ struct SerializationContext {
 
 struct DeserializationContext {
 	rapidjson::Document doc;
+	// Binary metadata is decoded in place, strings in `doc` point into this buffer.
+	std::vector<uint8_t> binary;
+
+	bool ParseBinary(std::vector<uint8_t> data)
+	{
+		binary = std::move(data);
+		BinaryMetadataReader reader(binary.data(), binary.size(), true);
+		bool valid = false;
+		auto generator = [&](rapidjson::Document& handler) { return valid = reader(handler); };
+		doc.Populate(generator);
+		return valid;
+	}
+
+	bool ParseString(const std::string& data)
+	{
+		doc.Parse(data.c_str());
+		return !doc.HasParseError();
+	}
+
+	// Accepts both the binary encoding and JSON strings written before it was introduced.
+	bool ParseMetadata(const Ref<Metadata>& meta)
+	{
+		if (!meta)
+			return false;
+		if (meta->IsRaw())
+			return ParseBinary(meta->GetRaw());
+		if (meta->IsString())
+			return ParseString(meta->GetString());
+		return false;
+	}
 
 	template <typename T>
 	T load(std::string_view x)
@@ -109,15 +208,34 @@ public:
 		AsDerived().Load(context);
 	}
 
-	Ref<Metadata> AsMetadata() {
-		return new Metadata(AsString());
+	std::vector<uint8_t> AsBinary() const
+	{
+		SerializationContext context(SerializationFormat::Binary);
+		Store(context);
+		return context.TakeBinary();
+	}
+
+	bool LoadFromBinary(std::vector<uint8_t> data)
+	{
+		DeserializationContext context;
+		if (!context.ParseBinary(std::move(data)))
+			return false;
+		AsDerived().Load(context);
+		return true;
+	}
+
+	Ref<Metadata> AsMetadata(SerializationFormat format = SerializationFormat::Binary) {
+		SerializationContext context(format);
+		Store(context);
+		return context.TakeMetadata();
 	}
 
 	bool LoadFromMetadata(const Ref<Metadata>& meta)
 	{
-		if (!meta->IsString())
+		DeserializationContext context;
+		if (!context.ParseMetadata(meta))
 			return false;
-		LoadFromString(meta->GetString());
+		AsDerived().Load(context);
 		return true;
 	}
 
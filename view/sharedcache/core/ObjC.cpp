@@ -362,18 +362,13 @@ void DSCObjCProcessor::LoadClasses(VMReader* reader, Ref<Section> classPtrSectio
 		reader->Seek(classPointerLocation);
 
 		classPtr = ReadPointerAccountingForRelocations(reader);
-		reader->Seek(classPtr);
 		try
 		{
-			clsStruct.isa = ReadPointerAccountingForRelocations(reader);
-			clsStruct.super = reader->ReadPointer();
-			clsStruct.cache = reader->ReadPointer();
-			clsStruct.vtable = reader->ReadPointer();
-			clsStruct.data = ReadPointerAccountingForRelocations(reader);
+			clsStruct = ReadClass(reader, classPtr);
 		}
 		catch (...)
 		{
-			m_logger->LogError("Failed to read class data at 0x%llx pointed to by @ 0x%llx", reader->GetOffset(),
+			m_logger->LogError("Failed to read class data at 0x%llx pointed to by @ 0x%llx", classPtr,
 				classPointerLocation);
 			continue;
 		}
@@ -384,26 +379,14 @@ void DSCObjCProcessor::LoadClasses(VMReader* reader, Ref<Section> classPtrSectio
 		}
 		// unset first two bits
 		view_ptr_t classROPtr = clsStruct.data & ~3;
-		reader->Seek(classROPtr);
 		try
 		{
-			classRO.flags = reader->Read32();
-			classRO.instanceStart = reader->Read32();
-			classRO.instanceSize = reader->Read32();
-			if (m_data->GetAddressSize() == 8)
-				classRO.reserved = reader->Read32();
-			classRO.ivarLayout = ReadPointerAccountingForRelocations(reader);
-			classRO.name = ReadPointerAccountingForRelocations(reader);
-			classRO.baseMethods = ReadPointerAccountingForRelocations(reader);
-			classRO.baseProtocols = ReadPointerAccountingForRelocations(reader);
-			classRO.ivars = ReadPointerAccountingForRelocations(reader);
-			classRO.weakIvarLayout = ReadPointerAccountingForRelocations(reader);
-			classRO.baseProperties = ReadPointerAccountingForRelocations(reader);
+			classRO = ReadClassRO(reader, classROPtr);
 		}
 		catch (...)
 		{
 			m_logger->LogError("Failed to read class RO data at 0x%llx. 0x%llx, objc_class_t @ 0x%llx",
-				reader->GetOffset(), classPointerLocation, classROPtr);
+				classROPtr, classPointerLocation, classROPtr);
 			continue;
 		}
 
@@ -453,21 +436,17 @@ void DSCObjCProcessor::LoadClasses(VMReader* reader, Ref<Section> classPtrSectio
 
 		if (clsStruct.isa)
 		{
-			reader->Seek(clsStruct.isa);
 			try
 			{
-				metaClsStruct.isa = ReadPointerAccountingForRelocations(reader);
-				metaClsStruct.super = reader->ReadPointer();
-				metaClsStruct.cache = reader->ReadPointer();
-				metaClsStruct.vtable = reader->ReadPointer();
-				metaClsStruct.data = ReadPointerAccountingForRelocations(reader) & ~1;
+				metaClsStruct = ReadClass(reader, clsStruct.isa);
+				metaClsStruct.data &= ~1;
 				DefineObjCSymbol(BNSymbolType::DataSymbol, m_typeNames.cls, "metacls_" + name, clsStruct.isa, true);
 				hasValidMetaClass = true;
 			}
 			catch (...)
 			{
 				m_logger->LogWarn("Failed to read metaclass data at 0x%llx pointed to by objc_class_t @ 0x%llx",
-					reader->GetOffset(), classPtr);
+					clsStruct.isa, classPtr);
 			}
 		}
 		if (hasValidMetaClass && (metaClsStruct.data & 1))
@@ -477,21 +456,9 @@ void DSCObjCProcessor::LoadClasses(VMReader* reader, Ref<Section> classPtrSectio
 		}
 		if (hasValidMetaClass)
 		{
-			reader->Seek(metaClsStruct.data);
 			try
 			{
-				metaClassRO.flags = reader->Read32();
-				metaClassRO.instanceStart = reader->Read32();
-				metaClassRO.instanceSize = reader->Read32();
-				if (m_data->GetAddressSize() == 8)
-					metaClassRO.reserved = reader->Read32();
-				metaClassRO.ivarLayout = ReadPointerAccountingForRelocations(reader);
-				metaClassRO.name = ReadPointerAccountingForRelocations(reader);
-				metaClassRO.baseMethods = ReadPointerAccountingForRelocations(reader);
-				metaClassRO.baseProtocols = ReadPointerAccountingForRelocations(reader);
-				metaClassRO.ivars = ReadPointerAccountingForRelocations(reader);
-				metaClassRO.weakIvarLayout = ReadPointerAccountingForRelocations(reader);
-				metaClassRO.baseProperties = ReadPointerAccountingForRelocations(reader);
+				metaClassRO = ReadClassRO(reader, metaClsStruct.data);
 				DefineObjCSymbol(
 					BNSymbolType::DataSymbol, m_typeNames.classRO, "metacls_ro_" + name, metaClsStruct.data, true);
 				hasValidMetaClassRO = true;
@@ -499,7 +466,7 @@ void DSCObjCProcessor::LoadClasses(VMReader* reader, Ref<Section> classPtrSectio
 			catch (...)
 			{
 				m_logger->LogWarn("Failed to read metaclass RO data at 0x%llx pointed to by meta objc_class_t @ 0x%llx",
-					reader->GetOffset(), clsStruct.isa);
+					metaClsStruct.data, clsStruct.isa);
 			}
 		}
 
@@ -824,43 +791,63 @@ void DSCObjCProcessor::ReadMethodList(VMReader* reader, ClassBase& cls, std::str
 	uint64_t pointerSize = m_data->GetAddressSize();
 	bool relativeOffsets = (head.entsizeAndFlags & 0xFFFF0000) & 0x80000000;
 	bool directSelectors = (head.entsizeAndFlags & 0xFFFF0000) & 0x40000000;
-	auto methodSize = relativeOffsets ? 12 : pointerSize * 3;
+	auto methodSize = relativeOffsets ? sizeof(method_entry_t) : pointerSize * 3;
 	DefineObjCSymbol(DataSymbol, m_typeNames.methodList, "method_list_" + std::string(name), start, true);
 
+	// Decode every entry up front from a single read of the whole list, then resolve names and types.
+	view_ptr_t entriesStart = start + sizeof(method_list_t);
+	std::vector<method_t> entries(head.count);
+	try
+	{
+		if (relativeOffsets)
+		{
+			auto relativeEntries = reader->ReadArray<method_entry_t>(entriesStart, head.count);
+			for (unsigned i = 0; i < head.count; i++)
+			{
+				auto cursor = entriesStart + (i * methodSize);
+				auto selectorBaseOffset = cursor;
+				if (directSelectors && m_customRelativeMethodSelectorBase.has_value())
+					selectorBaseOffset = m_customRelativeMethodSelectorBase.value();
+
+				entries[i].name = selectorBaseOffset + relativeEntries[i].name;
+				entries[i].types = cursor + 4 + (int32_t)relativeEntries[i].types;
+				entries[i].imp = cursor + 8 + (int32_t)relativeEntries[i].imp;
+			}
+		}
+		else
+		{
+			auto [data, _] = reader->ReadSpan(entriesStart, head.count * methodSize);
+			for (unsigned i = 0; i < head.count; i++)
+			{
+				auto cursor = entriesStart + (i * methodSize);
+				auto entry = data + (i * methodSize);
+				entries[i].name = DecodePointerAccountingForRelocations(cursor, entry);
+				entries[i].types = DecodePointerAccountingForRelocations(cursor + pointerSize, entry + pointerSize);
+				entries[i].imp = DecodePointerAccountingForRelocations(cursor + pointerSize * 2, entry + pointerSize * 2);
+			}
+		}
+	}
+	catch (...)
+	{
+		m_logger->LogError("Failed to read the entries of method list at 0x%llx", start);
+		return;
+	}
+
 	for (unsigned i = 0; i < head.count; i++)
 	{
 		try
 		{
 			Method method;
-			auto cursor = start + sizeof(method_list_t) + (i * methodSize);
-			reader->Seek(cursor);
-			method_t meth;
+			auto cursor = entriesStart + (i * methodSize);
+			const method_t& meth = entries[i];
 			// workflow_objc support
 			uint64_t selRefAddr = 0;
 			uint64_t selAddr = 0;
 			// --
-			if (relativeOffsets)
-			{
-				auto selectorBaseOffset = reader->GetOffset();
-				if (directSelectors && m_customRelativeMethodSelectorBase.has_value()) {
-					selectorBaseOffset = m_customRelativeMethodSelectorBase.value();
-				}
-
-				meth.name = selectorBaseOffset + reader->Read32();
-				meth.types = reader->GetOffset() + reader->ReadS32();
-				meth.imp = reader->GetOffset() + reader->ReadS32();
-			}
-			else
-			{
-				meth.name = ReadPointerAccountingForRelocations(reader);
-				meth.types = ReadPointerAccountingForRelocations(reader);
-				meth.imp = ReadPointerAccountingForRelocations(reader);
-			}
 			if (!relativeOffsets || directSelectors)
 			{
 				selAddr = meth.name;
 				method.name = reader->ReadCString(meth.name);
-				reader->Seek(meth.types);
 				method.types = reader->ReadCString(meth.types);
 				DefineObjCSymbol(DataSymbol, Type::ArrayType(Type::IntegerType(1, true), method.name.size() + 1),
 					"sel_" + method.name, meth.name, true);
@@ -874,14 +861,12 @@ void DSCObjCProcessor::ReadMethodList(VMReader* reader, ClassBase& cls, std::str
 				reader->Seek(meth.name);
 				selRefAddr = meth.name;
 				selRef = ReadPointerAccountingForRelocations(reader);
-				reader->Seek(meth.types);
 				method.types = reader->ReadCString(meth.types);
 				selAddr = selRef;
 				if (const auto& it = m_selectorCache.find(selRef); it != m_selectorCache.end())
 					method.name = it->second;
 				else
 				{
-					reader->Seek(selRef);
 					method.name = reader->ReadCString(selRef);
 					m_selectorCache[selRef] = method.name;
 				}
@@ -925,25 +910,41 @@ void DSCObjCProcessor::ReadIvarList(VMReader* reader, ClassBase& cls, std::strin
 		m_logger->LogError("Ivar list at 0x%llx has an invalid count of 0x%llx", start, head.count);
 		return;
 	}
+
+	// Decode every entry up front from a single read of the whole list, then resolve names and types.
+	auto ivarSize = (addressSize * 3) + 8;
+	view_ptr_t entriesStart = start + sizeof(ivar_list_t);
+	std::vector<ivar_t> entries(head.count);
+	try
+	{
+		auto [data, _] = reader->ReadSpan(entriesStart, head.count * ivarSize);
+		for (unsigned i = 0; i < head.count; i++)
+		{
+			auto cursor = entriesStart + (i * ivarSize);
+			auto entry = data + (i * ivarSize);
+			entries[i].offset = DecodePointerAccountingForRelocations(cursor, entry);
+			entries[i].name = DecodePointerAccountingForRelocations(cursor + addressSize, entry + addressSize);
+			entries[i].type = DecodePointerAccountingForRelocations(cursor + addressSize * 2, entry + addressSize * 2);
+			memcpy(&entries[i].alignmentRaw, entry + addressSize * 3, sizeof(uint32_t));
+			memcpy(&entries[i].size, entry + addressSize * 3 + 4, sizeof(uint32_t));
+		}
+	}
+	catch (...)
+	{
+		m_logger->LogError("Failed to read the entries of ivar list at 0x%llx", start);
+		return;
+	}
+
 	for (unsigned i = 0; i < head.count; i++)
 	{
 		try
 		{
 			Ivar ivar;
-			ivar_t ivarStruct;
-			uint64_t cursor = start + (sizeof(ivar_list_t)) + (i * ((addressSize * 3) + 8));
-			reader->Seek(cursor);
-			ivarStruct.offset = ReadPointerAccountingForRelocations(reader);
-			ivarStruct.name = ReadPointerAccountingForRelocations(reader);
-			ivarStruct.type = ReadPointerAccountingForRelocations(reader);
-			ivarStruct.alignmentRaw = reader->Read32();
-			ivarStruct.size = reader->Read32();
-
-			reader->Seek(ivarStruct.offset);
-			ivar.offset = reader->Read32();
-			reader->Seek(ivarStruct.name);
+			const ivar_t& ivarStruct = entries[i];
+			uint64_t cursor = entriesStart + (i * ivarSize);
+
+			ivar.offset = reader->ReadUInt32(ivarStruct.offset);
 			ivar.name = reader->ReadCString(ivarStruct.name);
-			reader->Seek(ivarStruct.type);
 			ivar.type = reader->ReadCString(ivarStruct.type);
 
 			DefineObjCSymbol(DataSymbol, m_typeNames.ivar, "ivar_" + ivar.name, cursor, true);
@@ -956,8 +957,7 @@ void DSCObjCProcessor::ReadIvarList(VMReader* reader, ClassBase& cls, std::strin
 		}
 		catch (...)
 		{
-			m_logger->LogError("Failed to process an ivar at offset 0x%llx",
-				start + (sizeof(ivar_list_t)) + (i * ((addressSize * 3) + 8)));
+			m_logger->LogError("Failed to process an ivar at offset 0x%llx", entriesStart + (i * ivarSize));
 		}
 	}
 }
@@ -1233,6 +1233,62 @@ uint64_t DSCObjCProcessor::ReadPointerAccountingForRelocations(VMReader* reader)
 	return reader->ReadPointer();
 }
 
+uint64_t DSCObjCProcessor::DecodePointer(const uint8_t* data) const
+{
+	if (m_data->GetAddressSize() == 8)
+	{
+		uint64_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+	uint32_t value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+uint64_t DSCObjCProcessor::DecodePointerAccountingForRelocations(view_ptr_t address, const uint8_t* data) const
+{
+	if (auto it = m_relocationPointerRewrites.find(address); it != m_relocationPointerRewrites.end())
+		return it->second;
+	return DecodePointer(data);
+}
+
+DSCObjC::class_t DSCObjCProcessor::ReadClass(VMReader* reader, view_ptr_t address)
+{
+	auto ptrSize = m_data->GetAddressSize();
+	auto [data, _] = reader->ReadSpan(address, ptrSize * 5);
+	class_t cls;
+	cls.isa = DecodePointerAccountingForRelocations(address, data);
+	cls.super = DecodePointer(data + ptrSize);
+	cls.cache = DecodePointer(data + ptrSize * 2);
+	cls.vtable = DecodePointer(data + ptrSize * 3);
+	cls.data = DecodePointerAccountingForRelocations(address + ptrSize * 4, data + ptrSize * 4);
+	return cls;
+}
+
+DSCObjC::class_ro_t DSCObjCProcessor::ReadClassRO(VMReader* reader, view_ptr_t address)
+{
+	auto ptrSize = m_data->GetAddressSize();
+	// `reserved` only exists in the 64-bit layout, where it pads the pointers out to 8 byte alignment.
+	size_t headerSize = ptrSize == 8 ? 16 : 12;
+	auto [data, _] = reader->ReadSpan(address, headerSize + ptrSize * 7);
+	class_ro_t ro;
+	memcpy(&ro.flags, data, sizeof(uint32_t));
+	memcpy(&ro.instanceStart, data + 4, sizeof(uint32_t));
+	memcpy(&ro.instanceSize, data + 8, sizeof(uint32_t));
+	if (ptrSize == 8)
+		memcpy(&ro.reserved, data + 12, sizeof(uint32_t));
+
+	view_ptr_t* pointers[] = {&ro.ivarLayout, &ro.name, &ro.baseMethods, &ro.baseProtocols, &ro.ivars,
+		&ro.weakIvarLayout, &ro.baseProperties};
+	for (size_t i = 0; i < 7; i++)
+	{
+		auto offset = headerSize + ptrSize * i;
+		*pointers[i] = DecodePointerAccountingForRelocations(address + offset, data + offset);
+	}
+	return ro;
+}
+
 
 DSCObjCProcessor::DSCObjCProcessor(BinaryNinja::BinaryView* data, SharedCache* cache, bool isBackedByDatabase) :
 	m_isBackedByDatabase(isBackedByDatabase), m_data(data), m_cache(cache)
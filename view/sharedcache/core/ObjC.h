@@ -209,6 +209,11 @@ namespace DSCObjC {
 		SharedCacheCore::SharedCache* m_cache;
 
 		uint64_t ReadPointerAccountingForRelocations(VMReader* reader);
+		// Decode a pointer from data already read out of the VM, e.g. via `VMReader::ReadSpan`.
+		uint64_t DecodePointer(const uint8_t* data) const;
+		uint64_t DecodePointerAccountingForRelocations(view_ptr_t address, const uint8_t* data) const;
+		class_t ReadClass(VMReader* reader, view_ptr_t address);
+		class_ro_t ReadClassRO(VMReader* reader, view_ptr_t address);
 		std::unordered_map<uint64_t, uint64_t> m_relocationPointerRewrites;
 
 		static Ref<Metadata> SerializeMethod(uint64_t loc, const Method& method);
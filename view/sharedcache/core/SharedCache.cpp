@@ -26,9 +26,11 @@
 
 #include "SharedCache.h"
 #include "ObjC.h"
+#include "AddressRangeMap.h"
 #include <filesystem>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <fcntl.h>
 #include <memory>
@@ -55,6 +57,36 @@ int count_trailing_zeros(uint64_t value) {
 }
 #endif
 
+// Immutable lookup tables derived from `State`, allowing address queries in O(log n) rather than scanning every
+// region and every image header. Rebuilt whenever the state is committed via `SaveToDSCView` or deserialized.
+struct SharedCache::AddressIndex
+{
+	enum RegionKind : uint8_t
+	{
+		StubIsland,
+		DyldData,
+		NonImage,
+		ImageSection,
+	};
+
+	struct RegionRef
+	{
+		RegionKind kind;
+		// Key into `State::headers` for `ImageSection`, unused otherwise.
+		uint64_t headerKey;
+		// Index into the region vector for `kind`, or into the header's sections for `ImageSection`.
+		size_t index;
+	};
+
+	// Named regions, with the same precedence `NameForAddress` has always used:
+	// stub islands, then dyld data, then non-image regions, then image sections.
+	AddressRangeMap<RegionRef> regions;
+	// Image segments -> key into `State::headers`.
+	AddressRangeMap<uint64_t> headers;
+	// Regions that have been loaded into the view -> index into `State::regionsMappedIntoMemory`.
+	AddressRangeMap<size_t> mappedRegions;
+};
+
 struct SharedCache::State
 {
 	std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>>>
@@ -80,8 +112,61 @@ struct SharedCache::State
 	std::string baseFilePath;
 	SharedCacheFormat cacheFormat;
 	DSCViewState viewState = DSCViewStateUnloaded;
+
+	// Not serialized. Shared between copies of the state as it is never mutated once built.
+	std::shared_ptr<const SharedCache::AddressIndex> addressIndex;
+
+	// Images whose export and symbol lists are stored under their own metadata keys. Those lists are only read back
+	// when needed, so `exportInfos` and `symbolInfos` hold just the ones produced since the state was loaded.
+	std::set<uint64_t> persistedExportRecords;
+	std::set<uint64_t> persistedSymbolRecords;
+
+	// Not serialized. Records changed since the last `SaveToDSCView`, a new state has never been saved.
+	bool headersDirty = true;
+	std::unordered_set<uint64_t> dirtyExportRecords;
+	std::unordered_set<uint64_t> dirtySymbolRecords;
 };
 
+
+static std::shared_ptr<const SharedCache::AddressIndex> BuildAddressIndex(const struct SharedCache::State& state)
+{
+	using AddressIndex = SharedCache::AddressIndex;
+	auto index = std::make_shared<AddressIndex>();
+
+	std::vector<AddressRangeMap<AddressIndex::RegionRef>::Entry> regions;
+	auto addRegions = [&](const std::vector<MemoryRegion>& list, AddressIndex::RegionKind kind) {
+		for (size_t i = 0; i < list.size(); i++)
+			regions.push_back({list[i].start, list[i].start + list[i].size, {kind, 0, i}});
+	};
+	addRegions(state.stubIslandRegions, AddressIndex::StubIsland);
+	addRegions(state.dyldDataRegions, AddressIndex::DyldData);
+	addRegions(state.nonImageRegions, AddressIndex::NonImage);
+
+	std::vector<AddressRangeMap<uint64_t>::Entry> headers;
+	for (const auto& [key, header] : state.headers)
+	{
+		for (const auto& segment : header.segments)
+			headers.push_back({segment.vmaddr, segment.vmaddr + segment.vmsize, key});
+		for (size_t i = 0; i < header.sections.size(); i++)
+		{
+			const auto& section = header.sections[i];
+			regions.push_back({section.addr, section.addr + section.size, {AddressIndex::ImageSection, key, i}});
+		}
+	}
+
+	std::vector<AddressRangeMap<size_t>::Entry> mappedRegions;
+	for (size_t i = 0; i < state.regionsMappedIntoMemory.size(); i++)
+	{
+		const auto& region = state.regionsMappedIntoMemory[i];
+		mappedRegions.push_back({region.start, region.start + region.size, i});
+	}
+
+	index->regions = AddressRangeMap<AddressIndex::RegionRef>(regions);
+	index->headers = AddressRangeMap<uint64_t>(headers);
+	index->mappedRegions = AddressRangeMap<size_t>(mappedRegions);
+	return index;
+}
+
 struct SharedCache::ViewSpecificState {
 	std::mutex typeLibraryMutex;
 	std::unordered_map<std::string, Ref<TypeLibrary>> typeLibraries;
@@ -207,6 +292,44 @@ uint64_t readValidULEB128(const uint8_t*& current, const uint8_t* end)
 }
 
 
+// Flags of each section in an image, used to decide whether a symbol is code or data.
+static AddressRangeMap<uint32_t> SectionFlagsForHeader(const SharedCacheMachOHeader& header)
+{
+	std::vector<AddressRangeMap<uint32_t>::Entry> sections;
+	sections.reserve(header.sections.size());
+	for (const auto& section : header.sections)
+		sections.push_back({section.addr, section.addr + section.size, section.flags});
+	return AddressRangeMap<uint32_t>(sections);
+}
+
+
+static BNSymbolType SymbolTypeForAddress(const AddressRangeMap<uint32_t>& sectionFlags, uint64_t address)
+{
+	if (auto flags = sectionFlags.Find(address))
+	{
+		if ((*flags & S_ATTR_PURE_INSTRUCTIONS) == S_ATTR_PURE_INSTRUCTIONS
+			|| (*flags & S_ATTR_SOME_INSTRUCTIONS) == S_ATTR_SOME_INSTRUCTIONS)
+			return FunctionSymbol;
+	}
+	return DataSymbol;
+}
+
+
+// Calls `callback(const ExportTrie::Entry& entry, uint64_t address, BNSymbolType type)` for each export of `header`.
+template <typename F>
+static void ForEachExport(const SharedCacheMachOHeader& header, const ExportTrie& exports, F&& callback)
+{
+	auto sectionFlags = SectionFlagsForHeader(header);
+	for (const auto& entry : exports.GetEntries())
+	{
+		uint64_t address = header.textBase + entry.imageOffset;
+		if (!address)
+			continue;
+		callback(entry, address, SymbolTypeForAddress(sectionFlags, address));
+	}
+}
+
+
 uint64_t SharedCache::FastGetBackingCacheCount(BinaryNinja::Ref<BinaryNinja::BinaryView> dscView)
 {
 	std::shared_ptr<MMappedFileAccessor> baseFile;
@@ -776,6 +899,13 @@ void SharedCache::PerformInitialLoad()
 		m_logger->LogError("Failed to map VM pages for Shared Cache on initial load, this is fatal.");
 		return;
 	}
+
+	auto settings = m_dscView->GetLoadSettings(VIEW_NAME);
+	if (settings && settings->Contains("loader.dsc.eagerSlideInfo")
+		&& settings->Get<bool>("loader.dsc.eagerSlideInfo", m_dscView))
+	{
+		ApplySlideInfoForAllFiles();
+	}
 	for (const auto& start : State().imageStarts)
 	{
 		try {
@@ -788,6 +918,7 @@ void SharedCache::PerformInitialLoad()
 					imageHeader->exportTriePath = mapping.first.fileAccessor->filePath();
 				}
 				MutableState().headers[start.second] = imageHeader.value();
+				MutableState().headersDirty = true;
 				CacheImage image;
 				image.installName = start.first;
 				image.headerLocation = start.second;
@@ -1004,7 +1135,7 @@ void SharedCache::DeserializeFromRawView()
 		}
 		else
 		{
-			LoadFromString(m_dscView->GetStringMetadata(SharedCacheMetadataTag));
+			LoadFromMetadata(m_dscView->QueryMetadata(SharedCacheMetadataTag));
 		}
 		if (!m_metadataValid)
 		{
@@ -1031,13 +1162,18 @@ std::string to_hex_string(uint64_t value)
 }
 
 
-void SharedCache::ParseAndApplySlideInfoForFile(std::shared_ptr<MMappedFileAccessor> file)
+void SharedCache::ParseAndApplySlideInfoForFile(std::shared_ptr<MMappedFileAccessor> file, const SlideInfoProgressCallback& progress)
 {
 	if (file->SlideInfoWasApplied())
 		return;
 
+	// Evicting the file part way through, or right after, would throw the rebased pages away.
+	FileAccessorPin pin(file);
+
 	WillMutateState();
+#ifdef SLIDEINFO_DEBUG_TAGS
 	std::vector<std::pair<uint64_t, uint64_t>> rewrites;
+#endif
 
 	dyld_cache_header baseHeader;
 	file->Read(&baseHeader, 0, sizeof(dyld_cache_header));
@@ -1144,214 +1280,301 @@ void SharedCache::ParseAndApplySlideInfoForFile(std::shared_ptr<MMappedFileAcces
 		return;
 	}
 
-	for (const auto& [off, mapping] : mappings)
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	// If a rebased page cache is configured, map a previously rebased copy of this file instead of doing the work.
+	std::string rebasedCachePath;
+	RebasedCacheKey rebasedCacheKey = {};
+	auto settings = m_dscView->GetLoadSettings(VIEW_NAME);
+	if (settings && settings->Contains("loader.dsc.rebasedPageCacheDirectory"))
+	{
+		auto directory = settings->Get<std::string>("loader.dsc.rebasedPageCacheDirectory", m_dscView);
+		std::error_code ec;
+		auto fileSize = std::filesystem::file_size(file->Path(), ec);
+		auto modificationTime = std::filesystem::last_write_time(file->Path(), ec);
+		if (!directory.empty() && !ec)
+		{
+			memcpy(rebasedCacheKey.uuid, baseHeader.uuid, sizeof(rebasedCacheKey.uuid));
+			rebasedCacheKey.fileSize = fileSize;
+			rebasedCacheKey.modificationTime = modificationTime.time_since_epoch().count();
+
+			char uuid[33] = {};
+			for (size_t i = 0; i < sizeof(baseHeader.uuid); i++)
+				snprintf(uuid + (i * 2), 3, "%02X", baseHeader.uuid[i]);
+			auto fileName = std::filesystem::path(file->Path()).filename().string();
+			rebasedCachePath = (std::filesystem::path(directory) / (fileName + "." + std::string(uuid) + ".rebased")).string();
+		}
+	}
+	if (!rebasedCachePath.empty() && file->MapRebasedCopy(rebasedCachePath, rebasedCacheKey))
+	{
+		double elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+		m_logger->LogInfo("Mapped rebased copy of %s from %s in %.3f seconds", file->Path().c_str(),
+			rebasedCachePath.c_str(), elapsed);
+		file->SetSlideInfoWasApplied(true);
+		return;
+	}
+
+	// Rebases a single page of `mapping`, whose slide info starts at file offset `off`, appending to `pageRewrites`.
+	auto rebasePage = [&](uint64_t off, const MappingInfo& mapping, size_t i, std::vector<std::pair<uint64_t, uint64_t>>& pageRewrites)
 	{
-		m_logger->LogDebug("Slide Info Version: %d", mapping.slideInfoVersion);
 		uint64_t extrasOffset = off;
 		uint64_t pageStartsOffset = off;
-		uint64_t pageStartCount;
 		uint64_t pageSize;
 
 		if (mapping.slideInfoVersion == 2)
 		{
 			pageStartsOffset += mapping.slideInfoV2.page_starts_offset;
-			pageStartCount = mapping.slideInfoV2.page_starts_count;
 			pageSize = mapping.slideInfoV2.page_size;
 			extrasOffset += mapping.slideInfoV2.page_extras_offset;
-			auto cursor = pageStartsOffset;
+			auto cursor = pageStartsOffset + (i * sizeof(uint16_t));
 
-			for (size_t i = 0; i < pageStartCount; i++)
+			try
 			{
-				try
-				{
-					uint16_t start = mapping.file->ReadUShort(cursor);
-					cursor += sizeof(uint16_t);
-					if (start == DYLD_CACHE_SLIDE_PAGE_ATTR_NO_REBASE)
-						continue;
+				uint16_t start = mapping.file->ReadUShort(cursor);
+				if (start == DYLD_CACHE_SLIDE_PAGE_ATTR_NO_REBASE)
+					return;
 
-					auto rebaseChain = [&](const dyld_cache_slide_info_v2& slideInfo, uint64_t pageContent, uint16_t startOffset)
-					{
-						uintptr_t slideAmount = 0;
+				auto rebaseChain = [&](const dyld_cache_slide_info_v2& slideInfo, uint64_t pageContent, uint16_t startOffset)
+				{
+					uintptr_t slideAmount = 0;
 
-						auto deltaMask = slideInfo.delta_mask;
-						auto valueMask = ~deltaMask;
-						auto valueAdd = slideInfo.value_add;
+					auto deltaMask = slideInfo.delta_mask;
+					auto valueMask = ~deltaMask;
+					auto valueAdd = slideInfo.value_add;
 
-						auto deltaShift = count_trailing_zeros(deltaMask) - 2;
+					auto deltaShift = count_trailing_zeros(deltaMask) - 2;
 
-						uint32_t pageOffset = startOffset;
-						uint32_t delta = 1;
-						while ( delta != 0 )
+					uint32_t pageOffset = startOffset;
+					uint32_t delta = 1;
+					while ( delta != 0 )
+					{
+						uint64_t loc = pageContent + pageOffset;
+						try
 						{
-							uint64_t loc = pageContent + pageOffset;
-							try
+							uintptr_t rawValue = file->ReadULong(loc);
+							delta = (uint32_t)((rawValue & deltaMask) >> deltaShift);
+							uintptr_t value = (rawValue & valueMask);
+							if (value != 0)
 							{
-								uintptr_t rawValue = file->ReadULong(loc);
-								delta = (uint32_t)((rawValue & deltaMask) >> deltaShift);
-								uintptr_t value = (rawValue & valueMask);
-								if (value != 0)
-								{
-									value += valueAdd;
-									value += slideAmount;
-								}
-								pageOffset += delta;
-								rewrites.emplace_back(loc, value);
-							}
-							catch (MappingReadException& ex)
-							{
-								m_logger->LogError("Failed to read v2 slide pointer at 0x%llx\n", loc);
-								break;
+								value += valueAdd;
+								value += slideAmount;
 							}
+							pageOffset += delta;
+							pageRewrites.emplace_back(loc, value);
 						}
-					};
-
-					if (start & DYLD_CACHE_SLIDE_PAGE_ATTR_EXTRA)
-					{
-						int j=(start & 0x3FFF);
-						bool done = false;
-						do
+						catch (MappingReadException& ex)
 						{
-							uint64_t extraCursor = extrasOffset + (j * sizeof(uint16_t));
-							try
-							{
-								auto extra = mapping.file->ReadUShort(extraCursor);
-								uint16_t aStart = extra;
-								uint64_t page = mapping.mappingInfo.fileOffset + (pageSize * i);
-								uint16_t pageStartOffset = (aStart & 0x3FFF)*4;
-								rebaseChain(mapping.slideInfoV2, page, pageStartOffset);
-								done = (extra & DYLD_CACHE_SLIDE_PAGE_ATTR_END);
-								++j;
-							}
-							catch (MappingReadException& ex)
-							{
-								m_logger->LogError("Failed to read v2 slide extra at 0x%llx\n", cursor);
-								break;
-							}
-						} while (!done);
+							m_logger->LogError("Failed to read v2 slide pointer at 0x%llx\n", loc);
+							break;
+						}
 					}
-					else
+				};
+
+				if (start & DYLD_CACHE_SLIDE_PAGE_ATTR_EXTRA)
+				{
+					int j=(start & 0x3FFF);
+					bool done = false;
+					do
 					{
-						uint64_t page = mapping.mappingInfo.fileOffset + (pageSize * i);
-						uint16_t pageStartOffset = start*4;
-						rebaseChain(mapping.slideInfoV2, page, pageStartOffset);
-					}
+						uint64_t extraCursor = extrasOffset + (j * sizeof(uint16_t));
+						try
+						{
+							auto extra = mapping.file->ReadUShort(extraCursor);
+							uint16_t aStart = extra;
+							uint64_t page = mapping.mappingInfo.fileOffset + (pageSize * i);
+							uint16_t pageStartOffset = (aStart & 0x3FFF)*4;
+							rebaseChain(mapping.slideInfoV2, page, pageStartOffset);
+							done = (extra & DYLD_CACHE_SLIDE_PAGE_ATTR_END);
+							++j;
+						}
+						catch (MappingReadException& ex)
+						{
+							m_logger->LogError("Failed to read v2 slide extra at 0x%llx\n", cursor);
+							break;
+						}
+					} while (!done);
 				}
-				catch (MappingReadException& ex)
+				else
 				{
-					m_logger->LogError("Failed to read v2 slide info at 0x%llx\n", cursor);
+					uint64_t page = mapping.mappingInfo.fileOffset + (pageSize * i);
+					uint16_t pageStartOffset = start*4;
+					rebaseChain(mapping.slideInfoV2, page, pageStartOffset);
 				}
 			}
+			catch (MappingReadException& ex)
+			{
+				m_logger->LogError("Failed to read v2 slide info at 0x%llx\n", cursor);
+			}
 		}
 		else if (mapping.slideInfoVersion == 3) {
 			// Slide Info Version 3 Logic
 			pageStartsOffset += sizeof(dyld_cache_slide_info_v3);
-			pageStartCount = mapping.slideInfoV3.page_starts_count;
 			pageSize = mapping.slideInfoV3.page_size;
-			auto cursor = pageStartsOffset;
+			auto cursor = pageStartsOffset + (i * sizeof(uint16_t));
 
-			for (size_t i = 0; i < pageStartCount; i++)
+			try
 			{
-				try
-				{
-					uint16_t delta = mapping.file->ReadUShort(cursor);
-					cursor += sizeof(uint16_t);
-					if (delta == DYLD_CACHE_SLIDE_V3_PAGE_ATTR_NO_REBASE)
-						continue;
+				uint16_t delta = mapping.file->ReadUShort(cursor);
+				if (delta == DYLD_CACHE_SLIDE_V3_PAGE_ATTR_NO_REBASE)
+					return;
 
-					delta = delta/sizeof(uint64_t); // initial offset is byte based
-					uint64_t loc = mapping.mappingInfo.fileOffset + (pageSize * i);
-					do
+				delta = delta/sizeof(uint64_t); // initial offset is byte based
+				uint64_t loc = mapping.mappingInfo.fileOffset + (pageSize * i);
+				do
+				{
+					loc += delta * sizeof(dyld_cache_slide_pointer3);
+					try
 					{
-						loc += delta * sizeof(dyld_cache_slide_pointer3);
-						try
-						{
-							dyld_cache_slide_pointer3 slideInfo;
-							file->Read(&slideInfo, loc, sizeof(slideInfo));
-							delta = slideInfo.plain.offsetToNextPointer;
+						dyld_cache_slide_pointer3 slideInfo;
+						file->Read(&slideInfo, loc, sizeof(slideInfo));
+						delta = slideInfo.plain.offsetToNextPointer;
 
-							if (slideInfo.auth.authenticated)
-							{
-								uint64_t value = slideInfo.auth.offsetFromSharedCacheBase;
-								value += mapping.slideInfoV3.auth_value_add;
-								rewrites.emplace_back(loc, value);
-							}
-							else
-							{
-								uint64_t value51 = slideInfo.plain.pointerValue;
-								uint64_t top8Bits = value51 & 0x0007F80000000000;
-								uint64_t bottom43Bits = value51 & 0x000007FFFFFFFFFF;
-								uint64_t value = (uint64_t)top8Bits << 13 | bottom43Bits;
-								rewrites.emplace_back(loc, value);
-							}
+						if (slideInfo.auth.authenticated)
+						{
+							uint64_t value = slideInfo.auth.offsetFromSharedCacheBase;
+							value += mapping.slideInfoV3.auth_value_add;
+							pageRewrites.emplace_back(loc, value);
 						}
-						catch (MappingReadException& ex)
+						else
 						{
-							m_logger->LogError("Failed to read v3 slide pointer at 0x%llx\n", loc);
-							break;
+							uint64_t value51 = slideInfo.plain.pointerValue;
+							uint64_t top8Bits = value51 & 0x0007F80000000000;
+							uint64_t bottom43Bits = value51 & 0x000007FFFFFFFFFF;
+							uint64_t value = (uint64_t)top8Bits << 13 | bottom43Bits;
+							pageRewrites.emplace_back(loc, value);
 						}
-					} while (delta != 0);
-				}
-				catch (MappingReadException& ex)
-				{
-					m_logger->LogError("Failed to read v3 slide info at 0x%llx\n", cursor);
-				}
+					}
+					catch (MappingReadException& ex)
+					{
+						m_logger->LogError("Failed to read v3 slide pointer at 0x%llx\n", loc);
+						break;
+					}
+				} while (delta != 0);
+			}
+			catch (MappingReadException& ex)
+			{
+				m_logger->LogError("Failed to read v3 slide info at 0x%llx\n", cursor);
 			}
 		}
 		else if (mapping.slideInfoVersion == 5)
 		{
 			pageStartsOffset += sizeof(dyld_cache_slide_info5);
-			pageStartCount = mapping.slideInfoV5.page_starts_count;
 			pageSize = mapping.slideInfoV5.page_size;
-			auto cursor = pageStartsOffset;
+			auto cursor = pageStartsOffset + (i * sizeof(uint16_t));
 
-			for (size_t i = 0; i < pageStartCount; i++)
+			try
 			{
-				try
-				{
-					uint16_t delta = mapping.file->ReadUShort(cursor);
-					cursor += sizeof(uint16_t);
-					if (delta == DYLD_CACHE_SLIDE_V5_PAGE_ATTR_NO_REBASE)
-						continue;
+				uint16_t delta = mapping.file->ReadUShort(cursor);
+				if (delta == DYLD_CACHE_SLIDE_V5_PAGE_ATTR_NO_REBASE)
+					return;
 
-					delta = delta/sizeof(uint64_t); // initial offset is byte based
-					uint64_t loc = mapping.mappingInfo.fileOffset + (pageSize * i);
-					do
+				delta = delta/sizeof(uint64_t); // initial offset is byte based
+				uint64_t loc = mapping.mappingInfo.fileOffset + (pageSize * i);
+				do
+				{
+					loc += delta * sizeof(dyld_cache_slide_pointer5);
+					try
 					{
-						loc += delta * sizeof(dyld_cache_slide_pointer5);
-						try
+						dyld_cache_slide_pointer5 slideInfo;
+						file->Read(&slideInfo, loc, sizeof(slideInfo));
+						delta = slideInfo.regular.next;
+						if (slideInfo.auth.auth)
 						{
-							dyld_cache_slide_pointer5 slideInfo;
-							file->Read(&slideInfo, loc, sizeof(slideInfo));
-							delta = slideInfo.regular.next;
-							if (slideInfo.auth.auth)
-							{
-								uint64_t value = mapping.slideInfoV5.value_add + slideInfo.auth.runtimeOffset;
-								rewrites.emplace_back(loc, value);
-							}
-							else
-							{
-								uint64_t value = mapping.slideInfoV5.value_add + slideInfo.regular.runtimeOffset;
-								rewrites.emplace_back(loc, value);
-							}
+							uint64_t value = mapping.slideInfoV5.value_add + slideInfo.auth.runtimeOffset;
+							pageRewrites.emplace_back(loc, value);
 						}
-						catch (MappingReadException& ex)
+						else
 						{
-							m_logger->LogError("Failed to read v5 slide pointer at 0x%llx\n", loc);
-							break;
+							uint64_t value = mapping.slideInfoV5.value_add + slideInfo.regular.runtimeOffset;
+							pageRewrites.emplace_back(loc, value);
 						}
-					} while (delta != 0);
-				}
-				catch (MappingReadException& ex)
-				{
-					m_logger->LogError("Failed to read v5 slide info at 0x%llx\n", cursor);
-				}
+					}
+					catch (MappingReadException& ex)
+					{
+						m_logger->LogError("Failed to read v5 slide pointer at 0x%llx\n", loc);
+						break;
+					}
+				} while (delta != 0);
+			}
+			catch (MappingReadException& ex)
+			{
+				m_logger->LogError("Failed to read v5 slide info at 0x%llx\n", cursor);
 			}
 		}
+	};
+
+	// Split the pages of every mapping into fixed size chunks that workers pull from. Pages never share rewrite
+	// locations, so each worker can write its rewrites back as soon as a chunk is done.
+	struct PageChunk
+	{
+		size_t mapping;
+		size_t firstPage;
+		size_t lastPage;
+	};
+	constexpr size_t pagesPerChunk = 64;
+	std::vector<PageChunk> chunks;
+	size_t totalPages = 0;
+	for (size_t m = 0; m < mappings.size(); m++)
+	{
+		const auto& mapping = mappings[m].second;
+		m_logger->LogDebug("Slide Info Version: %d", mapping.slideInfoVersion);
+		uint64_t pageStartCount = 0;
+		if (mapping.slideInfoVersion == 2)
+			pageStartCount = mapping.slideInfoV2.page_starts_count;
+		else if (mapping.slideInfoVersion == 3)
+			pageStartCount = mapping.slideInfoV3.page_starts_count;
+		else if (mapping.slideInfoVersion == 5)
+			pageStartCount = mapping.slideInfoV5.page_starts_count;
+		for (size_t page = 0; page < pageStartCount; page += pagesPerChunk)
+			chunks.push_back({m, page, std::min<size_t>(page + pagesPerChunk, pageStartCount)});
+		totalPages += pageStartCount;
 	}
-	for (const auto& [loc, value] : rewrites)
+
+	std::atomic<size_t> nextChunk = 0;
+	std::atomic<size_t> pagesDone = 0;
+	std::atomic<size_t> rewriteCount = 0;
+	std::mutex progressMutex;
+	auto worker = [&]()
 	{
-		file->WritePointer(loc, value);
+		std::vector<std::pair<uint64_t, uint64_t>> chunkRewrites;
+		for (size_t c = nextChunk++; c < chunks.size(); c = nextChunk++)
+		{
+			const auto& chunk = chunks[c];
+			const auto& [off, mapping] = mappings[chunk.mapping];
+			chunkRewrites.clear();
+			for (size_t i = chunk.firstPage; i < chunk.lastPage; i++)
+				rebasePage(off, mapping, i, chunkRewrites);
+
+			for (const auto& [loc, value] : chunkRewrites)
+				file->WritePointer(loc, value);
+			rewriteCount += chunkRewrites.size();
 #ifdef SLIDEINFO_DEBUG_TAGS
+			{
+				std::unique_lock<std::mutex> lock(progressMutex);
+				rewrites.insert(rewrites.end(), chunkRewrites.begin(), chunkRewrites.end());
+			}
+#endif
+
+			size_t done = pagesDone += chunk.lastPage - chunk.firstPage;
+			if (progress)
+			{
+				std::unique_lock<std::mutex> lock(progressMutex);
+				progress(file->Path(), done, totalPages);
+			}
+		}
+	};
+
+	size_t threadCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), chunks.size());
+	std::vector<std::thread> threads;
+	for (size_t t = 1; t < threadCount; t++)
+		threads.emplace_back(worker);
+	worker();
+	for (auto& thread : threads)
+		thread.join();
+
+#ifdef SLIDEINFO_DEBUG_TAGS
+	for (const auto& [loc, value] : rewrites)
+	{
 		uint64_t vmAddr = 0;
 		{
 			for (uint64_t off = baseHeader.mappingOffset; off < baseHeader.mappingOffset + baseHeader.mappingCount * sizeof(dyld_cache_mapping_info); off += sizeof(dyld_cache_mapping_info))
@@ -1372,10 +1595,50 @@ void SharedCache::ParseAndApplySlideInfoForFile(std::shared_ptr<MMappedFileAcces
 			type = m_dscView->GetTagType("slideinfo");
 		}
 		m_dscView->AddAutoDataTag(vmAddr, new Tag(type, "0x" + to_hex_string(file->ReadULong(loc)) + " => 0x" + to_hex_string(value)));
-#endif
 	}
-	m_logger->LogDebug("Applied slide info for %s (0x%llx rewrites)", file->Path().c_str(), rewrites.size());
+#endif
+
+	double elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+	m_logger->LogInfo("Applied slide info for %s (0x%llx rewrites across 0x%llx pages) in %.3f seconds on %zu threads",
+		file->Path().c_str(), (unsigned long long)rewriteCount.load(), (unsigned long long)totalPages, elapsed, threadCount);
 	file->SetSlideInfoWasApplied(true);
+
+	if (!rebasedCachePath.empty())
+	{
+		startTime = std::chrono::high_resolution_clock::now();
+		if (file->WriteRebasedCopy(rebasedCachePath, rebasedCacheKey))
+		{
+			elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+			m_logger->LogInfo("Saved rebased copy of %s to %s in %.3f seconds", file->Path().c_str(),
+				rebasedCachePath.c_str(), elapsed);
+		}
+		else
+		{
+			m_logger->LogWarn("Failed to save rebased copy of %s to %s", file->Path().c_str(), rebasedCachePath.c_str());
+		}
+	}
+}
+
+
+void SharedCache::ApplySlideInfoForAllFiles(const SlideInfoProgressCallback& progress)
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+	size_t fileCount = 0;
+	for (const auto& cache : State().backingCaches)
+	{
+		try
+		{
+			auto file = MMappedFileAccessor::Open(m_dscView, m_dscView->GetFile()->GetSessionId(), cache.path)->lock();
+			ParseAndApplySlideInfoForFile(file, progress);
+			fileCount++;
+		}
+		catch (...)
+		{
+			m_logger->LogError("Failed to apply slide info for %s", cache.path.c_str());
+		}
+	}
+	double elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+	m_logger->LogInfo("Applied slide info for %zu files in %.3f seconds", fileCount, elapsed);
 }
 
 
@@ -1461,66 +1724,59 @@ std::optional<uint64_t> SharedCache::GetImageStart(std::string installName)
 	return {};
 }
 
+const SharedCacheMachOHeader* SharedCache::FindHeaderForAddress(uint64_t address) const
+{
+	if (!State().addressIndex)
+		return nullptr;
+	auto key = State().addressIndex->headers.Find(address);
+	if (!key)
+		return nullptr;
+	if (auto it = State().headers.find(*key); it != State().headers.end())
+		return &it->second;
+	return nullptr;
+}
+
 std::optional<SharedCacheMachOHeader> SharedCache::HeaderForAddress(uint64_t address)
 {
-	// We _could_ mark each page with the image start? :grimacing emoji:
-	// But that'd require mapping pages :grimacing emoji: :grimacing emoji:
-	// There's not really any other hacks that could make this faster, that I can think of...
-	for (const auto& [start, header] : State().headers)
-	{
-		for (const auto& segment : header.segments)
-		{
-			if (segment.vmaddr <= address && segment.vmaddr + segment.vmsize > address)
-			{
-				return header;
-			}
-		}
-	}
+	if (auto header = FindHeaderForAddress(address))
+		return *header;
 	return {};
 }
 
 std::string SharedCache::NameForAddress(uint64_t address)
 {
-	for (const auto& stubIsland : State().stubIslandRegions)
-	{
-		if (stubIsland.start <= address && stubIsland.start + stubIsland.size > address)
-		{
-			return stubIsland.prettyName;
-		}
-	}
-	for (const auto& dyldData : State().dyldDataRegions)
-	{
-		if (dyldData.start <= address && dyldData.start + dyldData.size > address)
-		{
-			return dyldData.prettyName;
-		}
+	if (!State().addressIndex)
+		return "";
+	auto region = State().addressIndex->regions.Find(address);
+	if (!region)
+		return "";
+
+	switch (region->kind)
+	{
+	case AddressIndex::StubIsland:
+		return State().stubIslandRegions[region->index].prettyName;
+	case AddressIndex::DyldData:
+		return State().dyldDataRegions[region->index].prettyName;
+	case AddressIndex::NonImage:
+		return State().nonImageRegions[region->index].prettyName;
+	case AddressIndex::ImageSection:
+	{
+		auto it = State().headers.find(region->headerKey);
+		if (it == State().headers.end())
+			return "";
+		const auto& header = it->second;
+		char sectionName[17];
+		strncpy(sectionName, header.sections[region->index].sectname, 16);
+		sectionName[16] = '\0';
+		return header.identifierPrefix + "::" + sectionName;
 	}
-	for (const auto& nonImageRegion : State().nonImageRegions)
-	{
-		if (nonImageRegion.start <= address && nonImageRegion.start + nonImageRegion.size > address)
-		{
-			return nonImageRegion.prettyName;
-		}
-	}
-	if (auto header = HeaderForAddress(address))
-	{
-		for (const auto& section : header->sections)
-		{
-			if (section.addr <= address && section.addr + section.size > address)
-			{
-				char sectionName[17];
-				strncpy(sectionName, section.sectname, 16);
-				sectionName[16] = '\0';
-				return header->identifierPrefix + "::" + sectionName;
-			}
-		}
 	}
 	return "";
 }
 
 std::string SharedCache::ImageNameForAddress(uint64_t address)
 {
-	if (auto header = HeaderForAddress(address))
+	if (auto header = FindHeaderForAddress(address))
 	{
 		return header->identifierPrefix;
 	}
@@ -1529,15 +1785,11 @@ std::string SharedCache::ImageNameForAddress(uint64_t address)
 
 bool SharedCache::LoadImageContainingAddress(uint64_t address, bool skipObjC)
 {
-	for (const auto& [start, header] : State().headers)
+	if (auto header = FindHeaderForAddress(address))
 	{
-		for (const auto& segment : header.segments)
-		{
-			if (segment.vmaddr <= address && segment.vmaddr + segment.vmsize > address)
-			{
-				return LoadImageWithInstallName(header.installName, skipObjC);
-			}
-		}
+		// Copy the name, loading the image replaces the state `header` points into.
+		std::string installName = header->installName;
+		return LoadImageWithInstallName(installName, skipObjC);
 	}
 
 	return false;
@@ -2594,6 +2846,7 @@ void SharedCache::InitializeHeader(
 		memset(&sym, 0, sizeof(sym));
 		auto N_TYPE = 0xE;	// idk
 		std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>> symbolInfos;
+		auto sectionFlags = SectionFlagsForHeader(header);
 		for (size_t i = 0; i < header.symtab.nsyms; i++)
 		{
 			reader->Read(&sym, header.symtab.symoff + i * sizeof(nlist_64), sizeof(nlist_64));
@@ -2606,7 +2859,6 @@ void SharedCache::InitializeHeader(
 				continue;
 
 			BNSymbolType type = DataSymbol;
-			uint32_t flags;
 			if ((sym.n_type & N_TYPE) == N_SECT && sym.n_sect > 0 && (size_t)(sym.n_sect - 1) < header.sections.size())
 			{}
 			else if ((sym.n_type & N_TYPE) == N_ABS)
@@ -2618,25 +2870,8 @@ void SharedCache::InitializeHeader(
 			else
 				continue;
 
-			for (auto s : header.sections)
-			{
-				if (s.addr < sym.n_value)
-				{
-					if (s.addr + s.size > sym.n_value)
-					{
-						flags = s.flags;
-					}
-				}
-			}
-
 			if (type != ExternalSymbol)
-			{
-				if ((flags & S_ATTR_PURE_INSTRUCTIONS) == S_ATTR_PURE_INSTRUCTIONS
-					|| (flags & S_ATTR_SOME_INSTRUCTIONS) == S_ATTR_SOME_INSTRUCTIONS)
-					type = FunctionSymbol;
-				else
-					type = DataSymbol;
-			}
+				type = SymbolTypeForAddress(sectionFlags, sym.n_value);
 			if ((sym.n_desc & N_ARM_THUMB_DEF) == N_ARM_THUMB_DEF)
 				sym.n_value++;
 
@@ -2661,18 +2896,27 @@ void SharedCache::InitializeHeader(
 			symbolInfos.push_back({sym.n_value, {type, symbol}});
 		}
 		MutableState().symbolInfos[header.textBase] = symbolInfos;
+		MutableState().dirtySymbolRecords.insert(header.textBase);
 	}
 
 	if (header.exportTriePresent && header.linkeditPresent && vm->AddressIsMapped(header.linkeditSegment.vmaddr))
 	{
-		auto symbols = SharedCache::ParseExportTrie(vm->MappingAtAddress(header.linkeditSegment.vmaddr).first.fileAccessor->lock(), header);
+		auto exports = SharedCache::ParseExportTrie(vm->MappingAtAddress(header.linkeditSegment.vmaddr).first.fileAccessor->lock(), header);
 		std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>> exportMapping;
-		for (const auto& symbol : symbols)
-		{
-			exportMapping.push_back({symbol->GetAddress(), {symbol->GetType(), symbol->GetRawName()}});
+		exportMapping.reserve(exports.GetCount());
+		ForEachExport(header, exports, [&](const ExportTrie::Entry& entry, uint64_t address, BNSymbolType symbolType) {
+			std::string name = exports.GetName(entry);
+
+			// TODO: The usual `Symbol` constructors take a `NameSpace` and do unnecessary memory allocations
+			// to pass its fields down to the core API. Here we pass nullptr for the namespace which is treated
+			// the same, but avoids the memory allocations. Switch back to directly constructing a `Symbol`
+			// once it gains constructors without that overhead.
+			Ref<Symbol> symbol = new Symbol(BNCreateSymbol(symbolType, name.c_str(), name.c_str(),
+				name.c_str(), address, NoBinding, nullptr, 0));
+
 			if (typeLib)
 			{
-				auto type = m_dscView->ImportTypeLibraryObject(typeLib, {symbol->GetFullName()});
+				auto type = m_dscView->ImportTypeLibraryObject(typeLib, {name});
 
 				if (type)
 				{
@@ -2681,17 +2925,16 @@ void SharedCache::InitializeHeader(
 				else
 					view->DefineAutoSymbol(symbol);
 
-				if (view->GetAnalysisFunction(view->GetDefaultPlatform(), symbol->GetAddress()))
+				if (auto func = view->GetAnalysisFunction(view->GetDefaultPlatform(), address))
 				{
-					auto func = view->GetAnalysisFunction(view->GetDefaultPlatform(), symbol->GetAddress());
-					if (symbol->GetFullName() == "_objc_msgSend")
+					if (name == "_objc_msgSend")
 					{
 						func->SetHasVariableArguments(false);
 					}
-					else if (symbol->GetFullName().find("_objc_retain_x") != std::string::npos || symbol->GetFullName().find("_objc_release_x") != std::string::npos)
+					else if (name.find("_objc_retain_x") != std::string::npos || name.find("_objc_release_x") != std::string::npos)
 					{
-						auto x = symbol->GetFullName().rfind("x");
-						auto num = symbol->GetFullName().substr(x + 1);
+						auto x = name.rfind("x");
+						auto num = name.substr(x + 1);
 
 						std::vector<BinaryNinja::FunctionParameter> callTypeParams;
 						auto cc = m_dscView->GetDefaultArchitecture()->GetCallingConventionByName("apple-arm64-objc-fast-arc-" + num);
@@ -2705,8 +2948,11 @@ void SharedCache::InitializeHeader(
 			}
 			else
 				view->DefineAutoSymbol(symbol);
-		}
+
+			exportMapping.push_back({address, {symbolType, std::move(name)}});
+		});
 		MutableState().exportInfos[header.textBase] = std::move(exportMapping);
+		MutableState().dirtyExportRecords.insert(header.textBase);
 	}
 	view->EndBulkModifySymbols();
 
@@ -2717,76 +2963,7 @@ void SharedCache::InitializeHeader(
 }
 
 
-void SharedCache::ReadExportNode(std::vector<Ref<Symbol>>& symbolList, const SharedCacheMachOHeader& header,
-	const uint8_t* begin, const uint8_t* end, const uint8_t* current, uint64_t textBase, const std::string& currentText)
-{
-	if (current >= end)
-		throw ReadException();
-
-	uint64_t terminalSize = readValidULEB128(current, end);
-	const uint8_t* child = current + terminalSize;
-	if (terminalSize != 0) {
-		uint64_t imageOffset = 0;
-		uint64_t flags = readValidULEB128(current, end);
-		if (!(flags & EXPORT_SYMBOL_FLAGS_REEXPORT))
-		{
-			imageOffset = readValidULEB128(current, end);
-			if (!currentText.empty() && textBase + imageOffset)
-			{
-				uint32_t flags;
-				BNSymbolType type;
-				for (auto s : header.sections)
-				{
-					if (s.addr < textBase + imageOffset)
-					{
-						if (s.addr + s.size > textBase + imageOffset)
-						{
-							flags = s.flags;
-							break;
-						}
-					}
-				}
-				if ((flags & S_ATTR_PURE_INSTRUCTIONS) == S_ATTR_PURE_INSTRUCTIONS
-					|| (flags & S_ATTR_SOME_INSTRUCTIONS) == S_ATTR_SOME_INSTRUCTIONS)
-					type = FunctionSymbol;
-				else
-					type = DataSymbol;
-
-#if EXPORT_TRIE_DEBUG
-					// BNLogInfo("export: %s -> 0x%llx", n.text.c_str(), image.baseAddress + n.offset);
-#endif
-				// TODO: The usual `Symbol` constructors take a `NameSpace` and do unnecessary memory allocations
-				// to pass its fields down to the core API. Here we pass nullptr for the namespace which is treated
-				// the same, but avoids the memory allocations. Switch back to directly constructing a `Symbol`
-				// once it gains constructors without that overhead.
-				auto symbol = new Symbol(BNCreateSymbol(type, currentText.c_str(), currentText.c_str(),
-					currentText.c_str(), textBase + imageOffset, NoBinding, nullptr, 0));
-				symbolList.push_back(symbol);
-			}
-		}
-	}
-	current = child;
-	uint8_t childCount = *current++;
-	std::string childText = currentText;
-	for (uint8_t i = 0; i < childCount; ++i)
-	{
-		if (current >= end)
-			throw ReadException();
-		auto it = std::find(current, end, 0);
-		childText.append(current, it);
-		current = it + 1;
-		if (current >= end)
-			throw ReadException();
-		auto next = readValidULEB128(current, end);
-		if (next == 0)
-			throw ReadException();
-		ReadExportNode(symbolList, header, begin, end, begin + next, textBase, childText);
-		childText.resize(currentText.size());
-	}
-}
-
-
-std::vector<Ref<Symbol>> SharedCache::ParseExportTrie(std::shared_ptr<MMappedFileAccessor> linkeditFile, const SharedCacheMachOHeader& header)
+ExportTrie SharedCache::ParseExportTrie(std::shared_ptr<MMappedFileAccessor> linkeditFile, const SharedCacheMachOHeader& header)
 {
 	if (!header.exportTrie.datasize) {
 		return {};
@@ -2794,10 +2971,8 @@ std::vector<Ref<Symbol>> SharedCache::ParseExportTrie(std::shared_ptr<MMappedFil
 
 	try
 	{
-		std::vector<Ref<Symbol>> symbols;
 		auto [begin, end] = linkeditFile->ReadSpan(header.exportTrie.dataoff, header.exportTrie.datasize);
-		ReadExportNode(symbols, header, begin, end, begin, header.textBase, "");
-		return symbols;
+		return ExportTrie::Parse(begin, end);
 	}
 	catch (std::exception& e)
 	{
@@ -2817,38 +2992,99 @@ std::vector<std::string> SharedCache::GetAvailableImages()
 }
 
 
-std::vector<std::pair<std::string, Ref<Symbol>>> SharedCache::LoadAllSymbolsAndWait()
+std::vector<ImageExports> SharedCache::LoadAllSymbolsAndWait()
 {
 	WillMutateState();
 
 	std::lock_guard initialLoadBlock(m_viewSpecificState->viewOperationsThatInfluenceMetadataMutex);
 
-	std::vector<std::pair<std::string, Ref<Symbol>>> symbols;
+	struct PendingImage
+	{
+		const CacheImage* image;
+		const SharedCacheMachOHeader* header;
+		bool loaded;
+		ExportTrie exports;
+	};
+
+	std::vector<PendingImage> work;
+	work.reserve(State().images.size());
 	for (const auto& img : State().images)
 	{
-		auto header = HeaderForAddress(img.headerLocation);
-		std::shared_ptr<MMappedFileAccessor> mapping;
-		try {
-			mapping = MMappedFileAccessor::Open(m_dscView, m_dscView->GetFile()->GetSessionId(), header->exportTriePath)->lock();
-		}
-		catch (...)
+		if (auto header = FindHeaderForAddress(img.headerLocation))
+			work.push_back({&img, header, false, {}});
+	}
+
+	size_t threadCount = std::thread::hardware_concurrency();
+	auto settings = m_dscView->GetLoadSettings(VIEW_NAME);
+	if (settings && settings->Contains("loader.dsc.exportTrieParsingThreads"))
+	{
+		if (auto requested = settings->Get<uint64_t>("loader.dsc.exportTrieParsingThreads", m_dscView))
+			threadCount = requested;
+	}
+	threadCount = std::max<size_t>(1, std::min(threadCount, work.size()));
+
+	// Each trie is independent and only read from, so workers pull the next unparsed image until none are left.
+	// Results are written to the image's own slot and merged below in image order, keeping the output identical
+	// to parsing serially. Each worker only holds the linkedit file of the image it is parsing, so the file accessor
+	// pool can still evict between images and the file pointer budget holds however many threads there are.
+	std::atomic<size_t> nextImage = 0;
+	uint64_t sessionID = m_dscView->GetFile()->GetSessionId();
+	auto parseImages = [&]() {
+		for (size_t i = nextImage++; i < work.size(); i = nextImage++)
 		{
-			m_logger->LogWarn("Serious Error: Failed to open export trie %s for %s", header->exportTriePath.c_str(), header->installName.c_str());
-			continue;
+			auto& item = work[i];
+			std::shared_ptr<MMappedFileAccessor> linkeditFile;
+			try {
+				linkeditFile = MMappedFileAccessor::Open(m_dscView, sessionID, item.header->exportTriePath)->lock();
+			}
+			catch (...)
+			{
+				m_logger->LogWarn("Serious Error: Failed to open export trie %s for %s", item.header->exportTriePath.c_str(), item.header->installName.c_str());
+				continue;
+			}
+			item.exports = ParseExportTrie(linkeditFile, *item.header);
+			item.loaded = true;
 		}
-		auto exportList = SharedCache::ParseExportTrie(mapping, *header);
+	};
+
+	auto start = std::chrono::high_resolution_clock::now();
+	if (threadCount == 1)
+	{
+		parseImages();
+	}
+	else
+	{
+		std::vector<std::thread> workers;
+		workers.reserve(threadCount - 1);
+		for (size_t i = 1; i < threadCount; i++)
+			workers.emplace_back(parseImages);
+		parseImages();
+		for (auto& worker : workers)
+			worker.join();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+	m_logger->LogInfo("Parsed export tries for %zu images in %.3f seconds using %zu threads", work.size(), elapsed.count(), threadCount);
+
+	std::vector<ImageExports> result;
+	result.reserve(work.size());
+	for (auto& item : work)
+	{
+		if (!item.loaded)
+			continue;
+
 		std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>> exportMapping;
-		for (const auto& sym : exportList)
-		{
-			exportMapping.push_back({sym->GetAddress(), {sym->GetType(), sym->GetRawName()}});
-			symbols.push_back({img.installName, sym});
-		}
-		MutableState().exportInfos[header->textBase] = std::move(exportMapping);
+		exportMapping.reserve(item.exports.GetCount());
+		ForEachExport(*item.header, item.exports, [&](const ExportTrie::Entry& entry, uint64_t address, BNSymbolType type) {
+			exportMapping.push_back({address, {type, item.exports.GetName(entry)}});
+		});
+		MutableState().exportInfos[item.header->textBase] = std::move(exportMapping);
+		MutableState().dirtyExportRecords.insert(item.header->textBase);
+		result.push_back({item.image->installName, item.header->textBase, std::move(item.exports)});
 	}
 
 	SaveToDSCView();
 
-	return symbols;
+	return result;
 }
 
 
@@ -2935,46 +3171,49 @@ void SharedCache::FindSymbolAtAddrAndApplyToAddr(
 			m_logger->LogWarn("Serious Error: Failed to open export trie for %s", header->installName.c_str());
 			return;
 		}
-		auto exportList = SharedCache::ParseExportTrie(mapping, *header);
+		auto exports = SharedCache::ParseExportTrie(mapping, *header);
 		std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>> exportMapping;
+		exportMapping.reserve(exports.GetCount());
 		auto typeLib = TypeLibraryForImage(header->installName);
 		id = m_dscView->BeginUndoActions();
 		m_dscView->BeginBulkModifySymbols();
-		for (const auto& sym : exportList)
-		{
-			exportMapping.push_back({sym->GetAddress(), {sym->GetType(), sym->GetRawName()}});
-			if (sym->GetAddress() == symbolLocation)
+		bool applied = false;
+		ForEachExport(*header, exports, [&](const ExportTrie::Entry& entry, uint64_t address, BNSymbolType symbolType) {
+			exportMapping.push_back({address, {symbolType, exports.GetName(entry)}});
+			if (applied || address != symbolLocation)
+				return;
+			applied = true;
+
+			const std::string& name = exportMapping.back().second.second;
+			if (auto func = m_dscView->GetAnalysisFunction(m_dscView->GetDefaultPlatform(), targetLocation))
 			{
-				if (auto func = m_dscView->GetAnalysisFunction(m_dscView->GetDefaultPlatform(), targetLocation))
-				{
-					m_dscView->DefineUserSymbol(
-						new Symbol(FunctionSymbol, prefix + sym->GetFullName(), targetLocation));
+				m_dscView->DefineUserSymbol(
+					new Symbol(FunctionSymbol, prefix + name, targetLocation));
 
-					if (typeLib)
-						if (auto type = m_dscView->ImportTypeLibraryObject(typeLib, {sym->GetFullName()}))
-							func->SetUserType(type);
-				}
-				else
-				{
-					m_dscView->DefineUserSymbol(
-						new Symbol(sym->GetType(), prefix + sym->GetFullName(), targetLocation));
+				if (typeLib)
+					if (auto type = m_dscView->ImportTypeLibraryObject(typeLib, {name}))
+						func->SetUserType(type);
+			}
+			else
+			{
+				m_dscView->DefineUserSymbol(
+					new Symbol(symbolType, prefix + name, targetLocation));
 
-					if (typeLib)
-						if (auto type = m_dscView->ImportTypeLibraryObject(typeLib, {sym->GetFullName()}))
-							m_dscView->DefineUserDataVariable(targetLocation, type);
-				}
-				if (triggerReanalysis)
-				{
-					auto func = m_dscView->GetAnalysisFunction(m_dscView->GetDefaultPlatform(), targetLocation);
-					if (func)
-						func->Reanalyze();
-				}
-				break;
+				if (typeLib)
+					if (auto type = m_dscView->ImportTypeLibraryObject(typeLib, {name}))
+						m_dscView->DefineUserDataVariable(targetLocation, type);
 			}
-		}
+			if (triggerReanalysis)
+			{
+				auto func = m_dscView->GetAnalysisFunction(m_dscView->GetDefaultPlatform(), targetLocation);
+				if (func)
+					func->Reanalyze();
+			}
+		});
 		{
 			std::lock_guard lock(m_viewSpecificState->viewOperationsThatInfluenceMetadataMutex);
 			MutableState().exportInfos[header->textBase] = std::move(exportMapping);
+			MutableState().dirtyExportRecords.insert(header->textBase);
 		}
 		m_dscView->EndBulkModifySymbols();
 		m_dscView->ForgetUndoActions(id);
@@ -2982,11 +3221,134 @@ void SharedCache::FindSymbolAtAddrAndApplyToAddr(
 }
 
 
+static void SerializeHeaders(SerializationContext& context, const std::unordered_map<uint64_t, SharedCacheMachOHeader>& headers)
+{
+	context.writer.StartObject();
+	Serialize(context, "headers");
+	context.writer.StartArray();
+	for (auto& [k, v] : headers)
+	{
+		context.writer.StartObject();
+		v.Store(context);
+		context.writer.EndObject();
+	}
+	context.writer.EndArray();
+	context.writer.EndObject();
+}
+
+static void SerializeSymbolList(SerializationContext& context, uint64_t imageBase,
+	const std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>>& symbols)
+{
+	context.writer.StartObject();
+	Serialize(context, "key", imageBase);
+	Serialize(context, "value");
+	context.writer.StartArray();
+	for (const auto& pair2 : symbols)
+	{
+		context.writer.StartObject();
+		Serialize(context, "key", pair2.first);
+		Serialize(context, "val1", pair2.second.first);
+		Serialize(context, "val2", pair2.second.second);
+		context.writer.EndObject();
+	}
+	context.writer.EndArray();
+	context.writer.EndObject();
+}
+
+
+static void DeserializeSymbolList(const rapidjson::Value& list,
+	std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>>& symbols)
+{
+	for (const auto& si : list["value"].GetArray())
+	{
+		symbols.push_back({si["key"].GetUint64(),
+			{static_cast<BNSymbolType>(si["val1"].GetUint64()), si["val2"].GetString()}});
+	}
+}
+
+
+static bool DeserializeSymbolList(const Ref<Metadata>& record,
+	std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>>& symbols)
+{
+	DeserializationContext context;
+	if (!context.ParseMetadata(record) || !context.doc.IsObject() || !context.doc.HasMember("value"))
+		return false;
+
+	DeserializeSymbolList(context.doc, symbols);
+	return true;
+}
+
+
+bool SharedCache::LoadExportRecord(Ref<BinaryView> view, uint64_t imageBase,
+	std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>>& exports)
+{
+	return DeserializeSymbolList(view->QueryMetadata(SharedCacheExportsMetadataTag(imageBase)), exports);
+}
+
+
+void SharedCache::SaveDirtyRecords(SerializationFormat format)
+{
+	auto& state = *m_state;
+	auto store = [&](const std::string& key, const Ref<Metadata>& data) {
+		m_dscView->StoreMetadata(key, data);
+		m_dscView->GetParentView()->StoreMetadata(key, data);
+	};
+
+	size_t written = 0;
+	if (state.headersDirty)
+	{
+		SerializationContext context(format);
+		SerializeHeaders(context, state.headers);
+		store(SharedCacheHeadersMetadataTag, context.TakeMetadata());
+		state.headersDirty = false;
+		written++;
+	}
+
+	for (uint64_t imageBase : state.dirtyExportRecords)
+	{
+		SerializationContext context(format);
+		SerializeSymbolList(context, imageBase, state.exportInfos[imageBase]);
+		store(SharedCacheExportsMetadataTag(imageBase), context.TakeMetadata());
+		state.persistedExportRecords.insert(imageBase);
+		written++;
+	}
+	state.dirtyExportRecords.clear();
+
+	for (uint64_t imageBase : state.dirtySymbolRecords)
+	{
+		SerializationContext context(format);
+		SerializeSymbolList(context, imageBase, state.symbolInfos[imageBase]);
+		store(SharedCacheSymbolsMetadataTag(imageBase), context.TakeMetadata());
+		state.persistedSymbolRecords.insert(imageBase);
+		written++;
+	}
+	state.dirtySymbolRecords.clear();
+
+	if (written)
+		m_logger->LogDebug("Saved %zu changed Shared Cache metadata records", written);
+}
+
+
 bool SharedCache::SaveToDSCView()
 {
 	if (m_dscView)
 	{
-		auto data = AsMetadata();
+		// JSON is much larger and slower to write and parse, but is useful when inspecting a database by hand.
+		auto format = SerializationFormat::Binary;
+		auto settings = m_dscView->GetLoadSettings(VIEW_NAME);
+		if (settings && settings->Contains("loader.dsc.serializeMetadataAsJson")
+			&& settings->Get<bool>("loader.dsc.serializeMetadataAsJson", m_dscView))
+			format = SerializationFormat::Json;
+
+		// A shared state was already saved and can't have changed since.
+		if (!m_stateIsShared)
+		{
+			m_state->addressIndex = BuildAddressIndex(*m_state);
+			SaveDirtyRecords(format);
+		}
+
+		// Written after the records it refers to.
+		auto data = AsMetadata(format);
 		m_dscView->StoreMetadata(SharedCacheMetadataTag, data);
 		m_dscView->GetParentView()->StoreMetadata(SharedCacheMetadataTag, data);
 
@@ -3014,6 +3376,8 @@ std::vector<MemoryRegion> SharedCache::GetMappedRegions() const
 
 bool SharedCache::IsMemoryMapped(uint64_t address)
 {
+	if (State().addressIndex && State().addressIndex->mappedRegions.Contains(address))
+		return true;
 	return m_dscView->IsValidOffset(address);
 }
 
@@ -3121,15 +3485,26 @@ extern "C"
 		if (cache->object)
 		{
 			auto value = cache->object->LoadAllSymbolsAndWait();
-			*count = value.size();
+			size_t total = 0;
+			for (const auto& image : value)
+				total += image.exports.GetCount();
 
-			BNDSCSymbolRep* symbols = (BNDSCSymbolRep*)malloc(sizeof(BNDSCSymbolRep) * value.size());
-			for (size_t i = 0; i < value.size(); i++)
+			BNDSCSymbolRep* symbols = (BNDSCSymbolRep*)malloc(sizeof(BNDSCSymbolRep) * total);
+			size_t i = 0;
+			for (const auto& image : value)
 			{
-				symbols[i].address = value[i].second->GetAddress();
-				symbols[i].name = BNAllocString(value[i].second->GetRawName().c_str());
-				symbols[i].image = BNAllocString(value[i].first.c_str());
+				for (const auto& entry : image.exports.GetEntries())
+				{
+					uint64_t address = image.textBase + entry.imageOffset;
+					if (!address)
+						continue;
+					symbols[i].address = address;
+					symbols[i].name = BNAllocString(image.exports.GetName(entry));
+					symbols[i].image = BNAllocString(image.installName.c_str());
+					i++;
+				}
 			}
+			*count = i;
 			return symbols;
 		}
 		*count = 0;
@@ -3347,7 +3722,11 @@ extern "C"
 	BNDSCMemoryUsageInfo BNDSCViewGetMemoryUsageInfo()
 	{
 		BNDSCMemoryUsageInfo info;
-		info.mmapRefs = mmapCount.load();
+		auto pool = MMappedFileAccessor::PoolStatistics();
+		info.mmapRefs = pool.openFiles;
+		info.mmapHits = pool.hits;
+		info.mmapMisses = pool.misses;
+		info.mmapEvictions = pool.evictions;
 		info.sharedCacheRefs = sharedCacheReferences.load();
 		return info;
 	}
@@ -3419,57 +3798,11 @@ void SharedCache::Store(SerializationContext& context) const
     Serialize(context, "m_imageStarts", State().imageStarts);
     Serialize(context, "m_baseFilePath", State().baseFilePath);
 
-	Serialize(context, "headers");
-	context.writer.StartArray();
-	for (auto& [k, v] : State().headers)
-	{
-		context.writer.StartObject();
-		v.Store(context);
-		context.writer.EndObject();
-	}
-	context.writer.EndArray();
-
-	Serialize(context, "exportInfos");
-	context.writer.StartArray();
-	for (const auto& pair1 : State().exportInfos)
-	{
-		context.writer.StartObject();
-		Serialize(context, "key", pair1.first);
-		Serialize(context, "value");
-		context.writer.StartArray();
-		for (const auto& pair2 : pair1.second)
-		{
-			context.writer.StartObject();
-			Serialize(context, "key", pair2.first);
-			Serialize(context, "val1", pair2.second.first);
-			Serialize(context, "val2", pair2.second.second);
-			context.writer.EndObject();
-		}
-		context.writer.EndArray();
-		context.writer.EndObject();
-	}
-	context.writer.EndArray();
-
-	Serialize(context, "symbolInfos");
-	context.writer.StartArray();
-	for (const auto& pair1 : State().symbolInfos)
-	{
-		context.writer.StartObject();
-		Serialize(context, "key", pair1.first);
-		Serialize(context, "value");
-		context.writer.StartArray();
-		for (const auto& pair2 : pair1.second)
-		{
-			context.writer.StartObject();
-			Serialize(context, "key", pair2.first);
-			Serialize(context, "val1", pair2.second.first);
-			Serialize(context, "val2", pair2.second.second);
-			context.writer.EndObject();
-		}
-		context.writer.EndArray();
-		context.writer.EndObject();
-	}
-	context.writer.EndArray();
+	// Headers, exports and symbols are stored under their own keys by `SaveToDSCView`.
+	Serialize(context, "exportRecords",
+		std::vector<uint64_t>(State().persistedExportRecords.begin(), State().persistedExportRecords.end()));
+	Serialize(context, "symbolRecords",
+		std::vector<uint64_t>(State().persistedSymbolRecords.begin(), State().persistedSymbolRecords.end()));
 
 	Serialize(context, "backingCaches", State().backingCaches);
 	Serialize(context, "stubIslands", State().stubIslandRegions);
@@ -3481,17 +3814,36 @@ void SharedCache::Store(SerializationContext& context) const
 
 void SharedCache::Load(DeserializationContext& context)
 {
-	if (context.doc.HasMember("metadataVersion"))
+	if (!context.doc.HasMember("metadataVersion"))
 	{
-		if (context.doc["metadataVersion"].GetUint() != METADATA_VERSION)
+		m_logger->LogError("Shared Cache metadata version missing");
+		return;
+	}
+
+	int version = context.doc["metadataVersion"].GetInt();
+	if (version != METADATA_VERSION && version != SharedCacheLegacyMetadataVersion)
+	{
+		m_logger->LogError("Shared Cache metadata version mismatch");
+		return;
+	}
+	bool legacy = version == SharedCacheLegacyMetadataVersion;
+
+	// Legacy metadata keeps the headers in the main document
+	DeserializationContext headersContext;
+	rapidjson::Document* headersDoc = &context.doc;
+	if (!legacy)
+	{
+		if (!headersContext.ParseMetadata(m_dscView->QueryMetadata(SharedCacheHeadersMetadataTag))
+			|| !headersContext.doc.IsObject())
 		{
-			m_logger->LogError("Shared Cache metadata version mismatch");
+			m_logger->LogError("Shared Cache metadata is missing image headers");
 			return;
 		}
+		headersDoc = &headersContext.doc;
 	}
-	else
+	if (!headersDoc->HasMember("headers"))
 	{
-		m_logger->LogError("Shared Cache metadata version missing");
+		m_logger->LogError("Shared Cache metadata is missing image headers");
 		return;
 	}
 
@@ -3501,7 +3853,7 @@ void SharedCache::Load(DeserializationContext& context)
 	MutableState().viewState = static_cast<DSCViewState>(context.load<uint8_t>("m_viewState"));
 	MutableState().cacheFormat = static_cast<SharedCacheFormat>(context.load<uint8_t>("m_cacheFormat"));
 
-	for (auto& startAndHeader : context.doc["headers"].GetArray())
+	for (auto& startAndHeader : (*headersDoc)["headers"].GetArray())
 	{
 		SharedCacheMachOHeader header;
 		header.LoadFromValue(startAndHeader);
@@ -3511,29 +3863,43 @@ void SharedCache::Load(DeserializationContext& context)
 	Deserialize(context, "m_imageStarts", MutableState().imageStarts);
 	Deserialize(context, "m_baseFilePath", MutableState().baseFilePath);
 
-	for (const auto& obj1 : context.doc["exportInfos"].GetArray())
+	if (legacy)
 	{
-		std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>> innerVec;
-		for (const auto& obj2 : obj1["value"].GetArray())
+		// Everything is held in memory and marked dirty, so the next save writes it out as per-image records.
+		for (const auto& exports : context.doc["exportInfos"].GetArray())
 		{
-			std::pair<BNSymbolType, std::string> innerPair = {
-				(BNSymbolType)obj2["val1"].GetUint64(), obj2["val2"].GetString()};
-			innerVec.push_back({obj2["key"].GetUint64(), innerPair});
+			uint64_t imageBase = exports["key"].GetUint64();
+			DeserializeSymbolList(exports, MutableState().exportInfos[imageBase]);
+			MutableState().dirtyExportRecords.insert(imageBase);
 		}
-
-		MutableState().exportInfos[obj1["key"].GetUint64()] = std::move(innerVec);
+		for (const auto& symbols : context.doc["symbolInfos"].GetArray())
+		{
+			uint64_t imageBase = symbols["key"].GetUint64();
+			DeserializeSymbolList(symbols, MutableState().symbolInfos[imageBase]);
+			MutableState().dirtySymbolRecords.insert(imageBase);
+		}
+		m_logger->LogInfo("Shared Cache metadata will be upgraded from version %d on the next save", version);
 	}
-
-	for (auto& symbolInfo : context.doc["symbolInfos"].GetArray())
+	else
 	{
-		std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>>
-			symbolInfos;
-		for (auto& si : symbolInfo["value"].GetArray())
+		// Export lists stay in the view's metadata until they are needed, nothing reads symbol lists lazily.
+		std::vector<uint64_t> records;
+		Deserialize(context, "exportRecords", records);
+		MutableState().persistedExportRecords.insert(records.begin(), records.end());
+		records.clear();
+		Deserialize(context, "symbolRecords", records);
+		for (uint64_t imageBase : records)
 		{
-			symbolInfos.push_back({si["key"].GetUint64(),
-				{static_cast<BNSymbolType>(si["val1"].GetUint64()), si["val2"].GetString()}});
+			if (!DeserializeSymbolList(m_dscView->QueryMetadata(SharedCacheSymbolsMetadataTag(imageBase)),
+				MutableState().symbolInfos[imageBase]))
+			{
+				m_logger->LogWarn("Failed to load Shared Cache symbols for image at 0x%" PRIx64, imageBase);
+				MutableState().symbolInfos.erase(imageBase);
+				continue;
+			}
+			MutableState().persistedSymbolRecords.insert(imageBase);
 		}
-		MutableState().symbolInfos[symbolInfo["key"].GetUint64()] = std::move(symbolInfos);
+		MutableState().headersDirty = false;
 	}
 
 	for (auto& bcV : context.doc["backingCaches"].GetArray())
@@ -3578,6 +3944,8 @@ void SharedCache::Load(DeserializationContext& context)
 		MutableState().nonImageRegions.push_back(std::move(si));
 	}
 
+	MutableState().addressIndex = BuildAddressIndex(State());
+
 	m_metadataValid = true;
 }
 
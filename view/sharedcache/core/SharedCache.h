@@ -6,6 +6,7 @@
 #include "DSCView.h"
 #include "VM.h"
 #include "view/macho/machoview.h"
+#include "view/macho/exporttrie.h"
 #include "MetadataSerializable.hpp"
 #include "../api/sharedcachecore.h"
 
@@ -25,6 +26,24 @@ namespace SharedCacheCore {
 
 	const std::string SharedCacheMetadataTag = "SHAREDCACHE-SharedCacheData";
 
+	// The state is split across several metadata keys so that saving after loading an image only rewrites what that
+	// image changed. `SharedCacheMetadataTag` holds the rest of the state and lists which image records exist.
+	const std::string SharedCacheHeadersMetadataTag = SharedCacheMetadataTag + "-Headers";
+
+	inline std::string SharedCacheExportsMetadataTag(uint64_t imageBase)
+	{
+		return SharedCacheMetadataTag + "-Exports-" + std::to_string(imageBase);
+	}
+
+	inline std::string SharedCacheSymbolsMetadataTag(uint64_t imageBase)
+	{
+		return SharedCacheMetadataTag + "-Symbols-" + std::to_string(imageBase);
+	}
+
+	// Last metadata version that kept headers, exports and symbols in the `SharedCacheMetadataTag` document itself.
+	// Still accepted on load, the next save migrates it to per-image records.
+	constexpr int SharedCacheLegacyMetadataVersion = 4;
+
 	struct MemoryRegion : public MetadataSerializable<MemoryRegion>
 	{
 		std::string prettyName;
@@ -70,7 +89,11 @@ namespace SharedCacheCore {
 			context.writer.StartArray();
 			for (auto& region : regions)
 			{
-				Serialize(context, region.AsString());
+				// JSON keeps the historical nested string encoding, the binary format nests the object directly.
+				if (context.format == SerializationFormat::Json)
+					Serialize(context, region.AsString());
+				else
+					Serialize(context, region);
 			}
 			context.writer.EndArray();
 		}
@@ -84,7 +107,10 @@ namespace SharedCacheCore {
 			for (auto& region : bArr)
 			{
 				MemoryRegion r;
-				r.LoadFromString(region.GetString());
+				if (region.IsString())
+					r.LoadFromString(region.GetString());
+				else
+					r.LoadFromValue(region);
 				regions.push_back(r);
 			}
 		}
@@ -524,6 +550,15 @@ namespace SharedCacheCore {
 	};
 
 
+	// Exports parsed from a single image's export trie. Addresses are relative to `textBase`.
+	struct ImageExports
+	{
+		std::string installName;
+		uint64_t textBase;
+		ExportTrie exports;
+	};
+
+
 	class ScopedVMMapSession;
 
 	static std::atomic<uint64_t> sharedCacheReferences = 0;
@@ -567,6 +602,8 @@ namespace SharedCacheCore {
 
 		struct ViewSpecificState;
 
+		struct AddressIndex;
+
 	private:
 		Ref<Logger> m_logger;
 		/* VIEW STATE BEGIN -- SERIALIZE ALL OF THIS AND STORE IT IN RAW VIEW */
@@ -590,15 +627,27 @@ namespace SharedCacheCore {
 	private:
 		void PerformInitialLoad();
 		void DeserializeFromRawView();
+		void SaveDirtyRecords(SerializationFormat format);
 
 	public:
 		std::shared_ptr<VM> GetVMMap(bool mapPages = true);
 
 		static SharedCache* GetFromDSCView(BinaryNinja::Ref<BinaryNinja::BinaryView> dscView);
 		static uint64_t FastGetBackingCacheCount(BinaryNinja::Ref<BinaryNinja::BinaryView> dscView);
+		// Stores the state in the view's metadata. Only the per-image records changed since the last save are
+		// rewritten, along with the manifest under `SharedCacheMetadataTag`.
 		bool SaveToDSCView();
+		// Reads an image's export list from the per-image record written by `SaveToDSCView`.
+		static bool LoadExportRecord(BinaryNinja::Ref<BinaryNinja::BinaryView> view, uint64_t imageBase,
+			std::vector<std::pair<uint64_t, std::pair<BNSymbolType, std::string>>>& exports);
+
+		// Called with the path of the file being rebased and the number of its slid pages processed so far.
+		// May be called from any of the worker threads, but never concurrently.
+		using SlideInfoProgressCallback = std::function<void(const std::string& path, size_t pagesDone, size_t pagesTotal)>;
 
-		void ParseAndApplySlideInfoForFile(std::shared_ptr<MMappedFileAccessor> file);
+		void ParseAndApplySlideInfoForFile(std::shared_ptr<MMappedFileAccessor> file, const SlideInfoProgressCallback& progress = nullptr);
+		// Rebases every backing cache file up front instead of on first use.
+		void ApplySlideInfoForAllFiles(const SlideInfoProgressCallback& progress = nullptr);
 		std::optional<uint64_t> GetImageStart(std::string installName);
 		std::optional<SharedCacheMachOHeader> HeaderForAddress(uint64_t);
 		bool LoadImageWithInstallName(std::string installName, bool skipObjC);
@@ -613,7 +662,7 @@ namespace SharedCacheCore {
 		std::vector<MemoryRegion> GetMappedRegions() const;
 		bool IsMemoryMapped(uint64_t address);
 
-		std::vector<std::pair<std::string, Ref<Symbol>>> LoadAllSymbolsAndWait();
+		std::vector<ImageExports> LoadAllSymbolsAndWait();
 
 		const std::unordered_map<std::string, uint64_t>& AllImageStarts() const;
 		const std::unordered_map<uint64_t, SharedCacheMachOHeader>& AllImageHeaders() const;
@@ -633,13 +682,12 @@ namespace SharedCacheCore {
 		size_t GetObjCRelativeMethodBaseAddress(const VMReader& reader) const;
 
 private:
+		const SharedCacheMachOHeader* FindHeaderForAddress(uint64_t address) const;
 		std::optional<SharedCacheMachOHeader> LoadHeaderForAddress(
 			std::shared_ptr<VM> vm, uint64_t address, std::string installName);
 		void InitializeHeader(
 			Ref<BinaryView> view, VM* vm, const SharedCacheMachOHeader& header, std::vector<MemoryRegion*> regionsToLoad);
-		void ReadExportNode(std::vector<Ref<Symbol>>& symbolList, const SharedCacheMachOHeader& header, const uint8_t* begin,
-			const uint8_t *end, const uint8_t* current, uint64_t textBase, const std::string& currentText);
-		std::vector<Ref<Symbol>> ParseExportTrie(
+		ExportTrie ParseExportTrie(
 			std::shared_ptr<MMappedFileAccessor> linkeditFile, const SharedCacheMachOHeader& header);
 
 		Ref<TypeLibrary> TypeLibraryForImage(const std::string& installName);
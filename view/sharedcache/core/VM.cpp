@@ -19,6 +19,8 @@
 			- As soon as that lock is released, that file pointer MAY be freed if another thread wants to open a new one, and we are at our limit.
 			- Calling .lock() again on this same theoretical object will then wait for another file pointer to be freeable.
 
+		Which files stay open is decided by the FileAccessorPool below.
+
 	VM Implementation:
 
 
@@ -34,11 +36,16 @@
 
 
 #include "VM.h"
+#include <algorithm>
+#include <iterator>
+#include <set>
 #include <utility>
 #include <memory>
 #include <cstring>
+#include <cinttypes>
 #include <stdio.h>
 #include <filesystem>
+#include <random>
 #include <binaryninjaapi.h>
 
 #ifdef _MSC_VER
@@ -50,14 +57,156 @@
 	#include <sys/resource.h>
 #endif
 
-void VMShutdown()
+static VMBackend defaultVMBackend = VMBackend::PageTable;
+
+
+/*
+	Every mapped file uses one of `limit` file pointer slots. The pool keeps a reference to the files it has opened so
+	they stay mapped, and rebased, between uses, and picks which one to let go of when a new file needs a slot.
+
+	Eviction is CLOCK with a small saturating use counter per file: `LazyMappedFileAccessor::lock` bumps the counter and
+	the hand decrements counters as it sweeps, evicting the first file whose counter is already zero. Files that are
+	pinned, or still referenced outside the pool, are skipped since dropping them wouldn't free a slot.
+*/
+class FileAccessorPool
 {
-	std::unique_lock<std::mutex> lock2(fileAccessorsMutex);
-	std::unique_lock<std::mutex> lock(fileAccessorDequeMutex);
+	static constexpr uint8_t MaxUses = 3;
+
+	struct Entry
+	{
+		std::shared_ptr<MMappedFileAccessor> accessor;
+		uint64_t sessionID;
+	};
+
+	std::mutex m_mutex;
+	std::vector<Entry> m_entries;
+	size_t m_hand = 0;
+	std::set<uint64_t> m_blockedSessionIDs;
+
+	counting_semaphore m_slots {0};
+
+	// Returns false if every file in the pool is pinned or in use.
+	bool EvictOne()
+	{
+		std::shared_ptr<MMappedFileAccessor> victim;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			// Every full sweep decrements each counter, so MaxUses + 1 sweeps visit every evictable file at zero.
+			size_t steps = m_entries.size() * (MaxUses + 1);
+			for (size_t i = 0; i < steps; i++)
+			{
+				if (m_hand >= m_entries.size())
+					m_hand = 0;
+				Entry& entry = m_entries[m_hand];
+				MMappedFileAccessor& accessor = *entry.accessor;
+				if (accessor.m_pinCount.load() != 0 || entry.accessor.use_count() > 1)
+				{
+					m_hand++;
+					continue;
+				}
+				uint8_t uses = accessor.m_poolUses.load(std::memory_order_relaxed);
+				if (uses != 0)
+				{
+					accessor.m_poolUses.store(uses - 1, std::memory_order_relaxed);
+					m_hand++;
+					continue;
+				}
+
+				victim = std::move(entry.accessor);
+				entry = std::move(m_entries.back());
+				m_entries.pop_back();
+				break;
+			}
+		}
+		if (!victim)
+			return false;
+		evictions++;
+		return true;
+	}
 
+public:
+	uint64_t limit = 0;
+	std::atomic<uint64_t> hits = 0;
+	std::atomic<uint64_t> misses = 0;
+	std::atomic<uint64_t> evictions = 0;
+	std::atomic<uint64_t> openFiles = 0;
+
+	void SetLimit(uint64_t newLimit)
+	{
+		limit = newLimit;
+		m_slots.set_count(newLimit);
+	}
+
+	static void Touch(MMappedFileAccessor& accessor)
+	{
+		// Racy increments only make the counter slightly less accurate, avoid the cost of an atomic RMW per use.
+		uint8_t uses = accessor.m_poolUses.load(std::memory_order_relaxed);
+		if (uses < MaxUses)
+			accessor.m_poolUses.store(uses + 1, std::memory_order_relaxed);
+	}
+
+	// Reserves a slot for a new mapping. Returns false if none could be freed, the caller then maps the file anyway
+	// rather than failing, and no slot is returned when it is closed.
+	bool AcquireSlot()
+	{
+		if (m_slots.try_acquire())
+			return true;
+		while (EvictOne())
+		{
+			// Evicted accessors are destroyed on a worker thread, give it a moment to return the slot.
+			if (m_slots.try_acquire_for(std::chrono::milliseconds(100)))
+				return true;
+		}
+		return m_slots.try_acquire();
+	}
+
+	void ReleaseSlot() { m_slots.release(); }
+
+	void Add(std::shared_ptr<MMappedFileAccessor> accessor, uint64_t sessionID)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		// If some background thread has managed to try and open a file when the BV was already closed,
+		// 		we can still give them the file they want so they dont crash, but as soon as they let go it's gone.
+		if (m_blockedSessionIDs.count(sessionID))
+			return;
+		m_entries.push_back({std::move(accessor), sessionID});
+	}
+
+	void CloseSession(uint64_t sessionID)
+	{
+		std::vector<Entry> closed;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_blockedSessionIDs.insert(sessionID);
+			auto it = std::stable_partition(m_entries.begin(), m_entries.end(),
+				[&](const Entry& entry) { return entry.sessionID != sessionID; });
+			std::move(it, m_entries.end(), std::back_inserter(closed));
+			m_entries.erase(it, m_entries.end());
+		}
+	}
+
+	void Clear()
+	{
+		std::vector<Entry> closed;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			closed.swap(m_entries);
+		}
+	}
+};
+
+static FileAccessorPool fileAccessorPool;
+static std::mutex fileAccessorsMutex;
+static std::unordered_map<std::string, std::shared_ptr<LazyMappedFileAccessor>> fileAccessors;
+
+
+void VMShutdown()
+{
 	// This will trigger the deallocation logic for these.
 	// It is background threaded to avoid a deadlock on exit.
-	fileAccessorReferenceHolder.clear();
+	fileAccessorPool.Clear();
+
+	std::unique_lock<std::mutex> lock(fileAccessorsMutex);
 	fileAccessors.clear();
 }
 
@@ -133,6 +282,7 @@ void MMAP::Map()
 		return;
 	}
 	len = static_cast<size_t>(fileSize.QuadPart);
+	mappedLen = len;
 
 	HANDLE hMapping = CreateFileMapping(
 		hFile,                       // file handle
@@ -172,6 +322,7 @@ void MMAP::Map()
 #else
 	fseek(fd, 0L, SEEK_END);
 	len = ftell(fd);
+	mappedLen = len;
 	fseek(fd, 0L, SEEK_SET);
 
 	_mmap = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(fd), 0u);
@@ -196,7 +347,7 @@ void MMAP::Unmap()
 #else
 	if (mapped)
 	{
-		munmap(_mmap, len);
+		munmap(_mmap, mappedLen);
 		mapped = false;
 	}
 #endif
@@ -214,38 +365,40 @@ std::shared_ptr<LazyMappedFileAccessor> MMappedFileAccessor::Open(BinaryNinja::R
 		path,
 		// Allocator logic for the SelfAllocatingWeakPtr
 		[path=path, sessionID=sessionID, dscView](){
-			std::unique_lock<std::mutex> _lock(fileAccessorDequeMutex);
+			fileAccessorPool.misses++;
+			bool holdsSlot = fileAccessorPool.AcquireSlot();
+			if (!holdsSlot)
+				BinaryNinja::LogWarn("Exceeding the Shared Cache file pointer limit to open %s, every open file is in use", path.c_str());
 
-			// Iterate through held references and start removing them until we can get a file pointer
-			// FIXME: This could clear all currently used file pointers and still not get one. FIX!
-			// 		We should probably use a condition variable here to wait for a file pointer to be released!!!
-			for (auto& [_, fileAccessorDeque] : fileAccessorReferenceHolder)
+			MMappedFileAccessor* rawAccessor;
+			try
+			{
+				rawAccessor = new MMappedFileAccessor(ResolveFilePath(dscView, path));
+			}
+			catch (...)
 			{
-				if (fileAccessorSemaphore.try_acquire())
-					break;
-				fileAccessorDeque.pop_front();
+				if (holdsSlot)
+					fileAccessorPool.ReleaseSlot();
+				throw;
 			}
+			rawAccessor->m_holdsPoolSlot = holdsSlot;
+			fileAccessorPool.openFiles++;
 
-			mmapCount++;
-			_lock.unlock();
-			auto accessor = std::shared_ptr<MMappedFileAccessor>(new MMappedFileAccessor(ResolveFilePath(dscView, path)), [](MMappedFileAccessor* accessor){
+			auto accessor = std::shared_ptr<MMappedFileAccessor>(rawAccessor, [](MMappedFileAccessor* accessor){
 				// worker thread or we can deadlock on exit here.
 				BinaryNinja::WorkerEnqueue([accessor](){
-					fileAccessorSemaphore.release();
-					mmapCount--;
-					if (fileAccessors.count(accessor->m_path))
 					{
 						std::scoped_lock<std::mutex> lock(fileAccessorsMutex);
 						fileAccessors.erase(accessor->m_path);
 					}
+					bool holdsSlot = accessor->m_holdsPoolSlot;
 					delete accessor;
+					fileAccessorPool.openFiles--;
+					if (holdsSlot)
+						fileAccessorPool.ReleaseSlot();
 				}, "MMappedFileAccessor Destructor");
 			});
-			_lock.lock();
-			// If some background thread has managed to try and open a file when the BV was already closed,
-			// 		we can still give them the file they want so they dont crash, but as soon as they let go it's gone.
-			if (!blockedSessionIDs.count(sessionID))
-				fileAccessorReferenceHolder[sessionID].push_back(accessor);
+			fileAccessorPool.Add(accessor, sessionID);
 			return accessor;
 		},
 		[postAllocationRoutine=postAllocationRoutine](std::shared_ptr<MMappedFileAccessor> accessor){
@@ -257,12 +410,33 @@ std::shared_ptr<LazyMappedFileAccessor> MMappedFileAccessor::Open(BinaryNinja::R
 }
 
 
+std::shared_ptr<MMappedFileAccessor> LazyMappedFileAccessor::lock()
+{
+	auto accessor = lock_no_allocate();
+	if (accessor)
+		fileAccessorPool.hits++;
+	else
+		accessor = SelfAllocatingWeakPtr::lock();
+	FileAccessorPool::Touch(*accessor);
+	return accessor;
+}
+
+
 void MMappedFileAccessor::CloseAll(const uint64_t sessionID)
 {
-	blockedSessionIDs.insert(sessionID);
-	if (fileAccessorReferenceHolder.count(sessionID) == 0)
-		return;
-	fileAccessorReferenceHolder.erase(sessionID);
+	fileAccessorPool.CloseSession(sessionID);
+
+	auto stats = PoolStatistics();
+	BinaryNinja::LogDebug("Shared Cache file accessor pool: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64
+		" evictions, %" PRIu64 " files open",
+		stats.hits, stats.misses, stats.evictions, stats.openFiles);
+}
+
+
+FileAccessorPoolStatistics MMappedFileAccessor::PoolStatistics()
+{
+	return {fileAccessorPool.hits.load(), fileAccessorPool.misses.load(), fileAccessorPool.evictions.load(),
+		fileAccessorPool.openFiles.load(), fileAccessorPool.limit};
 }
 
 
@@ -270,7 +444,7 @@ void MMappedFileAccessor::InitialVMSetup()
 {
 	// check for BN_SHAREDCACHE_FP_MAX
 	// if it exists, set maxFPLimit to that value
-	maxFPLimit = 0;
+	uint64_t maxFPLimit = 0;
 	if (auto env = getenv("BN_SHAREDCACHE_FP_MAX"); env)
 	{
 		// FIXME behav on 0 here is unintuitive, '0123' will interpret as octal and be 83 according to manpage. meh.
@@ -304,7 +478,15 @@ void MMappedFileAccessor::InitialVMSetup()
 		}
 	}
 	BinaryNinja::LogInfo("Shared Cache processing initialized with a max file pointer limit of 0x%llx", maxFPLimit);
-	fileAccessorSemaphore.set_count(maxFPLimit);
+
+	// check for BN_SHAREDCACHE_VM_BACKEND
+	// "map" selects the original std::map based address lookup, anything else uses the page table
+	if (auto env = getenv("BN_SHAREDCACHE_VM_BACKEND"); env && std::string_view(env) == "map")
+	{
+		defaultVMBackend = VMBackend::Map;
+		BinaryNinja::LogInfo("Shared Cache VM using map backend");
+	}
+	fileAccessorPool.SetLimit(maxFPLimit);
 }
 
 
@@ -486,8 +668,19 @@ void MMappedFileAccessor::Read(void* dest, size_t address, size_t length)
 }
 
 
-VM::VM(size_t pageSize, bool safe) : m_pageSize(pageSize), m_safe(safe)
+VMBackend VM::DefaultBackend()
 {
+	return defaultVMBackend;
+}
+
+
+VM::VM(size_t pageSize, bool safe, VMBackend backend) : m_pageSize(pageSize), m_pageShift(0), m_safe(safe), m_backend(backend)
+{
+	while (((size_t)1 << m_pageShift) < m_pageSize)
+		m_pageShift++;
+	// The page table indexes by shifting, which only works for power of two page sizes.
+	if (((size_t)1 << m_pageShift) != m_pageSize)
+		m_backend = VMBackend::Map;
 }
 
 VM::~VM()
@@ -495,37 +688,229 @@ VM::~VM()
 }
 
 
+// Appended to rebased copies in the rebased page cache. The rebased file contents come first, unchanged in layout,
+// so the copy can be mapped in place of the original with no translation.
+struct RebasedCacheTrailer
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+	RebasedCacheKey key;
+	uint64_t dataLength;
+};
+
+static constexpr char RebasedCacheMagic[8] = {'B', 'N', 'D', 'S', 'C', 'R', 'B', 0};
+static constexpr uint32_t RebasedCacheVersion = 1;
+
+
+bool MMappedFileAccessor::MapRebasedCopy(const std::string& cachePath, const RebasedCacheKey& key)
+{
+	MMAP cached;
+#ifdef _MSC_VER
+	cached.hFile = CreateFile(cachePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, NULL);
+	if (cached.hFile == INVALID_HANDLE_VALUE)
+		return false;
+	cached.Map();
+	if (!cached.mapped)
+		return false;
+#else
+	cached.fd = fopen(cachePath.c_str(), "r");
+	if (!cached.fd)
+		return false;
+	cached.Map();
+	if (!cached.mapped)
+	{
+		fclose(cached.fd);
+		return false;
+	}
+#endif
+
+	RebasedCacheTrailer trailer;
+	bool valid = cached.len >= sizeof(trailer);
+	if (valid)
+	{
+		memcpy(&trailer, (uint8_t*)cached._mmap + cached.len - sizeof(trailer), sizeof(trailer));
+		valid = memcmp(trailer.magic, RebasedCacheMagic, sizeof(trailer.magic)) == 0
+			&& trailer.version == RebasedCacheVersion && memcmp(&trailer.key.uuid, key.uuid, sizeof(key.uuid)) == 0
+			&& trailer.key.fileSize == key.fileSize && trailer.key.modificationTime == key.modificationTime
+			&& trailer.dataLength == m_mmap.len && trailer.dataLength <= cached.len - sizeof(trailer);
+	}
+	if (!valid)
+	{
+		cached.Unmap();
+#ifndef _MSC_VER
+		fclose(cached.fd);
+#endif
+		return false;
+	}
+
+	m_mmap.Unmap();
+#ifdef _MSC_VER
+	if (m_mmap.hFile != INVALID_HANDLE_VALUE)
+		CloseHandle(m_mmap.hFile);
+#else
+	if (m_mmap.fd)
+		fclose(m_mmap.fd);
+#endif
+	m_mmap = cached;
+	m_mmap.len = trailer.dataLength;
+	return true;
+}
+
+
+bool MMappedFileAccessor::WriteRebasedCopy(const std::string& cachePath, const RebasedCacheKey& key) const
+{
+	std::error_code ec;
+	auto target = std::filesystem::path(cachePath);
+	std::filesystem::create_directories(target.parent_path(), ec);
+	if (ec)
+		return false;
+
+	auto tempPath = target;
+	// Other processes may be writing the same copy, so the temporary name needs to be unique across processes.
+	tempPath += ".tmp" + std::to_string(std::random_device()());
+	FILE* out = fopen(tempPath.string().c_str(), "wb");
+	if (!out)
+		return false;
+
+	RebasedCacheTrailer trailer = {};
+	memcpy(trailer.magic, RebasedCacheMagic, sizeof(trailer.magic));
+	trailer.version = RebasedCacheVersion;
+	trailer.key = key;
+	trailer.dataLength = m_mmap.len;
+
+	bool written = fwrite(m_mmap._mmap, 1, m_mmap.len, out) == m_mmap.len
+		&& fwrite(&trailer, 1, sizeof(trailer), out) == sizeof(trailer);
+	written = (fclose(out) == 0) && written;
+	if (written)
+		std::filesystem::rename(tempPath, target, ec);
+	if (!written || ec)
+	{
+		std::filesystem::remove(tempPath, ec);
+		return false;
+	}
+	return true;
+}
+
+
+void VM::MapPageTableRange(size_t start, size_t end, uint32_t entry)
+{
+	size_t firstPage = start >> m_pageShift;
+	size_t lastPage = end >> m_pageShift;
+	size_t firstChunk = firstPage / PageTableChunkPages;
+	size_t lastChunk = (lastPage + PageTableChunkPages - 1) / PageTableChunkPages;
+
+	// Grow the top level table to cover [firstChunk, lastChunk).
+	if (m_pageTable.empty())
+	{
+		m_firstChunk = firstChunk;
+		m_pageTable.resize(lastChunk - firstChunk);
+	}
+	else
+	{
+		if (firstChunk < m_firstChunk)
+		{
+			std::vector<PageTableChunk> grown(m_firstChunk - firstChunk);
+			grown.insert(grown.end(), std::make_move_iterator(m_pageTable.begin()), std::make_move_iterator(m_pageTable.end()));
+			m_pageTable = std::move(grown);
+			m_firstChunk = firstChunk;
+		}
+		if (lastChunk - m_firstChunk > m_pageTable.size())
+			m_pageTable.resize(lastChunk - m_firstChunk);
+	}
+
+	for (size_t chunk = firstChunk; chunk < lastChunk; chunk++)
+	{
+		auto& table = m_pageTable[chunk - m_firstChunk];
+		size_t chunkFirstPage = chunk * PageTableChunkPages;
+		size_t from = std::max(firstPage, chunkFirstPage) - chunkFirstPage;
+		size_t to = std::min(lastPage, chunkFirstPage + PageTableChunkPages) - chunkFirstPage;
+
+		if (from == 0 && to == PageTableChunkPages)
+		{
+			// Whole chunk belongs to this region, no leaf table needed.
+			table.pages.reset();
+			table.region = entry;
+			continue;
+		}
+
+		if (!table.pages)
+		{
+			table.pages = std::make_unique<uint32_t[]>(PageTableChunkPages);
+			std::fill_n(table.pages.get(), PageTableChunkPages, table.region);
+			table.region = 0;
+		}
+		std::fill(table.pages.get() + from, table.pages.get() + to, entry);
+	}
+}
+
+
 void VM::MapPages(BinaryNinja::Ref<BinaryNinja::BinaryView> dscView, uint64_t sessionID, size_t vm_address, size_t fileoff, size_t size, const std::string& filePath, std::function<void(std::shared_ptr<MMappedFileAccessor>)> postAllocationRoutine)
 {
 	// The mappings provided for shared caches will always be page aligned.
 	// We can use this to our advantage and gain considerable performance via page tables.
-	// This could probably be sped up if c++ were avoided?
 	// We want to create a map of page -> file offset
 
 	if (vm_address % m_pageSize != 0 || size % m_pageSize != 0)
 	{
 		throw MappingPageAlignmentException();
 	}
+	if (size == 0)
+		return;
 
-	auto accessor = MMappedFileAccessor::Open(std::move(dscView), sessionID, filePath, postAllocationRoutine);
-	auto [it, inserted] = m_map.insert_or_assign({vm_address, vm_address + size}, PageMapping(std::move(accessor), fileoff));
-	if (m_safe && !inserted)
+	AddressRange range = {vm_address, vm_address + size};
+	bool collision = false;
+	if (m_backend == VMBackend::Map)
+	{
+		auto it = m_map.find(range);
+		collision = it != m_map.end();
+	}
+	else
+	{
+		size_t chunkSize = m_pageSize * PageTableChunkPages;
+		for (size_t page = range.start; page < range.end && !collision;)
+		{
+			size_t chunk = (page >> m_pageShift) / PageTableChunkPages;
+			if (chunk >= m_firstChunk && chunk - m_firstChunk < m_pageTable.size()
+				&& m_pageTable[chunk - m_firstChunk].pages)
+			{
+				collision = RegionAtAddress(page) != nullptr;
+				page += m_pageSize;
+			}
+			else
+			{
+				// Chunk is uniformly mapped or unmapped, so it can be checked in one go.
+				collision = RegionAtAddress(page) != nullptr;
+				page = (page / chunkSize + 1) * chunkSize;
+			}
+		}
+	}
+
+	if (m_safe && collision)
 	{
 		BNLogWarn("Remapping page 0x%zx (f: 0x%zx)", vm_address, fileoff);
 		throw MappingCollisionException();
 	}
+
+	auto accessor = MMappedFileAccessor::Open(std::move(dscView), sessionID, filePath, postAllocationRoutine);
+	m_regions.push_back({range, PageMapping(std::move(accessor), fileoff)});
+	size_t index = m_regions.size() - 1;
+
+	if (m_backend == VMBackend::Map)
+		m_map.insert_or_assign(range, index);
+	else
+		MapPageTableRange(range.start, range.end, (uint32_t)(index + 1));
 }
 
 std::pair<PageMapping, size_t> VM::MappingAtAddress(size_t address)
 {
-	if (auto it = m_map.find(address); it != m_map.end())
+	if (auto region = RegionAtAddress(address))
 	{
 		// The PageMapping object returned contains the page, and more importantly, the file pointer (there can be
 		// multiple in newer caches) This is relevant for reading out the data in the rest of this file.
 		// The second item in the returned pair is the offset of `address` within the file.
-		auto& range = it->first;
-		auto& mapping = it->second;
-		return {mapping, mapping.fileOffset + (address - range.start)};
+		return {region->mapping, region->mapping.fileOffset + (address - region->range.start)};
 	}
 
 	throw MappingReadException();
@@ -534,8 +919,25 @@ std::pair<PageMapping, size_t> VM::MappingAtAddress(size_t address)
 
 bool VM::AddressIsMapped(uint64_t address)
 {
-	auto it = m_map.find(address);
-	return it != m_map.end();
+	return RegionAtAddress(address) != nullptr;
+}
+
+
+const uint8_t* VMReader::TranslateSlow(size_t address, size_t length)
+{
+	auto region = m_vm->RegionAtAddress(address);
+	if (!region)
+		throw MappingReadException();
+
+	auto file = region->mapping.fileAccessor->lock();
+	size_t offset = region->mapping.fileOffset + (address - region->range.start);
+	if (offset + length > file->Length())
+		throw MappingReadException();
+	auto data = (const uint8_t*)file->Data() + offset;
+
+	// The file is held even with the map backend so spans stay valid, it just isn't used to skip lookups.
+	m_tlb = {region->range.start, region->range.end, region->mapping.fileOffset, std::move(file)};
+	return data;
 }
 
 
@@ -659,7 +1061,11 @@ void VM::Read(void* dest, size_t addr, size_t length)
 	mapping.first.fileAccessor->lock()->Read(dest, mapping.second, length);
 }
 
-VMReader::VMReader(std::shared_ptr<VM> vm, size_t addressSize) : m_vm(vm), m_cursor(0), m_addressSize(addressSize) {}
+VMReader::VMReader(std::shared_ptr<VM> vm, size_t addressSize) : m_vm(vm), m_cursor(0), m_addressSize(addressSize)
+{
+	// The map backend is kept as a baseline, so it doesn't get the benefit of the translation cache.
+	m_useTLB = m_vm->m_backend == VMBackend::PageTable;
+}
 
 
 void VMReader::Seek(size_t address)
@@ -674,64 +1080,49 @@ void VMReader::SeekRelative(size_t offset)
 
 std::string VMReader::ReadCString(size_t address)
 {
-	auto mapping = m_vm->MappingAtAddress(address);
-	return mapping.first.fileAccessor->lock()->ReadNullTermString(mapping.second);
+	auto data = (const char*)Translate(address, 0);
+	auto fileEnd = (const char*)m_tlb.file->Data() + m_tlb.file->Length();
+	return std::string(data, strnlen(data, fileEnd - data));
 }
 
 uint8_t VMReader::ReadUChar(size_t address)
 {
-	auto mapping = m_vm->MappingAtAddress(address);
-	m_cursor = address + 1;
-	return mapping.first.fileAccessor->lock()->ReadUChar(mapping.second);
+	return ReadAt<uint8_t>(address);
 }
 
 int8_t VMReader::ReadChar(size_t address)
 {
-	auto mapping = m_vm->MappingAtAddress(address);
-	m_cursor = address + 1;
-	return mapping.first.fileAccessor->lock()->ReadChar(mapping.second);
+	return ReadAt<int8_t>(address);
 }
 
 uint16_t VMReader::ReadUShort(size_t address)
 {
-	auto mapping = m_vm->MappingAtAddress(address);
-	m_cursor = address + 2;
-	return mapping.first.fileAccessor->lock()->ReadUShort(mapping.second);
+	return ReadAt<uint16_t>(address);
 }
 
 int16_t VMReader::ReadShort(size_t address)
 {
-	auto mapping = m_vm->MappingAtAddress(address);
-	m_cursor = address + 2;
-	return mapping.first.fileAccessor->lock()->ReadShort(mapping.second);
+	return ReadAt<int16_t>(address);
 }
 
 uint32_t VMReader::ReadUInt32(size_t address)
 {
-	auto mapping = m_vm->MappingAtAddress(address);
-	m_cursor = address + 4;
-	return mapping.first.fileAccessor->lock()->ReadUInt32(mapping.second);
+	return ReadAt<uint32_t>(address);
 }
 
 int32_t VMReader::ReadInt32(size_t address)
 {
-	auto mapping = m_vm->MappingAtAddress(address);
-	m_cursor = address + 4;
-	return mapping.first.fileAccessor->lock()->ReadInt32(mapping.second);
+	return ReadAt<int32_t>(address);
 }
 
 uint64_t VMReader::ReadULong(size_t address)
 {
-	auto mapping = m_vm->MappingAtAddress(address);
-	m_cursor = address + 8;
-	return mapping.first.fileAccessor->lock()->ReadULong(mapping.second);
+	return ReadAt<uint64_t>(address);
 }
 
 int64_t VMReader::ReadLong(size_t address)
 {
-	auto mapping = m_vm->MappingAtAddress(address);
-	m_cursor = address + 8;
-	return mapping.first.fileAccessor->lock()->ReadLong(mapping.second);
+	return ReadAt<int64_t>(address);
 }
 
 
@@ -759,85 +1150,74 @@ size_t VMReader::ReadPointer()
 
 BinaryNinja::DataBuffer VMReader::ReadBuffer(size_t length)
 {
-	auto mapping = m_vm->MappingAtAddress(m_cursor);
-	m_cursor += length;
-	return mapping.first.fileAccessor->lock()->ReadBuffer(mapping.second, length);
+	return ReadBuffer(m_cursor, length);
 }
 
 BinaryNinja::DataBuffer VMReader::ReadBuffer(size_t addr, size_t length)
 {
-	auto mapping = m_vm->MappingAtAddress(addr);
+	auto data = Translate(addr, length);
 	m_cursor = addr + length;
-	return mapping.first.fileAccessor->lock()->ReadBuffer(mapping.second, length);
+	return BinaryNinja::DataBuffer(data, length);
 }
 
 void VMReader::Read(void* dest, size_t length)
 {
-	auto mapping = m_vm->MappingAtAddress(m_cursor);
-	m_cursor += length;
-	mapping.first.fileAccessor->lock()->Read(dest, mapping.second, length);
+	Read(dest, m_cursor, length);
 }
 
 void VMReader::Read(void* dest, size_t addr, size_t length)
 {
-	auto mapping = m_vm->MappingAtAddress(addr);
+	memcpy(dest, Translate(addr, length), length);
 	m_cursor = addr + length;
-	mapping.first.fileAccessor->lock()->Read(dest, mapping.second, length);
+}
+
+std::pair<const uint8_t*, const uint8_t*> VMReader::ReadSpan(size_t addr, size_t length)
+{
+	auto data = Translate(addr, length);
+	// Translate only checks against the end of the backing file, a span must also stay within its mapping.
+	if (addr < m_tlb.start || length > m_tlb.end - addr)
+		throw MappingReadException();
+	m_cursor = addr + length;
+	return {data, data + length};
 }
 
 
 uint8_t VMReader::Read8()
 {
-	auto mapping = m_vm->MappingAtAddress(m_cursor);
-	m_cursor += 1;
-	return mapping.first.fileAccessor->lock()->ReadUChar(mapping.second);
+	return ReadAt<uint8_t>(m_cursor);
 }
 
 int8_t VMReader::ReadS8()
 {
-	auto mapping = m_vm->MappingAtAddress(m_cursor);
-	m_cursor += 1;
-	return mapping.first.fileAccessor->lock()->ReadChar(mapping.second);
+	return ReadAt<int8_t>(m_cursor);
 }
 
 uint16_t VMReader::Read16()
 {
-	auto mapping = m_vm->MappingAtAddress(m_cursor);
-	m_cursor += 2;
-	return mapping.first.fileAccessor->lock()->ReadUShort(mapping.second);
+	return ReadAt<uint16_t>(m_cursor);
 }
 
 int16_t VMReader::ReadS16()
 {
-	auto mapping = m_vm->MappingAtAddress(m_cursor);
-	m_cursor += 2;
-	return mapping.first.fileAccessor->lock()->ReadShort(mapping.second);
+	return ReadAt<int16_t>(m_cursor);
 }
 
 uint32_t VMReader::Read32()
 {
-	auto mapping = m_vm->MappingAtAddress(m_cursor);
-	m_cursor += 4;
-	return mapping.first.fileAccessor->lock()->ReadUInt32(mapping.second);
+	return ReadAt<uint32_t>(m_cursor);
 }
 
 int32_t VMReader::ReadS32()
 {
-	auto mapping = m_vm->MappingAtAddress(m_cursor);
-	m_cursor += 4;
-	return mapping.first.fileAccessor->lock()->ReadInt32(mapping.second);
+	return ReadAt<int32_t>(m_cursor);
 }
 
 uint64_t VMReader::Read64()
 {
-	auto mapping = m_vm->MappingAtAddress(m_cursor);
-	m_cursor += 8;
-	return mapping.first.fileAccessor->lock()->ReadULong(mapping.second);
+	return ReadAt<uint64_t>(m_cursor);
 }
 
 int64_t VMReader::ReadS64()
 {
-	auto mapping = m_vm->MappingAtAddress(m_cursor);
-	m_cursor += 8;
-	return mapping.first.fileAccessor->lock()->ReadLong(mapping.second);
+	return ReadAt<int64_t>(m_cursor);
 }
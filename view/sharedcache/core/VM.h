@@ -5,7 +5,13 @@
 #ifndef SHAREDCACHE_VM_H
 #define SHAREDCACHE_VM_H
 #include <binaryninjaapi.h>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <type_traits>
 
 void VMShutdown();
 
@@ -36,6 +42,15 @@ public:
 		return false;
 	}
 
+	template <typename Rep, typename Period>
+	bool try_acquire_for(const std::chrono::duration<Rep, Period>& timeout) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		if (!cv_.wait_for(lock, timeout, [this]() { return count_ > 0; }))
+			return false;
+		--count_;
+		return true;
+	}
+
 	void set_count(int new_count) {
 		std::unique_lock<std::mutex> lock(mutex_);
 		count_ = new_count;
@@ -54,8 +69,12 @@ class SelfAllocatingWeakPtr {
 public:
 	SelfAllocatingWeakPtr(std::function<std::shared_ptr<T>()> allocator, std::function<void(std::shared_ptr<T>)> postAlloc)
 		: allocator(allocator), postAlloc(postAlloc) {}
+	virtual ~SelfAllocatingWeakPtr() = default;
 
-	std::shared_ptr<T> lock() {
+	// Virtual so a subclass that tracks uses (LazyMappedFileAccessor) sees calls made through a base pointer.
+	// Safe to call from several threads, only one of them allocates.
+	virtual std::shared_ptr<T> lock() {
+		std::unique_lock<std::mutex> guard(mutex);
 		std::shared_ptr<T> sharedPtr = weakPtr.lock();
 		if (!sharedPtr) {
 			sharedPtr = allocator();
@@ -66,10 +85,12 @@ public:
 	}
 
 	std::shared_ptr<T> lock_no_allocate() {
+		std::unique_lock<std::mutex> guard(mutex);
 		return weakPtr.lock();
 	}
 
 private:
+	std::mutex mutex;                               // Guards weakPtr
 	std::weak_ptr<T> weakPtr;                       // Weak reference to the object
 	std::function<std::shared_ptr<T>()> allocator;  // Function to recreate the object
 	std::function<void(std::shared_ptr<T>)> postAlloc;  // Function to call after the object is allocated
@@ -92,6 +113,8 @@ class MMAP {
     void *_mmap;
     FILE *fd;
     size_t len;
+    // Size of the actual mapping, which can be larger than `len` when the file has a trailer.
+    size_t mappedLen = 0;
 
 #ifdef _MSC_VER
 	HANDLE hFile = INVALID_HANDLE_VALUE; // For Windows
@@ -113,25 +136,46 @@ public:
 
     std::string_view filePath() const { return m_filePath; }
 
+    // Returns the accessor, mapping the file again if it was evicted from the file accessor pool.
+    // Every call counts as a use of the file for the pool's eviction policy.
+    std::shared_ptr<MMappedFileAccessor> lock() override;
+
 private:
     std::string m_filePath;
 };
 
-static uint64_t maxFPLimit;
-static std::mutex fileAccessorDequeMutex;
-static std::unordered_map<uint64_t, std::deque<std::shared_ptr<MMappedFileAccessor>>> fileAccessorReferenceHolder;
-static std::set<uint64_t> blockedSessionIDs;
-static std::mutex fileAccessorsMutex;
-static std::unordered_map<std::string, std::shared_ptr<LazyMappedFileAccessor>> fileAccessors;
-static counting_semaphore fileAccessorSemaphore(0);
+struct FileAccessorPoolStatistics {
+	// `LazyMappedFileAccessor::lock` calls that found the file already mapped.
+	uint64_t hits;
+	// `LazyMappedFileAccessor::lock` calls that had to map the file.
+	uint64_t misses;
+	// Files the pool stopped holding to stay within the file pointer limit.
+	uint64_t evictions;
+	// Files currently mapped, whether or not the pool still holds them.
+	uint64_t openFiles;
+	uint64_t limit;
+};
 
-static std::atomic<uint64_t> mmapCount = 0;
+// Identifies the original file a rebased copy in the rebased page cache was made from.
+struct RebasedCacheKey {
+	uint8_t uuid[16];
+	uint64_t fileSize;
+	int64_t modificationTime;
+};
 
 class MMappedFileAccessor {
+	friend class FileAccessorPool;
+	friend LazyMappedFileAccessor;
+
     std::string m_path;
     MMAP m_mmap;
 	bool m_slideInfoWasApplied = false;
 
+	// State used by the file accessor pool, see VM.cpp.
+	std::atomic<uint8_t> m_poolUses = 0;
+	std::atomic<uint32_t> m_pinCount = 0;
+	bool m_holdsPoolSlot = false;
+
 public:
 	MMappedFileAccessor(const std::string &path);
 	~MMappedFileAccessor();
@@ -142,6 +186,17 @@ public:
 
 	static void InitialVMSetup();
 
+	static FileAccessorPoolStatistics PoolStatistics();
+
+	/**
+	 * Prevents the file accessor pool from evicting this file until the matching `Unpin`.
+	 *
+	 * Used while slide info is being applied, so a rebased file isn't dropped and rebased again as soon as the pool
+	 * comes under pressure.
+	 */
+	void Pin() { m_pinCount++; }
+	void Unpin() { m_pinCount--; }
+
     std::string Path() const { return m_path; };
 
     size_t Length() const { return m_mmap.len; };
@@ -196,6 +251,42 @@ public:
     std::pair<const uint8_t*, const uint8_t*> ReadSpan(size_t addr, size_t length);
 
     void Read(void *dest, size_t addr, size_t length);
+
+	/**
+	 * Replaces this accessor's mapping with an already rebased copy of the same file from the rebased page cache.
+	 *
+	 * This must only be called before any data pointers have been handed out from this accessor, i.e. straight after
+	 * it is opened and before slide info is applied.
+	 *
+	 * \param cachePath Path of the rebased copy, as written by `WriteRebasedCopy`
+	 * \param key Key of the file currently mapped
+	 * \return false if the copy doesn't exist or was made from a different file, in which case nothing changes
+	 */
+	bool MapRebasedCopy(const std::string& cachePath, const RebasedCacheKey& key);
+
+	/**
+	 * Writes the current contents of this file, followed by a trailer identifying `key`, to `cachePath`.
+	 *
+	 * The copy is written to a temporary file first and renamed into place, so concurrent readers never observe
+	 * a partially written copy.
+	 */
+	bool WriteRebasedCopy(const std::string& cachePath, const RebasedCacheKey& key) const;
+};
+
+
+// Keeps a file pinned in the file accessor pool for the lifetime of the guard.
+class FileAccessorPin {
+	std::shared_ptr<MMappedFileAccessor> m_accessor;
+
+public:
+	explicit FileAccessorPin(std::shared_ptr<MMappedFileAccessor> accessor) : m_accessor(std::move(accessor))
+	{
+		m_accessor->Pin();
+	}
+	~FileAccessorPin() { m_accessor->Unpin(); }
+
+	FileAccessorPin(const FileAccessorPin&) = delete;
+	FileAccessorPin& operator=(const FileAccessorPin&) = delete;
 };
 
 
@@ -234,6 +325,20 @@ class MappingCollisionException : VMException {
 class VMReader;
 
 
+/**
+ * How a `VM` resolves virtual addresses to file mappings.
+ *
+ * `PageTable` is the default. `Map` is the original `std::map` based lookup with no per reader caching, kept around
+ * for comparing behavior and performance. It can be selected with the `BN_SHAREDCACHE_VM_BACKEND=map` environment
+ * variable.
+ */
+enum class VMBackend
+{
+	PageTable,
+	Map,
+};
+
+
 class VM {
 
     // Represents a range of addresses [start, end).
@@ -255,17 +360,61 @@ class VM {
         }
     };
 
+    struct Region {
+        AddressRange range;
+        PageMapping mapping;
+    };
+
+    // Two level page table. Each top level entry covers `PageTableChunkPages` pages. Chunks that lie entirely within
+    // a single region store that region directly, so leaf tables only exist where a chunk straddles a region boundary.
+    // Entries hold a region index + 1, with 0 meaning unmapped.
+    static constexpr size_t PageTableChunkPages = 1024;
+    struct PageTableChunk {
+        uint32_t region = 0;
+        std::unique_ptr<uint32_t[]> pages;
+    };
+
+    // Regions are never removed, so indexes into this stay valid for the lifetime of the VM.
+    std::deque<Region> m_regions;
+
     // A map keyed by address ranges that can be looked up via any
     // address within a range thanks to C++14's transparent comparators.
-    std::map<AddressRange, PageMapping, std::less<>> m_map;
+    std::map<AddressRange, size_t, std::less<>> m_map;
+
+    std::vector<PageTableChunk> m_pageTable;
+    size_t m_firstChunk = 0;
+
     size_t m_pageSize;
+    size_t m_pageShift;
     bool m_safe;
+    VMBackend m_backend;
 
     friend VMReader;
 
+    void MapPageTableRange(size_t start, size_t end, uint32_t entry);
+
+    const Region* RegionAtAddress(size_t address) const
+    {
+        if (m_backend == VMBackend::Map)
+        {
+            if (auto it = m_map.find(address); it != m_map.end())
+                return &m_regions[it->second];
+            return nullptr;
+        }
+
+        size_t chunk = (address >> m_pageShift) / PageTableChunkPages;
+        if (chunk < m_firstChunk || chunk - m_firstChunk >= m_pageTable.size())
+            return nullptr;
+        const auto& entry = m_pageTable[chunk - m_firstChunk];
+        uint32_t region = entry.pages ? entry.pages[(address >> m_pageShift) % PageTableChunkPages] : entry.region;
+        return region ? &m_regions[region - 1] : nullptr;
+    }
+
 public:
 
-    VM(size_t pageSize, bool safe = true);
+    static VMBackend DefaultBackend();
+
+    VM(size_t pageSize, bool safe = true, VMBackend backend = DefaultBackend());
 
     ~VM();
 
@@ -275,6 +424,8 @@ public:
 
     std::pair<PageMapping, size_t> MappingAtAddress(size_t address);
 
+    VMBackend Backend() const { return m_backend; }
+
     std::string ReadNullTermString(size_t address);
 
     uint8_t ReadUChar(size_t address);
@@ -306,6 +457,41 @@ class VMReader {
 
 	BNEndianness m_endianness = LittleEndian;
 
+	// The last region this reader touched. Holding the locked file accessor keeps the file mapped between reads
+	// instead of re-locking the weak pointer every time, and keeps spans returned by `ReadSpan` valid.
+	struct TLBEntry {
+		size_t start = 0;
+		size_t end = 0;
+		size_t fileOffset = 0;
+		std::shared_ptr<MMappedFileAccessor> file;
+	};
+	TLBEntry m_tlb;
+	bool m_useTLB;
+
+	// Returns a pointer to `length` bytes of mapped file data backing `address`.
+	const uint8_t* Translate(size_t address, size_t length)
+	{
+		if (m_useTLB && address >= m_tlb.start && address < m_tlb.end)
+		{
+			size_t offset = m_tlb.fileOffset + (address - m_tlb.start);
+			if (offset + length <= m_tlb.file->Length())
+				return (const uint8_t*)m_tlb.file->Data() + offset;
+			throw MappingReadException();
+		}
+		return TranslateSlow(address, length);
+	}
+
+	const uint8_t* TranslateSlow(size_t address, size_t length);
+
+	template <typename T>
+	T ReadAt(size_t address)
+	{
+		T result;
+		memcpy(&result, Translate(address, sizeof(T)), sizeof(T));
+		m_cursor = address + sizeof(T);
+		return result;
+	}
+
 public:
     VMReader(std::shared_ptr<VM> vm, size_t addressSize = 8);
 
@@ -368,6 +554,38 @@ public:
     void Read(void *dest, size_t length);
 
     void Read(void *dest, size_t addr, size_t length);
+
+    /**
+     * Returns the range [addr, addr + length) as a pointer pair into the backing file.
+     *
+     * The range must lie entirely within a single mapping, otherwise `MappingReadException` is thrown.
+     *
+     * WARNING: The returned pointers are only valid until the next read through this reader, or until it is destroyed.
+     * Decode everything needed from the span before doing any other reads.
+     */
+    std::pair<const uint8_t*, const uint8_t*> ReadSpan(size_t addr, size_t length);
+
+    // Copies a packed structure at `addr` in a single bounds checked read.
+    template <typename T>
+    T ReadStruct(size_t addr)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return ReadAt<T>(addr);
+    }
+
+    // Copies `count` consecutive packed structures at `addr`. The whole array must lie within a single mapping.
+    template <typename T>
+    std::vector<T> ReadArray(size_t addr, size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (count > SIZE_MAX / sizeof(T))
+            throw MappingReadException();
+        std::vector<T> result(count);
+        auto [begin, end] = ReadSpan(addr, count * sizeof(T));
+        if (count)
+            memcpy(result.data(), begin, end - begin);
+        return result;
+    }
 };
 
 #endif //SHAREDCACHE_VM_H
@@ -0,0 +1,120 @@
+// Compares the JSON and binary encodings of shared cache metadata.
+//
+// Takes a saved shared cache state, either the JSON written when `loader.dsc.serializeMetadataAsJson` is enabled or
+// the raw binary metadata, e.g. dumped from the Python console with:
+//
+//     open("state.bin", "wb").write(bv.parent_view.query_metadata("SHAREDCACHE-SharedCacheData"))
+//
+// and times a full write and load of that state in both formats.
+//
+// Build with -DMETADATA_BENCHMARK=ON.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "rapidjson/document.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include "BinaryMetadata.h"
+
+using namespace SharedCacheCore;
+
+template <typename F>
+static double TimeMilliseconds(size_t iterations, F&& f)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++)
+		f();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+
+static bool LoadBinary(rapidjson::Document& doc, const std::vector<uint8_t>& data, bool inSitu)
+{
+	BinaryMetadataReader reader(data.data(), data.size(), inSitu);
+	bool valid = false;
+	auto generator = [&](rapidjson::Document& handler) { return valid = reader(handler); };
+	doc.Populate(generator);
+	return valid;
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <state file> [iterations]\n", argv[0]);
+		return 1;
+	}
+	size_t iterations = argc > 2 ? strtoul(argv[2], nullptr, 0) : 10;
+	if (iterations == 0)
+		iterations = 1;
+
+	std::ifstream file(argv[1], std::ios::binary);
+	if (!file)
+	{
+		fprintf(stderr, "failed to open %s\n", argv[1]);
+		return 1;
+	}
+	std::vector<uint8_t> input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	rapidjson::Document state;
+	if (BinaryMetadata::IsBinaryMetadata(input.data(), input.size()))
+	{
+		if (!LoadBinary(state, input, false))
+		{
+			fprintf(stderr, "malformed binary metadata\n");
+			return 1;
+		}
+	}
+	else
+	{
+		std::string json(input.begin(), input.end());
+		state.Parse(json.c_str());
+		if (state.HasParseError())
+		{
+			fprintf(stderr, "input is neither binary metadata nor JSON\n");
+			return 1;
+		}
+	}
+
+	// Serialization in the plugin streams SAX events from `Store` into the writer, replaying the document produces
+	// the same event sequence without needing a loaded cache.
+	std::string json;
+	double jsonWrite = TimeMilliseconds(iterations, [&]() {
+		rapidjson::StringBuffer buffer;
+		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+		state.Accept(writer);
+		json.assign(buffer.GetString(), buffer.GetSize());
+	});
+
+	std::vector<uint8_t> binary;
+	double binaryWrite = TimeMilliseconds(iterations, [&]() {
+		BinaryMetadataWriter writer;
+		state.Accept(writer);
+		binary = writer.TakeOutput();
+	});
+
+	double jsonLoad = TimeMilliseconds(iterations, [&]() {
+		rapidjson::Document doc;
+		doc.Parse(json.c_str());
+	});
+
+	double binaryLoad = TimeMilliseconds(iterations, [&]() {
+		rapidjson::Document doc;
+		LoadBinary(doc, binary, true);
+	});
+
+	printf("%-8s %14s %12s %12s\n", "format", "size (bytes)", "write (ms)", "load (ms)");
+	printf("%-8s %14zu %12.3f %12.3f\n", "json", json.size(), jsonWrite, jsonLoad);
+	printf("%-8s %14zu %12.3f %12.3f\n", "binary", binary.size(), binaryWrite, binaryLoad);
+	printf("binary is %.1f%% of the JSON size, writes %.2fx and loads %.2fx faster\n",
+		100.0 * binary.size() / json.size(), jsonWrite / binaryWrite, jsonLoad / binaryLoad);
+	return 0;
+}